@@ -167,5 +167,58 @@ def run_benchmarks():
     print("   pure Python significantly because the loop runs fully inside C++ compiled code.")
     print("=" * 70)
 
+def run_batch_benchmark(n=1_000_000):
+    """Time a 1M-option price + delta risk sweep through the vectorized kernel."""
+    if not optipricer:
+        return
+    import numpy as np
+
+    rng = np.random.default_rng(42)
+    S = 21500.0
+    K = rng.uniform(15000.0, 28000.0, n)
+    T = rng.uniform(1.0 / 365.0, 2.0, n)
+    vol = rng.uniform(0.05, 0.8, n)
+    is_call = rng.random(n) < 0.5
+
+    optipricer.models.price_delta_batch(S, K, 0.07, T, vol, 0.012, is_call)  # Warm-up
+    t0 = time.perf_counter()
+    optipricer.models.price_delta_batch(S, K, 0.07, T, vol, 0.012, is_call)
+    t_batch = time.perf_counter() - t0
+
+    print("\n" + "=" * 70)
+    print(f"{'Batch Risk Sweep (1M options)':<32} | {'Time (ms)':<12} | {'Per option':<16}")
+    print("-" * 70)
+    print(f"{'price_delta_batch (SIMD)':<32} | {t_batch * 1e3:.2f} ms     | {t_batch / n * 1e9:.1f} ns")
+    print("=" * 70)
+
+def run_mc_convergence_benchmark(steps=64):
+    """Error vs wall-clock of pseudo-random MC and Sobol QMC against the closed-form price."""
+    if not optipricer:
+        return
+    from optipricer import montecarlo
+
+    S, K, r, T, vol, q = 100.0, 100.0, 0.05, 1.0, 0.2, 0.02
+    exact = optipricer.models.BlackScholesModel(strike_price=K, volatility=vol, risk_free_rate=r, time_to_maturity=T,
+                                                underlying_price=S, dividend_yield=q).call_price()
+    engine = montecarlo.MonteCarloEngine(S, r, T, vol, q)
+
+    print("\n" + "=" * 70)
+    print(f"MC vs QMC convergence: European call, {steps} steps, no variance reduction")
+    print(f"Black-Scholes price {exact:.6f}")
+    print("-" * 70)
+    print(f"{'Paths':>9} | {'MC error':>9} {'MC s.e.':>9} {'ms':>7} | {'QMC error':>9} {'QMC s.e.':>9} {'ms':>7}")
+    print("-" * 70)
+    for paths in (2 ** 12, 2 ** 14, 2 ** 16, 2 ** 18, 2 ** 20):
+        row = []
+        for sampler in (montecarlo.Sampler.PSEUDO_RANDOM, montecarlo.Sampler.SOBOL):
+            t0 = time.perf_counter()
+            res = engine.price(K, paths=paths, steps=steps, antithetic=False, control_variate=False, sampler=sampler)
+            row.append((abs(res.price - exact), res.std_error, (time.perf_counter() - t0) * 1e3))
+        (e_mc, se_mc, t_mc), (e_qmc, se_qmc, t_qmc) = row
+        print(f"{paths:>9} | {e_mc:>9.2e} {se_mc:>9.2e} {t_mc:>7.1f} | {e_qmc:>9.2e} {se_qmc:>9.2e} {t_qmc:>7.1f}")
+    print("=" * 70)
+
 if __name__ == '__main__':
     run_benchmarks()
+    run_batch_benchmark()
+    run_mc_convergence_benchmark()
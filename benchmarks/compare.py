@@ -0,0 +1,69 @@
+"""
+Compare two JSON reports from benchmarks/cpp/bench_optipricer.
+
+    python benchmarks/compare.py baseline.json current.json [--threshold 0.10] [--metric real_time]
+
+Prints the per-benchmark change in time and exits with status 1 when any
+benchmark present in both runs got slower by more than the threshold, so it
+can gate CI. Benchmarks that exist in only one run are listed but never fail
+the comparison.
+"""
+
+import argparse
+import json
+import sys
+
+_UNITS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def load(path, metric):
+    with open(path) as f:
+        report = json.load(f)
+    times = {}
+    for bench in report.get('benchmarks', []):
+        if bench.get('run_type', 'iteration') != 'iteration':
+            continue
+        times[bench['name']] = bench[metric] * _UNITS[bench.get('time_unit', 'ns')]
+    return report.get('context', {}), times
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help='relative slowdown that counts as a regression (default 0.10)')
+    parser.add_argument('--metric', default='real_time', choices=('real_time', 'cpu_time', 'real_time_min'),
+                        help='timing field to compare (default real_time, the median repetition)')
+    args = parser.parse_args(argv)
+
+    base_ctx, base = load(args.baseline, args.metric)
+    curr_ctx, curr = load(args.current, args.metric)
+    for label, ctx in (('baseline', base_ctx), ('current', curr_ctx)):
+        print(f"{label}: {ctx.get('commit', '?')} ({ctx.get('date', '?')}, {ctx.get('num_cpus', '?')} cpus, "
+              f"simd={ctx.get('simd', '?')})")
+
+    regressions = []
+    width = max((len(name) for name in base.keys() | curr.keys()), default=9)
+    print(f"\n{'Benchmark':<{width}} {'Baseline (ns)':>14} {'Current (ns)':>14} {'Change':>9}")
+    for name in list(base) + [n for n in curr if n not in base]:
+        if name not in curr or name not in base:
+            old = f"{base[name]:14.1f}" if name in base else f"{'-':>14}"
+            new = f"{curr[name]:14.1f}" if name in curr else f"{'-':>14}"
+            print(f"{name:<{width}} {old} {new} {'n/a':>9}")
+            continue
+        change = curr[name] / base[name] - 1.0 if base[name] > 0 else 0.0
+        flag = '  REGRESSION' if change > args.threshold else ''
+        print(f"{name:<{width}} {base[name]:14.1f} {curr[name]:14.1f} {change:+9.1%}{flag}")
+        if flag:
+            regressions.append(name)
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than the {args.threshold:.0%} threshold")
+        return 1
+    print(f"\nNo regressions beyond {args.threshold:.0%}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,353 @@
+#ifndef OPTIPRICER_BENCH_HPP
+#define OPTIPRICER_BENCH_HPP
+
+/*
+ * Minimal Google Benchmark-style harness for the native microbenchmarks.
+ *
+ * Benchmarks are functions of a State, timed over the `for (auto _ : state)`
+ * loop only, so setup before the loop is free. Each one is run with a
+ * growing iteration count until a repetition lasts at least --benchmark_min_time
+ * seconds, then repeated --benchmark_repetitions times; the median repetition
+ * is reported. Results go to the console and, with --benchmark_out=<file>,
+ * to JSON laid out like Google Benchmark's (context + benchmarks[]) so runs
+ * from different commits can be diffed with benchmarks/compare.py.
+ *
+ * Kept dependency-free on purpose: the library is header-only and this
+ * harness should build with the same one-line compiler invocation.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__)
+#define OPTIPRICER_BENCH_UNUSED __attribute__((unused))
+#else
+#define OPTIPRICER_BENCH_UNUSED
+#endif
+
+namespace bench
+{
+    // Keeps value (and the work that produced it) from being optimized away
+    template <typename T>
+    inline void do_not_optimize(const T &value)
+    {
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        const volatile T *sink = &value;
+        (void)sink;
+#endif
+    }
+
+    class State
+    {
+    private:
+        std::size_t remaining;
+        std::size_t total;
+        std::chrono::steady_clock::time_point wall_start;
+        std::chrono::steady_clock::time_point wall_end;
+        std::clock_t cpu_start = 0;
+        std::clock_t cpu_end = 0;
+        double items = 0.0;
+
+    public:
+        // Named per-benchmark values copied into the report (solver iterations, ...)
+        std::map<std::string, double> counters;
+
+        // Loop variable type; marked unused so `for (auto _ : state)` does not warn
+        struct OPTIPRICER_BENCH_UNUSED Value
+        {
+        };
+
+        class Iterator
+        {
+        private:
+            State *state;
+
+        public:
+            explicit Iterator(State *s) : state(s) {}
+            Value operator*() const { return Value(); }
+            Iterator &operator++()
+            {
+                --state->remaining;
+                return *this;
+            }
+            bool operator!=(const Iterator &) const
+            {
+                if (state->remaining != 0)
+                {
+                    return true;
+                }
+                state->cpu_end = std::clock();
+                state->wall_end = std::chrono::steady_clock::now();
+                return false;
+            }
+        };
+
+        explicit State(std::size_t iterations) : remaining(iterations), total(iterations) {}
+
+        Iterator begin()
+        {
+            wall_start = std::chrono::steady_clock::now();
+            cpu_start = std::clock();
+            return Iterator(this);
+        }
+        Iterator end() { return Iterator(this); }
+
+        std::size_t iterations() const { return total; }
+        // Work items per iteration times iterations, for the items_per_second rate
+        void set_items_processed(double n) { items = n; }
+        double items_processed() const { return items; }
+
+        double wall_seconds() const { return std::chrono::duration<double>(wall_end - wall_start).count(); }
+        double cpu_seconds() const { return static_cast<double>(cpu_end - cpu_start) / CLOCKS_PER_SEC; }
+    };
+
+    typedef std::function<void(State &)> Function;
+
+    struct Benchmark
+    {
+        std::string name;
+        Function fn;
+    };
+
+    inline std::vector<Benchmark> &registry()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    inline std::vector<std::pair<std::string, std::string>> &context()
+    {
+        static std::vector<std::pair<std::string, std::string>> entries;
+        return entries;
+    }
+
+    inline void add(const std::string &name, Function fn) { registry().push_back({name, std::move(fn)}); }
+    inline void add_context(const std::string &key, const std::string &value) { context().emplace_back(key, value); }
+
+    namespace detail
+    {
+        struct Report
+        {
+            std::string name;
+            std::size_t iterations;
+            std::size_t repetitions;
+            double real_ns;
+            double cpu_ns;
+            double real_min_ns;
+            double items_per_second;
+            std::map<std::string, double> counters;
+        };
+
+        inline std::string json_escape(const std::string &s)
+        {
+            std::string out;
+            for (char c : s)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    out += '\\';
+                }
+                out += c;
+            }
+            return out;
+        }
+
+        inline double median(std::vector<double> v)
+        {
+            std::sort(v.begin(), v.end());
+            const std::size_t n = v.size();
+            return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+        }
+
+        inline Report run(const Benchmark &b, double min_time, std::size_t repetitions)
+        {
+            // Grow the iteration count until one repetition lasts min_time
+            std::size_t n = 1;
+            for (;;)
+            {
+                State probe(n);
+                b.fn(probe);
+                const double t = probe.wall_seconds();
+                if (t >= min_time || n >= 1000000000)
+                {
+                    break;
+                }
+                const double scale = t > 0.0 ? 1.4 * min_time / t : 10.0;
+                n = static_cast<std::size_t>(static_cast<double>(n) * std::min(std::max(scale, 2.0), 10.0));
+            }
+
+            std::vector<double> real, cpu, rate;
+            Report report;
+            for (std::size_t rep = 0; rep < repetitions; ++rep)
+            {
+                State state(n);
+                b.fn(state);
+                real.push_back(state.wall_seconds() * 1e9 / static_cast<double>(n));
+                cpu.push_back(state.cpu_seconds() * 1e9 / static_cast<double>(n));
+                rate.push_back(state.items_processed() > 0.0 ? state.items_processed() / state.wall_seconds() : 0.0);
+                report.counters = state.counters;
+            }
+            report.name = b.name;
+            report.iterations = n;
+            report.repetitions = repetitions;
+            report.real_ns = median(real);
+            report.cpu_ns = median(cpu);
+            report.real_min_ns = *std::min_element(real.begin(), real.end());
+            report.items_per_second = median(rate);
+            return report;
+        }
+
+        inline void write_json(FILE *out, const std::vector<Report> &reports)
+        {
+            char date[64];
+            std::time_t now = std::time(nullptr);
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+            std::fprintf(out, "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"num_cpus\": %u", date,
+                         std::thread::hardware_concurrency());
+            for (const auto &entry : context())
+            {
+                std::fprintf(out, ",\n    \"%s\": \"%s\"", json_escape(entry.first).c_str(),
+                             json_escape(entry.second).c_str());
+            }
+            std::fprintf(out, "\n  },\n  \"benchmarks\": [");
+            for (std::size_t i = 0; i < reports.size(); ++i)
+            {
+                const Report &r = reports[i];
+                std::fprintf(out,
+                             "%s\n    {\n      \"name\": \"%s\",\n      \"run_type\": \"iteration\",\n"
+                             "      \"repetitions\": %zu,\n      \"iterations\": %zu,\n"
+                             "      \"real_time\": %.6g,\n      \"cpu_time\": %.6g,\n      \"real_time_min\": %.6g,\n"
+                             "      \"time_unit\": \"ns\"",
+                             i ? "," : "", json_escape(r.name).c_str(), r.repetitions, r.iterations, r.real_ns,
+                             r.cpu_ns, r.real_min_ns);
+                if (r.items_per_second > 0.0)
+                {
+                    std::fprintf(out, ",\n      \"items_per_second\": %.6g", r.items_per_second);
+                }
+                for (const auto &c : r.counters)
+                {
+                    std::fprintf(out, ",\n      \"%s\": %.6g", json_escape(c.first).c_str(), c.second);
+                }
+                std::fprintf(out, "\n    }");
+            }
+            std::fprintf(out, "\n  ]\n}\n");
+        }
+
+        inline bool flag(const char *arg, const char *name, std::string &value)
+        {
+            const std::size_t len = std::strlen(name);
+            if (std::strncmp(arg, name, len) != 0 || arg[len] != '=')
+            {
+                return false;
+            }
+            value = arg + len + 1;
+            return true;
+        }
+    }
+
+    /**
+     * @brief Runs every registered benchmark whose name contains --benchmark_filter.
+     *
+     * Flags: --benchmark_filter=<substring>, --benchmark_min_time=<seconds>
+     * (default 0.2), --benchmark_repetitions=<n> (default 5),
+     * --benchmark_out=<file.json>, --benchmark_context=<key>=<value> (repeatable,
+     * e.g. the commit being measured), --benchmark_list_tests.
+     */
+    inline int run_main(int argc, char **argv)
+    {
+        std::string filter, out_path, value;
+        double min_time = 0.2;
+        std::size_t repetitions = 5;
+        bool list_only = false;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (detail::flag(argv[i], "--benchmark_filter", value))
+            {
+                filter = value;
+            }
+            else if (detail::flag(argv[i], "--benchmark_min_time", value))
+            {
+                min_time = std::atof(value.c_str());
+            }
+            else if (detail::flag(argv[i], "--benchmark_repetitions", value))
+            {
+                repetitions = static_cast<std::size_t>(std::max(std::atoi(value.c_str()), 1));
+            }
+            else if (detail::flag(argv[i], "--benchmark_out", value))
+            {
+                out_path = value;
+            }
+            else if (detail::flag(argv[i], "--benchmark_context", value) && value.find('=') != std::string::npos)
+            {
+                add_context(value.substr(0, value.find('=')), value.substr(value.find('=') + 1));
+            }
+            else if (std::strcmp(argv[i], "--benchmark_list_tests") == 0)
+            {
+                list_only = true;
+            }
+            else
+            {
+                std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+                return 2;
+            }
+        }
+
+        std::vector<detail::Report> reports;
+        if (!list_only)
+        {
+            std::printf("%-52s %14s %14s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+        }
+        for (const Benchmark &b : registry())
+        {
+            if (!filter.empty() && b.name.find(filter) == std::string::npos)
+            {
+                continue;
+            }
+            if (list_only)
+            {
+                std::printf("%s\n", b.name.c_str());
+                continue;
+            }
+            detail::Report r = detail::run(b, min_time, repetitions);
+            std::printf("%-52s %14.1f %14.1f %12zu", r.name.c_str(), r.real_ns, r.cpu_ns, r.iterations);
+            if (r.items_per_second > 0.0)
+            {
+                std::printf("  items/s=%.4g", r.items_per_second);
+            }
+            for (const auto &c : r.counters)
+            {
+                std::printf("  %s=%.4g", c.first.c_str(), c.second);
+            }
+            std::printf("\n");
+            std::fflush(stdout);
+            reports.push_back(r);
+        }
+
+        if (!out_path.empty())
+        {
+            FILE *out = std::fopen(out_path.c_str(), "w");
+            if (out == nullptr)
+            {
+                std::fprintf(stderr, "Cannot open %s for writing\n", out_path.c_str());
+                return 1;
+            }
+            detail::write_json(out, reports);
+            std::fclose(out);
+        }
+        return 0;
+    }
+}
+
+#endif // OPTIPRICER_BENCH_HPP
@@ -0,0 +1,525 @@
+/*
+ * Native microbenchmarks for the pricing core, without the Python bindings.
+ *
+ * Build from the repository root (the SIMD kernels dispatch at runtime, so no
+ * -march flag is needed):
+ *
+ *   c++ -std=c++17 -O3 -pthread -Wno-psabi -Iinclude benchmarks/cpp/bench_optipricer.cpp -o bench_optipricer
+ *   ./bench_optipricer --benchmark_out=current.json --benchmark_context=commit=$(git rev-parse --short HEAD)
+ *   python benchmarks/compare.py baseline.json current.json
+ *
+ * Scalar benchmarks run once per moneyness/maturity regime; batch benchmarks
+ * run single-threaded and on the full thread pool.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "optipricer/batch.hpp"
+#include "optipricer/chain.hpp"
+#include "optipricer/greeks.hpp"
+#include "optipricer/models.hpp"
+#include "optipricer/parallel.hpp"
+#include "optipricer/parity.hpp"
+#include "optipricer/portfolio.hpp"
+#include "optipricer/snapshot.hpp"
+#include "optipricer/stats.hpp"
+#include "optipricer/strategies.hpp"
+#include "optipricer/stream.hpp"
+#include "optipricer/var.hpp"
+
+using namespace optipricer;
+
+namespace
+{
+    struct Regime
+    {
+        const char *name;
+        double S;
+        double K;
+        double T;
+        double sigma;
+    };
+
+    // Deep OTM short-dated wings are where the IV solver needs the most iterations
+    const Regime REGIMES[] = {
+        {"atm_1w", 100.0, 100.0, 7.0 / 365.0, 0.20},
+        {"atm_1y", 100.0, 100.0, 1.0, 0.20},
+        {"itm_3m", 100.0, 80.0, 0.25, 0.25},
+        {"otm_3m", 100.0, 120.0, 0.25, 0.25},
+        {"deep_otm_1m", 100.0, 125.0, 30.0 / 365.0, 0.35},
+        {"deep_otm_put_1w", 100.0, 88.0, 7.0 / 365.0, 0.40},
+    };
+
+    const double RATE = 0.065;
+    const double DIVIDEND = 0.012;
+    const std::size_t BATCH = 1 << 16;
+
+    // OTM side of the regime: calls above the forward, puts below
+    bool otm_call(const Regime &g) { return g.K >= g.S; }
+
+    double otm_price(const Regime &g)
+    {
+        models::BlackScholesModel m(g.K, g.sigma, RATE, g.T, g.S, DIVIDEND);
+        return otm_call(g) ? m.call_price() : m.put_price();
+    }
+
+    // Quotes spread over every regime, so batch IV covers easy and hard solves alike
+    struct QuoteBatch
+    {
+        std::vector<double> price, S, K, T;
+        std::unique_ptr<bool[]> is_call;
+
+        explicit QuoteBatch(std::size_t n) : is_call(new bool[n])
+        {
+            const std::size_t regimes = sizeof(REGIMES) / sizeof(REGIMES[0]);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                Regime g = REGIMES[i % regimes];
+                g.K *= 1.0 + 0.02 * (static_cast<double>(i % 17) / 17.0 - 0.5);
+                price.push_back(otm_price(g));
+                S.push_back(g.S);
+                K.push_back(g.K);
+                T.push_back(g.T);
+                is_call[i] = otm_call(g);
+            }
+        }
+    };
+
+    void register_scalar()
+    {
+        for (const Regime &g : REGIMES)
+        {
+            const std::string suffix = std::string("/") + g.name;
+
+            bench::add("BlackScholesModel/call_price" + suffix, [g](bench::State &state) {
+                models::BlackScholesModel m(g.K, g.sigma, RATE, g.T, g.S, DIVIDEND);
+                for (auto _ : state)
+                {
+                    bench::do_not_optimize(m.call_price());
+                }
+            });
+
+            bench::add("BlackScholesModel/construct_and_price" + suffix, [g](bench::State &state) {
+                double S = g.S;
+                for (auto _ : state)
+                {
+                    bench::do_not_optimize(S);
+                    models::BlackScholesModel m(g.K, g.sigma, RATE, g.T, S, DIVIDEND);
+                    bench::do_not_optimize(m.put_price());
+                }
+            });
+
+            bench::add("GreeksCalculator/individual" + suffix, [g](bench::State &state) {
+                models::GreeksCalculator calc(models::BlackScholesModel(g.K, g.sigma, RATE, g.T, g.S, DIVIDEND));
+                for (auto _ : state)
+                {
+                    double sum = calc.call_delta() + calc.put_delta() + calc.gamma() + calc.vega() +
+                                 calc.call_theta() + calc.put_theta() + calc.call_rho() + calc.put_rho() +
+                                 calc.vanna() + calc.volga() + calc.call_charm() + calc.put_charm();
+                    bench::do_not_optimize(sum);
+                }
+            });
+
+            bench::add("GreeksCalculator/compute_all" + suffix, [g](bench::State &state) {
+                models::GreeksCalculator calc(models::BlackScholesModel(g.K, g.sigma, RATE, g.T, g.S, DIVIDEND));
+                for (auto _ : state)
+                {
+                    bench::do_not_optimize(calc.compute_all());
+                }
+            });
+
+            bench::add("calculate_implied_volatility" + suffix, [g](bench::State &state) {
+                const double price = otm_price(g);
+                const bool call = otm_call(g);
+                for (auto _ : state)
+                {
+                    bench::do_not_optimize(
+                        models::calculate_implied_volatility(price, g.K, RATE, g.T, g.S, DIVIDEND, call));
+                }
+                models::IVResult r = models::solve_implied_volatility(price, g.K, RATE, g.T, g.S, DIVIDEND, call);
+                state.counters["solver_iterations"] = r.iterations;
+                state.counters["abs_error"] = std::abs(r.volatility - g.sigma);
+            });
+        }
+    }
+
+    void register_batch(unsigned threads, const std::string &tag)
+    {
+        bench::add("price_batch/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            std::vector<double> K(BATCH), out(BATCH);
+            for (std::size_t i = 0; i < BATCH; ++i)
+            {
+                K[i] = 60.0 + 80.0 * static_cast<double>(i) / BATCH;
+            }
+            const double S = 100.0, T = 0.25, sigma = 0.2;
+            const bool call = true;
+            for (auto _ : state)
+            {
+                models::price_batch({&S, 0}, {K.data(), 1}, {&RATE, 0}, {&T, 0}, {&sigma, 0}, {&DIVIDEND, 0},
+                                    {&call, 0}, out.data(), BATCH);
+                bench::do_not_optimize(out[BATCH / 2]);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * BATCH));
+        });
+
+        bench::add("price_batch_f32/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            std::vector<float> K(BATCH), out(BATCH);
+            for (std::size_t i = 0; i < BATCH; ++i)
+            {
+                K[i] = static_cast<float>(60.0 + 80.0 * static_cast<double>(i) / BATCH);
+            }
+            const float S = 100.0f, r = static_cast<float>(RATE), T = 0.25f, sigma = 0.2f,
+                        q = static_cast<float>(DIVIDEND);
+            const bool call = true;
+            for (auto _ : state)
+            {
+                models::price_batch({&S, 0}, {K.data(), 1}, {&r, 0}, {&T, 0}, {&sigma, 0}, {&q, 0}, {&call, 0},
+                                    out.data(), BATCH);
+                bench::do_not_optimize(out[BATCH / 2]);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * BATCH));
+        });
+
+        // A chain as usually quoted: every call strike, then every put, no dividend
+        bench::add("price_batch_calls_then_puts_q0/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            std::vector<double> K(BATCH), out(BATCH);
+            std::unique_ptr<bool[]> call(new bool[BATCH]);
+            for (std::size_t i = 0; i < BATCH; ++i)
+            {
+                K[i] = 60.0 + 80.0 * static_cast<double>(i % (BATCH / 2)) / (BATCH / 2);
+                call[i] = i < BATCH / 2;
+            }
+            const double S = 100.0, T = 0.25, sigma = 0.2, q = 0.0;
+            for (auto _ : state)
+            {
+                models::price_batch({&S, 0}, {K.data(), 1}, {&RATE, 0}, {&T, 0}, {&sigma, 0}, {&q, 0},
+                                    {call.get(), 1}, out.data(), BATCH);
+                bench::do_not_optimize(out[BATCH / 2]);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * BATCH));
+        });
+
+        bench::add("compute_all_batch/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            std::vector<double> K(BATCH);
+            std::vector<models::AllGreeks> out(BATCH);
+            for (std::size_t i = 0; i < BATCH; ++i)
+            {
+                K[i] = 60.0 + 80.0 * static_cast<double>(i) / BATCH;
+            }
+            const double S = 100.0, T = 0.25, sigma = 0.2;
+            for (auto _ : state)
+            {
+                models::compute_all_batch({&S, 0}, {K.data(), 1}, {&RATE, 0}, {&T, 0}, {&sigma, 0}, {&DIVIDEND, 0},
+                                          out.data(), BATCH);
+                bench::do_not_optimize(out[BATCH / 2]);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * BATCH));
+        });
+
+        bench::add("implied_volatility_batch/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            QuoteBatch quotes(BATCH);
+            std::vector<double> sigma(BATCH);
+            std::vector<std::int8_t> status(BATCH);
+            for (auto _ : state)
+            {
+                models::implied_volatility_batch({quotes.price.data(), 1}, {quotes.S.data(), 1}, {quotes.K.data(), 1},
+                                                 {&RATE, 0}, {quotes.T.data(), 1}, {&DIVIDEND, 0},
+                                                 {quotes.is_call.get(), 1}, 1e-6, 100, sigma.data(), status.data(),
+                                                 BATCH);
+                bench::do_not_optimize(sigma[BATCH / 2]);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * BATCH));
+        });
+
+        // refine adds one double Newton step per root on top of the float solve
+        bench::add("implied_volatility_batch_f32_refined/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            QuoteBatch quotes(BATCH);
+            std::vector<float> price(quotes.price.begin(), quotes.price.end()), S(quotes.S.begin(), quotes.S.end()),
+                K(quotes.K.begin(), quotes.K.end()), T(quotes.T.begin(), quotes.T.end()), sigma(BATCH);
+            const float r = static_cast<float>(RATE), q = static_cast<float>(DIVIDEND);
+            std::vector<std::int8_t> status(BATCH);
+            for (auto _ : state)
+            {
+                models::implied_volatility_batch({price.data(), 1}, {S.data(), 1}, {K.data(), 1}, {&r, 0},
+                                                 {T.data(), 1}, {&q, 0}, {quotes.is_call.get(), 1}, 1e-6, 100, true,
+                                                 sigma.data(), status.data(), BATCH);
+                bench::do_not_optimize(sigma[BATCH / 2]);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * BATCH));
+        });
+
+        bench::add("OptionChain/build_201_strikes/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            std::vector<double> strikes, vols;
+            for (int i = 0; i <= 200; ++i)
+            {
+                strikes.push_back(20000.0 + 15.0 * i);
+                vols.push_back(0.14 + 0.00002 * (i - 100) * (i - 100));
+            }
+            for (auto _ : state)
+            {
+                chain::OptionChain c(21500.0, RATE, 15.0 / 365.0, strikes, vols, DIVIDEND);
+                bench::do_not_optimize(c.data()[c.size()]);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * strikes.size()));
+        });
+
+        bench::add("Portfolio/valuate_50k_legs/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            const std::size_t legs = 50000;
+            portfolio::Portfolio book(RATE);
+            for (int u = 0; u < 20; ++u)
+            {
+                book.add_underlying(100.0 + 50.0 * u, 0.005 * (u % 3));
+            }
+            const double expiries[] = {7.0 / 365.0, 30.0 / 365.0, 0.25, 0.5, 1.0};
+            for (std::size_t i = 0; i < legs; ++i)
+            {
+                const std::size_t u = i % 20;
+                const double S = book.get_underlying_price(u);
+                book.add_leg(u, S * (0.7 + 0.6 * static_cast<double>(i % 101) / 100.0), expiries[i % 5],
+                             0.15 + 0.002 * static_cast<double>(i % 50), (i % 3 == 0) ? -10.0 : 5.0, i % 2 == 0);
+            }
+            bench::do_not_optimize(book.valuate());
+            for (auto _ : state)
+            {
+                bench::do_not_optimize(book.valuate().total);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * legs));
+        });
+
+        // Risk's spot +/-10% x vol +/-5pt ladder; items are leg revaluations
+        bench::add("Portfolio/scenarios_21x11_5k_legs/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            const std::size_t legs = 5000;
+            portfolio::Portfolio book(RATE);
+            const std::size_t u = book.add_underlying(21500.0, DIVIDEND);
+            const double expiries[] = {7.0 / 365.0, 30.0 / 365.0, 0.25};
+            for (std::size_t i = 0; i < legs; ++i)
+            {
+                book.add_leg(u, 21500.0 * (0.8 + 0.4 * static_cast<double>(i % 101) / 100.0), expiries[i % 3],
+                             0.12 + 0.002 * static_cast<double>(i % 50), (i % 3 == 0) ? -50.0 : 25.0, i % 2 == 0);
+            }
+            std::vector<double> spot_shifts, vol_shifts;
+            for (int i = -10; i <= 10; ++i)
+            {
+                spot_shifts.push_back(0.01 * i);
+            }
+            for (int j = -5; j <= 5; ++j)
+            {
+                vol_shifts.push_back(0.01 * j);
+            }
+            for (auto _ : state)
+            {
+                bench::do_not_optimize(book.scenarios(spot_shifts.data(), spot_shifts.size(), vol_shifts.data(),
+                                                      vol_shifts.size())
+                                           .pnl.data());
+            }
+            state.set_items_processed(
+                static_cast<double>(state.iterations() * legs * spot_shifts.size() * vol_shifts.size()));
+        });
+
+        // 250 days of per-underlying shocks on a 10k-leg, 10-underlying book; items are leg revaluations
+        bench::add("Portfolio/value_at_risk_10k_legs_250_scenarios/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            const std::size_t legs = 10000, underlyings = 10, scenarios = 250;
+            portfolio::Portfolio book(RATE);
+            for (std::size_t u = 0; u < underlyings; ++u)
+            {
+                book.add_underlying(100.0 + 50.0 * static_cast<double>(u), DIVIDEND);
+            }
+            const double expiries[] = {7.0 / 365.0, 30.0 / 365.0, 0.25, 0.5};
+            for (std::size_t i = 0; i < legs; ++i)
+            {
+                const std::size_t u = i % underlyings;
+                const double S = book.get_underlying_price(u);
+                book.add_leg(u, S * (0.8 + 0.4 * static_cast<double>(i % 101) / 100.0), expiries[i % 4],
+                             0.15 + 0.002 * static_cast<double>(i % 50), (i % 3 == 0) ? -10.0 : 5.0, i % 2 == 0);
+            }
+            std::vector<double> spot_shocks(scenarios * underlyings), vol_shocks(scenarios * underlyings);
+            for (std::size_t k = 0; k < spot_shocks.size(); ++k)
+            {
+                // Deterministic pseudo-shocks within +/-3% spot and +/-2 vol points
+                spot_shocks[k] = 0.03 * std::sin(0.7 * static_cast<double>(k));
+                vol_shocks[k] = 0.02 * std::cos(1.3 * static_cast<double>(k));
+            }
+            for (auto _ : state)
+            {
+                bench::do_not_optimize(var::historical_var(book, spot_shocks.data(), vol_shocks.data(), scenarios,
+                                                           0.99, 1.0 / 365.0)
+                                           .expected_shortfall);
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * legs * scenarios));
+        });
+
+        // Every contract ticks once per batch, alternating the spot so each one is re-solved
+        bench::add("TickPipeline/push_and_process_2000/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            const std::size_t contracts = 2000;
+            const double T = 15.0 / 365.0;
+            stream::TickPipeline pipe(RATE, contracts);
+            std::vector<double> mid(contracts);
+            for (std::size_t i = 0; i < contracts; ++i)
+            {
+                const double K = 20000.0 + 3.0 * static_cast<double>(i);
+                const bool call = K >= 21500.0;
+                pipe.add_contract(K, T, call, DIVIDEND);
+                models::BlackScholesModel m(K, 0.14, RATE, T, 21500.0, DIVIDEND);
+                mid[i] = call ? m.call_price() : m.put_price();
+            }
+            double S = 21500.0;
+            for (auto _ : state)
+            {
+                S = S == 21500.0 ? 21501.0 : 21500.0;
+                for (std::size_t i = 0; i < contracts; ++i)
+                {
+                    pipe.push(i, mid[i] - 0.5, mid[i] + 0.5, S);
+                }
+                bench::do_not_optimize(pipe.process());
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * contracts));
+        });
+
+        // Ten minutes of 1-second snapshots, two expiries of 61 strikes, replayed from the page cache
+        bench::add("SnapshotReader/surface_series_600/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            const std::string path = "bench_optipricer.snap";
+            const std::size_t snapshots = 600, strikes = 61;
+            {
+                snapshot::SnapshotWriter writer(path);
+                std::vector<double> K(strikes), iv(strikes);
+                for (std::size_t i = 0; i < snapshots; ++i)
+                {
+                    for (std::size_t j = 0; j < strikes; ++j)
+                    {
+                        K[j] = 20000.0 + 50.0 * static_cast<double>(j);
+                        iv[j] = 0.14 + 1e-8 * (K[j] - 21500.0) * (K[j] - 21500.0) + 1e-5 * static_cast<double>(i);
+                    }
+                    const snapshot::ExpiryColumns expiries[] = {
+                        {7.0 / 365.0, K.data(), iv.data(), nullptr, nullptr, strikes},
+                        {35.0 / 365.0, K.data(), iv.data(), nullptr, nullptr, strikes},
+                    };
+                    writer.append(static_cast<double>(i), 21500.0, RATE, DIVIDEND, expiries, 2);
+                }
+            }
+            const snapshot::SnapshotReader reader(path);
+            const double qK[] = {21000.0, 21500.0, 22100.0};
+            const double qT[] = {30.0 / 365.0, 30.0 / 365.0, 30.0 / 365.0};
+            std::vector<double> out(snapshots * 3);
+            for (auto _ : state)
+            {
+                reader.surface_series(0, snapshots, qK, qT, 3, out.data());
+                bench::do_not_optimize(out.data());
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * snapshots));
+            std::remove(path.c_str());
+        });
+
+        // A NIFTY-sized tick: eight expiries of 121 strikes, each with a stale ITM call to reject
+        bench::add("parity/calibrate_8x121/" + tag, [threads](bench::State &state) {
+            parallel::set_num_threads(threads);
+            const std::size_t expiries = 8, strikes = 121;
+            std::vector<double> T, K, call, put;
+            for (std::size_t e = 0; e < expiries; ++e)
+            {
+                const double t = static_cast<double>(7 * (e + 1)) / 365.0;
+                const double q = 0.005 + 0.001 * static_cast<double>(e);
+                for (std::size_t j = 0; j < strikes; ++j)
+                {
+                    const double k = 18500.0 + 50.0 * static_cast<double>(j);
+                    models::BlackScholesModel m(k, 0.14, RATE, t, 21500.0, q);
+                    T.push_back(t);
+                    K.push_back(k);
+                    call.push_back(m.call_price() + (j == 10 ? 25.0 : 0.0));
+                    put.push_back(m.put_price());
+                }
+            }
+            for (auto _ : state)
+            {
+                auto fits = parity::calibrate(21500.0, RATE, {T.data(), 1}, {K.data(), 1}, {call.data(), 1},
+                                              {put.data(), 1}, {nullptr, 0}, T.size());
+                bench::do_not_optimize(fits.data());
+            }
+            state.set_items_processed(static_cast<double>(state.iterations() * T.size()));
+        });
+    }
+
+    strategies::OptionsStrategy make_strategy(std::size_t legs)
+    {
+        strategies::OptionsStrategy s(21500.0, 0.14, RATE, 15.0 / 365.0, "bench", DIVIDEND);
+        for (std::size_t i = 0; i < legs; ++i)
+        {
+            s.add_position(i % 2 ? strategies::OptionType::CALL : strategies::OptionType::PUT,
+                           i % 4 < 2 ? strategies::PositionType::LONG : strategies::PositionType::SHORT, 50.0,
+                           21000.0 + 100.0 * static_cast<double>(i));
+        }
+        return s;
+    }
+
+    void register_strategies()
+    {
+        for (std::size_t legs : {4, 32})
+        {
+            const std::string suffix = "/" + std::to_string(legs) + "_legs";
+
+            bench::add("OptionsStrategy/total_delta_cached" + suffix, [legs](bench::State &state) {
+                strategies::OptionsStrategy s = make_strategy(legs);
+                for (auto _ : state)
+                {
+                    bench::do_not_optimize(s.total_delta());
+                }
+            });
+
+            // Re-marking invalidates the leg cache, so every total is a full repricing
+            bench::add("OptionsStrategy/update_market_and_totals" + suffix, [legs](bench::State &state) {
+                strategies::OptionsStrategy s = make_strategy(legs);
+                double S = 21500.0;
+                for (auto _ : state)
+                {
+                    S = S == 21500.0 ? 21510.0 : 21500.0;
+                    s.update_market(S, 0.14, RATE, 15.0 / 365.0, DIVIDEND);
+                    double sum = s.total_value() + s.total_delta() + s.total_gamma() + s.total_vega() +
+                                 s.total_theta() + s.total_rho();
+                    bench::do_not_optimize(sum);
+                }
+            });
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const unsigned hardware = parallel::hardware_threads();
+    register_scalar();
+    register_batch(1, "threads:1");
+    if (hardware > 1)
+    {
+        register_batch(hardware, "threads:" + std::to_string(hardware));
+    }
+    register_strategies();
+
+#if defined(OPTIPRICER_SIMD)
+    bench::add_context("simd", "vector extensions");
+#else
+    bench::add_context("simd", "scalar");
+#endif
+#if defined(NDEBUG)
+    bench::add_context("assertions", "off");
+#else
+    bench::add_context("assertions", "on");
+#endif
+    bench::add_context("stats", stats::enabled() ? "on" : "off");
+    bench::add_context("thread_pool_threads", std::to_string(hardware));
+    return bench::run_main(argc, argv);
+}
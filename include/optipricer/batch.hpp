@@ -0,0 +1,241 @@
+#ifndef OPTIPRICER_BATCH_HPP
+#define OPTIPRICER_BATCH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "models.hpp"
+#include "greeks.hpp"
+#include "simd.hpp"
+#include "simd_float.hpp"
+#include "parallel.hpp"
+
+namespace optipricer
+{
+    namespace models
+    {
+        using utils::Column;
+
+        namespace detail
+        {
+            template <typename Real>
+            void validate_columns(Column<Real> S, Column<Real> K, Column<Real> r,
+                                  Column<Real> T, Column<Real> sigma, Column<Real> q,
+                                  std::size_t n)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (BlackScholesModel::inputs_valid(K[i], sigma[i], r[i], T[i], S[i], q[i]))
+                    {
+                        continue;
+                    }
+                    try
+                    {
+                        BlackScholesModel rejected(K[i], sigma[i], r[i], T[i], S[i], q[i]);
+                        (void)rejected;
+                    }
+                    catch (const std::invalid_argument &e)
+                    {
+                        throw std::invalid_argument("Invalid inputs at index " + std::to_string(i) + ": " + e.what());
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Checks every element of a batch with the BlackScholesModel rules.
+         *
+         * The fast predicate runs on the hot path; only a failing element is
+         * re-checked through the constructor so the error message matches the
+         * scalar API, prefixed with the element index.
+         */
+        inline void validate_batch(Column<double> S, Column<double> K, Column<double> r,
+                                   Column<double> T, Column<double> sigma, Column<double> q,
+                                   std::size_t n)
+        {
+            detail::validate_columns(S, K, r, T, sigma, q, n);
+        }
+
+        // Float batches are checked on their values widened to double
+        inline void validate_batch(Column<float> S, Column<float> K, Column<float> r,
+                                   Column<float> T, Column<float> sigma, Column<float> q,
+                                   std::size_t n)
+        {
+            detail::validate_columns(S, K, r, T, sigma, q, n);
+        }
+
+        /**
+         * @brief Splits an already validated batch across the thread pool.
+         *
+         * Chunks are a multiple of simd::LANES so only the final chunk takes
+         * the kernel's padded tail path.
+         */
+        inline void price_delta_blocks(Column<double> S, Column<double> K, Column<double> r,
+                                       Column<double> T, Column<double> sigma, Column<double> q,
+                                       Column<bool> is_call, double *price, double *delta, std::size_t n)
+        {
+            parallel::parallel_for(n, 1024 * simd::LANES, [&](std::size_t begin, std::size_t end) {
+                simd::bs_price_delta(S.from(begin), K.from(begin), r.from(begin), T.from(begin),
+                                     sigma.from(begin), q.from(begin), is_call.from(begin),
+                                     price + begin, delta ? delta + begin : nullptr, end - begin);
+            });
+        }
+
+        /**
+         * @brief Prices n European options in a single native pass.
+         *
+         * Inputs are validated up front, then priced by the vectorized kernel in
+         * simd.hpp.
+         */
+        inline void price_batch(Column<double> S, Column<double> K, Column<double> r,
+                                Column<double> T, Column<double> sigma, Column<double> q,
+                                Column<bool> is_call, double *out, std::size_t n)
+        {
+            OPTIPRICER_STATS_TIMER(stats::Timer::PRICE_BATCH);
+            validate_batch(S, K, r, T, sigma, q, n);
+            price_delta_blocks(S, K, r, T, sigma, q, is_call, out, nullptr, n);
+        }
+
+        /**
+         * @brief Prices n European options and their deltas in a single native pass.
+         */
+        inline void price_delta_batch(Column<double> S, Column<double> K, Column<double> r,
+                                      Column<double> T, Column<double> sigma, Column<double> q,
+                                      Column<bool> is_call, double *price, double *delta, std::size_t n)
+        {
+            OPTIPRICER_STATS_TIMER(stats::Timer::PRICE_BATCH);
+            validate_batch(S, K, r, T, sigma, q, n);
+            price_delta_blocks(S, K, r, T, sigma, q, is_call, price, delta, n);
+        }
+
+        namespace detail
+        {
+            template <bool ZeroDividend>
+            void compute_all_run(Column<double> S, Column<double> K, Column<double> r, Column<double> T,
+                                 Column<double> sigma, Column<double> q, AllGreeks *out,
+                                 std::size_t begin, std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    out[i] = compute_all_greeks<ZeroDividend>(S[i], K[i], r[i], T[i], sigma[i], q[i]);
+                }
+            }
+        }
+
+        /**
+         * @brief Fused prices and Greeks for n call/put pairs.
+         *
+         * Like the price kernel, every simd::SPECIALIZED_BLOCK options are checked
+         * once for q == 0 and run through the matching compute_all_greeks().
+         */
+        inline void compute_all_batch(Column<double> S, Column<double> K, Column<double> r,
+                                      Column<double> T, Column<double> sigma, Column<double> q,
+                                      AllGreeks *out, std::size_t n)
+        {
+            OPTIPRICER_STATS_TIMER(stats::Timer::GREEKS_BATCH);
+            validate_batch(S, K, r, T, sigma, q, n);
+            parallel::parallel_for(n, 2048, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i += simd::SPECIALIZED_BLOCK)
+                {
+                    const std::size_t stop = std::min(end, i + simd::SPECIALIZED_BLOCK);
+                    if (simd::block_zero(q, i, stop - i))
+                    {
+                        detail::compute_all_run<true>(S, K, r, T, sigma, q, out, i, stop);
+                    }
+                    else
+                    {
+                        detail::compute_all_run<false>(S, K, r, T, sigma, q, out, i, stop);
+                    }
+                }
+            });
+        }
+
+        /**
+         * @brief Implied volatilities for n quotes, solved across threads.
+         *
+         * Never throws on bad quotes: each element gets an IVStatus code and a
+         * NaN volatility unless it converged (NOT_CONVERGED keeps the last
+         * iterate).
+         */
+        inline void implied_volatility_batch(Column<double> market_price, Column<double> S, Column<double> K,
+                                             Column<double> r, Column<double> T, Column<double> q,
+                                             Column<bool> is_call, double tol, int max_iter,
+                                             double *sigma_out, std::int8_t *status_out, std::size_t n)
+        {
+            OPTIPRICER_STATS_TIMER(stats::Timer::IMPLIED_VOLATILITY_BATCH);
+            parallel::parallel_for(n, 512, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    IVResult result = solve_implied_volatility(market_price[i], K[i], r[i], T[i], S[i], q[i],
+                                                               is_call[i], tol, max_iter);
+                    sigma_out[i] = result.volatility;
+                    status_out[i] = static_cast<std::int8_t>(result.status);
+                }
+            });
+        }
+
+        /**
+         * @brief Float counterpart of price_delta_batch(); delta may be nullptr.
+         *
+         * Same validation as the double batch, priced by the 16-lane float
+         * kernel in simd_float.hpp.
+         */
+        inline void price_delta_batch(Column<float> S, Column<float> K, Column<float> r,
+                                      Column<float> T, Column<float> sigma, Column<float> q,
+                                      Column<bool> is_call, float *price, float *delta, std::size_t n)
+        {
+            OPTIPRICER_STATS_TIMER(stats::Timer::PRICE_BATCH);
+            validate_batch(S, K, r, T, sigma, q, n);
+            parallel::parallel_for(n, 1024 * simd::FLOAT_LANES, [&](std::size_t begin, std::size_t end) {
+                simd::bs_price_delta(S.from(begin), K.from(begin), r.from(begin), T.from(begin),
+                                     sigma.from(begin), q.from(begin), is_call.from(begin),
+                                     price + begin, delta ? delta + begin : nullptr, end - begin);
+            });
+        }
+
+        inline void price_batch(Column<float> S, Column<float> K, Column<float> r,
+                                Column<float> T, Column<float> sigma, Column<float> q,
+                                Column<bool> is_call, float *out, std::size_t n)
+        {
+            price_delta_batch(S, K, r, T, sigma, q, is_call, out, nullptr, n);
+        }
+
+        /**
+         * @brief Float counterpart of compute_all_batch().
+         */
+        inline void compute_all_batch(Column<float> S, Column<float> K, Column<float> r,
+                                      Column<float> T, Column<float> sigma, Column<float> q,
+                                      AllGreeks32 *out, std::size_t n)
+        {
+            OPTIPRICER_STATS_TIMER(stats::Timer::GREEKS_BATCH);
+            validate_batch(S, K, r, T, sigma, q, n);
+            parallel::parallel_for(n, 256 * simd::FLOAT_LANES, [&](std::size_t begin, std::size_t end) {
+                simd::all_greeks(S.from(begin), K.from(begin), r.from(begin), T.from(begin),
+                                 sigma.from(begin), q.from(begin), out + begin, end - begin);
+            });
+        }
+
+        /**
+         * @brief Float implied volatilities for n quotes, solved in float.
+         *
+         * Statuses follow the double batch. refine takes one final Newton
+         * step per converged quote in double (see simd_float.hpp).
+         */
+        inline void implied_volatility_batch(Column<float> market_price, Column<float> S, Column<float> K,
+                                             Column<float> r, Column<float> T, Column<float> q,
+                                             Column<bool> is_call, double tol, int max_iter, bool refine,
+                                             float *sigma_out, std::int8_t *status_out, std::size_t n)
+        {
+            OPTIPRICER_STATS_TIMER(stats::Timer::IMPLIED_VOLATILITY_BATCH);
+            parallel::parallel_for(n, 64 * simd::FLOAT_LANES, [&](std::size_t begin, std::size_t end) {
+                simd::implied_volatility(market_price.from(begin), S.from(begin), K.from(begin), r.from(begin),
+                                         T.from(begin), q.from(begin), is_call.from(begin), tol, max_iter, refine,
+                                         sigma_out + begin, status_out + begin, end - begin);
+            });
+        }
+    }
+}
+
+#endif // OPTIPRICER_BATCH_HPP
@@ -0,0 +1,176 @@
+#ifndef OPTIPRICER_CHAIN_HPP
+#define OPTIPRICER_CHAIN_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "batch.hpp"
+#include "parallel.hpp"
+
+namespace optipricer
+{
+    namespace chain
+    {
+        enum ChainColumn : std::size_t
+        {
+            STRIKE,
+            IV,
+            CALL_PRICE,
+            PUT_PRICE,
+            CALL_DELTA,
+            PUT_DELTA,
+            GAMMA,
+            VEGA,
+            CALL_THETA,
+            PUT_THETA,
+            CALL_RHO,
+            PUT_RHO,
+            VANNA,
+            VOLGA,
+            CALL_CHARM,
+            PUT_CHARM,
+            NUM_COLUMNS
+        };
+
+        constexpr const char *COLUMN_NAMES[NUM_COLUMNS] = {
+            "strike", "iv", "call_price", "put_price",
+            "call_delta", "put_delta", "gamma", "vega",
+            "call_theta", "put_theta", "call_rho", "put_rho",
+            "vanna", "volga", "call_charm", "put_charm"};
+
+        /**
+         * @brief Prices and Greeks for every strike of one expiry, stored by column.
+         *
+         * All columns live in one contiguous block of NUM_COLUMNS * size()
+         * doubles, column c starting at data() + c * size(), so callers can view
+         * them (or the whole block as a 2-D array) without copying. Strikes are
+         * kept sorted together with their volatilities. reprice() refreshes the
+         * block in place when the underlying moves.
+         */
+        class OptionChain
+        {
+        private:
+            double underlying_price;
+            double risk_free_rate;
+            double time_to_maturity;
+            double dividend_yield;
+            std::size_t n;
+            std::vector<double> values;
+
+            double *column_ptr(std::size_t c) { return values.data() + c * n; }
+
+            void build()
+            {
+                const double *K = column(STRIKE);
+                const double *sigma = column(IV);
+                models::validate_batch({&underlying_price, 0}, {K, 1}, {&risk_free_rate, 0},
+                                       {&time_to_maturity, 0}, {sigma, 1}, {&dividend_yield, 0}, n);
+
+                // One expiry: the discount factors and sqrt(T) are shared by every strike
+                const models::ExpiryContext expiry =
+                    models::ExpiryContext::unchecked(risk_free_rate, time_to_maturity, dividend_yield);
+                parallel::parallel_for(n, 4096, [this, K, sigma, &expiry](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        models::AllGreeks g = models::compute_all_greeks(underlying_price, K[i], sigma[i], expiry);
+                        column_ptr(CALL_PRICE)[i] = g.call_price;
+                        column_ptr(PUT_PRICE)[i] = g.put_price;
+                        column_ptr(CALL_DELTA)[i] = g.call_delta;
+                        column_ptr(PUT_DELTA)[i] = g.put_delta;
+                        column_ptr(GAMMA)[i] = g.gamma;
+                        column_ptr(VEGA)[i] = g.vega;
+                        column_ptr(CALL_THETA)[i] = g.call_theta;
+                        column_ptr(PUT_THETA)[i] = g.put_theta;
+                        column_ptr(CALL_RHO)[i] = g.call_rho;
+                        column_ptr(PUT_RHO)[i] = g.put_rho;
+                        column_ptr(VANNA)[i] = g.vanna;
+                        column_ptr(VOLGA)[i] = g.volga;
+                        column_ptr(CALL_CHARM)[i] = g.call_charm;
+                        column_ptr(PUT_CHARM)[i] = g.put_charm;
+                    }
+                });
+            }
+
+        public:
+            OptionChain(double S, double r, double T, const std::vector<double> &strikes,
+                        const std::vector<double> &volatilities, double q = 0.0)
+                : underlying_price(S), risk_free_rate(r), time_to_maturity(T),
+                  dividend_yield(q), n(strikes.size())
+            {
+                if (strikes.empty())
+                {
+                    throw std::invalid_argument("strikes list must not be empty.");
+                }
+                if (volatilities.size() != n)
+                {
+                    throw std::invalid_argument("volatilities must have one entry per strike, got " +
+                                                std::to_string(volatilities.size()) + " for " +
+                                                std::to_string(n) + " strikes");
+                }
+
+                std::vector<std::size_t> order(n);
+                std::iota(order.begin(), order.end(), std::size_t(0));
+                std::stable_sort(order.begin(), order.end(),
+                                 [&strikes](std::size_t a, std::size_t b) { return strikes[a] < strikes[b]; });
+
+                values.assign(NUM_COLUMNS * n, 0.0);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    column_ptr(STRIKE)[i] = strikes[order[i]];
+                    column_ptr(IV)[i] = volatilities[order[i]];
+                }
+                build();
+            }
+
+            /**
+             * @brief Reprices every strike at a new underlying price, in place
+             */
+            void reprice(double S)
+            {
+                double previous = underlying_price;
+                underlying_price = S;
+                try
+                {
+                    build();
+                }
+                catch (...)
+                {
+                    underlying_price = previous;
+                    throw;
+                }
+            }
+
+            std::size_t size() const { return n; }
+            const double *data() const { return values.data(); }
+            const double *column(std::size_t c) const { return values.data() + c * n; }
+
+            /**
+             * @brief Index of the strike closest to the underlying price (lowest on ties)
+             */
+            std::size_t atm_index() const
+            {
+                const double *K = column(STRIKE);
+                std::size_t best = 0;
+                for (std::size_t i = 1; i < n; ++i)
+                {
+                    if (std::abs(K[i] - underlying_price) < std::abs(K[best] - underlying_price))
+                    {
+                        best = i;
+                    }
+                }
+                return best;
+            }
+
+            double get_underlying_price() const { return underlying_price; }
+            double get_risk_free_rate() const { return risk_free_rate; }
+            double get_time_to_maturity() const { return time_to_maturity; }
+            double get_dividend_yield() const { return dividend_yield; }
+        };
+    }
+}
+
+#endif // OPTIPRICER_CHAIN_HPP
@@ -3,11 +3,165 @@
 #include "models.hpp"
 #include "utils.hpp"
 #include <cmath>
+#include <stdexcept>
 
 namespace optipricer
 {
     namespace models
     {
+        /**
+         * @brief Every price and Greek of one call/put pair, in the units of GreeksCalculator
+         *
+         * Plain-old-data so batches can be exposed as NumPy structured arrays.
+         */
+        struct AllGreeks
+        {
+            double call_price;
+            double put_price;
+            double call_delta;
+            double put_delta;
+            double gamma;
+            double vega;
+            double call_theta;
+            double put_theta;
+            double call_rho;
+            double put_rho;
+            double vanna;
+            double volga;
+            double call_charm;
+            double put_charm;
+        };
+
+        /**
+         * @brief Single-precision AllGreeks, the element type of float32 Greeks batches
+         */
+        struct AllGreeks32
+        {
+            float call_price;
+            float put_price;
+            float call_delta;
+            float put_delta;
+            float gamma;
+            float vega;
+            float call_theta;
+            float put_theta;
+            float call_rho;
+            float put_rho;
+            float vanna;
+            float volga;
+            float call_charm;
+            float put_charm;
+        };
+
+        /**
+         * @brief Fused evaluation of all prices and Greeks for already-validated inputs
+         *
+         * Takes sqrt(T) and the two discount factors from the expiry context, computes
+         * d1/d2, N(+/-d1), N(+/-d2) and N'(d1) exactly once and derives every output
+         * from them. Results match the individual BlackScholesModel / GreeksCalculator
+         * methods, edge cases included.
+         *
+         * ZeroDividend drops every q term and the dividend discount; callers must only
+         * select it when the context's q is exactly 0. The q terms are then +0.0 or
+         * -0.0; the +0.0 ones are kept as literals, so signed zeros and every other
+         * result stay bit-identical to the general form. (Built with -mfma, contraction
+         * can still differ between the two in the last bit.)
+         */
+        template <bool ZeroDividend = false>
+        AllGreeks compute_all_greeks(double S, double K, double sigma, const ExpiryContext &expiry)
+        {
+            const double r = expiry.get_risk_free_rate();
+            const double T = expiry.get_time_to_maturity();
+            const double q = ZeroDividend ? 0.0 : expiry.get_dividend_yield();
+            const double df_r = expiry.get_discount_factor();
+            const double df_q = ZeroDividend ? 1.0 : expiry.get_dividend_discount();
+            if (std::isinf(df_r) || std::isnan(df_r) || std::isinf(df_q) || std::isnan(df_q))
+            {
+                throw std::runtime_error("Discount factor calculation resulted in invalid value");
+            }
+            const double fwd_S = ZeroDividend ? S : S * df_q;
+            const double fwd_K = K * df_r;
+
+            AllGreeks g;
+            if (sigma < 1e-10 || T < 1e-10)
+            {
+                // Same limits as BlackScholesModel::d1() and the GreeksCalculator edge cases
+                const double D = fwd_S > fwd_K ? 1e15 : (fwd_S < fwd_K ? -1e15 : 0.0);
+                const double N = utils::norm_cdf(D);
+                const double N_neg = utils::norm_cdf(-D);
+                g.call_price = fwd_S * N - fwd_K * N;
+                g.put_price = fwd_K * N_neg - fwd_S * N_neg;
+                g.call_delta = df_q * N;
+                g.put_delta = df_q * (N - 1.0);
+                g.gamma = 0.0;
+                g.vega = 0.0;
+
+                double carry = 0.0 - r * fwd_K;
+                if constexpr (!ZeroDividend)
+                {
+                    carry = q * fwd_S - r * fwd_K;
+                }
+                g.call_theta = (fwd_S > fwd_K ? carry : (fwd_S < fwd_K ? 0.0 : 0.5 * carry)) / utils::DAYS_PER_YEAR;
+                g.put_theta = (fwd_S < fwd_K ? -carry : (fwd_S > fwd_K ? 0.0 : -0.5 * carry)) / utils::DAYS_PER_YEAR;
+                g.call_rho = K * T * df_r * N / utils::PERCENTAGE_DIVISOR;
+                g.put_rho = -K * T * df_r * N_neg / utils::PERCENTAGE_DIVISOR;
+                g.vanna = 0.0;
+                g.volga = 0.0;
+                g.call_charm = 0.0;
+                g.put_charm = 0.0;
+                return g;
+            }
+
+            const double sqrt_T = expiry.get_sqrt_time();
+            const double vol_sqrt_T = sigma * sqrt_T;
+            const double mu = ZeroDividend ? r : r - q;
+            const double D1 = (std::log(S / K) + (mu + 0.5 * sigma * sigma) * T) / vol_sqrt_T;
+            const double D2 = D1 - vol_sqrt_T;
+            const double N1 = utils::norm_cdf(D1);
+            const double N2 = utils::norm_cdf(D2);
+            const double N1_neg = utils::norm_cdf(-D1);
+            const double N2_neg = utils::norm_cdf(-D2);
+            const double pdf_d1 = utils::norm_pdf(D1);
+            const double raw_vega = fwd_S * pdf_d1 * sqrt_T;
+
+            g.call_price = fwd_S * N1 - fwd_K * N2;
+            g.put_price = fwd_K * N2_neg - fwd_S * N1_neg;
+            const double theta_decay = -(fwd_S * pdf_d1 * sigma) / (2.0 * sqrt_T);
+            const double charm_term = pdf_d1 * (2.0 * mu * T - D2 * vol_sqrt_T) / (2.0 * T * vol_sqrt_T);
+            if constexpr (ZeroDividend)
+            {
+                g.call_delta = N1;
+                g.put_delta = N1 - 1.0;
+                g.gamma = pdf_d1 / (S * vol_sqrt_T);
+                g.call_theta = (theta_decay + 0.0 - r * fwd_K * N2) / utils::DAYS_PER_YEAR;
+                g.put_theta = (theta_decay + r * fwd_K * N2_neg) / utils::DAYS_PER_YEAR;
+                g.vanna = -pdf_d1 * D2 / sigma;
+                g.call_charm = -charm_term / utils::DAYS_PER_YEAR;
+                g.put_charm = -(charm_term + 0.0) / utils::DAYS_PER_YEAR;
+            }
+            else
+            {
+                g.call_delta = df_q * N1;
+                g.put_delta = df_q * (N1 - 1.0);
+                g.gamma = df_q * pdf_d1 / (S * vol_sqrt_T);
+                g.call_theta = (theta_decay + q * fwd_S * N1 - r * fwd_K * N2) / utils::DAYS_PER_YEAR;
+                g.put_theta = (theta_decay - q * fwd_S * N1_neg + r * fwd_K * N2_neg) / utils::DAYS_PER_YEAR;
+                g.vanna = -df_q * pdf_d1 * D2 / sigma;
+                g.call_charm = -df_q * (charm_term - q * N1) / utils::DAYS_PER_YEAR;
+                g.put_charm = -df_q * (charm_term + q * N1_neg) / utils::DAYS_PER_YEAR;
+            }
+            g.vega = raw_vega / utils::PERCENTAGE_DIVISOR;
+            g.call_rho = K * T * df_r * N2 / utils::PERCENTAGE_DIVISOR;
+            g.put_rho = -K * T * df_r * N2_neg / utils::PERCENTAGE_DIVISOR;
+            g.volga = raw_vega * D1 * D2 / sigma;
+            return g;
+        }
+
+        template <bool ZeroDividend = false>
+        AllGreeks compute_all_greeks(double S, double K, double r, double T, double sigma, double q)
+        {
+            return compute_all_greeks<ZeroDividend>(S, K, sigma, ExpiryContext::unchecked(r, T, q));
+        }
 
         /**
          * @brief Calculator for option Greeks (sensitivity measures)
@@ -21,39 +175,52 @@ namespace optipricer
         private:
             BlackScholesModel model; // Stored by value to avoid dangling reference issues
 
+            bool zero_dividend() const { return model.get_dividend_yield() == 0.0; }
+
         public:
             explicit GreeksCalculator(const BlackScholesModel &bs_model)
                 : model(bs_model) {}
 
             const BlackScholesModel& get_model() const { return model; }
 
-            double call_delta() const
+            /**
+             * @brief Delta of the call (IsCall) or put, specialized at compile time.
+             *
+             * ZeroDividend drops the dividend discount; the call_ and put_ wrappers
+             * select it when q is exactly 0, where the result is bit-identical.
+             */
+            template <bool IsCall, bool ZeroDividend = false>
+            double delta() const
             {
-                double q = model.get_dividend_yield();
-                double T = model.get_time_to_maturity();
-                return std::exp(-q * T) * utils::norm_cdf(model.d1());
+                const double N1 = utils::norm_cdf(model.d1());
+                const double side = IsCall ? N1 : N1 - 1.0;
+                if constexpr (ZeroDividend)
+                {
+                    return side;
+                }
+                else
+                {
+                    return model.get_expiry().get_dividend_discount() * side;
+                }
             }
 
-            double put_delta() const
-            {
-                double q = model.get_dividend_yield();
-                double T = model.get_time_to_maturity();
-                return std::exp(-q * T) * (utils::norm_cdf(model.d1()) - 1.0);
-            }
+            double call_delta() const { return zero_dividend() ? delta<true, true>() : delta<true, false>(); }
+            double put_delta() const { return zero_dividend() ? delta<false, true>() : delta<false, false>(); }
 
             double gamma() const
             {
                 double S = model.get_underlying_price();
                 double sigma = model.get_volatility();
                 double T = model.get_time_to_maturity();
-                double q = model.get_dividend_yield();
+                double df_q = model.get_expiry().get_dividend_discount();
+                double sqrt_T = model.get_expiry().get_sqrt_time();
 
                 if (sigma < 1e-10 || T < 1e-10)
                 {
                     return 0.0;
                 }
 
-                return std::exp(-q * T) * utils::norm_pdf(model.d1()) / (S * sigma * std::sqrt(T));
+                return df_q * utils::norm_pdf(model.d1()) / (S * sigma * sqrt_T);
             }
 
             double vega() const
@@ -61,7 +228,8 @@ namespace optipricer
                 double S = model.get_underlying_price();
                 double sigma = model.get_volatility();
                 double T = model.get_time_to_maturity();
-                double q = model.get_dividend_yield();
+                double df_q = model.get_expiry().get_dividend_discount();
+                double sqrt_T = model.get_expiry().get_sqrt_time();
 
                 if (sigma < 1e-10 || T < 1e-10)
                 {
@@ -69,10 +237,14 @@ namespace optipricer
                 }
 
                 // Vega is divided by 100 to express per 1% change in volatility
-                return S * std::exp(-q * T) * utils::norm_pdf(model.d1()) * std::sqrt(T) / utils::PERCENTAGE_DIVISOR;
+                return S * df_q * utils::norm_pdf(model.d1()) * sqrt_T / utils::PERCENTAGE_DIVISOR;
             }
 
-            double call_theta() const
+            /**
+             * @brief Theta per day of the call (IsCall) or put, specialized at compile time.
+             */
+            template <bool IsCall, bool ZeroDividend = false>
+            double theta() const
             {
                 double S = model.get_underlying_price();
                 double K = model.get_strike_price();
@@ -80,90 +252,88 @@ namespace optipricer
                 double sigma = model.get_volatility();
                 double T = model.get_time_to_maturity();
                 double q = model.get_dividend_yield();
+                double df_r = model.get_expiry().get_discount_factor();
+                double df_q = model.get_expiry().get_dividend_discount();
+                double sqrt_T = model.get_expiry().get_sqrt_time();
+                double discounted_underlying = ZeroDividend ? S : S * df_q;
 
                 if (sigma < 1e-10 || T < 1e-10)
                 {
-                    double discounted_strike = K * std::exp(-r * T);
-                    double discounted_underlying = S * std::exp(-q * T);
-                    double term2 = 0.0;
-                    if (discounted_underlying > discounted_strike)
+                    // Only the in-the-money side earns its carry, each side half of it at the forward
+                    double discounted_strike = K * df_r;
+                    double carry;
+                    if constexpr (IsCall)
                     {
-                        term2 = q * S * std::exp(-q * T) - r * K * std::exp(-r * T);
+                        carry = ZeroDividend ? 0.0 - r * K * df_r : q * S * df_q - r * K * df_r;
                     }
-                    else if (discounted_underlying < discounted_strike)
+                    else
                     {
-                        term2 = 0.0;
+                        carry = ZeroDividend ? r * K * df_r : -q * S * df_q + r * K * df_r;
                     }
-                    else
+                    double term2 = 0.0;
+                    if (discounted_underlying == discounted_strike)
                     {
-                        term2 = 0.5 * (q * S * std::exp(-q * T) - r * K * std::exp(-r * T));
+                        term2 = 0.5 * carry;
+                    }
+                    else if (IsCall ? discounted_underlying > discounted_strike
+                                    : discounted_underlying < discounted_strike)
+                    {
+                        term2 = carry;
                     }
                     return term2 / utils::DAYS_PER_YEAR;
                 }
 
-                double term1 = -(S * std::exp(-q * T) * utils::norm_pdf(model.d1()) * sigma) / (2.0 * std::sqrt(T));
-                double term2 = q * S * std::exp(-q * T) * utils::norm_cdf(model.d1()) - r * K * std::exp(-r * T) * utils::norm_cdf(model.d2());
-
-                // Theta is divided by 365 to express per-day time decay
-                return (term1 + term2) / utils::DAYS_PER_YEAR;
-            }
-
-            double put_theta() const
-            {
-                double S = model.get_underlying_price();
-                double K = model.get_strike_price();
-                double r = model.get_risk_free_rate();
-                double sigma = model.get_volatility();
-                double T = model.get_time_to_maturity();
-                double q = model.get_dividend_yield();
-
-                if (sigma < 1e-10 || T < 1e-10)
+                double D1 = model.d1();
+                double term1 = -(discounted_underlying * utils::norm_pdf(D1) * sigma) / (2.0 * sqrt_T);
+                double term2;
+                if constexpr (IsCall)
                 {
-                    double discounted_strike = K * std::exp(-r * T);
-                    double discounted_underlying = S * std::exp(-q * T);
-                    double term2 = 0.0;
-                    if (discounted_underlying < discounted_strike)
+                    term2 = 0.0 - r * K * df_r * utils::norm_cdf(model.d2());
+                    if constexpr (!ZeroDividend)
                     {
-                        term2 = -q * S * std::exp(-q * T) + r * K * std::exp(-r * T);
+                        term2 = q * S * df_q * utils::norm_cdf(D1) - r * K * df_r * utils::norm_cdf(model.d2());
                     }
-                    else if (discounted_underlying > discounted_strike)
-                    {
-                        term2 = 0.0;
-                    }
-                    else
+                }
+                else
+                {
+                    term2 = r * K * df_r * utils::norm_cdf(-model.d2());
+                    if constexpr (!ZeroDividend)
                     {
-                        term2 = 0.5 * (-q * S * std::exp(-q * T) + r * K * std::exp(-r * T));
+                        term2 = -q * S * df_q * utils::norm_cdf(-D1) + r * K * df_r * utils::norm_cdf(-model.d2());
                     }
-                    return term2 / utils::DAYS_PER_YEAR;
                 }
 
-                double term1 = -(S * std::exp(-q * T) * utils::norm_pdf(model.d1()) * sigma) / (2.0 * std::sqrt(T));
-                double term2 = -q * S * std::exp(-q * T) * utils::norm_cdf(-model.d1()) + r * K * std::exp(-r * T) * utils::norm_cdf(-model.d2());
-
                 // Theta is divided by 365 to express per-day time decay
                 return (term1 + term2) / utils::DAYS_PER_YEAR;
             }
 
-            double call_rho() const
-            {
-                double K = model.get_strike_price();
-                double r = model.get_risk_free_rate();
-                double T = model.get_time_to_maturity();
-
-                // Rho is divided by 100 to express per 1% change in interest rate
-                return K * T * std::exp(-r * T) * utils::norm_cdf(model.d2()) / utils::PERCENTAGE_DIVISOR;
-            }
+            double call_theta() const { return zero_dividend() ? theta<true, true>() : theta<true, false>(); }
+            double put_theta() const { return zero_dividend() ? theta<false, true>() : theta<false, false>(); }
 
-            double put_rho() const
+            /**
+             * @brief Rho per 1% rate move of the call (IsCall) or put; q does not enter.
+             */
+            template <bool IsCall>
+            double rho() const
             {
                 double K = model.get_strike_price();
-                double r = model.get_risk_free_rate();
                 double T = model.get_time_to_maturity();
+                double df_r = model.get_expiry().get_discount_factor();
 
                 // Rho is divided by 100 to express per 1% change in interest rate
-                return -K * T * std::exp(-r * T) * utils::norm_cdf(-model.d2()) / utils::PERCENTAGE_DIVISOR;
+                if constexpr (IsCall)
+                {
+                    return K * T * df_r * utils::norm_cdf(model.d2()) / utils::PERCENTAGE_DIVISOR;
+                }
+                else
+                {
+                    return -K * T * df_r * utils::norm_cdf(-model.d2()) / utils::PERCENTAGE_DIVISOR;
+                }
             }
 
+            double call_rho() const { return rho<true>(); }
+            double put_rho() const { return rho<false>(); }
+
             /**
              * @brief Vanna: ∂²V/∂S∂σ (cross-gamma between spot and vol)
              * 
@@ -175,7 +345,7 @@ namespace optipricer
             {
                 double sigma = model.get_volatility();
                 double T = model.get_time_to_maturity();
-                double q = model.get_dividend_yield();
+                double df_q = model.get_expiry().get_dividend_discount();
 
                 if (sigma < 1e-10 || T < 1e-10)
                 {
@@ -184,7 +354,7 @@ namespace optipricer
 
                 double d1_val = model.d1();
                 double d2_val = model.d2();
-                return -std::exp(-q * T) * utils::norm_pdf(d1_val) * d2_val / sigma;
+                return -df_q * utils::norm_pdf(d1_val) * d2_val / sigma;
             }
 
             /**
@@ -199,7 +369,8 @@ namespace optipricer
                 double S = model.get_underlying_price();
                 double sigma = model.get_volatility();
                 double T = model.get_time_to_maturity();
-                double q = model.get_dividend_yield();
+                double df_q = model.get_expiry().get_dividend_discount();
+                double sqrt_T = model.get_expiry().get_sqrt_time();
 
                 if (sigma < 1e-10 || T < 1e-10)
                 {
@@ -209,7 +380,7 @@ namespace optipricer
                 double d1_val = model.d1();
                 double d2_val = model.d2();
                 // Raw vega (unscaled) = S * e^{-qT} * N'(d1) * sqrt(T)
-                double raw_vega = S * std::exp(-q * T) * utils::norm_pdf(d1_val) * std::sqrt(T);
+                double raw_vega = S * df_q * utils::norm_pdf(d1_val) * sqrt_T;
                 return raw_vega * d1_val * d2_val / sigma;
             }
 
@@ -220,13 +391,15 @@ namespace optipricer
              * daily delta hedging adjustments.
              * Call Charm = -e^{-qT} * [N'(d1) * (2(r-q)T - d2*σ*√T) / (2T*σ*√T) + q*N(d1)]
              */
-            double call_charm() const
+            template <bool IsCall, bool ZeroDividend = false>
+            double charm() const
             {
-                double S = model.get_underlying_price();
                 double sigma = model.get_volatility();
                 double T = model.get_time_to_maturity();
                 double r = model.get_risk_free_rate();
                 double q = model.get_dividend_yield();
+                double df_q = model.get_expiry().get_dividend_discount();
+                double sqrt_T = model.get_expiry().get_sqrt_time();
 
                 if (sigma < 1e-10 || T < 1e-10)
                 {
@@ -235,38 +408,35 @@ namespace optipricer
 
                 double d1_val = model.d1();
                 double d2_val = model.d2();
-                double sqrt_T = std::sqrt(T);
                 double pdf_d1 = utils::norm_pdf(d1_val);
 
-                double term1 = pdf_d1 * (2.0 * (r - q) * T - d2_val * sigma * sqrt_T) / (2.0 * T * sigma * sqrt_T);
-                double term2 = -q * utils::norm_cdf(d1_val);
+                double mu = ZeroDividend ? r : r - q;
+                double term1 = pdf_d1 * (2.0 * mu * T - d2_val * sigma * sqrt_T) / (2.0 * T * sigma * sqrt_T);
 
                 // Charm = -dDelta/dT, expressed per day (divide by 365)
-                return -std::exp(-q * T) * (term1 + term2) / utils::DAYS_PER_YEAR;
-            }
-
-            double put_charm() const
-            {
-                double S = model.get_underlying_price();
-                double sigma = model.get_volatility();
-                double T = model.get_time_to_maturity();
-                double r = model.get_risk_free_rate();
-                double q = model.get_dividend_yield();
-
-                if (sigma < 1e-10 || T < 1e-10)
+                if constexpr (ZeroDividend)
                 {
-                    return 0.0;
+                    // The call's q term is -0.0 and drops out; the put's is +0.0
+                    return -(IsCall ? term1 : term1 + 0.0) / utils::DAYS_PER_YEAR;
                 }
+                else
+                {
+                    double term2 = IsCall ? -q * utils::norm_cdf(d1_val) : q * utils::norm_cdf(-d1_val);
+                    return -df_q * (term1 + term2) / utils::DAYS_PER_YEAR;
+                }
+            }
 
-                double d1_val = model.d1();
-                double d2_val = model.d2();
-                double sqrt_T = std::sqrt(T);
-                double pdf_d1 = utils::norm_pdf(d1_val);
-
-                double term1 = pdf_d1 * (2.0 * (r - q) * T - d2_val * sigma * sqrt_T) / (2.0 * T * sigma * sqrt_T);
-                double term2 = q * utils::norm_cdf(-d1_val);
+            double call_charm() const { return zero_dividend() ? charm<true, true>() : charm<true, false>(); }
+            double put_charm() const { return zero_dividend() ? charm<false, true>() : charm<false, false>(); }
 
-                return -std::exp(-q * T) * (term1 + term2) / utils::DAYS_PER_YEAR;
+            /**
+             * @brief Both prices and every Greek in one pass, sharing all intermediates
+             */
+            AllGreeks compute_all() const
+            {
+                OPTIPRICER_STATS_TIMER(stats::Timer::GREEKS);
+                return compute_all_greeks(model.get_underlying_price(), model.get_strike_price(),
+                                          model.get_volatility(), model.get_expiry());
             }
         };
 
@@ -0,0 +1,520 @@
+#ifndef OPTIPRICER_HESTON_HPP
+#define OPTIPRICER_HESTON_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "greeks.hpp"
+#include "svi.hpp"
+#include "utils.hpp"
+
+namespace optipricer
+{
+    namespace heston
+    {
+        using utils::Column;
+
+        /**
+         * @brief Heston dynamics: dv = kappa (theta - v) dt + xi sqrt(v) dW_v, corr(dW_S, dW_v) = rho.
+         */
+        struct HestonParams
+        {
+            double v0;    // Initial variance
+            double kappa; // Mean reversion speed
+            double theta; // Long-run variance
+            double xi;    // Volatility of variance
+            double rho;   // Spot/variance correlation
+        };
+
+        // Per-unit price with spot delta and gamma
+        struct HestonResult
+        {
+            double price;
+            double delta;
+            double gamma;
+        };
+
+        /**
+         * @brief Calibrated parameters plus the fit quality in volatility terms
+         */
+        struct HestonFit
+        {
+            HestonParams params;
+            double expiry;
+            double rmse; // Vega-weighted RMS implied volatility error
+            int iterations;
+            int num_quotes;
+        };
+
+        namespace detail
+        {
+            // Truncation half-width L of the log-return density: L sqrt(c2 + sqrt(c4)), as in Fang & Oosterlee
+            constexpr double TRUNCATION_WIDTH = 12.0;
+
+            // Cosine terms per standard deviation of log(S_T / S) across the range, and their bounds
+            constexpr double TERMS_PER_SD = 8.0;
+            constexpr std::size_t MIN_TERMS = 64;
+            constexpr std::size_t MAX_TERMS = 8192;
+
+            inline bool same(const HestonParams &a, const HestonParams &b)
+            {
+                return a.v0 == b.v0 && a.kappa == b.kappa && a.theta == b.theta && a.xi == b.xi && a.rho == b.rho;
+            }
+
+            inline void check_params(const HestonParams &p)
+            {
+                if (!(p.v0 >= 0.0) || !std::isfinite(p.v0) || !(p.theta >= 0.0) || !std::isfinite(p.theta))
+                {
+                    throw std::invalid_argument("Heston variances v0 and theta must be finite and non-negative");
+                }
+                if (!(p.kappa > 0.0) || !std::isfinite(p.kappa) || !(p.xi > 0.0) || !std::isfinite(p.xi))
+                {
+                    throw std::invalid_argument("Heston kappa and xi must be positive and finite");
+                }
+                if (!(p.rho > -1.0 && p.rho < 1.0))
+                {
+                    throw std::invalid_argument("Heston rho must be in (-1, 1), got: " + std::to_string(p.rho));
+                }
+            }
+
+            /**
+             * @brief log E[exp(iu log(S_T / S))] in Albrecher et al.'s "little trap" form.
+             *
+             * This branch keeps the complex logarithm continuous in u, so long
+             * expiries need no rotation counting.
+             */
+            inline std::complex<double> log_cf(double u, const HestonParams &p, double r, double q, double T)
+            {
+                const std::complex<double> iu(0.0, u);
+                const double xi2 = p.xi * p.xi;
+                const std::complex<double> beta = p.kappa - p.rho * p.xi * iu;
+                const std::complex<double> d = std::sqrt(beta * beta + xi2 * (u * u + iu));
+                const std::complex<double> g = (beta - d) / (beta + d);
+                const std::complex<double> e = std::exp(-d * T);
+                const std::complex<double> C =
+                    (r - q) * iu * T +
+                    p.kappa * p.theta / xi2 * ((beta - d) * T - 2.0 * std::log((1.0 - g * e) / (1.0 - g)));
+                const std::complex<double> D = (beta - d) / xi2 * (1.0 - e) / (1.0 - g * e);
+                return C + D * p.v0;
+            }
+
+            /**
+             * @brief Cumulants c1, c2 and c4 of log(S_T / S).
+             *
+             * Read off the Taylor expansion of log_cf at u = h and 2h, with the
+             * next order eliminated.
+             */
+            inline void cumulants(const HestonParams &p, double r, double q, double T, double &c1, double &c2,
+                                  double &c4)
+            {
+                const double h = 0.02;
+                const std::complex<double> l1 = log_cf(h, p, r, q, T);
+                const std::complex<double> l2 = log_cf(2.0 * h, p, r, q, T);
+                c1 = (8.0 * l1.imag() - l2.imag()) / (6.0 * h);
+                c2 = std::max((l2.real() - 16.0 * l1.real()) / (6.0 * h * h), 1e-12);
+                c4 = std::max(2.0 * (l2.real() - 4.0 * l1.real()) / (h * h * h * h), 0.0);
+            }
+
+            // Re/Im of phi(u_k) V_k under one parameter set; never changed once published
+            struct CfTerms
+            {
+                HestonParams params;
+                std::vector<double> re;
+                std::vector<double> im;
+            };
+
+            // Last published CfTerms of an expiry; copies (and moves) start empty
+            class CfCache
+            {
+            private:
+                mutable std::mutex mutex;
+                std::shared_ptr<const CfTerms> last;
+
+            public:
+                CfCache() = default;
+                CfCache(const CfCache &) {}
+                CfCache &operator=(const CfCache &) { return *this; }
+
+                std::shared_ptr<const CfTerms> get() const
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    return last;
+                }
+
+                void put(std::shared_ptr<const CfTerms> terms)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    last = std::move(terms);
+                }
+            };
+        }
+
+        /**
+         * @brief COS-method (Fang & Oosterlee 2008) pricer for every strike of one expiry.
+         *
+         * The truncation range, the cosine frequencies, the put payoff
+         * coefficients and the strike-dependent cosine/sine basis are fixed
+         * at construction, so pricing the chain under a parameter set is one
+         * pass over the characteristic function plus a dot product per strike.
+         * The characteristic-function terms of the last parameter set are
+         * kept, so repeated calls under the same parameters (as a calibrator
+         * makes) skip them. The range comes from the cumulants under
+         * `reference`; keep it close to the parameters being priced. Calls
+         * come from put-call parity.
+         *
+         * The const methods may be called from several threads at once. Each
+         * call prices from an immutable block of terms. It takes the cached
+         * block when the parameters match, and otherwise builds its own and
+         * publishes it for later calls. Concurrent callers with different
+         * parameters therefore never share a buffer, and the one that
+         * publishes last owns the cache.
+         */
+        class HestonExpiry
+        {
+        private:
+            double underlying_price;
+            double risk_free_rate;
+            double dividend_yield;
+            double time_to_maturity;
+            std::vector<double> strikes;
+            double a;
+            double b;
+            std::size_t terms;
+            std::vector<double> frequency; // u_k = k pi / (b - a)
+            std::vector<double> payoff;    // Put coefficients V_k, first term halved
+            std::vector<double> basis_cos; // cos(u_k (x_j - a)), x_j = log(S / K_j), at [j * terms + k]
+            std::vector<double> basis_sin;
+
+            mutable detail::CfCache cf_cache;
+
+            std::shared_ptr<const detail::CfTerms> cf_terms(const HestonParams &params) const
+            {
+                std::shared_ptr<const detail::CfTerms> cached = cf_cache.get();
+                if (cached && detail::same(params, cached->params))
+                {
+                    return cached;
+                }
+                detail::check_params(params);
+                std::shared_ptr<detail::CfTerms> fresh = std::make_shared<detail::CfTerms>();
+                fresh->params = params;
+                fresh->re.resize(terms);
+                fresh->im.resize(terms);
+                for (std::size_t k = 0; k < terms; ++k)
+                {
+                    const std::complex<double> phi =
+                        std::exp(detail::log_cf(frequency[k], params, risk_free_rate, dividend_yield, time_to_maturity));
+                    fresh->re[k] = phi.real() * payoff[k];
+                    fresh->im[k] = phi.imag() * payoff[k];
+                }
+                cf_cache.put(fresh);
+                return fresh;
+            }
+
+        public:
+            /**
+             * @param terms Cosine terms; 0 picks them from the width of the range
+             */
+            HestonExpiry(double S, double r, double q, double T, const double *K, std::size_t n,
+                         const HestonParams &reference, std::size_t terms = 0)
+                : underlying_price(S), risk_free_rate(r), dividend_yield(q), time_to_maturity(T), strikes(K, K + n)
+            {
+                // Same rules (and messages) as the closed-form model, with a placeholder volatility
+                models::BlackScholesModel checked(S, 0.2, r, T, S, q);
+                (void)checked;
+                detail::check_params(reference);
+                if (n == 0)
+                {
+                    throw std::invalid_argument("HestonExpiry needs at least one strike");
+                }
+                double x_min = std::numeric_limits<double>::infinity();
+                double x_max = -x_min;
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    if (!(K[j] > 0.0) || !std::isfinite(K[j]))
+                    {
+                        throw std::invalid_argument("Invalid strike at index " + std::to_string(j) +
+                                                    ": must be positive and finite");
+                    }
+                    const double x = std::log(S / K[j]);
+                    x_min = std::min(x_min, x);
+                    x_max = std::max(x_max, x);
+                }
+                if (terms != 0 && (terms < 16 || terms > detail::MAX_TERMS))
+                {
+                    throw std::invalid_argument("Number of COS terms must be 0 (automatic) or in [16, " +
+                                                std::to_string(detail::MAX_TERMS) + "], got: " + std::to_string(terms));
+                }
+
+                // log(S_T / K) = x + log(S_T / S): one range covering the density for every strike
+                double c1, c2, c4;
+                detail::cumulants(reference, r, q, T, c1, c2, c4);
+                const double sd = std::sqrt(c2);
+                const double half_width = detail::TRUNCATION_WIDTH * std::sqrt(c2 + std::sqrt(c4));
+                a = std::min(x_min + c1 - half_width, -1e-8);
+                b = std::max(x_max + c1 + half_width, 1e-8);
+                if (terms == 0)
+                {
+                    const double wanted = std::ceil(detail::TERMS_PER_SD * (b - a) / sd);
+                    terms = std::min(std::max(static_cast<std::size_t>(wanted), detail::MIN_TERMS), detail::MAX_TERMS);
+                }
+                this->terms = terms;
+
+                const double width = b - a;
+                frequency.resize(terms);
+                payoff.resize(terms);
+                for (std::size_t k = 0; k < terms; ++k)
+                {
+                    const double u = static_cast<double>(k) * utils::PI / width;
+                    frequency[k] = u;
+                    // chi and psi over [a, 0] for the put payoff K (1 - e^y)^+
+                    const double cos_b = std::cos(-u * a);
+                    const double sin_b = std::sin(-u * a);
+                    const double chi = (cos_b - std::exp(a) + u * sin_b) / (1.0 + u * u);
+                    const double psi = k == 0 ? -a : sin_b / u;
+                    payoff[k] = 2.0 / width * (psi - chi) * (k == 0 ? 0.5 : 1.0);
+                }
+                basis_cos.resize(n * terms);
+                basis_sin.resize(n * terms);
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    const double shift = std::log(S / K[j]) - a;
+                    for (std::size_t k = 0; k < terms; ++k)
+                    {
+                        basis_cos[j * terms + k] = std::cos(frequency[k] * shift);
+                        basis_sin[j * terms + k] = std::sin(frequency[k] * shift);
+                    }
+                }
+            }
+
+            /**
+             * @brief Prices and spot Greeks of every strike under `params`.
+             *
+             * out[j] is for the j-th strike given at construction.
+             */
+            void price_chain(const HestonParams &params, Column<bool> is_call, HestonResult *out) const
+            {
+                const std::shared_ptr<const detail::CfTerms> cf = cf_terms(params);
+                const double *cf_re = cf->re.data();
+                const double *cf_im = cf->im.data();
+                const double S = underlying_price;
+                const double df_r = std::exp(-risk_free_rate * time_to_maturity);
+                const double df_q = std::exp(-dividend_yield * time_to_maturity);
+                for (std::size_t j = 0; j < strikes.size(); ++j)
+                {
+                    const double *c = &basis_cos[j * terms];
+                    const double *s = &basis_sin[j * terms];
+                    // Re[phi V e^{iu(x - a)}] and its first two x-derivatives
+                    double v = 0.0, v_x = 0.0, v_xx = 0.0;
+                    for (std::size_t k = 0; k < terms; ++k)
+                    {
+                        const double re = cf_re[k] * c[k] - cf_im[k] * s[k];
+                        const double im = cf_re[k] * s[k] + cf_im[k] * c[k];
+                        const double u = frequency[k];
+                        v += re;
+                        v_x -= u * im;
+                        v_xx -= u * u * re;
+                    }
+                    const double scale = strikes[j] * df_r;
+                    const double put = scale * v;
+                    const double put_delta = scale * v_x / S;
+                    HestonResult &res = out[j];
+                    res.gamma = scale * (v_xx - v_x) / (S * S);
+                    if (is_call[j])
+                    {
+                        res.price = put + S * df_q - strikes[j] * df_r;
+                        res.delta = put_delta + df_q;
+                    }
+                    else
+                    {
+                        res.price = put;
+                        res.delta = put_delta;
+                    }
+                }
+            }
+
+            // Prices only, for calibration
+            void prices(const HestonParams &params, Column<bool> is_call, double *out) const
+            {
+                const std::shared_ptr<const detail::CfTerms> cf = cf_terms(params);
+                const double *cf_re = cf->re.data();
+                const double *cf_im = cf->im.data();
+                const double S = underlying_price;
+                const double df_r = std::exp(-risk_free_rate * time_to_maturity);
+                const double df_q = std::exp(-dividend_yield * time_to_maturity);
+                for (std::size_t j = 0; j < strikes.size(); ++j)
+                {
+                    const double *c = &basis_cos[j * terms];
+                    const double *s = &basis_sin[j * terms];
+                    double v = 0.0;
+                    for (std::size_t k = 0; k < terms; ++k)
+                    {
+                        v += cf_re[k] * c[k] - cf_im[k] * s[k];
+                    }
+                    const double put = strikes[j] * df_r * v;
+                    out[j] = is_call[j] ? put + S * df_q - strikes[j] * df_r : put;
+                }
+            }
+
+            std::size_t size() const { return strikes.size(); }
+            std::size_t num_terms() const { return terms; }
+            double range_lower() const { return a; }
+            double range_upper() const { return b; }
+            const std::vector<double> &get_strikes() const { return strikes; }
+            double get_underlying_price() const { return underlying_price; }
+            double get_risk_free_rate() const { return risk_free_rate; }
+            double get_dividend_yield() const { return dividend_yield; }
+            double get_time_to_maturity() const { return time_to_maturity; }
+        };
+
+        namespace detail
+        {
+            constexpr double MAX_RHO = 0.999;
+
+            inline void project(std::array<double, 5> &p)
+            {
+                p[0] = std::min(std::max(p[0], 1e-6), 4.0);
+                p[1] = std::min(std::max(p[1], 1e-3), 50.0);
+                p[2] = std::min(std::max(p[2], 1e-6), 4.0);
+                p[3] = std::min(std::max(p[3], 1e-2), 5.0);
+                p[4] = std::min(std::max(p[4], -MAX_RHO), MAX_RHO);
+            }
+
+            inline HestonParams to_params(const std::array<double, 5> &p) { return {p[0], p[1], p[2], p[3], p[4]}; }
+        }
+
+        /**
+         * @brief Fits Heston to one expiry's implied volatilities.
+         *
+         * Each quote is priced out of the money (puts below the forward,
+         * calls above) and its price error is divided by its Black-Scholes
+         * vega, so the least-squares objective is close to implied volatility
+         * error without inverting model prices. The fit is the same projected
+         * Levenberg-Marquardt as the SVI calibration, with a central-difference
+         * Jacobian; one HestonExpiry carries the COS basis through every
+         * iteration. `initial` (null for a start at the ATM variance) also
+         * sets the truncation range; NaN volatilities are skipped and weight
+         * may be null. The Feller condition is not imposed.
+         */
+        inline HestonFit calibrate(double S, double r, double q, double T, const double *K, const double *iv,
+                                   const double *weight, std::size_t n, const HestonParams *initial = nullptr,
+                                   int max_iter = 100)
+        {
+            const double forward = S * std::exp((r - q) * T);
+            const models::ExpiryContext discounting = models::ExpiryContext::unchecked(r, T, q);
+            std::vector<double> strikes, market, inv_vega, root;
+            std::unique_ptr<bool[]> calls(new bool[n > 0 ? n : 1]);
+            double atm_var = 0.0, atm_dist = std::numeric_limits<double>::infinity();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (std::isnan(iv[i]))
+                {
+                    continue;
+                }
+                if (!(K[i] > 0.0) || !std::isfinite(K[i]) || !(iv[i] > 0.0) || !std::isfinite(iv[i]))
+                {
+                    throw std::invalid_argument("Invalid quote at index " + std::to_string(i) +
+                                                ": strike and iv must be positive and finite");
+                }
+                const bool call = K[i] >= forward;
+                const models::AllGreeks g = models::compute_all_greeks(S, K[i], iv[i], discounting);
+                calls[strikes.size()] = call;
+                strikes.push_back(K[i]);
+                market.push_back(call ? g.call_price : g.put_price);
+                // vega is per 1%; the residual is in volatility units
+                inv_vega.push_back(1.0 / std::max(g.vega * utils::PERCENTAGE_DIVISOR, 1e-8 * S));
+                root.push_back(weight ? std::sqrt(weight[i]) : 1.0);
+                const double dist = std::abs(std::log(K[i] / forward));
+                if (dist < atm_dist)
+                {
+                    atm_dist = dist;
+                    atm_var = iv[i] * iv[i];
+                }
+            }
+            const std::size_t m = strikes.size();
+            if (m < 5)
+            {
+                throw std::invalid_argument("Heston calibration needs at least 5 quotes, got " + std::to_string(m) +
+                                            " at T=" + std::to_string(T));
+            }
+
+            std::array<double, 5> p = initial ? std::array<double, 5>{initial->v0, initial->kappa, initial->theta,
+                                                                      initial->xi, initial->rho}
+                                              : std::array<double, 5>{atm_var, 2.0, atm_var, 0.5, -0.5};
+            detail::project(p);
+            const HestonExpiry expiry(S, r, q, T, strikes.data(), m, detail::to_params(p));
+            const Column<bool> is_call = {calls.get(), 1};
+
+            // Model residuals of the last point, and the Jacobian of the last point it was asked for
+            std::array<double, 5> at_value = {}, at_jacobian = {};
+            bool have_value = false, have_jacobian = false;
+            std::vector<double> model(m), value(m), jacobian(m * 5), up(m), down(m);
+            auto evaluate = [&](const std::array<double, 5> &x) {
+                if (have_value && x == at_value)
+                {
+                    return;
+                }
+                expiry.prices(detail::to_params(x), is_call, model.data());
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    value[i] = root[i] * (model[i] - market[i]) * inv_vega[i];
+                }
+                at_value = x;
+                have_value = true;
+            };
+            auto differentiate = [&](const std::array<double, 5> &x) {
+                if (have_jacobian && x == at_jacobian)
+                {
+                    return;
+                }
+                for (std::size_t a = 0; a < 5; ++a)
+                {
+                    const double h = 1e-5 * std::max(std::abs(x[a]), 1e-2);
+                    std::array<double, 5> lo = x, hi = x;
+                    hi[a] += h;
+                    lo[a] -= h;
+                    expiry.prices(detail::to_params(hi), is_call, up.data());
+                    expiry.prices(detail::to_params(lo), is_call, down.data());
+                    for (std::size_t i = 0; i < m; ++i)
+                    {
+                        jacobian[i * 5 + a] = root[i] * (up[i] - down[i]) / (2.0 * h) * inv_vega[i];
+                    }
+                }
+                at_jacobian = x;
+                have_jacobian = true;
+            };
+            auto residual = [&](const std::array<double, 5> &x, std::size_t i, double *J) {
+                if (J)
+                {
+                    differentiate(x);
+                    std::copy(&jacobian[i * 5], &jacobian[i * 5] + 5, J);
+                }
+                evaluate(x);
+                return value[i];
+            };
+
+            double cost;
+            HestonFit fit;
+            fit.iterations = svi::detail::levenberg_marquardt<5>(p, m, residual, detail::project, max_iter, cost);
+            fit.params = detail::to_params(p);
+            fit.expiry = T;
+            double total = 0.0;
+            for (double w : root)
+            {
+                total += w * w;
+            }
+            fit.rmse = std::sqrt(cost / total);
+            fit.num_quotes = static_cast<int>(m);
+            return fit;
+        }
+    }
+}
+
+#endif // OPTIPRICER_HESTON_HPP
@@ -0,0 +1,366 @@
+#ifndef OPTIPRICER_LATTICE_HPP
+#define OPTIPRICER_LATTICE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "batch.hpp"
+#include "models.hpp"
+#include "parallel.hpp"
+#include "utils.hpp"
+
+namespace optipricer
+{
+    namespace lattice
+    {
+        using utils::Column;
+
+        enum class LatticeMethod
+        {
+            CRR,           // Cox-Ross-Rubinstein binomial tree
+            LEISEN_REIMER, // Binomial tree centred on the strike; steps are rounded up to odd
+            TRINOMIAL      // Log-space trinomial tree (dx = sigma sqrt(3 dt))
+        };
+
+        /**
+         * @brief Price and the Greeks read off the lattice nodes at t = 0.
+         *
+         * theta is per calendar day, like the closed-form Greeks.
+         */
+        struct LatticeResult
+        {
+            double price;
+            double delta;
+            double gamma;
+            double theta;
+        };
+
+        struct LatticeSettings
+        {
+            LatticeMethod method = LatticeMethod::LEISEN_REIMER;
+            std::size_t steps = 201;
+            bool american = true;
+            bool richardson = true; // Extrapolate from steps and ~steps / 2
+        };
+
+        namespace detail
+        {
+            // Peizer-Pratt method 2 inversion of the normal CDF for an n-step tree
+            inline double peizer_pratt(double z, double n)
+            {
+                double t = z / (n + 1.0 / 3.0 + 0.1 / (n + 1.0));
+                double h = 0.5 * std::sqrt(1.0 - std::exp(-t * t * (n + 1.0 / 6.0)));
+                return z >= 0.0 ? 0.5 + h : 0.5 - h;
+            }
+
+            inline double intrinsic(bool is_call, double S, double K)
+            {
+                return is_call ? std::max(S - K, 0.0) : std::max(K - S, 0.0);
+            }
+
+            // European value over the last step, which removes the payoff kink from the tree (Broadie-Detemple)
+            inline double smoothed(bool is_call, double S, double K, double r, double dt, double sigma, double q)
+            {
+                models::BlackScholesModel m = models::BlackScholesModel::unchecked(K, sigma, r, dt, S, q);
+                return is_call ? m.call_price() : m.put_price();
+            }
+
+            // Node spots carry rounding from the repeated products, hence the tolerance
+            inline bool exercised(double value, bool is_call, double S, double K)
+            {
+                return value <= intrinsic(is_call, S, K) + 1e-12 * K;
+            }
+
+            /**
+             * @brief Price and Greeks from the three time-0 nodes of an extended tree.
+             *
+             * `f` and `s` hold the down, middle (= spot) and up node values and
+             * spots. theta follows from the pricing PDE, or is zero where the
+             * American holder exercises immediately.
+             */
+            inline LatticeResult from_nodes(const double (&f)[3], const double (&s)[3], double r, double q, double sigma,
+                                            bool exercised)
+            {
+                LatticeResult out;
+                out.price = f[1];
+                double up = (f[2] - f[1]) / (s[2] - s[1]);
+                double down = (f[1] - f[0]) / (s[1] - s[0]);
+                out.gamma = (up - down) / (0.5 * (s[2] - s[0]));
+                // Slope at the middle node of the parabola through the three nodes
+                out.delta = down + 0.5 * out.gamma * (s[1] - s[0]);
+                const double S = s[1];
+                out.theta = exercised ? 0.0
+                                      : (r * out.price - (r - q) * S * out.delta - 0.5 * sigma * sigma * S * S * out.gamma) /
+                                            utils::DAYS_PER_YEAR;
+                return out;
+            }
+
+            /**
+             * @brief Binomial backward induction over one rolling buffer.
+             *
+             * The tree is started two steps before t = 0 (Pelsser-Vorst), so
+             * that the level reached last holds three nodes at t = 0 centred on
+             * the spot and the Greeks need no time offset.
+             */
+            inline LatticeResult binomial(double S, double K, double r, double T, double sigma, double q, bool is_call,
+                                          bool american, std::size_t steps, LatticeMethod method, bool smooth,
+                                          std::vector<double> &v)
+            {
+                const double n = static_cast<double>(steps);
+                const double dt = T / n;
+                const double growth = std::exp((r - q) * dt);
+                const double disc = std::exp(-r * dt);
+                double u, d, p;
+                if (method == LatticeMethod::CRR)
+                {
+                    u = std::exp(sigma * std::sqrt(dt));
+                    d = 1.0 / u;
+                    p = (growth - d) / (u - d);
+                }
+                else
+                {
+                    models::BlackScholesModel bs = models::BlackScholesModel::unchecked(K, sigma, r, T, S, q);
+                    p = peizer_pratt(bs.d2(), n);
+                    double p_star = peizer_pratt(bs.d1(), n);
+                    u = growth * p_star / p;
+                    d = (growth - p * u) / (1.0 - p);
+                }
+                if (!(p > 0.0 && p < 1.0))
+                {
+                    throw std::invalid_argument("Lattice probabilities fall outside (0, 1); increase the number of steps");
+                }
+                const double pu = disc * p;
+                const double pd = disc * (1.0 - p);
+                const double ratio = u / d;
+                // Level j sits at t = (j - 2) dt; node i of it at root * d^(j - i) * u^i
+                const double root = S / (u * d);
+
+                // Values at the last level the induction starts from
+                std::size_t top = smooth ? steps + 1 : steps + 2;
+                v.resize(top + 1);
+                double s = root * std::pow(d, static_cast<double>(top));
+                for (std::size_t i = 0; i <= top; ++i, s *= ratio)
+                {
+                    double value = smooth ? smoothed(is_call, s, K, r, dt, sigma, q) : intrinsic(is_call, s, K);
+                    v[i] = american ? std::max(value, intrinsic(is_call, s, K)) : value;
+                }
+                for (std::size_t j = top; j-- > 2;)
+                {
+                    for (std::size_t i = 0; i <= j; ++i)
+                    {
+                        v[i] = pd * v[i] + pu * v[i + 1];
+                    }
+                    if (american)
+                    {
+                        s = root * std::pow(d, static_cast<double>(j));
+                        for (std::size_t i = 0; i <= j; ++i, s *= ratio)
+                        {
+                            v[i] = std::max(v[i], intrinsic(is_call, s, K));
+                        }
+                    }
+                }
+                const double f[3] = {v[0], v[1], v[2]};
+                const double spots[3] = {S / ratio, S, S * ratio};
+                return from_nodes(f, spots, r, q, sigma, american && exercised(f[1], is_call, S, K));
+            }
+
+            /**
+             * @brief Trinomial backward induction over one rolling buffer.
+             *
+             * Started one step before t = 0, for the same reason as binomial().
+             */
+            inline LatticeResult trinomial(double S, double K, double r, double T, double sigma, double q, bool is_call,
+                                           bool american, std::size_t steps, bool smooth, std::vector<double> &v)
+            {
+                const double dt = T / static_cast<double>(steps);
+                const double nu = r - q - 0.5 * sigma * sigma;
+                const double dx = sigma * std::sqrt(3.0 * dt);
+                const double a = (sigma * sigma * dt + nu * nu * dt * dt) / (dx * dx);
+                const double b = nu * dt / dx;
+                const double disc = std::exp(-r * dt);
+                const double p_up = 0.5 * (a + b);
+                const double p_down = 0.5 * (a - b);
+                const double p_mid = 1.0 - a;
+                if (!(p_up > 0.0 && p_down > 0.0 && p_mid > 0.0))
+                {
+                    throw std::invalid_argument("Lattice probabilities fall outside (0, 1); increase the number of steps");
+                }
+                const double pu = disc * p_up;
+                const double pm = disc * p_mid;
+                const double pd = disc * p_down;
+                const double ratio = std::exp(dx);
+
+                // Level j sits at t = (j - 1) dt; node i of it at S * e^((i - j) dx)
+                std::size_t top = smooth ? steps : steps + 1;
+                v.resize(2 * top + 1);
+                double s = S * std::exp(-static_cast<double>(top) * dx);
+                for (std::size_t i = 0; i <= 2 * top; ++i, s *= ratio)
+                {
+                    double value = smooth ? smoothed(is_call, s, K, r, dt, sigma, q) : intrinsic(is_call, s, K);
+                    v[i] = american ? std::max(value, intrinsic(is_call, s, K)) : value;
+                }
+                for (std::size_t j = top; j-- > 1;)
+                {
+                    for (std::size_t i = 0; i <= 2 * j; ++i)
+                    {
+                        v[i] = pd * v[i] + pm * v[i + 1] + pu * v[i + 2];
+                    }
+                    if (american)
+                    {
+                        s = S * std::exp(-static_cast<double>(j) * dx);
+                        for (std::size_t i = 0; i <= 2 * j; ++i, s *= ratio)
+                        {
+                            v[i] = std::max(v[i], intrinsic(is_call, s, K));
+                        }
+                    }
+                }
+                const double f[3] = {v[0], v[1], v[2]};
+                const double spots[3] = {S / ratio, S, S * ratio};
+                return from_nodes(f, spots, r, q, sigma, american && exercised(f[1], is_call, S, K));
+            }
+
+            inline LatticeResult solve(double S, double K, double r, double T, double sigma, double q, bool is_call,
+                                       bool american, std::size_t steps, LatticeMethod method, bool smooth,
+                                       std::vector<double> &buffer)
+            {
+                if (method == LatticeMethod::TRINOMIAL)
+                {
+                    return trinomial(S, K, r, T, sigma, q, is_call, american, steps, smooth, buffer);
+                }
+                return binomial(S, K, r, T, sigma, q, is_call, american, steps, method, smooth, buffer);
+            }
+
+            inline void check(double sigma, const LatticeSettings &settings)
+            {
+                if (!(sigma > 0.0))
+                {
+                    throw std::invalid_argument("Lattice pricing needs a positive volatility, got: " + std::to_string(sigma));
+                }
+                if (settings.steps < 6 || settings.steps > 100000)
+                {
+                    throw std::invalid_argument("Number of lattice steps must be in [6, 100000], got: " +
+                                                std::to_string(settings.steps));
+                }
+            }
+
+            /**
+             * @brief Prices one option; the caller owns the rolling buffer so batches reuse it.
+             *
+             * With Richardson extrapolation the error of the smoothed CRR and
+             * trinomial trees and of American Leisen-Reimer is taken as c / N,
+             * that of European Leisen-Reimer (odd N) as c / N^2, and the N and
+             * ~N / 2 results are combined to cancel it. The Greeks are always
+             * extrapolated as first order.
+             */
+            inline LatticeResult price_option(double S, double K, double r, double T, double sigma, double q,
+                                              bool is_call, const LatticeSettings &settings, std::vector<double> &buffer)
+            {
+                const bool lr = settings.method == LatticeMethod::LEISEN_REIMER;
+                const std::size_t n = lr ? (settings.steps | 1) : settings.steps;
+                // Leisen-Reimer is already smooth in N; the others get a European last step
+                const bool smooth = settings.richardson && !lr;
+                LatticeResult fine = solve(S, K, r, T, sigma, q, is_call, settings.american, n, settings.method, smooth,
+                                           buffer);
+                if (!settings.richardson)
+                {
+                    return fine;
+                }
+                const std::size_t m = lr ? ((n / 2) | 1) : n / 2;
+                LatticeResult coarse = solve(S, K, r, T, sigma, q, is_call, settings.american, m, settings.method,
+                                             smooth, buffer);
+                // The early-exercise boundary brings Leisen-Reimer back to first order, and
+                // its off-centre nodes leave the Greeks first order even for Europeans
+                const double order = lr && !settings.american ? 2.0 : 1.0;
+                auto extrapolate = [&](double a, double b, double p) {
+                    double wn = std::pow(static_cast<double>(n), p);
+                    double wm = std::pow(static_cast<double>(m), p);
+                    return (wn * a - wm * b) / (wn - wm);
+                };
+                LatticeResult out;
+                out.price = extrapolate(fine.price, coarse.price, order);
+                out.delta = extrapolate(fine.delta, coarse.delta, 1.0);
+                out.gamma = extrapolate(fine.gamma, coarse.gamma, 1.0);
+                out.theta = extrapolate(fine.theta, coarse.theta, 1.0);
+                return out;
+            }
+        }
+
+        /**
+         * @brief American / European vanilla pricer on a recombining lattice.
+         *
+         * Backward induction runs in place over a single buffer of N + 1
+         * (binomial) or 2N + 1 (trinomial) values, so memory is O(N) and the
+         * tree is never stored. Delta, gamma and theta come from the values
+         * already computed at the first nodes, not from bumped re-pricing.
+         */
+        class LatticeEngine
+        {
+        private:
+            double underlying_price;
+            double risk_free_rate;
+            double time_to_maturity;
+            double volatility;
+            double dividend_yield;
+
+        public:
+            LatticeEngine(double S, double r, double T, double sigma, double q = 0.0)
+                : underlying_price(S), risk_free_rate(r), time_to_maturity(T), volatility(sigma), dividend_yield(q)
+            {
+                // Same rules (and messages) as the closed-form model; the strike is checked per option
+                models::BlackScholesModel checked(S, sigma, r, T, S, q);
+                (void)checked;
+                detail::check(sigma, LatticeSettings());
+            }
+
+            LatticeResult price(double strike, bool is_call, const LatticeSettings &settings = LatticeSettings()) const
+            {
+                models::BlackScholesModel checked(strike, volatility, risk_free_rate, time_to_maturity,
+                                                  underlying_price, dividend_yield);
+                (void)checked;
+                detail::check(volatility, settings);
+                std::vector<double> buffer;
+                return detail::price_option(underlying_price, strike, risk_free_rate, time_to_maturity, volatility,
+                                            dividend_yield, is_call, settings, buffer);
+            }
+
+            double get_underlying_price() const { return underlying_price; }
+            double get_risk_free_rate() const { return risk_free_rate; }
+            double get_time_to_maturity() const { return time_to_maturity; }
+            double get_volatility() const { return volatility; }
+            double get_dividend_yield() const { return dividend_yield; }
+        };
+
+        /**
+         * @brief Prices n options on the lattice, spread across the thread pool.
+         *
+         * Each chunk keeps one rolling buffer for all of its options.
+         */
+        inline void price_batch(Column<double> S, Column<double> K, Column<double> r, Column<double> T,
+                                Column<double> sigma, Column<double> q, Column<bool> is_call,
+                                const LatticeSettings &settings, LatticeResult *out, std::size_t n)
+        {
+            models::validate_batch(S, K, r, T, sigma, q, n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (!(sigma[i] > 0.0))
+                {
+                    throw std::invalid_argument("Invalid inputs at index " + std::to_string(i) +
+                                                ": Lattice pricing needs a positive volatility");
+                }
+            }
+            detail::check(1.0, settings);
+            parallel::parallel_for(n, 4, [&](std::size_t begin, std::size_t end) {
+                std::vector<double> buffer;
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    out[i] = detail::price_option(S[i], K[i], r[i], T[i], sigma[i], q[i], is_call[i], settings, buffer);
+                }
+            });
+        }
+    }
+}
+
+#endif // OPTIPRICER_LATTICE_HPP
@@ -1,28 +1,113 @@
 #ifndef OPTIPRICER_MODELS_HPP
 #define OPTIPRICER_MODELS_HPP
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <limits>
+#include "stats.hpp"
 #include "utils.hpp"
 
 namespace optipricer
 {
     namespace models
     {
+        /**
+         * @brief The strike-independent half of a Black-Scholes evaluation: r, q, T,
+         * both discount factors and sqrt(T).
+         *
+         * Build one per expiry and hand it to every strike priced against it
+         * (BlackScholesModel, compute_all_greeks(), solve_implied_volatility()), so
+         * the exponentials and the square root are evaluated once per chain rather
+         * than once per strike and Greek.
+         */
+        class ExpiryContext
+        {
+        private:
+            double risk_free_rate;
+            double time_to_maturity;
+            double dividend_yield;
+            double discount_factor;
+            double dividend_discount;
+            double sqrt_time;
+
+            void validate_inputs() const
+            {
+                if (time_to_maturity <= 0.0)
+                {
+                    throw std::invalid_argument("Time to maturity must be positive, got: " + std::to_string(time_to_maturity));
+                }
+                if (time_to_maturity > 100.0)
+                {
+                    throw std::invalid_argument("Time to maturity seems unreasonably high (>100 years), got: " + std::to_string(time_to_maturity));
+                }
+                if (dividend_yield < 0.0)
+                {
+                    throw std::invalid_argument("Dividend yield must be non-negative, got: " + std::to_string(dividend_yield));
+                }
+                if (dividend_yield > 10.0)
+                {
+                    throw std::invalid_argument("Dividend yield seems unreasonably high (>1000%), got: " + std::to_string(dividend_yield));
+                }
+                if (std::isnan(risk_free_rate) || std::isnan(time_to_maturity) || std::isnan(dividend_yield))
+                {
+                    throw std::invalid_argument("Input parameters cannot be NaN");
+                }
+                if (std::isinf(risk_free_rate) || std::isinf(time_to_maturity) || std::isinf(dividend_yield))
+                {
+                    throw std::invalid_argument("Input parameters cannot be infinite");
+                }
+            }
+
+            struct UncheckedTag
+            {
+            };
+
+            ExpiryContext(UncheckedTag, double r, double T, double q) noexcept
+                : risk_free_rate(r), time_to_maturity(T), dividend_yield(q),
+                  discount_factor(std::exp(-r * T)), dividend_discount(std::exp(-q * T)), sqrt_time(std::sqrt(T))
+            {
+            }
+
+        public:
+            ExpiryContext(double r, double T, double q = 0.0)
+                : ExpiryContext(UncheckedTag(), r, T, q)
+            {
+                validate_inputs();
+            }
+
+            /**
+             * @brief Builds a context without running validate_inputs(), with the same
+             * contract as BlackScholesModel::unchecked().
+             */
+            static ExpiryContext unchecked(double r, double T, double q = 0.0) noexcept
+            {
+                return ExpiryContext(UncheckedTag(), r, T, q);
+            }
+
+            double get_risk_free_rate() const { return risk_free_rate; }
+            double get_time_to_maturity() const { return time_to_maturity; }
+            double get_dividend_yield() const { return dividend_yield; }
+            double get_discount_factor() const { return discount_factor; }     // e^{-rT}
+            double get_dividend_discount() const { return dividend_discount; } // e^{-qT}
+            double get_sqrt_time() const { return sqrt_time; }
+        };
+
         class BlackScholesModel
         {
         private:
             double strike_price;
             double volatility;
-            double risk_free_rate;
-            double time_to_maturity;
             double underlying_price;
-            double dividend_yield;
+            ExpiryContext expiry;
 
             void validate_inputs() const
             {
+                const double risk_free_rate = expiry.get_risk_free_rate();
+                const double time_to_maturity = expiry.get_time_to_maturity();
+                const double dividend_yield = expiry.get_dividend_yield();
                 if (strike_price <= 0.0)
                 {
                     throw std::invalid_argument("Strike price must be positive, got: " + std::to_string(strike_price));
@@ -67,21 +152,70 @@ namespace optipricer
                 }
             }
 
+            struct UncheckedTag
+            {
+            };
+
+            BlackScholesModel(UncheckedTag, double K, double sigma, double S, const ExpiryContext &context) noexcept
+                : strike_price(K), volatility(sigma), underlying_price(S), expiry(context)
+            {
+            }
+
         public:
             BlackScholesModel(double K, double sigma, double r, double T, double S, double q = 0.0)
-                : strike_price(K), volatility(sigma), risk_free_rate(r),
-                  time_to_maturity(T), underlying_price(S), dividend_yield(q)
+                : strike_price(K), volatility(sigma), underlying_price(S), expiry(ExpiryContext::unchecked(r, T, q))
             {
                 validate_inputs();
             }
 
+            /**
+             * @brief Model for one strike of an expiry whose discount factors are already known.
+             *
+             * Strike, volatility and spot are still validated; the context's r, T and q
+             * are re-checked too, as they are cheap compared with the exponentials saved.
+             */
+            BlackScholesModel(double K, double sigma, double S, const ExpiryContext &context)
+                : strike_price(K), volatility(sigma), underlying_price(S), expiry(context)
+            {
+                validate_inputs();
+            }
+
+            /**
+             * @brief Builds a model without running validate_inputs().
+             *
+             * For internal callers whose inputs were already validated at the API
+             * boundary (strategy legs, batches). Passing values that the checked
+             * constructor would reject is undefined behaviour for the results.
+             */
+            static BlackScholesModel unchecked(double K, double sigma, double r, double T, double S, double q = 0.0) noexcept
+            {
+                return BlackScholesModel(UncheckedTag(), K, sigma, S, ExpiryContext::unchecked(r, T, q));
+            }
+
+            static BlackScholesModel unchecked(double K, double sigma, double S, const ExpiryContext &context) noexcept
+            {
+                return BlackScholesModel(UncheckedTag(), K, sigma, S, context);
+            }
+
+            /**
+             * @brief Non-throwing form of the constructor checks, used to pre-validate batches
+             */
+            static bool inputs_valid(double K, double sigma, double r, double T, double S, double q) noexcept
+            {
+                return K > 0.0 && sigma >= 0.0 && sigma <= 10.0 && T > 0.0 && T <= 100.0 &&
+                       S > 0.0 && q >= 0.0 && q <= 10.0 &&
+                       std::isfinite(K) && std::isfinite(sigma) && std::isfinite(r) &&
+                       std::isfinite(T) && std::isfinite(S) && std::isfinite(q);
+            }
+
             double d1() const
             {
+                const double T = expiry.get_time_to_maturity();
                 // Handle edge case where volatility is very small or time to maturity is very small
-                if (volatility < 1e-10 || time_to_maturity < 1e-10)
+                if (volatility < 1e-10 || T < 1e-10)
                 {
-                    double discounted_strike = strike_price * std::exp(-risk_free_rate * time_to_maturity);
-                    double discounted_underlying = underlying_price * std::exp(-dividend_yield * time_to_maturity);
+                    double discounted_strike = strike_price * expiry.get_discount_factor();
+                    double discounted_underlying = underlying_price * expiry.get_dividend_discount();
                     if (discounted_underlying > discounted_strike)
                     {
                         return 1e15; // Represents +infinity
@@ -96,31 +230,38 @@ namespace optipricer
                     }
                 }
 
-                double sqrt_T = std::sqrt(time_to_maturity);
-                double vol_sqrt_T = volatility * sqrt_T;
+                double vol_sqrt_T = volatility * expiry.get_sqrt_time();
 
                 return (std::log(underlying_price / strike_price) +
-                        (risk_free_rate - dividend_yield + 0.5 * volatility * volatility) * time_to_maturity) /
+                        (expiry.get_risk_free_rate() - expiry.get_dividend_yield() + 0.5 * volatility * volatility) * T) /
                        vol_sqrt_T;
             }
 
             double d2() const
             {
-                if (volatility < 1e-10 || time_to_maturity < 1e-10)
+                if (volatility < 1e-10 || expiry.get_time_to_maturity() < 1e-10)
                 {
                     return d1();
                 }
-                return d1() - volatility * std::sqrt(time_to_maturity);
+                return d1() - volatility * expiry.get_sqrt_time();
             }
 
-            double call_price() const
+            /**
+             * @brief Price of the call (IsCall) or put, specialized at compile time.
+             *
+             * ZeroDividend skips the dividend discount. call_price() and put_price()
+             * select it when q is exactly 0, where the result is bit-identical.
+             */
+            template <bool IsCall, bool ZeroDividend = false>
+            double price() const
             {
+                OPTIPRICER_STATS_TIMER(stats::Timer::PRICE);
                 try
                 {
                     double D1 = d1();
                     double D2 = d2();
-                    double discount_factor = std::exp(-risk_free_rate * time_to_maturity);
-                    double div_discount = std::exp(-dividend_yield * time_to_maturity);
+                    double discount_factor = expiry.get_discount_factor();
+                    double div_discount = expiry.get_dividend_discount();
 
                     // Check for overflow/underflow
                     if (std::isinf(discount_factor) || std::isnan(discount_factor) ||
@@ -129,65 +270,257 @@ namespace optipricer
                         throw std::runtime_error("Discount factor calculation resulted in invalid value");
                     }
 
-                    return underlying_price * div_discount * utils::norm_cdf(D1) -
-                           strike_price * discount_factor * utils::norm_cdf(D2);
+                    const double forward_underlying = ZeroDividend ? underlying_price : underlying_price * div_discount;
+                    if constexpr (IsCall)
+                    {
+                        return forward_underlying * utils::norm_cdf(D1) -
+                               strike_price * discount_factor * utils::norm_cdf(D2);
+                    }
+                    else
+                    {
+                        return strike_price * discount_factor * utils::norm_cdf(-D2) -
+                               forward_underlying * utils::norm_cdf(-D1);
+                    }
                 }
                 catch (const std::exception &e)
                 {
-                    throw std::runtime_error("Error calculating call price: " + std::string(e.what()));
+                    throw std::runtime_error(std::string(IsCall ? "Error calculating call price: "
+                                                                : "Error calculating put price: ") +
+                                             e.what());
                 }
             }
 
+            double call_price() const
+            {
+                return expiry.get_dividend_yield() == 0.0 ? price<true, true>() : price<true, false>();
+            }
+
             double put_price() const
             {
-                try
+                return expiry.get_dividend_yield() == 0.0 ? price<false, true>() : price<false, false>();
+            }
+
+            // Getters for model parameters
+            double get_strike_price() const { return strike_price; }
+            double get_volatility() const { return volatility; }
+            double get_risk_free_rate() const { return expiry.get_risk_free_rate(); }
+            double get_time_to_maturity() const { return expiry.get_time_to_maturity(); }
+            double get_underlying_price() const { return underlying_price; }
+            double get_dividend_yield() const { return expiry.get_dividend_yield(); }
+            const ExpiryContext &get_expiry() const { return expiry; }
+        };
+
+        /**
+         * @brief Per-element outcome of the implied volatility solver.
+         */
+        enum class IVStatus : std::int8_t
+        {
+            OK = 0,
+            INVALID_INPUT = 1,
+            BELOW_INTRINSIC = 2,
+            ABOVE_MAXIMUM = 3,
+            VOLATILITY_TOO_HIGH = 4,
+            NOT_CONVERGED = 5
+        };
+
+        struct IVResult
+        {
+            double volatility;
+            IVStatus status;
+            int iterations;
+        };
+
+        // Largest volatility a BlackScholesModel accepts
+        constexpr double IV_MAX_VOLATILITY = 10.0;
+
+        /**
+         * @brief Closed-form starting point for the implied volatility search.
+         *
+         * Corrado-Miller applied to the equivalent call price (via put-call
+         * parity), falling back to the Brenner-Subrahmanyam ATM approximation
+         * when the Corrado-Miller discriminant gives nothing usable.
+         */
+        inline double implied_volatility_seed(double market_price, double forward_underlying,
+                                              double forward_strike, double sqrt_T, bool is_call) noexcept
+        {
+            double gap = forward_underlying - forward_strike;
+            double call = is_call ? market_price : market_price + gap;
+            double a = call - 0.5 * gap;
+            double disc = a * a - gap * gap / utils::PI;
+            double sigma = utils::SQRT_2PI / (forward_underlying + forward_strike) *
+                           (a + std::sqrt(std::max(disc, 0.0))) / sqrt_T;
+            if (!(sigma > 1e-3) || !std::isfinite(sigma))
+            {
+                sigma = utils::SQRT_2PI * call / (forward_underlying * sqrt_T);
+            }
+            if (!(sigma > 1e-3) || !std::isfinite(sigma))
+            {
+                return 0.2;
+            }
+            return std::min(sigma, IV_MAX_VOLATILITY);
+        }
+
+        namespace detail
+        {
+            // Body of solve_implied_volatility() for one option side; steps is only
+            // written when stats are compiled in
+            template <bool IsCall>
+            IVResult implied_volatility_search(double market_price, double strike_price, double underlying_price,
+                                               const ExpiryContext &expiry, double tol, int max_iter,
+                                               stats::SolverSteps &steps) noexcept
+            {
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                if (!(market_price > 0.0) || !std::isfinite(market_price) ||
+                    !BlackScholesModel::inputs_valid(strike_price, 0.0, expiry.get_risk_free_rate(), expiry.get_time_to_maturity(),
+                                                      underlying_price, expiry.get_dividend_yield()))
                 {
-                    double D1 = d1();
-                    double D2 = d2();
-                    double discount_factor = std::exp(-risk_free_rate * time_to_maturity);
-                    double div_discount = std::exp(-dividend_yield * time_to_maturity);
+                    return {nan, IVStatus::INVALID_INPUT, 0};
+                }
 
-                    // Check for overflow/underflow
-                    if (std::isinf(discount_factor) || std::isnan(discount_factor) ||
-                        std::isinf(div_discount) || std::isnan(div_discount))
+                const double forward_underlying = underlying_price * expiry.get_dividend_discount();
+                const double forward_strike = strike_price * expiry.get_discount_factor();
+                const double intrinsic = std::max(IsCall ? forward_underlying - forward_strike
+                                                         : forward_strike - forward_underlying, 0.0);
+                const double upper = IsCall ? forward_underlying : forward_strike;
+                if (market_price < intrinsic)
+                {
+                    return {nan, IVStatus::BELOW_INTRINSIC, 0};
+                }
+                if (market_price > upper)
+                {
+                    return {nan, IVStatus::ABOVE_MAXIMUM, 0};
+                }
+
+                const double sqrt_T = expiry.get_sqrt_time();
+                const double log_moneyness = std::log(forward_underlying / forward_strike);
+
+                double low = 0.0;
+                double high = IV_MAX_VOLATILITY;
+                bool bracketed = false;
+                double sigma = implied_volatility_seed(market_price, forward_underlying, forward_strike, sqrt_T, IsCall);
+                for (int i = 0; i < max_iter; ++i)
+                {
+                    double vol_sqrt_T = sigma * sqrt_T;
+                    double D1 = log_moneyness / vol_sqrt_T + 0.5 * vol_sqrt_T;
+                    double D2 = D1 - vol_sqrt_T;
+                    double price;
+                    if constexpr (IsCall)
                     {
-                        throw std::runtime_error("Discount factor calculation resulted in invalid value");
+                        price = forward_underlying * utils::norm_cdf(D1) - forward_strike * utils::norm_cdf(D2);
+                    }
+                    else
+                    {
+                        price = forward_strike * utils::norm_cdf(-D2) - forward_underlying * utils::norm_cdf(-D1);
+                    }
+                    double diff = price - market_price;
+                    if (std::abs(diff) < tol)
+                    {
+                        return {sigma, IVStatus::OK, i + 1};
                     }
 
-                    return strike_price * discount_factor * utils::norm_cdf(-D2) -
-                           underlying_price * div_discount * utils::norm_cdf(-D1);
-                }
-                catch (const std::exception &e)
-                {
-                    throw std::runtime_error("Error calculating put price: " + std::string(e.what()));
+                    if (diff > 0.0)
+                    {
+                        high = sigma;
+                        bracketed = true;
+                    }
+                    else
+                    {
+                        low = sigma;
+                        if (!bracketed && sigma >= IV_MAX_VOLATILITY)
+                        {
+                            return {nan, IVStatus::VOLATILITY_TOO_HIGH, i + 1};
+                        }
+                    }
+
+                    double vega = forward_underlying * utils::norm_pdf(D1) * sqrt_T;
+                    double sigma_new = vega > 1e-300 ? sigma - diff / vega : nan;
+                    if (sigma_new > low && sigma_new < high)
+                    {
+                        sigma = sigma_new;
+                        steps.newton_step();
+                    }
+                    else if (bracketed)
+                    {
+                        sigma = 0.5 * (low + high);
+                        steps.bisection_step();
+                    }
+                    else
+                    {
+                        sigma = std::min(2.0 * sigma, IV_MAX_VOLATILITY);
+                        steps.bracket_expansion();
+                    }
+
+                    if (bracketed && high - low < tol)
+                    {
+                        return {0.5 * (low + high), IVStatus::OK, i + 1};
+                    }
                 }
+
+                return {sigma, IVStatus::NOT_CONVERGED, max_iter};
             }
+        }
 
-            // Getters for model parameters
-            double get_strike_price() const { return strike_price; }
-            double get_volatility() const { return volatility; }
-            double get_risk_free_rate() const { return risk_free_rate; }
-            double get_time_to_maturity() const { return time_to_maturity; }
-            double get_underlying_price() const { return underlying_price; }
-            double get_dividend_yield() const { return dividend_yield; }
-        };
+        /**
+         * @brief Non-throwing implied volatility solver.
+         *
+         * Safeguarded Newton-Raphson from implied_volatility_seed(). The root is
+         * bracketed lazily: steps that leave the bracket fall back to bisection
+         * once an upper bound is known, and to doubling the volatility before
+         * that. The price is evaluated in forward terms so no model objects are
+         * built along the way; the discount factors and sqrt(T) come from the
+         * expiry context. is_call selects a specialized search once, outside
+         * the iteration loop.
+         */
+        inline IVResult solve_implied_volatility(
+            double market_price,
+            double strike_price,
+            double underlying_price,
+            const ExpiryContext &expiry,
+            bool is_call,
+            double tol = 1e-6,
+            int max_iter = 100) noexcept
+        {
+            stats::SolverSteps steps;
+            IVResult result = is_call ? detail::implied_volatility_search<true>(market_price, strike_price, underlying_price,
+                                                                                expiry, tol, max_iter, steps)
+                                      : detail::implied_volatility_search<false>(market_price, strike_price, underlying_price,
+                                                                                 expiry, tol, max_iter, steps);
+            stats::record_solve(result.status == IVStatus::OK, result.status == IVStatus::NOT_CONVERGED,
+                                result.iterations, steps);
+            return result;
+        }
+
+        inline IVResult solve_implied_volatility(
+            double market_price,
+            double strike_price,
+            double risk_free_rate,
+            double time_to_maturity,
+            double underlying_price,
+            double dividend_yield,
+            bool is_call,
+            double tol = 1e-6,
+            int max_iter = 100) noexcept
+        {
+            return solve_implied_volatility(market_price, strike_price, underlying_price,
+                                            ExpiryContext::unchecked(risk_free_rate, time_to_maturity, dividend_yield),
+                                            is_call, tol, max_iter);
+        }
 
         /**
          * @brief Calculates the implied volatility for an option.
          * 
-         * Uses a hybrid Newton-Raphson and Bisection solver.
+         * Throwing wrapper around solve_implied_volatility().
          */
         inline double calculate_implied_volatility(
             double market_price,
             double strike_price,
-            double risk_free_rate,
-            double time_to_maturity,
             double underlying_price,
-            double dividend_yield,
+            const ExpiryContext &expiry,
             bool is_call,
             double tol = 1e-6,
             int max_iter = 100)
         {
+            OPTIPRICER_STATS_TIMER(stats::Timer::IMPLIED_VOLATILITY);
             if (market_price <= 0.0)
             {
                 throw std::invalid_argument("Market price must be positive, got: " + std::to_string(market_price));
@@ -196,121 +529,65 @@ namespace optipricer
             {
                 throw std::invalid_argument("Strike price must be positive, got: " + std::to_string(strike_price));
             }
-            if (time_to_maturity <= 0.0)
+            if (expiry.get_time_to_maturity() <= 0.0)
             {
-                throw std::invalid_argument("Time to maturity must be positive, got: " + std::to_string(time_to_maturity));
+                throw std::invalid_argument("Time to maturity must be positive, got: " + std::to_string(expiry.get_time_to_maturity()));
             }
             if (underlying_price <= 0.0)
             {
                 throw std::invalid_argument("Underlying price must be positive, got: " + std::to_string(underlying_price));
             }
-            if (dividend_yield < 0.0)
+            if (expiry.get_dividend_yield() < 0.0)
             {
-                throw std::invalid_argument("Dividend yield must be non-negative, got: " + std::to_string(dividend_yield));
+                throw std::invalid_argument("Dividend yield must be non-negative, got: " + std::to_string(expiry.get_dividend_yield()));
             }
 
-            double discount_factor = std::exp(-risk_free_rate * time_to_maturity);
-            double div_discount = std::exp(-dividend_yield * time_to_maturity);
-
-            // Theoretical bounds
-            double min_price = 0.0;
-            double max_price = 0.0;
-            if (is_call)
+            IVResult result = solve_implied_volatility(market_price, strike_price, underlying_price, expiry,
+                                                       is_call, tol, max_iter);
+            switch (result.status)
             {
-                min_price = std::max(underlying_price * div_discount - strike_price * discount_factor, 0.0);
-                max_price = underlying_price * div_discount;
-            }
-            else
+            case IVStatus::OK:
+            case IVStatus::NOT_CONVERGED:
+                return result.volatility;
+            case IVStatus::INVALID_INPUT:
             {
-                min_price = std::max(strike_price * discount_factor - underlying_price * div_discount, 0.0);
-                max_price = strike_price * discount_factor;
+                // Let the model report which parameter it rejects
+                BlackScholesModel rejected(strike_price, 0.0, underlying_price, expiry);
+                (void)rejected;
+                throw std::invalid_argument("Market price must be finite, got: " + std::to_string(market_price));
             }
-
-            if (market_price < min_price || market_price > max_price)
+            case IVStatus::BELOW_INTRINSIC:
+            case IVStatus::ABOVE_MAXIMUM:
             {
+                double discount_factor = expiry.get_discount_factor();
+                double div_discount = expiry.get_dividend_discount();
+                double min_price = is_call ? std::max(underlying_price * div_discount - strike_price * discount_factor, 0.0)
+                                           : std::max(strike_price * discount_factor - underlying_price * div_discount, 0.0);
+                double max_price = is_call ? underlying_price * div_discount : strike_price * discount_factor;
                 throw std::invalid_argument("Market price " + std::to_string(market_price) + 
                                             " is outside theoretical Black-Scholes bounds [" + 
                                             std::to_string(min_price) + ", " + std::to_string(max_price) + "]");
             }
-
-            // Bracket the root
-            double low = 1e-10;
-            double high = 10.0;
-            
-            // Check if price at high bracket is too small (volatility extremely high, expanding search)
-            {
-                BlackScholesModel test_high(strike_price, high, risk_free_rate, time_to_maturity, underlying_price, dividend_yield);
-                double price_high = is_call ? test_high.call_price() : test_high.put_price();
-                while (price_high < market_price && high < 50.0)
-                {
-                    high += 5.0;
-                    BlackScholesModel test_high_new(strike_price, high, risk_free_rate, time_to_maturity, underlying_price, dividend_yield);
-                    price_high = is_call ? test_high_new.call_price() : test_high_new.put_price();
-                }
-                if (price_high < market_price)
-                {
-                    throw std::invalid_argument("Market price is too high for maximum supported volatility.");
-                }
-            }
-
-            // Newton-Raphson Solver with Bisection Fallback
-            double sigma = 0.5; // Initial guess
-            for (int i = 0; i < max_iter; ++i)
-            {
-                BlackScholesModel model(strike_price, sigma, risk_free_rate, time_to_maturity, underlying_price, dividend_yield);
-                double price = is_call ? model.call_price() : model.put_price();
-                double diff = price - market_price;
-
-                if (std::abs(diff) < tol)
-                {
-                    return sigma;
-                }
-
-                // Compute exact analytical vega to use as derivative
-                double d1_val = model.d1();
-                double vega_derivative = underlying_price * div_discount * utils::norm_pdf(d1_val) * std::sqrt(time_to_maturity);
-
-                double sigma_new = -1.0;
-                if (vega_derivative > 1e-8)
-                {
-                    sigma_new = sigma - diff / vega_derivative;
-                }
-
-                // If Newton step went out of bounds or vega is too small, use bisection
-                if (sigma_new <= low || sigma_new >= high)
-                {
-                    if (diff > 0.0)
-                    {
-                        high = sigma;
-                    }
-                    else
-                    {
-                        low = sigma;
-                    }
-                    sigma = 0.5 * (low + high);
-                }
-                else
-                {
-                    // Update brackets and apply Newton-Raphson update
-                    if (diff > 0.0)
-                    {
-                        high = sigma;
-                    }
-                    else
-                    {
-                        low = sigma;
-                    }
-                    sigma = sigma_new;
-                }
-
-                // Check bracket size for convergence
-                if (std::abs(high - low) < tol)
-                {
-                    return 0.5 * (low + high);
-                }
+            case IVStatus::VOLATILITY_TOO_HIGH:
+                break;
             }
+            throw std::invalid_argument("Market price is too high for maximum supported volatility.");
+        }
 
-            return sigma;
+        inline double calculate_implied_volatility(
+            double market_price,
+            double strike_price,
+            double risk_free_rate,
+            double time_to_maturity,
+            double underlying_price,
+            double dividend_yield,
+            bool is_call,
+            double tol = 1e-6,
+            int max_iter = 100)
+        {
+            return calculate_implied_volatility(market_price, strike_price, underlying_price,
+                                                ExpiryContext::unchecked(risk_free_rate, time_to_maturity, dividend_yield),
+                                                is_call, tol, max_iter);
         }
     }
 }
@@ -0,0 +1,436 @@
+#ifndef OPTIPRICER_MONTECARLO_HPP
+#define OPTIPRICER_MONTECARLO_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "models.hpp"
+#include "parallel.hpp"
+#include "qmc.hpp"
+#include "random.hpp"
+#include "simd.hpp"
+
+namespace optipricer
+{
+    namespace mc
+    {
+        enum class PathPayoff
+        {
+            EUROPEAN,
+            ASIAN,        // Arithmetic average of the monitoring dates
+            UP_AND_OUT,
+            UP_AND_IN,
+            DOWN_AND_OUT,
+            DOWN_AND_IN
+        };
+
+        /**
+         * @brief Option written on a simulated path.
+         *
+         * Monitoring is discrete: the average (ASIAN) and the barrier check
+         * use the `steps` equally spaced dates of the simulation. Barriers are
+         * also checked against the spot at t = 0.
+         */
+        struct PathOption
+        {
+            PathPayoff payoff;
+            bool is_call;
+            double strike;
+            double barrier;
+        };
+
+        enum class Sampler
+        {
+            PSEUDO_RANDOM, // Philox draws, error from the sample variance
+            SOBOL          // Scrambled Sobol + Brownian bridge, error from independent replicates
+        };
+
+        struct MCSettings
+        {
+            std::size_t paths = 100000;
+            std::size_t steps = 1;
+            std::uint64_t seed = 42;
+            bool antithetic = true;
+            bool control_variate = true;
+            Sampler sampler = Sampler::PSEUDO_RANDOM;
+            std::size_t replicates = 16; // Independent scrambles for SOBOL; paths are split evenly
+        };
+
+        struct MCResult
+        {
+            double price;
+            double std_error;
+            std::size_t paths;
+        };
+
+        namespace detail
+        {
+            /**
+             * @brief Streaming moments of (payoff y, control x), merged with Chan's update.
+             *
+             * Only these six numbers are kept per chunk, so memory does not
+             * grow with the number of paths.
+             */
+            struct Moments
+            {
+                double n = 0.0;
+                double mean_y = 0.0;
+                double mean_x = 0.0;
+                double m2_y = 0.0;
+                double m2_x = 0.0;
+                double c_xy = 0.0;
+
+                void add(double y, double x)
+                {
+                    n += 1.0;
+                    double dy = y - mean_y;
+                    double dx = x - mean_x;
+                    mean_y += dy / n;
+                    mean_x += dx / n;
+                    m2_y += dy * (y - mean_y);
+                    m2_x += dx * (x - mean_x);
+                    c_xy += dx * (y - mean_y);
+                }
+
+                void merge(const Moments &o)
+                {
+                    if (o.n == 0.0)
+                    {
+                        return;
+                    }
+                    double total = n + o.n;
+                    double dy = o.mean_y - mean_y;
+                    double dx = o.mean_x - mean_x;
+                    double w = n * o.n / total;
+                    m2_y += o.m2_y + dy * dy * w;
+                    m2_x += o.m2_x + dx * dx * w;
+                    c_xy += o.c_xy + dx * dy * w;
+                    mean_y += dy * o.n / total;
+                    mean_x += dx * o.n / total;
+                    n = total;
+                }
+            };
+
+            // Paths simulated together; a multiple of simd::LANES
+            constexpr std::size_t BLOCK = 64;
+        }
+
+        /**
+         * @brief Monte Carlo pricer for GBM paths under Black-Scholes dynamics.
+         *
+         * Paths are simulated in blocks: Philox fills a steps x BLOCK matrix
+         * of uniforms indexed by (path, step), simd::inverse_normal turns it
+         * into normals, and the block is walked with exact log-normal steps.
+         * Blocks are spread over the thread pool and each chunk keeps only
+         * running moments, merged in chunk order at the end, so the estimate
+         * is bit-identical for any thread count and memory is O(threads).
+         *
+         * With Sampler::SOBOL the uniforms instead come from a scrambled
+         * Sobol sequence (one dimension per step, Philox beyond
+         * SOBOL_DIMENSIONS) and a Brownian bridge orders the path so the
+         * first dimensions set the terminal value and the coarse shape. The
+         * paths are split over `replicates` independent scrambles and the
+         * standard error is the spread of the replicate estimates, since the
+         * within-sample variance says nothing about QMC error. Paths per
+         * replicate work best as a power of two.
+         *
+         * Variance reduction:
+         *  - antithetic: each draw Z is paired with -Z and the pair averaged;
+         *  - control variate: the discounted European payoff with the same
+         *    strike and type, whose mean is the closed-form BlackScholesModel
+         *    price (for EUROPEAN itself, the discounted terminal spot with mean
+         *    S e^{-qT}), with the optimal coefficient estimated from the paths.
+         */
+        class MonteCarloEngine
+        {
+        private:
+            double underlying_price;
+            double risk_free_rate;
+            double time_to_maturity;
+            double volatility;
+            double dividend_yield;
+
+            static double vanilla(bool is_call, double S, double K)
+            {
+                return is_call ? std::max(S - K, 0.0) : std::max(K - S, 0.0);
+            }
+
+            static void check(const PathOption &option, const MCSettings &settings)
+            {
+                std::size_t samples = settings.antithetic ? (settings.paths + 1) / 2 : settings.paths;
+                if (samples < 2)
+                {
+                    throw std::invalid_argument("Monte Carlo needs at least 2 independent samples (4 paths with antithetic), got " +
+                                                std::to_string(settings.paths) + " paths");
+                }
+                if (settings.steps < 1 || settings.steps > 100000)
+                {
+                    throw std::invalid_argument("Number of steps must be in [1, 100000], got: " + std::to_string(settings.steps));
+                }
+                if (settings.sampler == Sampler::SOBOL)
+                {
+                    if (settings.replicates < 2 || settings.replicates > 4096)
+                    {
+                        throw std::invalid_argument("Number of Sobol replicates must be in [2, 4096], got: " +
+                                                    std::to_string(settings.replicates));
+                    }
+                    if (samples < settings.replicates ||
+                        samples / settings.replicates >= SOBOL_MAX_POINTS)
+                    {
+                        throw std::invalid_argument("Sobol needs between 1 and 2^32 samples per replicate, got " +
+                                                    std::to_string(settings.paths) + " paths over " +
+                                                    std::to_string(settings.replicates) + " replicates");
+                    }
+                }
+                bool barrier = option.payoff != PathPayoff::EUROPEAN && option.payoff != PathPayoff::ASIAN;
+                if (barrier && (!(option.barrier > 0.0) || !std::isfinite(option.barrier)))
+                {
+                    throw std::invalid_argument("Barrier must be positive and finite, got: " + std::to_string(option.barrier));
+                }
+            }
+
+            /**
+             * @brief Uniforms for paths [first, first + count) into u[step * BLOCK + lane], steps [begin, steps).
+             *
+             * One Philox call yields two uniforms, for steps 2j and 2j + 1;
+             * `begin` must be even. `stream` separates independent sets of
+             * draws under one seed. Lanes past the last path get a neutral 0.5.
+             */
+            static void fill_uniforms(const Philox4x32 &rng, std::size_t first, std::size_t count, std::size_t begin,
+                                      std::size_t steps, std::uint32_t stream, double *u)
+            {
+                // Lane-major so the Philox rounds vectorize across paths
+                for (std::size_t j = begin; j < steps; j += 2)
+                {
+                    double *u0 = u + j * detail::BLOCK;
+                    double *u1 = j + 1 < steps ? u0 + detail::BLOCK : nullptr;
+                    for (std::size_t b = 0; b < detail::BLOCK; ++b)
+                    {
+                        std::uint64_t path = first + b;
+                        std::uint32_t ctr[4] = {static_cast<std::uint32_t>(path), static_cast<std::uint32_t>(path >> 32),
+                                                static_cast<std::uint32_t>(j >> 1), stream};
+                        rng(ctr);
+                        u0[b] = b < count ? to_unit(ctr[0], ctr[1]) : 0.5;
+                        if (u1)
+                        {
+                            u1[b] = b < count ? to_unit(ctr[2], ctr[3]) : 0.5;
+                        }
+                    }
+                }
+            }
+
+        public:
+            MonteCarloEngine(double S, double r, double T, double sigma, double q = 0.0)
+                : underlying_price(S), risk_free_rate(r), time_to_maturity(T), volatility(sigma), dividend_yield(q)
+            {
+                // Same rules (and messages) as the closed-form model; the strike is checked per option
+                models::BlackScholesModel checked(S, sigma, r, T, S, q);
+                (void)checked;
+            }
+
+            MCResult price(const PathOption &option, const MCSettings &settings) const
+            {
+                check(option, settings);
+                models::BlackScholesModel control_model(option.strike, volatility, risk_free_rate, time_to_maturity,
+                                                        underlying_price, dividend_yield);
+
+                const std::size_t steps = settings.steps;
+                const bool antithetic = settings.antithetic;
+                const bool sobol = settings.sampler == Sampler::SOBOL;
+                const std::size_t replicates = sobol ? settings.replicates : 1;
+                const std::size_t requested = antithetic ? (settings.paths + 1) / 2 : settings.paths;
+                const std::size_t samples = requested / replicates; // Per replicate
+                const std::size_t blocks = (samples + detail::BLOCK - 1) / detail::BLOCK;
+                // At most ~256 chunks, so the per-chunk moments stay a fixed, small amount of memory
+                const std::size_t target_chunks = std::max<std::size_t>(1, 256 / replicates);
+                const std::size_t blocks_per_chunk = std::max<std::size_t>(4, (blocks + target_chunks - 1) / target_chunks);
+                const std::size_t chunks = (blocks + blocks_per_chunk - 1) / blocks_per_chunk;
+
+                const double dt = time_to_maturity / static_cast<double>(steps);
+                const double drift = (risk_free_rate - dividend_yield - 0.5 * volatility * volatility) * dt;
+                const double diffusion = volatility * std::sqrt(dt);
+                const double discount = std::exp(-risk_free_rate * time_to_maturity);
+                const double log_S0 = std::log(underlying_price);
+                const double K = option.strike;
+                const double H = option.barrier;
+                const PathPayoff kind = option.payoff;
+                const bool is_call = option.is_call;
+                const bool up = kind == PathPayoff::UP_AND_OUT || kind == PathPayoff::UP_AND_IN;
+                const bool knock_in = kind == PathPayoff::UP_AND_IN || kind == PathPayoff::DOWN_AND_IN;
+                const bool barrier = kind != PathPayoff::EUROPEAN && kind != PathPayoff::ASIAN;
+                const bool hit_at_start = barrier && (up ? underlying_price >= H : underlying_price <= H);
+                const double log_H = barrier ? std::log(H) : 0.0;
+                const Philox4x32 rng(settings.seed);
+
+                std::vector<ScrambledSobol> sequences;
+                std::unique_ptr<BrownianBridge> bridge;
+                const std::size_t sobol_dims = std::min(steps, SOBOL_DIMENSIONS);
+                if (sobol)
+                {
+                    sequences.reserve(replicates);
+                    for (std::size_t rep = 0; rep < replicates; ++rep)
+                    {
+                        sequences.emplace_back(sobol_dims, settings.seed, rep);
+                    }
+                    bridge.reset(new BrownianBridge(steps));
+                }
+
+                std::vector<detail::Moments> partial(replicates * chunks);
+                parallel::parallel_for(partial.size(), 1, [&](std::size_t chunk_begin, std::size_t chunk_end) {
+                    const std::size_t B = detail::BLOCK;
+                    std::vector<double> z(steps * B);
+                    std::vector<double> increments(sobol ? steps * B : 0);
+                    double log_S[2][B], sum_S[2][B];
+                    bool hit[2][B];
+                    const int legs = antithetic ? 2 : 1;
+
+                    for (std::size_t c = chunk_begin; c < chunk_end; ++c)
+                    {
+                        const std::size_t rep = c / chunks;
+                        const std::size_t local = c % chunks;
+                        detail::Moments acc;
+                        std::size_t block_end = std::min(blocks, (local + 1) * blocks_per_chunk);
+                        for (std::size_t blk = local * blocks_per_chunk; blk < block_end; ++blk)
+                        {
+                            std::size_t first = blk * B;
+                            std::size_t count = std::min(B, samples - first);
+                            const double *dz = z.data();
+                            if (sobol)
+                            {
+                                sequences[rep].fill(first, count, B, z.data(), B);
+                                fill_uniforms(rng, first, count, sobol_dims, steps,
+                                              0x80000000u | static_cast<std::uint32_t>(rep), z.data());
+                                simd::inverse_normal(z.data(), z.data(), steps * B);
+                                bridge->transform(z.data(), increments.data(), B);
+                                dz = increments.data();
+                            }
+                            else
+                            {
+                                fill_uniforms(rng, first, count, 0, steps, 0u, z.data());
+                                simd::inverse_normal(z.data(), z.data(), steps * B);
+                            }
+
+                            for (int leg = 0; leg < legs; ++leg)
+                            {
+                                std::fill(log_S[leg], log_S[leg] + B, log_S0);
+                                std::fill(sum_S[leg], sum_S[leg] + B, 0.0);
+                                std::fill(hit[leg], hit[leg] + B, hit_at_start);
+                            }
+                            for (std::size_t j = 0; j < steps; ++j)
+                            {
+                                const double *zj = dz + j * B;
+                                for (int leg = 0; leg < legs; ++leg)
+                                {
+                                    const double sign = leg == 0 ? diffusion : -diffusion;
+                                    for (std::size_t b = 0; b < B; ++b)
+                                    {
+                                        log_S[leg][b] += drift + sign * zj[b];
+                                    }
+                                    if (kind == PathPayoff::ASIAN)
+                                    {
+                                        for (std::size_t b = 0; b < B; ++b)
+                                        {
+                                            sum_S[leg][b] += std::exp(log_S[leg][b]);
+                                        }
+                                    }
+                                    else if (barrier)
+                                    {
+                                        for (std::size_t b = 0; b < B; ++b)
+                                        {
+                                            hit[leg][b] = hit[leg][b] || (up ? log_S[leg][b] >= log_H : log_S[leg][b] <= log_H);
+                                        }
+                                    }
+                                }
+                            }
+
+                            for (std::size_t b = 0; b < count; ++b)
+                            {
+                                double y = 0.0;
+                                double x = 0.0;
+                                for (int leg = 0; leg < legs; ++leg)
+                                {
+                                    double S_T = std::exp(log_S[leg][b]);
+                                    double payoff;
+                                    if (kind == PathPayoff::EUROPEAN)
+                                    {
+                                        payoff = vanilla(is_call, S_T, K);
+                                    }
+                                    else if (kind == PathPayoff::ASIAN)
+                                    {
+                                        payoff = vanilla(is_call, sum_S[leg][b] / static_cast<double>(steps), K);
+                                    }
+                                    else
+                                    {
+                                        payoff = hit[leg][b] == knock_in ? vanilla(is_call, S_T, K) : 0.0;
+                                    }
+                                    y += payoff;
+                                    x += kind == PathPayoff::EUROPEAN ? S_T : vanilla(is_call, S_T, K);
+                                }
+                                acc.add(discount * y / legs, discount * x / legs);
+                            }
+                        }
+                        partial[c] = acc;
+                    }
+                });
+
+                std::vector<detail::Moments> per_replicate(replicates);
+                detail::Moments total;
+                for (std::size_t rep = 0; rep < replicates; ++rep)
+                {
+                    for (std::size_t c = 0; c < chunks; ++c)
+                    {
+                        per_replicate[rep].merge(partial[rep * chunks + c]);
+                    }
+                    total.merge(per_replicate[rep]);
+                }
+
+                MCResult result;
+                result.paths = (antithetic ? 2 : 1) * samples * replicates;
+                const bool use_control = settings.control_variate && total.m2_x > 0.0;
+                const double control_mean = kind == PathPayoff::EUROPEAN
+                                                ? underlying_price * std::exp(-dividend_yield * time_to_maturity)
+                                                : (is_call ? control_model.call_price() : control_model.put_price());
+                const double beta = use_control ? total.c_xy / total.m2_x : 0.0;
+                if (sobol)
+                {
+                    // Replicates are i.i.d. unbiased estimates; their spread is the error bar
+                    detail::Moments spread;
+                    for (const detail::Moments &m : per_replicate)
+                    {
+                        spread.add(m.mean_y - beta * (m.mean_x - control_mean), 0.0);
+                    }
+                    result.price = spread.mean_y;
+                    result.std_error = std::sqrt(spread.m2_y / (spread.n - 1.0) / spread.n);
+                    return result;
+                }
+                const double n = total.n;
+                if (use_control)
+                {
+                    double residual = std::max(total.m2_y - beta * total.c_xy, 0.0);
+                    result.price = total.mean_y - beta * (total.mean_x - control_mean);
+                    result.std_error = std::sqrt(residual / (n - 1.0) / n);
+                }
+                else
+                {
+                    result.price = total.mean_y;
+                    result.std_error = std::sqrt(total.m2_y / (n - 1.0) / n);
+                }
+                return result;
+            }
+
+            double get_underlying_price() const { return underlying_price; }
+            double get_risk_free_rate() const { return risk_free_rate; }
+            double get_time_to_maturity() const { return time_to_maturity; }
+            double get_volatility() const { return volatility; }
+            double get_dividend_yield() const { return dividend_yield; }
+        };
+    }
+}
+
+#endif // OPTIPRICER_MONTECARLO_HPP
@@ -0,0 +1,295 @@
+#ifndef OPTIPRICER_PARALLEL_HPP
+#define OPTIPRICER_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace optipricer
+{
+    namespace parallel
+    {
+        inline unsigned hardware_threads()
+        {
+            unsigned n = std::thread::hardware_concurrency();
+            return n == 0 ? 1u : n;
+        }
+
+        /**
+         * @brief Persistent pool behind parallel_for().
+         *
+         * A job is cut into grain-sized chunks and the chunk indices are dealt
+         * out as one contiguous run per participant. A participant drains its
+         * own run first and then steals single chunks from the others, so a
+         * slow region (e.g. quotes that need many IV iterations) does not leave
+         * cores idle. Every index is still written by the same code whichever
+         * thread runs it, which keeps results deterministic.
+         *
+         * One job runs at a time. A call that arrives while the pool is busy,
+         * or from inside a pool task, runs inline on the calling thread.
+         */
+        class ThreadPool
+        {
+        private:
+            // Padded rather than alignas(64): over-aligned new needs C++17
+            struct Run
+            {
+                std::atomic<std::size_t> next;
+                std::size_t end;
+                char padding[64 - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+            };
+
+            struct Job
+            {
+                void (*invoke)(void *, std::size_t, std::size_t);
+                void *fn;
+                std::size_t n;
+                std::size_t grain;
+                std::size_t participants;
+                Run *runs;
+                std::exception_ptr *errors;
+                std::atomic<bool> failed;
+            };
+
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable finished;
+            std::mutex submit_mutex;
+            std::vector<std::thread> workers;
+            // Per-participant bookkeeping reused by every job (guarded by submit_mutex),
+            // so a steady stream of jobs does not allocate
+            std::unique_ptr<Run[]> runs;
+            std::vector<std::exception_ptr> errors;
+            std::size_t runs_capacity = 0;
+            std::atomic<unsigned> configured;
+            Job *job;
+            unsigned long long generation;
+            std::size_t pending;
+            bool stopping;
+
+            static bool &inside_task()
+            {
+                static thread_local bool flag = false;
+                return flag;
+            }
+
+            static bool take_chunk(Job &job, std::size_t run, std::size_t &chunk)
+            {
+                Run &r = job.runs[run];
+                if (r.next.load(std::memory_order_relaxed) >= r.end)
+                {
+                    return false;
+                }
+                chunk = r.next.fetch_add(1, std::memory_order_relaxed);
+                return chunk < r.end;
+            }
+
+            static void participate(Job &job, std::size_t id)
+            {
+                inside_task() = true;
+                try
+                {
+                    for (std::size_t k = 0; k < job.participants; ++k)
+                    {
+                        std::size_t run = (id + k) % job.participants;
+                        std::size_t chunk;
+                        while (!job.failed.load(std::memory_order_relaxed) && take_chunk(job, run, chunk))
+                        {
+                            std::size_t begin = chunk * job.grain;
+                            job.invoke(job.fn, begin, std::min(job.n, begin + job.grain));
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    job.errors[id] = std::current_exception();
+                    job.failed.store(true, std::memory_order_relaxed);
+                }
+                inside_task() = false;
+            }
+
+            void worker_loop(std::size_t id, unsigned long long seen)
+            {
+                for (;;)
+                {
+                    Job *current;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        wake.wait(lock, [&] { return stopping || generation != seen; });
+                        if (stopping)
+                        {
+                            return;
+                        }
+                        seen = generation;
+                        current = job;
+                    }
+                    if (id < current->participants)
+                    {
+                        participate(*current, id);
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (--pending == 0)
+                        {
+                            finished.notify_one();
+                        }
+                    }
+                }
+            }
+
+            void stop_workers()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_all();
+                for (auto &w : workers)
+                {
+                    w.join();
+                }
+                workers.clear();
+                stopping = false;
+            }
+
+            void start_workers()
+            {
+                // The calling thread is participant 0
+                unsigned long long seen = generation;
+                for (unsigned t = 1; t < configured; ++t)
+                {
+                    workers.emplace_back([this, t, seen]() { worker_loop(t, seen); });
+                }
+            }
+
+            ThreadPool() : configured(hardware_threads()), job(nullptr), generation(0), pending(0), stopping(false) {}
+
+        public:
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            /**
+             * @brief Process-wide pool. Intentionally leaked: joining threads from
+             * static destructors can deadlock while an extension module unloads.
+             */
+            static ThreadPool &instance()
+            {
+                static ThreadPool *pool = new ThreadPool();
+                return *pool;
+            }
+
+            unsigned num_threads() const { return configured.load(); }
+
+            /**
+             * @brief Resizes the pool; 0 selects the hardware thread count
+             */
+            void set_num_threads(unsigned n)
+            {
+                std::lock_guard<std::mutex> submit(submit_mutex);
+                unsigned target = n == 0 ? hardware_threads() : n;
+                if (target == configured)
+                {
+                    return;
+                }
+                stop_workers();
+                configured = target;
+            }
+
+            template <typename Fn>
+            void run(std::size_t n, std::size_t grain, Fn &fn)
+            {
+                grain = std::max<std::size_t>(grain, 1);
+                std::size_t chunks = (n + grain - 1) / grain;
+                if (chunks <= 1 || configured <= 1 || inside_task())
+                {
+                    fn(std::size_t(0), n);
+                    return;
+                }
+                std::unique_lock<std::mutex> submit(submit_mutex, std::try_to_lock);
+                if (!submit.owns_lock())
+                {
+                    fn(std::size_t(0), n);
+                    return;
+                }
+                if (workers.empty())
+                {
+                    start_workers();
+                }
+
+                Job j;
+                j.invoke = [](void *f, std::size_t begin, std::size_t end) { (*static_cast<Fn *>(f))(begin, end); };
+                j.fn = &fn;
+                j.n = n;
+                j.grain = grain;
+                j.participants = std::min<std::size_t>(configured, chunks);
+                if (runs_capacity < j.participants)
+                {
+                    runs.reset(new Run[j.participants]);
+                    errors.resize(j.participants);
+                    runs_capacity = j.participants;
+                }
+                j.runs = runs.get();
+                j.errors = errors.data();
+                for (std::size_t p = 0; p < j.participants; ++p)
+                {
+                    j.runs[p].next.store(chunks * p / j.participants, std::memory_order_relaxed);
+                    j.runs[p].end = chunks * (p + 1) / j.participants;
+                }
+                j.failed.store(false, std::memory_order_relaxed);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    job = &j;
+                    pending = workers.size();
+                    ++generation;
+                }
+                wake.notify_all();
+                participate(j, 0);
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    finished.wait(lock, [&] { return pending == 0; });
+                    job = nullptr;
+                }
+
+                std::exception_ptr error;
+                for (std::size_t p = 0; p < j.participants; ++p)
+                {
+                    if (j.errors[p] && !error)
+                    {
+                        error = j.errors[p];
+                    }
+                    j.errors[p] = nullptr;
+                }
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+
+        inline unsigned get_num_threads() { return ThreadPool::instance().num_threads(); }
+        inline void set_num_threads(unsigned n) { ThreadPool::instance().set_num_threads(n); }
+
+        /**
+         * @brief Runs fn(begin, end) over [0, n) on the shared thread pool.
+         *
+         * Work is handed out in chunks of `grain` elements, so small inputs
+         * stay on the calling thread. Chunks are disjoint, which keeps results
+         * written by index deterministic. The first exception thrown by any
+         * chunk is rethrown on the calling thread once all chunks have stopped.
+         */
+        template <typename Fn>
+        void parallel_for(std::size_t n, std::size_t grain, Fn fn)
+        {
+            ThreadPool::instance().run(n, grain, fn);
+        }
+    }
+}
+
+#endif // OPTIPRICER_PARALLEL_HPP
@@ -0,0 +1,359 @@
+#ifndef OPTIPRICER_PARITY_HPP
+#define OPTIPRICER_PARITY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "parallel.hpp"
+#include "utils.hpp"
+
+/*
+ * Implied forward and dividend yield per expiry from put-call parity.
+ *
+ * For European options C - P = S e^{-qT} - K e^{-rT}, so across the strikes
+ * of one expiry the call-put difference is a straight line in K: the
+ * intercept is the discounted spot S e^{-qT} and the slope minus the
+ * discount factor. With the rate given only the intercept is fitted; with
+ * fit_rate the discount factor is regressed too. Either way the fit gives
+ * the forward F = S e^{-qT} / e^{-rT} and the carry the market is pricing,
+ * which a flat user-supplied q misses when it differs between expiries.
+ *
+ * Stale or mispriced strikes (typically deep in the money) are rejected by
+ * refitting without quotes whose parity residual exceeds outlier_threshold
+ * robust standard deviations (1.4826 times the median absolute residual).
+ * Quotes may carry weights, e.g. inverse squared spreads.
+ */
+
+namespace optipricer
+{
+    namespace parity
+    {
+        // Residuals beyond this many robust standard deviations drop out of the fit
+        constexpr double DEFAULT_OUTLIER_THRESHOLD = 4.0;
+
+        struct ParityFit
+        {
+            double expiry;
+            double forward;
+            // The given rate, or the regressed one with fit_rate
+            double rate;
+            double dividend_yield;
+            double discount_factor;
+            // Weighted RMS parity residual of the quotes used, in price units
+            double rmse;
+            // Call/put pairs quoted at this expiry, and those left after outlier rejection
+            int num_quotes;
+            int num_used;
+        };
+
+        // Rate and dividend yield to price an expiry with
+        struct Carry
+        {
+            double rate;
+            double dividend_yield;
+        };
+
+        namespace detail
+        {
+            // Passes of outlier rejection; a pass that changes nothing ends the fit early
+            constexpr int MAX_PASSES = 10;
+
+            inline void check_market(double S, double r)
+            {
+                if (!(S > 0.0) || !std::isfinite(S))
+                {
+                    throw std::invalid_argument("Underlying price must be positive and finite, got: " + std::to_string(S));
+                }
+                if (!std::isfinite(r))
+                {
+                    throw std::invalid_argument("Risk-free rate must be finite, got: " + std::to_string(r));
+                }
+            }
+
+            // NaN prices mark a missing quote; anything else must be a usable number
+            inline void check_quote(std::size_t i, double K, double call, double put, double weight)
+            {
+                if (!(K > 0.0) || !std::isfinite(K))
+                {
+                    throw std::invalid_argument("Invalid quote at index " + std::to_string(i) +
+                                                ": strike must be positive and finite");
+                }
+                if ((!std::isnan(call) && !(call >= 0.0 && std::isfinite(call))) ||
+                    (!std::isnan(put) && !(put >= 0.0 && std::isfinite(put))))
+                {
+                    throw std::invalid_argument("Invalid quote at index " + std::to_string(i) +
+                                                ": prices must be non-negative and finite, or NaN if missing");
+                }
+                if (!(weight >= 0.0) || !std::isfinite(weight))
+                {
+                    throw std::invalid_argument("Invalid quote at index " + std::to_string(i) +
+                                                ": weight must be non-negative and finite");
+                }
+            }
+
+            inline double median(std::vector<double> &values)
+            {
+                auto mid = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+                std::nth_element(values.begin(), mid, values.end());
+                double upper = *mid;
+                if (values.size() % 2 == 1)
+                {
+                    return upper;
+                }
+                return 0.5 * (upper + *std::max_element(values.begin(), mid));
+            }
+        }
+
+        /**
+         * @brief Forward and dividend yield of one expiry from its call/put quotes.
+         *
+         * Pairs with a NaN call or put, or zero weight, are skipped; weight may
+         * be nullptr for equal weights. Throws std::invalid_argument when too few
+         * pairs remain (one, or two distinct strikes with fit_rate) or the fit
+         * implies a non-positive discounted spot or discount factor. An
+         * outlier_threshold of 0 disables rejection.
+         */
+        inline ParityFit fit_expiry(double S, double r, double T, const double *K, const double *call,
+                                    const double *put, const double *weight, std::size_t n, bool fit_rate = false,
+                                    double outlier_threshold = DEFAULT_OUTLIER_THRESHOLD)
+        {
+            detail::check_market(S, r);
+            if (!(T > 0.0) || !std::isfinite(T))
+            {
+                throw std::invalid_argument("Time to maturity must be positive and finite, got: " + std::to_string(T));
+            }
+            std::vector<double> k, y, w;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const double wi = weight ? weight[i] : 1.0;
+                detail::check_quote(i, K[i], call[i], put[i], wi);
+                if (std::isnan(call[i]) || std::isnan(put[i]) || wi == 0.0)
+                {
+                    continue;
+                }
+                k.push_back(K[i]);
+                y.push_back(call[i] - put[i]);
+                w.push_back(wi);
+            }
+            const std::size_t m = k.size();
+            const std::size_t min_pairs = fit_rate ? 2 : 1;
+            if (m < min_pairs)
+            {
+                throw std::invalid_argument("Put-call parity at T=" + std::to_string(T) + " needs at least " +
+                                            std::to_string(min_pairs) + " call/put pairs, got " + std::to_string(m));
+            }
+
+            // Weighted least squares of y = A - D K over the quotes in use
+            std::vector<char> used(m, 1), next(m);
+            std::vector<double> residual(m), spread;
+            double A = 0.0, D = std::exp(-r * T);
+            auto solve = [&]() {
+                double sw = 0.0, sk = 0.0, sy = 0.0;
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    if (used[i])
+                    {
+                        sw += w[i];
+                        sk += w[i] * k[i];
+                        sy += w[i] * y[i];
+                    }
+                }
+                const double k_mean = sk / sw, y_mean = sy / sw;
+                if (fit_rate)
+                {
+                    double sxx = 0.0, sxy = 0.0;
+                    for (std::size_t i = 0; i < m; ++i)
+                    {
+                        if (used[i])
+                        {
+                            sxx += w[i] * (k[i] - k_mean) * (k[i] - k_mean);
+                            sxy += w[i] * (k[i] - k_mean) * (y[i] - y_mean);
+                        }
+                    }
+                    if (!(sxx > 0.0))
+                    {
+                        throw std::invalid_argument("Put-call parity at T=" + std::to_string(T) +
+                                                    " needs two distinct strikes to fit the rate");
+                    }
+                    D = -sxy / sxx;
+                }
+                A = y_mean + D * k_mean;
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    residual[i] = y[i] - (A - D * k[i]);
+                }
+            };
+
+            solve();
+            for (int pass = 0; pass < detail::MAX_PASSES && outlier_threshold > 0.0; ++pass)
+            {
+                spread.clear();
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    if (used[i])
+                    {
+                        spread.push_back(std::abs(residual[i]));
+                    }
+                }
+                // The floor keeps an exact fit from rejecting quotes over rounding noise
+                const double scale = std::max(1.4826 * detail::median(spread), 1e-9 * S);
+                std::size_t kept = 0;
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    next[i] = std::abs(residual[i]) <= outlier_threshold * scale;
+                    kept += next[i] ? 1 : 0;
+                }
+                if (kept < min_pairs || next == used)
+                {
+                    break;
+                }
+                used.swap(next);
+                solve();
+            }
+
+            if (!(A > 0.0))
+            {
+                throw std::invalid_argument("Put-call parity at T=" + std::to_string(T) +
+                                            " implies a non-positive discounted spot");
+            }
+            if (!(D > 0.0))
+            {
+                throw std::invalid_argument("Put-call parity at T=" + std::to_string(T) +
+                                            " implies a non-positive discount factor");
+            }
+
+            ParityFit fit;
+            fit.expiry = T;
+            fit.discount_factor = D;
+            fit.forward = A / D;
+            fit.rate = fit_rate ? -std::log(D) / T : r;
+            fit.dividend_yield = -std::log(A / S) / T;
+            double sw = 0.0, sse = 0.0;
+            int num_used = 0;
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                if (used[i])
+                {
+                    sw += w[i];
+                    sse += w[i] * residual[i] * residual[i];
+                    ++num_used;
+                }
+            }
+            fit.rmse = std::sqrt(sse / sw);
+            fit.num_quotes = static_cast<int>(m);
+            fit.num_used = num_used;
+            return fit;
+        }
+
+        /**
+         * @brief Fits every expiry of n call/put quotes, in parallel across expiries.
+         *
+         * Rows are grouped by exact expiry, as SviSurface calibration groups
+         * them, and the fits come back ordered by expiry. weight.data may be
+         * nullptr for equal weights. Any expiry that cannot be fitted throws.
+         */
+        inline std::vector<ParityFit> calibrate(double S, double r, utils::Column<double> T, utils::Column<double> K,
+                                                utils::Column<double> call, utils::Column<double> put,
+                                                utils::Column<double> weight, std::size_t n, bool fit_rate = false,
+                                                double outlier_threshold = DEFAULT_OUTLIER_THRESHOLD)
+        {
+            detail::check_market(S, r);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (!(T[i] > 0.0) || !std::isfinite(T[i]))
+                {
+                    throw std::invalid_argument("Invalid quote at index " + std::to_string(i) +
+                                                ": expiry must be positive and finite");
+                }
+                detail::check_quote(i, K[i], call[i], put[i], weight.data ? weight[i] : 1.0);
+            }
+            std::vector<std::size_t> order(n);
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            std::stable_sort(order.begin(), order.end(), [&T](std::size_t a, std::size_t b) { return T[a] < T[b]; });
+
+            struct Expiry
+            {
+                double T;
+                std::vector<double> K, call, put, weight;
+            };
+            std::vector<Expiry> expiries;
+            for (std::size_t i : order)
+            {
+                if (expiries.empty() || expiries.back().T != T[i])
+                {
+                    expiries.push_back({T[i], {}, {}, {}, {}});
+                }
+                Expiry &e = expiries.back();
+                e.K.push_back(K[i]);
+                e.call.push_back(call[i]);
+                e.put.push_back(put[i]);
+                e.weight.push_back(weight.data ? weight[i] : 1.0);
+            }
+
+            std::vector<ParityFit> fits(expiries.size());
+            parallel::parallel_for(expiries.size(), 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t j = begin; j < end; ++j)
+                {
+                    const Expiry &e = expiries[j];
+                    fits[j] = fit_expiry(S, r, e.T, e.K.data(), e.call.data(), e.put.data(), e.weight.data(),
+                                         e.K.size(), fit_rate, outlier_threshold);
+                }
+            });
+            return fits;
+        }
+
+        /**
+         * @brief Rate and dividend yield at expiry T from fits ordered by expiry.
+         *
+         * At a fitted expiry this is exactly its fit. Between two, the total
+         * carries r T and q T (so the log forward) are interpolated linearly in
+         * T; outside the fitted range the nearest fit is held flat.
+         */
+        inline Carry carry_at(const std::vector<ParityFit> &fits, double T)
+        {
+            if (fits.empty())
+            {
+                throw std::invalid_argument("Carry needs at least one parity fit");
+            }
+            if (!(T > fits.front().expiry))
+            {
+                return {fits.front().rate, fits.front().dividend_yield};
+            }
+            if (T >= fits.back().expiry)
+            {
+                return {fits.back().rate, fits.back().dividend_yield};
+            }
+            auto it = std::upper_bound(fits.begin(), fits.end(), T,
+                                       [](double t, const ParityFit &f) { return t < f.expiry; });
+            const ParityFit &hi = *it, &lo = *(it - 1);
+            const double t = (T - lo.expiry) / (hi.expiry - lo.expiry);
+            const double rate_T = lo.rate * lo.expiry + t * (hi.rate * hi.expiry - lo.rate * lo.expiry);
+            const double q_T = lo.dividend_yield * lo.expiry + t * (hi.dividend_yield * hi.expiry - lo.dividend_yield * lo.expiry);
+            return {rate_T / T, q_T / T};
+        }
+
+        /**
+         * @brief Per-row rate and dividend yield columns for n expiries, e.g. for the batch IV solver
+         */
+        inline void carry_batch(const std::vector<ParityFit> &fits, utils::Column<double> T, double *rate,
+                                double *dividend_yield, std::size_t n)
+        {
+            if (fits.empty())
+            {
+                throw std::invalid_argument("Carry needs at least one parity fit");
+            }
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                Carry c = carry_at(fits, T[i]);
+                rate[i] = c.rate;
+                dividend_yield[i] = c.dividend_yield;
+            }
+        }
+    }
+}
+
+#endif // OPTIPRICER_PARITY_HPP
@@ -0,0 +1,674 @@
+#ifndef OPTIPRICER_PDE_HPP
+#define OPTIPRICER_PDE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "greeks.hpp"
+#include "models.hpp"
+#include "parallel.hpp"
+#include "utils.hpp"
+
+namespace optipricer
+{
+    namespace pde
+    {
+        using utils::Column;
+
+        enum class BarrierType
+        {
+            NONE,
+            UP_AND_OUT,   // Continuously monitored; zero rebate
+            DOWN_AND_OUT,
+            UP_AND_IN,    // European only: vanilla minus the matching knock-out
+            DOWN_AND_IN
+        };
+
+        struct PDESettings
+        {
+            std::size_t space_steps = 400;
+            std::size_t time_steps = 200;
+            bool american = true;
+            BarrierType barrier = BarrierType::NONE;
+            double barrier_level = std::numeric_limits<double>::quiet_NaN();
+            bool sensitivities = true; // vega, rho, vanna and volga from re-solves on the same grid
+        };
+
+        /**
+         * @brief Per-unit price and Greeks of one option, in the units of models::AllGreeks.
+         *
+         * vega and rho are per 1% move, theta and charm per calendar day;
+         * vega, rho, vanna and volga are NaN when sensitivities are off.
+         */
+        struct PDEResult
+        {
+            double price;
+            double delta;
+            double gamma;
+            double vega;
+            double theta;
+            double rho;
+            double vanna;
+            double volga;
+            double charm;
+        };
+
+        namespace detail
+        {
+            // Grid half-width in standard deviations of log-spot beyond the spot and the strikes
+            constexpr double WIDTH_SD = 6.0;
+
+            // Columns per backward solve; keeps the node-major buffers in cache
+            constexpr std::size_t COLUMNS_PER_SOLVE = 64;
+
+            // Uniform grid in x = log(S); the spot is always a node
+            struct Grid
+            {
+                double x_lo;
+                double h;
+                std::size_t last; // Index of the upper boundary node
+                std::size_t spot;
+                bool lower_barrier;
+                bool upper_barrier;
+            };
+
+            inline bool is_up(BarrierType b) { return b == BarrierType::UP_AND_OUT || b == BarrierType::UP_AND_IN; }
+            inline bool is_down(BarrierType b) { return b == BarrierType::DOWN_AND_OUT || b == BarrierType::DOWN_AND_IN; }
+            inline bool is_knock_in(BarrierType b) { return b == BarrierType::UP_AND_IN || b == BarrierType::DOWN_AND_IN; }
+
+            inline Grid make_grid(double S, double sigma, double T, double k_min, double k_max,
+                                  const PDESettings &settings)
+            {
+                const double x0 = std::log(S);
+                const double width = WIDTH_SD * sigma * std::sqrt(T);
+                double lo = std::min(x0, std::log(k_min)) - width;
+                double hi = std::max(x0, std::log(k_max)) + width;
+                Grid g;
+                g.lower_barrier = is_down(settings.barrier);
+                g.upper_barrier = is_up(settings.barrier);
+                if (g.lower_barrier)
+                {
+                    lo = std::log(settings.barrier_level);
+                }
+                if (g.upper_barrier)
+                {
+                    hi = std::log(settings.barrier_level);
+                }
+                const double target = (hi - lo) / static_cast<double>(settings.space_steps);
+                std::size_t below, above;
+                if (g.lower_barrier)
+                {
+                    below = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil((x0 - lo) / target)));
+                    g.h = (x0 - lo) / static_cast<double>(below);
+                    above = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil((hi - x0) / g.h)));
+                }
+                else if (g.upper_barrier)
+                {
+                    above = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil((hi - x0) / target)));
+                    g.h = (hi - x0) / static_cast<double>(above);
+                    below = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil((x0 - lo) / g.h)));
+                }
+                else
+                {
+                    g.h = target;
+                    below = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil((x0 - lo) / g.h)));
+                    above = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil((hi - x0) / g.h)));
+                }
+                g.spot = below;
+                g.last = below + above;
+                g.x_lo = x0 - static_cast<double>(below) * g.h;
+                return g;
+            }
+
+            /**
+             * @brief Thomas factorization of a constant tridiagonal matrix (l, d, u), reused every step.
+             *
+             * `upward` eliminates from the top node down (UL), which lets the
+             * back substitution for puts run from the exercise region upward
+             * (Brennan-Schwartz); calls use the usual LU order.
+             */
+            struct Factorization
+            {
+                double lower;
+                double upper;
+                std::vector<double> c;
+                std::vector<double> inv;
+
+                void factor(double l, double d, double u, std::size_t interior, bool upward)
+                {
+                    lower = l;
+                    upper = u;
+                    c.resize(interior);
+                    inv.resize(interior);
+                    if (!upward)
+                    {
+                        for (std::size_t i = 0; i < interior; ++i)
+                        {
+                            double den = i == 0 ? d : d - l * c[i - 1];
+                            inv[i] = 1.0 / den;
+                            c[i] = u * inv[i];
+                        }
+                    }
+                    else
+                    {
+                        for (std::size_t i = interior; i-- > 0;)
+                        {
+                            double den = i + 1 == interior ? d : d - u * c[i + 1];
+                            inv[i] = 1.0 / den;
+                            c[i] = l * inv[i];
+                        }
+                    }
+                }
+            };
+
+            /**
+             * @brief Buffers of one backward solve, sized once and reused for every time step.
+             *
+             * Values are node-major (v[i * columns + k]) so each sweep of the
+             * Thomas solve runs across all columns at once.
+             */
+            struct Workspace
+            {
+                std::vector<double> v;
+                std::vector<double> rhs;
+                std::vector<double> exercise;
+                std::vector<double> low;
+                std::vector<double> high;
+                Factorization implicit_lu, implicit_ul, cn_lu, cn_ul;
+            };
+
+            /**
+             * @brief One backward solve for `n` strikes sharing the grid; calls come first.
+             *
+             * Writes the values at the nodes below, at and above the spot to
+             * out[k * 6 + 0..2] at tau = T and to out[k * 6 + 3..5] one step
+             * earlier (see last_step()). The first two steps are four implicit
+             * half-steps (Rannacher) to damp the payoff kink; Crank-Nicolson
+             * takes the rest.
+             */
+            inline void march(const Grid &g, double r, double sigma, double q, double T, const PDESettings &settings,
+                                const double *strikes, std::size_t n_calls, std::size_t n, Workspace &ws, double *out)
+            {
+                const std::size_t nodes = g.last + 1;
+                const std::size_t interior = nodes - 2;
+                const bool american = settings.american;
+                const double h = g.h;
+
+                ws.v.assign(nodes * n, 0.0);
+                ws.rhs.resize(nodes * n);
+                ws.low.resize(n);
+                ws.high.resize(n);
+                if (american)
+                {
+                    ws.exercise.resize(nodes * n);
+                }
+
+                // Terminal payoff; the cell holding the strike gets its average so the kink does not alias
+                for (std::size_t i = 0; i < nodes; ++i)
+                {
+                    const double x = g.x_lo + static_cast<double>(i) * h;
+                    const double s = std::exp(x);
+                    const double xa = x - 0.5 * h;
+                    const double xb = x + 0.5 * h;
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        const double K = strikes[k];
+                        const bool call = k < n_calls;
+                        const double lk = std::log(K);
+                        double payoff;
+                        if (lk > xa && lk < xb)
+                        {
+                            payoff = call ? (std::exp(xb) - K - K * (xb - lk)) / h
+                                          : (K * (lk - xa) - (K - std::exp(xa))) / h;
+                        }
+                        else
+                        {
+                            payoff = call ? std::max(s - K, 0.0) : std::max(K - s, 0.0);
+                        }
+                        ws.v[i * n + k] = payoff;
+                        if (american)
+                        {
+                            ws.exercise[i * n + k] = call ? std::max(s - K, 0.0) : std::max(K - s, 0.0);
+                        }
+                    }
+                }
+                if (g.lower_barrier)
+                {
+                    std::fill(ws.v.begin(), ws.v.begin() + n, 0.0);
+                }
+                if (g.upper_barrier)
+                {
+                    std::fill(ws.v.begin() + g.last * n, ws.v.end(), 0.0);
+                }
+
+                const double a = 0.5 * sigma * sigma / (h * h);
+                const double b = (r - q - 0.5 * sigma * sigma) / (2.0 * h);
+                const double op_lower = a - b;
+                const double op_diag = -(2.0 * a + r);
+                const double op_upper = a + b;
+
+                const std::size_t steps = settings.time_steps;
+                const double dt = T / static_cast<double>(steps);
+                const double half = 0.5 * dt;
+                ws.implicit_lu.factor(-half * op_lower, 1.0 - half * op_diag, -half * op_upper, interior, false);
+                ws.implicit_ul.factor(-half * op_lower, 1.0 - half * op_diag, -half * op_upper, interior, true);
+                ws.cn_lu.factor(-0.5 * dt * op_lower, 1.0 - 0.5 * dt * op_diag, -0.5 * dt * op_upper, interior, false);
+                ws.cn_ul.factor(-0.5 * dt * op_lower, 1.0 - 0.5 * dt * op_diag, -0.5 * dt * op_upper, interior, true);
+
+                const double s_lo = std::exp(g.x_lo);
+                const double s_hi = std::exp(g.x_lo + static_cast<double>(g.last) * h);
+
+                // Advances tau by `delta` with weight theta on the new level (1 = implicit, 0.5 = CN)
+                auto step = [&](double tau, double delta, double theta, const Factorization &lu, const Factorization &ul) {
+                    const double df_r = std::exp(-r * tau);
+                    const double df_q = std::exp(-q * tau);
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        const double K = strikes[k];
+                        const bool call = k < n_calls;
+                        double lo = 0.0, hi = 0.0;
+                        if (!g.lower_barrier && !call)
+                        {
+                            lo = std::max(K * df_r - s_lo * df_q, american ? K - s_lo : 0.0);
+                        }
+                        if (!g.upper_barrier && call)
+                        {
+                            hi = std::max(s_hi * df_q - K * df_r, american ? s_hi - K : 0.0);
+                        }
+                        ws.low[k] = lo;
+                        ws.high[k] = hi;
+                    }
+
+                    const double explicit_w = (1.0 - theta) * delta;
+                    for (std::size_t i = 1; i <= interior; ++i)
+                    {
+                        const double *vm = &ws.v[(i - 1) * n];
+                        const double *v0 = &ws.v[i * n];
+                        const double *vp = &ws.v[(i + 1) * n];
+                        double *dst = &ws.rhs[i * n];
+                        for (std::size_t k = 0; k < n; ++k)
+                        {
+                            dst[k] = v0[k] + explicit_w * (op_lower * vm[k] + op_diag * v0[k] + op_upper * vp[k]);
+                        }
+                    }
+                    const double implicit_w = theta * delta;
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        ws.rhs[n + k] += implicit_w * op_lower * ws.low[k];
+                        ws.rhs[interior * n + k] += implicit_w * op_upper * ws.high[k];
+                    }
+
+                    // Calls: forward elimination, back substitution from the top
+                    if (n_calls > 0)
+                    {
+                        for (std::size_t i = 1; i <= interior; ++i)
+                        {
+                            double *y = &ws.rhs[i * n];
+                            const double *prev = &ws.rhs[(i - 1) * n];
+                            const double inv = lu.inv[i - 1];
+                            for (std::size_t k = 0; k < n_calls; ++k)
+                            {
+                                y[k] = (i == 1 ? y[k] : y[k] - lu.lower * prev[k]) * inv;
+                            }
+                        }
+                        for (std::size_t i = interior; i >= 1; --i)
+                        {
+                            double *x = &ws.v[i * n];
+                            const double *y = &ws.rhs[i * n];
+                            const double *next = i == interior ? ws.high.data() : &ws.v[(i + 1) * n];
+                            const double c = i == interior ? 0.0 : lu.c[i - 1];
+                            for (std::size_t k = 0; k < n_calls; ++k)
+                            {
+                                x[k] = y[k] - c * next[k];
+                            }
+                            if (american)
+                            {
+                                const double *e = &ws.exercise[i * n];
+                                for (std::size_t k = 0; k < n_calls; ++k)
+                                {
+                                    x[k] = std::max(x[k], e[k]);
+                                }
+                            }
+                        }
+                    }
+                    // Puts: elimination from the top, back substitution from the bottom
+                    if (n_calls < n)
+                    {
+                        for (std::size_t i = interior; i >= 1; --i)
+                        {
+                            double *y = &ws.rhs[i * n];
+                            const double *prev = &ws.rhs[(i + 1) * n];
+                            const double inv = ul.inv[i - 1];
+                            for (std::size_t k = n_calls; k < n; ++k)
+                            {
+                                y[k] = (i == interior ? y[k] : y[k] - ul.upper * prev[k]) * inv;
+                            }
+                        }
+                        for (std::size_t i = 1; i <= interior; ++i)
+                        {
+                            double *x = &ws.v[i * n];
+                            const double *y = &ws.rhs[i * n];
+                            const double *below = i == 1 ? ws.low.data() : &ws.v[(i - 1) * n];
+                            const double c = i == 1 ? 0.0 : ul.c[i - 1];
+                            for (std::size_t k = n_calls; k < n; ++k)
+                            {
+                                x[k] = y[k] - c * below[k];
+                            }
+                            if (american)
+                            {
+                                const double *e = &ws.exercise[i * n];
+                                for (std::size_t k = n_calls; k < n; ++k)
+                                {
+                                    x[k] = std::max(x[k], e[k]);
+                                }
+                            }
+                        }
+                    }
+                    std::copy(ws.low.begin(), ws.low.end(), ws.v.begin());
+                    std::copy(ws.high.begin(), ws.high.end(), ws.v.begin() + g.last * n);
+                };
+
+                auto record = [&](std::size_t offset) {
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        for (std::size_t j = 0; j < 3; ++j)
+                        {
+                            out[k * 6 + offset + j] = ws.v[(g.spot - 1 + j) * n + k];
+                        }
+                    }
+                };
+
+                // Rannacher start: two steps as four implicit half-steps
+                double tau = 0.0;
+                for (int j = 0; j < 4; ++j)
+                {
+                    if (j == 3 && steps == 2)
+                    {
+                        record(3);
+                    }
+                    tau += half;
+                    step(tau, half, 1.0, ws.implicit_lu, ws.implicit_ul);
+                }
+                for (std::size_t j = 2; j < steps; ++j)
+                {
+                    if (j + 1 == steps)
+                    {
+                        record(3);
+                    }
+                    tau = static_cast<double>(j + 1) * dt;
+                    step(tau, dt, 0.5, ws.cn_lu, ws.cn_ul);
+                }
+                record(0);
+            }
+
+            // Length of the step between the two levels march() records
+            inline double last_step(double T, const PDESettings &settings)
+            {
+                const double dt = T / static_cast<double>(settings.time_steps);
+                return settings.time_steps == 2 ? 0.5 * dt : dt;
+            }
+
+            inline void check(double sigma, const PDESettings &settings)
+            {
+                if (!(sigma > 0.0))
+                {
+                    throw std::invalid_argument("PDE pricing needs a positive volatility, got: " + std::to_string(sigma));
+                }
+                if (settings.space_steps < 20 || settings.space_steps > 20000)
+                {
+                    throw std::invalid_argument("Number of PDE space steps must be in [20, 20000], got: " +
+                                                std::to_string(settings.space_steps));
+                }
+                if (settings.time_steps < 2 || settings.time_steps > 100000)
+                {
+                    throw std::invalid_argument("Number of PDE time steps must be in [2, 100000], got: " +
+                                                std::to_string(settings.time_steps));
+                }
+                if (settings.barrier != BarrierType::NONE)
+                {
+                    if (!(settings.barrier_level > 0.0) || !std::isfinite(settings.barrier_level))
+                    {
+                        throw std::invalid_argument("Barrier must be positive and finite");
+                    }
+                    if (settings.american && is_knock_in(settings.barrier))
+                    {
+                        throw std::invalid_argument("Knock-in barriers are priced as European options; set american to false");
+                    }
+                }
+            }
+
+            // The barrier has already been touched at the valuation date
+            inline bool knocked(double S, const PDESettings &settings)
+            {
+                return (is_up(settings.barrier) && S >= settings.barrier_level) ||
+                       (is_down(settings.barrier) && S <= settings.barrier_level);
+            }
+
+            inline PDEResult from_closed_form(const models::AllGreeks &g, bool is_call)
+            {
+                return {is_call ? g.call_price : g.put_price,
+                        is_call ? g.call_delta : g.put_delta,
+                        g.gamma,
+                        g.vega,
+                        is_call ? g.call_theta : g.put_theta,
+                        is_call ? g.call_rho : g.put_rho,
+                        g.vanna,
+                        g.volga,
+                        is_call ? g.call_charm : g.put_charm};
+            }
+
+            // Spot delta from the three recorded values around the spot
+            inline double delta_at(const double *v, double S, double h)
+            {
+                return (v[2] - v[0]) / (2.0 * h * S);
+            }
+
+            /**
+             * @brief Price, delta, gamma, theta and charm from one column of march() output.
+             *
+             * Theta comes from the pricing PDE itself, so it sits at t = 0 and
+             * is exactly zero where an American option is exercised.
+             */
+            inline PDEResult from_nodes(const double *v, double S, double K, double r, double q, double sigma, double h,
+                                        double dt, bool is_call, bool american)
+            {
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                const double v_x = (v[2] - v[0]) / (2.0 * h);
+                const double v_xx = (v[2] - 2.0 * v[1] + v[0]) / (h * h);
+                PDEResult res;
+                res.price = v[1];
+                res.delta = v_x / S;
+                res.gamma = (v_xx - v_x) / (S * S);
+                const double intrinsic = is_call ? std::max(S - K, 0.0) : std::max(K - S, 0.0);
+                const bool exercised = american && v[1] <= intrinsic + 1e-12 * K;
+                res.theta = exercised ? 0.0
+                                      : (r * res.price - (r - q) * S * res.delta - 0.5 * sigma * sigma * S * S * res.gamma) /
+                                            utils::DAYS_PER_YEAR;
+                res.charm = -(res.delta - delta_at(v + 3, S, h)) / dt / utils::DAYS_PER_YEAR;
+                res.vega = nan;
+                res.rho = nan;
+                res.vanna = nan;
+                res.volga = nan;
+                return res;
+            }
+        }
+
+        /**
+         * @brief Crank-Nicolson finite-difference engine for one underlying.
+         *
+         * The whole chain shares one log-spot grid, so a single backward solve
+         * carries every strike as another right-hand side of the same
+         * tridiagonal system; the Thomas factorizations are computed once per
+         * solve and the value buffers once per call. American exercise uses
+         * Brennan-Schwartz (the exercise check is folded into the back
+         * substitution), and knock-out barriers sit exactly on a grid boundary.
+         * Results are in the units of GreeksCalculator / models::AllGreeks.
+         */
+        class CrankNicolsonEngine
+        {
+        private:
+            double underlying_price;
+            double risk_free_rate;
+            double time_to_maturity;
+            double volatility;
+            double dividend_yield;
+
+            // Relative volatility bump and absolute rate bump of the sensitivity re-solves
+            static constexpr double VOL_BUMP = 0.01;
+            static constexpr double RATE_BUMP = 1e-4;
+
+        public:
+            CrankNicolsonEngine(double S, double r, double T, double sigma, double q = 0.0)
+                : underlying_price(S), risk_free_rate(r), time_to_maturity(T), volatility(sigma), dividend_yield(q)
+            {
+                // Same rules (and messages) as the closed-form model; strikes are checked per chain
+                models::BlackScholesModel checked(S, sigma, r, T, S, q);
+                (void)checked;
+                detail::check(sigma, PDESettings());
+            }
+
+            /**
+             * @brief Prices n options on this underlying with one backward solve per scenario.
+             *
+             * With sensitivities on, the volatility and rate bumps are four more
+             * solves on the same grid; scenarios and column blocks run in
+             * parallel. Knock-in options are the closed-form vanilla minus the
+             * knock-out.
+             */
+            void price_chain(Column<double> strikes, Column<bool> is_call, std::size_t n, const PDESettings &settings,
+                             PDEResult *out) const
+            {
+                detail::check(volatility, settings);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (!(strikes[i] > 0.0) || !std::isfinite(strikes[i]))
+                    {
+                        throw std::invalid_argument("Invalid strike at index " + std::to_string(i) +
+                                                    ": must be positive and finite");
+                    }
+                }
+                if (n == 0)
+                {
+                    return;
+                }
+
+                const double S = underlying_price;
+                const double r = risk_free_rate;
+                const double T = time_to_maturity;
+                const double sigma = volatility;
+                const double q = dividend_yield;
+                const bool knock_in = detail::is_knock_in(settings.barrier);
+                const models::ExpiryContext expiry = models::ExpiryContext::unchecked(r, T, q);
+
+                if (settings.barrier != BarrierType::NONE && detail::knocked(S, settings))
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = knock_in ? detail::from_closed_form(models::compute_all_greeks(S, strikes[i], sigma, expiry),
+                                                                     is_call[i])
+                                          : PDEResult{0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+                    }
+                    return;
+                }
+
+                // Calls first, so each solve is one LU sweep and one UL sweep
+                std::vector<std::size_t> order;
+                order.reserve(n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (is_call[i])
+                    {
+                        order.push_back(i);
+                    }
+                }
+                const std::size_t n_calls = order.size();
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (!is_call[i])
+                    {
+                        order.push_back(i);
+                    }
+                }
+                std::vector<double> K(n);
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    K[j] = strikes[order[j]];
+                }
+                const double k_min = *std::min_element(K.begin(), K.end());
+                const double k_max = *std::max_element(K.begin(), K.end());
+                const detail::Grid grid = detail::make_grid(S, sigma, T, k_min, k_max, settings);
+                if (grid.last > 20 * settings.space_steps)
+                {
+                    throw std::invalid_argument("Spot is too close to the barrier for this grid; increase space_steps");
+                }
+
+                const double d_sigma = VOL_BUMP * sigma;
+                const double sigmas[5] = {sigma, sigma + d_sigma, sigma - d_sigma, sigma, sigma};
+                const double rates[5] = {r, r, r, r + RATE_BUMP, r - RATE_BUMP};
+                const std::size_t scenarios = settings.sensitivities ? 5 : 1;
+                const std::size_t blocks = (n + detail::COLUMNS_PER_SOLVE - 1) / detail::COLUMNS_PER_SOLVE;
+                std::vector<double> raw(scenarios * n * 6);
+
+                parallel::parallel_for(scenarios * blocks, 1, [&](std::size_t begin, std::size_t end) {
+                    detail::Workspace ws;
+                    for (std::size_t job = begin; job < end; ++job)
+                    {
+                        const std::size_t scenario = job / blocks;
+                        const std::size_t first = (job % blocks) * detail::COLUMNS_PER_SOLVE;
+                        const std::size_t count = std::min(detail::COLUMNS_PER_SOLVE, n - first);
+                        const std::size_t calls = n_calls > first ? std::min(n_calls - first, count) : 0;
+                        detail::march(grid, rates[scenario], sigmas[scenario], q, T, settings, K.data() + first, calls,
+                                      count, ws, raw.data() + (scenario * n + first) * 6);
+                    }
+                });
+
+                const double dt = detail::last_step(T, settings);
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    const bool call = j < n_calls;
+                    const double *v = raw.data() + j * 6;
+                    PDEResult res = detail::from_nodes(v, S, K[j], r, q, sigma, grid.h, dt, call, settings.american);
+                    if (settings.sensitivities)
+                    {
+                        const double *up = raw.data() + (n + j) * 6;
+                        const double *dn = raw.data() + (2 * n + j) * 6;
+                        const double *r_up = raw.data() + (3 * n + j) * 6;
+                        const double *r_dn = raw.data() + (4 * n + j) * 6;
+                        res.vega = (up[1] - dn[1]) / (2.0 * d_sigma) / utils::PERCENTAGE_DIVISOR;
+                        res.volga = (up[1] - 2.0 * v[1] + dn[1]) / (d_sigma * d_sigma);
+                        res.vanna = (detail::delta_at(up, S, grid.h) - detail::delta_at(dn, S, grid.h)) / (2.0 * d_sigma);
+                        res.rho = (r_up[1] - r_dn[1]) / (2.0 * RATE_BUMP) / utils::PERCENTAGE_DIVISOR;
+                    }
+                    if (knock_in)
+                    {
+                        const PDEResult vanilla =
+                            detail::from_closed_form(models::compute_all_greeks(S, K[j], sigma, expiry), call);
+                        res = {vanilla.price - res.price, vanilla.delta - res.delta, vanilla.gamma - res.gamma,
+                               vanilla.vega - res.vega,   vanilla.theta - res.theta, vanilla.rho - res.rho,
+                               vanilla.vanna - res.vanna, vanilla.volga - res.volga, vanilla.charm - res.charm};
+                    }
+                    out[order[j]] = res;
+                }
+            }
+
+            PDEResult price(double strike, bool is_call, const PDESettings &settings = PDESettings()) const
+            {
+                PDEResult res;
+                price_chain({&strike, 0}, {&is_call, 0}, 1, settings, &res);
+                return res;
+            }
+
+            double get_underlying_price() const { return underlying_price; }
+            double get_risk_free_rate() const { return risk_free_rate; }
+            double get_time_to_maturity() const { return time_to_maturity; }
+            double get_volatility() const { return volatility; }
+            double get_dividend_yield() const { return dividend_yield; }
+        };
+    }
+}
+
+#endif // OPTIPRICER_PDE_HPP
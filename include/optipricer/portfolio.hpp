@@ -0,0 +1,665 @@
+#ifndef OPTIPRICER_PORTFOLIO_HPP
+#define OPTIPRICER_PORTFOLIO_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "batch.hpp"
+#include "models.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "strategies.hpp"
+
+namespace optipricer
+{
+    namespace portfolio
+    {
+        using utils::Column;
+
+        /**
+         * @brief Quantity-weighted value and Greeks, in the units of models::AllGreeks
+         *
+         * Delta and gamma are per unit of each leg's own underlying, so book-wide
+         * totals only make sense when the underlyings move together; use the
+         * per-underlying rollup otherwise.
+         */
+        struct BookGreeks
+        {
+            double value;
+            double delta;
+            double gamma;
+            double vega;
+            double theta;
+            double rho;
+            double vanna;
+            double volga;
+            double charm;
+        };
+
+        /**
+         * @brief Aggregates of every leg sharing one underlying and one expiry
+         */
+        struct ExpiryRollup
+        {
+            std::int64_t underlying;
+            double time_to_maturity;
+            std::int64_t num_legs;
+            double value;
+            double delta;
+            double gamma;
+            double vega;
+            double theta;
+            double rho;
+            double vanna;
+            double volga;
+            double charm;
+        };
+
+        /**
+         * @brief Whole-book valuation: the total plus rollups by underlying id and by expiry
+         */
+        struct PortfolioRisk
+        {
+            BookGreeks total;
+            std::vector<BookGreeks> by_underlying;
+            std::vector<ExpiryRollup> by_expiry;
+        };
+
+        /**
+         * @brief How Portfolio::scenarios values each cell of the ladder
+         *
+         * FULL reprices every leg under every scenario. TAYLOR expands each
+         * underlying's value to second order in spot and volatility using the
+         * book's delta, gamma, vega, vanna and volga; it is O(1) per cell but
+         * drifts from FULL for large moves and does not floor volatilities at zero.
+         */
+        enum class ScenarioMode
+        {
+            FULL,
+            TAYLOR
+        };
+
+        /**
+         * @brief Book P&L over a spot x volatility scenario ladder
+         *
+         * pnl[(u * num_spot_shifts() + i) * num_vol_shifts() + j] is the change in
+         * value of underlying u's legs when every spot is scaled by
+         * (1 + spot_shifts[i]) and every leg's volatility moves by vol_shifts[j]
+         * (absolute, 0.05 = 5 vol points); base_values[u] is the unshocked value.
+         */
+        struct ScenarioCube
+        {
+            ScenarioMode mode;
+            std::vector<double> spot_shifts;
+            std::vector<double> vol_shifts;
+            std::vector<double> base_values;
+            std::vector<double> pnl;
+
+            std::size_t num_underlyings() const { return base_values.size(); }
+            std::size_t num_spot_shifts() const { return spot_shifts.size(); }
+            std::size_t num_vol_shifts() const { return vol_shifts.size(); }
+
+            double at(std::size_t underlying, std::size_t i, std::size_t j) const
+            {
+                return pnl[(underlying * spot_shifts.size() + i) * vol_shifts.size() + j];
+            }
+
+            // Book-wide P&L of one cell, summed over underlyings
+            double total(std::size_t i, std::size_t j) const
+            {
+                double sum = 0.0;
+                for (std::size_t u = 0; u < num_underlyings(); ++u)
+                {
+                    sum += at(u, i, j);
+                }
+                return sum;
+            }
+        };
+
+        /**
+         * @brief A book of European legs across many underlyings and expiries, stored by column.
+         *
+         * Legs live in structure-of-arrays form (strike, expiry, volatility,
+         * signed quantity, call flag, underlying id) and are kept grouped by
+         * (underlying, expiry), so a valuation streams through contiguous
+         * columns and computes each expiry's discount factors once. Groups are
+         * rebuilt lazily after legs are added; like OptionsStrategy, one
+         * portfolio must not be used from several threads at once.
+         */
+        class Portfolio
+        {
+        private:
+            // Legs per valuation task; a multiple of simd::LANES
+            static constexpr std::size_t CHUNK = 512 * simd::LANES;
+            // Scenarios revalued per pass of scenario_pnl, and per task within a pass
+            static constexpr std::size_t SCENARIO_BLOCK = 256;
+            static constexpr std::size_t TASK_SCENARIOS = 16;
+
+            struct Group
+            {
+                std::uint32_t underlying;
+                double time_to_maturity;
+                std::size_t begin;
+                std::size_t end;
+            };
+
+            struct Chunk
+            {
+                std::size_t group;
+                std::size_t begin;
+                std::size_t end;
+            };
+
+            double risk_free_rate;
+            std::vector<double> spots;
+            std::vector<double> dividend_yields;
+
+            // Leg columns; reordered by (underlying, expiry) when the groups are rebuilt
+            mutable std::vector<double> strikes;
+            mutable std::vector<double> expiries;
+            mutable std::vector<double> volatilities;
+            mutable std::vector<double> quantities;
+            mutable std::vector<std::uint8_t> calls;
+            mutable std::vector<std::uint32_t> underlyings;
+
+            mutable std::vector<Group> groups;
+            mutable std::vector<Chunk> chunks;
+            mutable bool grouped = true;
+
+            void check_underlying(std::size_t id) const
+            {
+                if (id >= spots.size())
+                {
+                    throw std::out_of_range("Underlying id " + std::to_string(id) + " out of range for " +
+                                            std::to_string(spots.size()) + " underlyings");
+                }
+            }
+
+            static void check_shifts(const double *spot_shifts, std::size_t ns, const double *vol_shifts, std::size_t nv)
+            {
+                for (std::size_t i = 0; i < ns; ++i)
+                {
+                    if (!(spot_shifts[i] > -1.0) || !std::isfinite(spot_shifts[i]))
+                    {
+                        throw std::invalid_argument("Spot shift must be finite and greater than -1 at index " +
+                                                    std::to_string(i) + ", got: " + std::to_string(spot_shifts[i]));
+                    }
+                }
+                for (std::size_t j = 0; j < nv; ++j)
+                {
+                    if (!(std::abs(vol_shifts[j]) <= 10.0))
+                    {
+                        throw std::invalid_argument("Volatility shift must be within [-10, 10] at index " +
+                                                    std::to_string(j) + ", got: " + std::to_string(vol_shifts[j]));
+                    }
+                }
+            }
+
+            // Strike-independent inputs of one group, with its expiry brought horizon years closer
+            simd::ExpiryTerms expiry_terms(const Group &group, double horizon = 0.0) const
+            {
+                const double T = std::max(group.time_to_maturity - horizon, 0.0);
+                const double q = dividend_yields[group.underlying];
+                const models::ExpiryContext expiry = models::ExpiryContext::unchecked(risk_free_rate, T, q);
+                return {spots[group.underlying], risk_free_rate, T, q, expiry.get_discount_factor(),
+                        expiry.get_dividend_discount(), expiry.get_sqrt_time()};
+            }
+
+            template <typename T>
+            static void permute(std::vector<T> &column, const std::vector<std::size_t> &order)
+            {
+                std::vector<T> sorted(column.size());
+                for (std::size_t i = 0; i < order.size(); ++i)
+                {
+                    sorted[i] = column[order[i]];
+                }
+                column.swap(sorted);
+            }
+
+            void regroup() const
+            {
+                if (grouped)
+                {
+                    return;
+                }
+                const std::size_t n = strikes.size();
+                std::vector<std::size_t> order(n);
+                std::iota(order.begin(), order.end(), std::size_t(0));
+                std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+                    return underlyings[a] != underlyings[b] ? underlyings[a] < underlyings[b] : expiries[a] < expiries[b];
+                });
+                permute(strikes, order);
+                permute(expiries, order);
+                permute(volatilities, order);
+                permute(quantities, order);
+                permute(calls, order);
+                permute(underlyings, order);
+
+                groups.clear();
+                chunks.clear();
+                for (std::size_t i = 0; i < n;)
+                {
+                    std::size_t end = i + 1;
+                    while (end < n && underlyings[end] == underlyings[i] && expiries[end] == expiries[i])
+                    {
+                        ++end;
+                    }
+                    for (std::size_t begin = i; begin < end; begin += CHUNK)
+                    {
+                        chunks.push_back({groups.size(), begin, std::min(begin + CHUNK, end)});
+                    }
+                    groups.push_back({underlyings[i], expiries[i], i, end});
+                    i = end;
+                }
+                grouped = true;
+            }
+
+        public:
+            explicit Portfolio(double r = 0.0) : risk_free_rate(r)
+            {
+                if (!std::isfinite(r))
+                {
+                    throw std::invalid_argument("Risk-free rate must be finite, got: " + std::to_string(r));
+                }
+            }
+
+            /**
+             * @brief Registers an underlying and returns its id (0, 1, 2, ... in order of registration)
+             */
+            std::size_t add_underlying(double S, double q = 0.0)
+            {
+                models::BlackScholesModel checked(S, 0.2, risk_free_rate, 1.0, S, q);
+                (void)checked;
+                if (spots.size() >= UINT32_MAX)
+                {
+                    throw std::invalid_argument("Too many underlyings in one portfolio");
+                }
+                spots.push_back(S);
+                dividend_yields.push_back(q);
+                return spots.size() - 1;
+            }
+
+            /**
+             * @brief Adds one leg; quantity is signed (negative for short)
+             */
+            void add_leg(std::size_t underlying, double K, double T, double sigma, double quantity, bool is_call)
+            {
+                add_legs({&underlying, 0}, {&K, 0}, {&T, 0}, {&sigma, 0}, {&quantity, 0}, {&is_call, 0}, 1);
+            }
+
+            /**
+             * @brief Appends n legs at once; stride-0 columns broadcast a single value.
+             *
+             * The whole batch is validated before anything is added, so a bad
+             * leg leaves the portfolio unchanged.
+             */
+            void add_legs(Column<std::size_t> underlying, Column<double> K, Column<double> T, Column<double> sigma,
+                          Column<double> quantity, Column<bool> is_call, std::size_t n)
+            {
+                std::vector<double> S(n), q(n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    check_underlying(underlying[i]);
+                    S[i] = spots[underlying[i]];
+                    q[i] = dividend_yields[underlying[i]];
+                    if (!std::isfinite(quantity[i]))
+                    {
+                        throw std::invalid_argument("Invalid leg at index " + std::to_string(i) +
+                                                    ": quantity must be finite");
+                    }
+                }
+                models::validate_batch({S.data(), 1}, K, {&risk_free_rate, 0}, T, sigma, {q.data(), 1}, n);
+
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    strikes.push_back(K[i]);
+                    expiries.push_back(T[i]);
+                    volatilities.push_back(sigma[i]);
+                    quantities.push_back(quantity[i]);
+                    calls.push_back(is_call[i] ? 1 : 0);
+                    underlyings.push_back(static_cast<std::uint32_t>(underlying[i]));
+                }
+                grouped = grouped && n == 0;
+            }
+
+            void set_underlying_price(std::size_t id, double S)
+            {
+                check_underlying(id);
+                models::BlackScholesModel checked(S, 0.2, risk_free_rate, 1.0, S, dividend_yields[id]);
+                (void)checked;
+                spots[id] = S;
+            }
+
+            void set_risk_free_rate(double r)
+            {
+                if (!std::isfinite(r))
+                {
+                    throw std::invalid_argument("Risk-free rate must be finite, got: " + std::to_string(r));
+                }
+                risk_free_rate = r;
+            }
+
+            /**
+             * @brief Values the whole book in one pass over the leg columns.
+             *
+             * Each task covers a contiguous run of at most CHUNK legs of one
+             * (underlying, expiry) group and feeds it to simd::weighted_greeks;
+             * partial sums are then reduced in group order, so results are
+             * identical for any thread count.
+             */
+            PortfolioRisk valuate() const
+            {
+                regroup();
+                std::vector<double> partial(chunks.size() * simd::NUM_BOOK_GREEKS, 0.0);
+                parallel::parallel_for(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t c = begin; c < end; ++c)
+                    {
+                        const Chunk &chunk = chunks[c];
+                        const simd::ExpiryTerms terms = expiry_terms(groups[chunk.group]);
+                        simd::weighted_greeks(terms, strikes.data() + chunk.begin, volatilities.data() + chunk.begin,
+                                              quantities.data() + chunk.begin, calls.data() + chunk.begin,
+                                              chunk.end - chunk.begin, partial.data() + c * simd::NUM_BOOK_GREEKS);
+                    }
+                });
+
+                PortfolioRisk risk;
+                risk.total = BookGreeks{};
+                risk.by_underlying.assign(spots.size(), BookGreeks{});
+                risk.by_expiry.resize(groups.size());
+                for (std::size_t g = 0; g < groups.size(); ++g)
+                {
+                    risk.by_expiry[g] = ExpiryRollup{static_cast<std::int64_t>(groups[g].underlying),
+                                                     groups[g].time_to_maturity,
+                                                     static_cast<std::int64_t>(groups[g].end - groups[g].begin),
+                                                     0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+                }
+                for (std::size_t c = 0; c < chunks.size(); ++c)
+                {
+                    const double *s = partial.data() + c * simd::NUM_BOOK_GREEKS;
+                    ExpiryRollup &e = risk.by_expiry[chunks[c].group];
+                    e.value += s[0];
+                    e.delta += s[1];
+                    e.gamma += s[2];
+                    e.vega += s[3];
+                    e.theta += s[4];
+                    e.rho += s[5];
+                    e.vanna += s[6];
+                    e.volga += s[7];
+                    e.charm += s[8];
+                }
+                for (const ExpiryRollup &e : risk.by_expiry)
+                {
+                    BookGreeks *targets[2] = {&risk.by_underlying[static_cast<std::size_t>(e.underlying)], &risk.total};
+                    for (BookGreeks *t : targets)
+                    {
+                        t->value += e.value;
+                        t->delta += e.delta;
+                        t->gamma += e.gamma;
+                        t->vega += e.vega;
+                        t->theta += e.theta;
+                        t->rho += e.rho;
+                        t->vanna += e.vanna;
+                        t->volga += e.volga;
+                        t->charm += e.charm;
+                    }
+                }
+                return risk;
+            }
+
+            /**
+             * @brief P&L cube of the whole book over relative spot shifts x absolute volatility shifts.
+             *
+             * Every underlying moves by the same relative shift. In FULL mode each
+             * task reprices one chunk of legs for one volatility shift across the
+             * whole spot axis with simd::weighted_value_ladder, so per-leg terms
+             * are shared by every spot shift and the discounting of each expiry by
+             * every scenario; the unshocked value comes from the same kernel, so
+             * zero shifts give exactly zero P&L. Results are identical for any
+             * thread count.
+             */
+            ScenarioCube scenarios(const double *spot_shifts, std::size_t ns, const double *vol_shifts,
+                                   std::size_t nv, ScenarioMode mode = ScenarioMode::FULL) const
+            {
+                check_shifts(spot_shifts, ns, vol_shifts, nv);
+
+                ScenarioCube cube;
+                cube.mode = mode;
+                cube.spot_shifts.assign(spot_shifts, spot_shifts + ns);
+                cube.vol_shifts.assign(vol_shifts, vol_shifts + nv);
+                cube.base_values.assign(spots.size(), 0.0);
+                cube.pnl.assign(spots.size() * ns * nv, 0.0);
+
+                if (mode == ScenarioMode::TAYLOR)
+                {
+                    const PortfolioRisk risk = valuate();
+                    for (std::size_t u = 0; u < spots.size(); ++u)
+                    {
+                        const BookGreeks &g = risk.by_underlying[u];
+                        cube.base_values[u] = g.value;
+                        for (std::size_t i = 0; i < ns; ++i)
+                        {
+                            const double dS = spots[u] * spot_shifts[i];
+                            for (std::size_t j = 0; j < nv; ++j)
+                            {
+                                // Vega is per 1%; vanna and volga are per unit of volatility
+                                const double dv = vol_shifts[j];
+                                cube.pnl[(u * ns + i) * nv + j] = g.delta * dS + 0.5 * g.gamma * dS * dS +
+                                                                  g.vega * utils::PERCENTAGE_DIVISOR * dv +
+                                                                  g.vanna * dS * dv + 0.5 * g.volga * dv * dv;
+                            }
+                        }
+                    }
+                    return cube;
+                }
+
+                regroup();
+                std::vector<double> scales(ns);
+                for (std::size_t i = 0; i < ns; ++i)
+                {
+                    scales[i] = 1.0 + spot_shifts[i];
+                }
+                // Per chunk: nv rows of ns shocked values, then the unshocked value
+                const std::size_t stride = nv * ns + 1;
+                std::vector<double> partial(chunks.size() * stride, 0.0);
+                parallel::parallel_for(chunks.size() * (nv + 1), 1, [&](std::size_t begin, std::size_t end) {
+                    const double one = 1.0, zero = 0.0;
+                    for (std::size_t t = begin; t < end; ++t)
+                    {
+                        const std::size_t c = t / (nv + 1), j = t % (nv + 1);
+                        const Chunk &chunk = chunks[c];
+                        const simd::ExpiryTerms terms = expiry_terms(groups[chunk.group]);
+                        const bool base = j == nv;
+                        simd::weighted_value_ladder(terms, strikes.data() + chunk.begin,
+                                                    volatilities.data() + chunk.begin, quantities.data() + chunk.begin,
+                                                    calls.data() + chunk.begin, chunk.end - chunk.begin,
+                                                    base ? &one : scales.data(), base ? 1 : ns,
+                                                    base ? &zero : vol_shifts + j, 1,
+                                                    partial.data() + c * stride + j * ns);
+                    }
+                });
+
+                for (std::size_t c = 0; c < chunks.size(); ++c)
+                {
+                    const double *s = partial.data() + c * stride;
+                    const std::size_t u = groups[chunks[c].group].underlying;
+                    double *cell = cube.pnl.data() + u * ns * nv;
+                    for (std::size_t j = 0; j < nv; ++j)
+                    {
+                        for (std::size_t i = 0; i < ns; ++i)
+                        {
+                            cell[i * nv + j] += s[j * ns + i];
+                        }
+                    }
+                    cube.base_values[u] += s[nv * ns];
+                }
+                for (std::size_t u = 0; u < spots.size(); ++u)
+                {
+                    for (std::size_t k = u * ns * nv; k < (u + 1) * ns * nv; ++k)
+                    {
+                        cube.pnl[k] -= cube.base_values[u];
+                    }
+                }
+                return cube;
+            }
+
+            /**
+             * @brief P&L of each underlying's legs under n historical scenarios.
+             *
+             * Scenario s moves underlying u's spot by the relative shock
+             * spot_shocks[s * U + u] and the volatility of its legs by vol_shocks[s * U + u]
+             * (absolute), with every expiry horizon years closer; out[s * U + u]
+             * receives the P&L, for U = num_underlyings(). vol_shocks may be nullptr.
+             *
+             * Scenarios stream through in blocks of SCENARIO_BLOCK. Each task
+             * revalues one chunk of legs under TASK_SCENARIOS of them with
+             * simd::weighted_value_scenarios and writes its own partial sums, which
+             * are reduced in chunk order before the next block. Memory stays at
+             * chunks x SCENARIO_BLOCK doubles however many legs and scenarios there
+             * are, and results are identical for any thread count. TAYLOR mode
+             * uses valuate()'s Greeks, including theta over the horizon.
+             */
+            void scenario_pnl(const double *spot_shocks, const double *vol_shocks, std::size_t n, double horizon,
+                              ScenarioMode mode, double *out) const
+            {
+                const std::size_t nu = spots.size();
+                check_shifts(spot_shocks, n * nu, vol_shocks, vol_shocks != nullptr ? n * nu : 0);
+                if (!(horizon >= 0.0) || !std::isfinite(horizon))
+                {
+                    throw std::invalid_argument("Horizon must be non-negative and finite, got: " + std::to_string(horizon));
+                }
+                std::fill(out, out + n * nu, 0.0);
+
+                if (mode == ScenarioMode::TAYLOR)
+                {
+                    const PortfolioRisk risk = valuate();
+                    for (std::size_t u = 0; u < nu; ++u)
+                    {
+                        const BookGreeks &g = risk.by_underlying[u];
+                        const double decay = g.theta * horizon * utils::DAYS_PER_YEAR;
+                        for (std::size_t k = 0; k < n; ++k)
+                        {
+                            const double dS = spots[u] * spot_shocks[k * nu + u];
+                            const double dv = vol_shocks != nullptr ? vol_shocks[k * nu + u] : 0.0;
+                            out[k * nu + u] = g.delta * dS + 0.5 * g.gamma * dS * dS +
+                                              g.vega * utils::PERCENTAGE_DIVISOR * dv + g.vanna * dS * dv +
+                                              0.5 * g.volga * dv * dv + decay;
+                        }
+                    }
+                    return;
+                }
+
+                regroup();
+                const double one = 1.0, zero = 0.0;
+                std::vector<double> base(chunks.size(), 0.0);
+                parallel::parallel_for(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t c = begin; c < end; ++c)
+                    {
+                        const Chunk &chunk = chunks[c];
+                        simd::weighted_value_scenarios(expiry_terms(groups[chunk.group]), strikes.data() + chunk.begin,
+                                                       volatilities.data() + chunk.begin,
+                                                       quantities.data() + chunk.begin, calls.data() + chunk.begin,
+                                                       chunk.end - chunk.begin, &one, &zero, 1, &base[c]);
+                    }
+                });
+
+                std::vector<double> partial(chunks.size() * SCENARIO_BLOCK);
+                for (std::size_t first = 0; first < n; first += SCENARIO_BLOCK)
+                {
+                    const std::size_t m = std::min(n - first, std::size_t(SCENARIO_BLOCK));
+                    const std::size_t tasks_per_chunk = (m + TASK_SCENARIOS - 1) / TASK_SCENARIOS;
+                    std::fill(partial.begin(), partial.end(), 0.0);
+                    parallel::parallel_for(chunks.size() * tasks_per_chunk, 1, [&](std::size_t begin, std::size_t end) {
+                        double scales[TASK_SCENARIOS], shifts[TASK_SCENARIOS];
+                        for (std::size_t t = begin; t < end; ++t)
+                        {
+                            const std::size_t c = t / tasks_per_chunk;
+                            const std::size_t k0 = (t % tasks_per_chunk) * TASK_SCENARIOS;
+                            const std::size_t count = std::min(m - k0, std::size_t(TASK_SCENARIOS));
+                            const Chunk &chunk = chunks[c];
+                            const Group &group = groups[chunk.group];
+                            for (std::size_t k = 0; k < count; ++k)
+                            {
+                                const std::size_t cell = (first + k0 + k) * nu + group.underlying;
+                                scales[k] = 1.0 + spot_shocks[cell];
+                                shifts[k] = vol_shocks != nullptr ? vol_shocks[cell] : 0.0;
+                            }
+                            simd::weighted_value_scenarios(expiry_terms(group, horizon), strikes.data() + chunk.begin,
+                                                           volatilities.data() + chunk.begin,
+                                                           quantities.data() + chunk.begin, calls.data() + chunk.begin,
+                                                           chunk.end - chunk.begin, scales, shifts, count,
+                                                           partial.data() + c * SCENARIO_BLOCK + k0);
+                        }
+                    });
+                    for (std::size_t c = 0; c < chunks.size(); ++c)
+                    {
+                        const std::size_t u = groups[chunks[c].group].underlying;
+                        for (std::size_t k = 0; k < m; ++k)
+                        {
+                            out[(first + k) * nu + u] += partial[c * SCENARIO_BLOCK + k];
+                        }
+                    }
+                }
+
+                std::vector<double> base_values(nu, 0.0);
+                for (std::size_t c = 0; c < chunks.size(); ++c)
+                {
+                    base_values[groups[chunks[c].group].underlying] += base[c];
+                }
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    for (std::size_t u = 0; u < nu; ++u)
+                    {
+                        out[k * nu + u] -= base_values[u];
+                    }
+                }
+            }
+
+            /**
+             * @brief One-underlying book holding a strategy's legs as European options.
+             *
+             * Quantities are signed by position type and legs with a volatility
+             * override keep it; r, q, S and T come from the strategy.
+             */
+            static Portfolio from_strategy(const strategies::OptionsStrategy &strategy)
+            {
+                Portfolio book(strategy.get_risk_free_rate());
+                const std::size_t u = book.add_underlying(strategy.get_underlying_price(), strategy.get_dividend_yield());
+                for (const strategies::Position &pos : strategy.get_positions())
+                {
+                    const double sigma = pos.has_volatility_override() ? pos.volatility_override : strategy.get_volatility();
+                    const double quantity = pos.position_type == strategies::PositionType::LONG ? pos.quantity : -pos.quantity;
+                    book.add_leg(u, pos.strike, strategy.get_time_to_maturity(), sigma, quantity,
+                                 pos.option_type == strategies::OptionType::CALL);
+                }
+                return book;
+            }
+
+            std::size_t size() const { return strikes.size(); }
+            std::size_t num_underlyings() const { return spots.size(); }
+            std::size_t num_expiries() const
+            {
+                regroup();
+                return groups.size();
+            }
+
+            double get_risk_free_rate() const { return risk_free_rate; }
+            double get_underlying_price(std::size_t id) const
+            {
+                check_underlying(id);
+                return spots[id];
+            }
+            double get_dividend_yield(std::size_t id) const
+            {
+                check_underlying(id);
+                return dividend_yields[id];
+            }
+        };
+    }
+}
+
+#endif // OPTIPRICER_PORTFOLIO_HPP
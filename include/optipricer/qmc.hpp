@@ -0,0 +1,327 @@
+#ifndef OPTIPRICER_QMC_HPP
+#define OPTIPRICER_QMC_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "random.hpp"
+
+namespace optipricer
+{
+    namespace mc
+    {
+        // Dimensions with Joe-Kuo direction numbers; higher ones are padded with Philox draws
+        constexpr std::size_t SOBOL_DIMENSIONS = 32;
+
+        // Points per scrambled sequence (the direction numbers have 32 digits)
+        constexpr std::uint64_t SOBOL_MAX_POINTS = std::uint64_t(1) << 32;
+
+        namespace detail
+        {
+            struct SobolPolynomial
+            {
+                unsigned degree;
+                unsigned coefficients; // Interior coefficients a_1..a_{s-1}, most significant first
+                unsigned m[7];         // Initial direction numbers m_1..m_s
+            };
+
+            /**
+             * @brief Dimensions 2..32 of Joe & Kuo's new-joe-kuo-6.21201 table.
+             *
+             * Dimension 1 is the van der Corput sequence and needs no entry.
+             */
+            inline const SobolPolynomial *sobol_polynomials()
+            {
+                static const SobolPolynomial table[SOBOL_DIMENSIONS - 1] = {
+                    {1, 0, {1}},
+                    {2, 1, {1, 3}},
+                    {3, 1, {1, 3, 1}},
+                    {3, 2, {1, 1, 1}},
+                    {4, 1, {1, 1, 3, 3}},
+                    {4, 4, {1, 3, 5, 13}},
+                    {5, 2, {1, 1, 5, 5, 17}},
+                    {5, 4, {1, 1, 5, 5, 5}},
+                    {5, 7, {1, 1, 7, 11, 19}},
+                    {5, 11, {1, 1, 5, 1, 1}},
+                    {5, 13, {1, 1, 1, 3, 11}},
+                    {5, 14, {1, 3, 5, 5, 31}},
+                    {6, 1, {1, 3, 3, 9, 7, 49}},
+                    {6, 13, {1, 1, 1, 15, 21, 21}},
+                    {6, 16, {1, 3, 1, 13, 27, 49}},
+                    {6, 19, {1, 1, 1, 15, 7, 5}},
+                    {6, 22, {1, 3, 1, 15, 13, 25}},
+                    {6, 25, {1, 1, 5, 5, 19, 61}},
+                    {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+                    {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+                    {7, 7, {1, 1, 3, 13, 7, 35, 63}},
+                    {7, 8, {1, 3, 5, 9, 1, 25, 53}},
+                    {7, 14, {1, 3, 1, 13, 9, 35, 107}},
+                    {7, 19, {1, 3, 1, 5, 27, 61, 31}},
+                    {7, 21, {1, 1, 5, 11, 19, 41, 61}},
+                    {7, 28, {1, 3, 5, 3, 3, 13, 69}},
+                    {7, 31, {1, 1, 7, 13, 1, 19, 1}},
+                    {7, 32, {1, 3, 7, 5, 13, 19, 59}},
+                    {7, 37, {1, 1, 3, 9, 25, 29, 41}},
+                    {7, 41, {1, 3, 5, 13, 23, 1, 55}},
+                    {7, 42, {1, 3, 7, 3, 13, 59, 17}}};
+                return table;
+            }
+
+            inline unsigned trailing_zeros(std::uint64_t x)
+            {
+                unsigned n = 0;
+                while ((x & 1u) == 0u)
+                {
+                    x >>= 1;
+                    ++n;
+                }
+                return n;
+            }
+        }
+
+        /**
+         * @brief Sobol sequence with a random linear scramble and digital shift (Matousek 1998).
+         *
+         * Each seed gives an independent randomization that keeps the net
+         * structure of the sequence, so every replicate is an unbiased
+         * estimate and the spread over replicates is an honest error bar.
+         * Points are produced in Gray-code order; point i can be reached
+         * directly, which lets blocks of paths be generated on any thread.
+         */
+        class ScrambledSobol
+        {
+        private:
+            std::size_t dims;
+            std::vector<std::uint64_t> directions; // directions[d * 32 + k]
+            std::vector<std::uint64_t> shift;
+
+            // Keeps the scramble draws apart from the path draws made with the same key
+            static constexpr std::uint32_t SCRAMBLE_TAG = 0x40000000u;
+
+        public:
+            ScrambledSobol(std::size_t dimensions, std::uint64_t seed, std::uint64_t stream)
+                : dims(dimensions), directions(dimensions * 32), shift(dimensions)
+            {
+                if (dimensions == 0 || dimensions > SOBOL_DIMENSIONS)
+                {
+                    throw std::invalid_argument("Sobol dimension must be in [1, " + std::to_string(SOBOL_DIMENSIONS) +
+                                                "], got: " + std::to_string(dimensions));
+                }
+                const detail::SobolPolynomial *table = detail::sobol_polynomials();
+                const Philox4x32 rng(seed);
+                std::uint64_t v[32];
+
+                for (std::size_t d = 0; d < dims; ++d)
+                {
+                    // Direction numbers, left-aligned in 64 bits
+                    if (d == 0)
+                    {
+                        for (unsigned k = 0; k < 32; ++k)
+                        {
+                            v[k] = std::uint64_t(1) << (63 - k);
+                        }
+                    }
+                    else
+                    {
+                        const detail::SobolPolynomial &p = table[d - 1];
+                        const unsigned s = p.degree;
+                        for (unsigned k = 0; k < s; ++k)
+                        {
+                            v[k] = static_cast<std::uint64_t>(p.m[k]) << (63 - k);
+                        }
+                        for (unsigned k = s; k < 32; ++k)
+                        {
+                            v[k] = v[k - s] ^ (v[k - s] >> s);
+                            for (unsigned j = 1; j < s; ++j)
+                            {
+                                if ((p.coefficients >> (s - 1 - j)) & 1u)
+                                {
+                                    v[k] ^= v[k - j];
+                                }
+                            }
+                        }
+                    }
+
+                    // Lower-triangular scramble: column j keeps digit j and mixes it into the later ones
+                    std::uint64_t column[32];
+                    for (unsigned j = 0; j < 32; j += 2)
+                    {
+                        std::uint32_t ctr[4] = {static_cast<std::uint32_t>(d), j, static_cast<std::uint32_t>(stream),
+                                                static_cast<std::uint32_t>(stream >> 32) ^ SCRAMBLE_TAG};
+                        rng(ctr);
+                        std::uint64_t r0 = (static_cast<std::uint64_t>(ctr[0]) << 32) | ctr[1];
+                        std::uint64_t r1 = (static_cast<std::uint64_t>(ctr[2]) << 32) | ctr[3];
+                        column[j] = (std::uint64_t(1) << (63 - j)) | ((r0 >> 1) >> j);
+                        column[j + 1] = (std::uint64_t(1) << (62 - j)) | ((r1 >> 2) >> j);
+                    }
+                    for (unsigned k = 0; k < 32; ++k)
+                    {
+                        std::uint64_t scrambled = 0;
+                        for (unsigned j = 0; j < 32; ++j)
+                        {
+                            if ((v[k] >> (63 - j)) & 1u)
+                            {
+                                scrambled ^= column[j];
+                            }
+                        }
+                        directions[d * 32 + k] = scrambled;
+                    }
+
+                    std::uint32_t ctr[4] = {static_cast<std::uint32_t>(d), 0xFFFFFFFFu, static_cast<std::uint32_t>(stream),
+                                            static_cast<std::uint32_t>(stream >> 32) ^ SCRAMBLE_TAG};
+                    rng(ctr);
+                    shift[d] = (static_cast<std::uint64_t>(ctr[0]) << 32) | ctr[1];
+                }
+            }
+
+            std::size_t dimensions() const { return dims; }
+
+            /**
+             * @brief Points [first, first + count) into u[d * stride + i], for i < lanes.
+             *
+             * Lanes at or past `count` get a neutral 0.5.
+             */
+            void fill(std::uint64_t first, std::size_t count, std::size_t lanes, double *u, std::size_t stride) const
+            {
+                for (std::size_t d = 0; d < dims; ++d)
+                {
+                    const std::uint64_t *v = directions.data() + d * 32;
+                    std::uint64_t gray = first ^ (first >> 1);
+                    std::uint64_t x = shift[d];
+                    for (unsigned k = 0; gray != 0; ++k, gray >>= 1)
+                    {
+                        if (gray & 1u)
+                        {
+                            x ^= v[k];
+                        }
+                    }
+                    double *row = u + d * stride;
+                    for (std::size_t i = 0; i < lanes; ++i)
+                    {
+                        row[i] = i < count ? to_unit(static_cast<std::uint32_t>(x >> 32), static_cast<std::uint32_t>(x)) : 0.5;
+                        if (i + 1 < count)
+                        {
+                            x ^= v[detail::trailing_zeros(first + i + 1)];
+                        }
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief Brownian bridge on a uniform grid (Jaeckel's construction).
+         *
+         * Maps normals ordered by importance (the first one fixes the final
+         * point, the next ones successive midpoints) to the standardized
+         * increments of the path, so the leading Sobol dimensions carry most
+         * of the variance of the payoff.
+         */
+        class BrownianBridge
+        {
+        private:
+            std::size_t n;
+            std::vector<std::size_t> bridge_index;
+            std::vector<std::size_t> left_index;
+            std::vector<std::size_t> right_index;
+            std::vector<double> left_weight;
+            std::vector<double> right_weight;
+            std::vector<double> std_dev;
+
+        public:
+            explicit BrownianBridge(std::size_t steps)
+                : n(steps), bridge_index(steps), left_index(steps), right_index(steps), left_weight(steps),
+                  right_weight(steps), std_dev(steps)
+            {
+                if (steps == 0)
+                {
+                    throw std::invalid_argument("Brownian bridge needs at least one step");
+                }
+                // Times are t_i = i + 1, so the increments come out with unit variance
+                std::vector<std::size_t> map(steps, 0);
+                map[steps - 1] = 1;
+                bridge_index[0] = steps - 1;
+                std_dev[0] = std::sqrt(static_cast<double>(steps));
+                for (std::size_t i = 1, j = 0; i < steps; ++i)
+                {
+                    while (map[j])
+                    {
+                        ++j;
+                    }
+                    std::size_t k = j;
+                    while (!map[k])
+                    {
+                        ++k;
+                    }
+                    std::size_t l = j + ((k - 1 - j) >> 1);
+                    map[l] = i;
+                    bridge_index[i] = l;
+                    left_index[i] = j;
+                    right_index[i] = k;
+                    double t_left = static_cast<double>(j);
+                    double t_mid = static_cast<double>(l + 1);
+                    double t_right = static_cast<double>(k + 1);
+                    left_weight[i] = (t_right - t_mid) / (t_right - t_left);
+                    right_weight[i] = (t_mid - t_left) / (t_right - t_left);
+                    std_dev[i] = std::sqrt((t_mid - t_left) * (t_right - t_mid) / (t_right - t_left));
+                    j = k + 1;
+                    if (j >= steps)
+                    {
+                        j = 0;
+                    }
+                }
+            }
+
+            std::size_t steps() const { return n; }
+
+            /**
+             * @brief z[i * lanes + b] (bridge order) to increments out[j * lanes + b] (time order)
+             */
+            void transform(const double *z, double *out, std::size_t lanes) const
+            {
+                double *last = out + (n - 1) * lanes;
+                for (std::size_t b = 0; b < lanes; ++b)
+                {
+                    last[b] = std_dev[0] * z[b];
+                }
+                for (std::size_t i = 1; i < n; ++i)
+                {
+                    const double *zi = z + i * lanes;
+                    double *mid = out + bridge_index[i] * lanes;
+                    const double *right = out + right_index[i] * lanes;
+                    const double wr = right_weight[i];
+                    const double sd = std_dev[i];
+                    if (left_index[i] == 0)
+                    {
+                        for (std::size_t b = 0; b < lanes; ++b)
+                        {
+                            mid[b] = wr * right[b] + sd * zi[b];
+                        }
+                    }
+                    else
+                    {
+                        const double *left = out + (left_index[i] - 1) * lanes;
+                        const double wl = left_weight[i];
+                        for (std::size_t b = 0; b < lanes; ++b)
+                        {
+                            mid[b] = wl * left[b] + wr * right[b] + sd * zi[b];
+                        }
+                    }
+                }
+                for (std::size_t j = n - 1; j > 0; --j)
+                {
+                    double *row = out + j * lanes;
+                    const double *prev = row - lanes;
+                    for (std::size_t b = 0; b < lanes; ++b)
+                    {
+                        row[b] -= prev[b];
+                    }
+                }
+            }
+        };
+    }
+}
+
+#endif // OPTIPRICER_QMC_HPP
@@ -0,0 +1,53 @@
+#ifndef OPTIPRICER_RANDOM_HPP
+#define OPTIPRICER_RANDOM_HPP
+
+#include <cstdint>
+
+namespace optipricer
+{
+    namespace mc
+    {
+        /**
+         * @brief Philox4x32-10 counter-based generator (Salmon et al., SC'11).
+         *
+         * Maps a 128-bit counter and 64-bit key to 128 random bits with no
+         * state, so any draw can be regenerated from its (path, step) index.
+         * That is what keeps results identical whatever the thread count.
+         */
+        struct Philox4x32
+        {
+            std::uint32_t key[2];
+
+            explicit Philox4x32(std::uint64_t seed)
+                : key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)} {}
+
+            void operator()(std::uint32_t (&ctr)[4]) const
+            {
+                std::uint32_t k0 = key[0];
+                std::uint32_t k1 = key[1];
+                for (int round = 0; round < 10; ++round)
+                {
+                    std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u) * ctr[0];
+                    std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * ctr[2];
+                    std::uint32_t c0 = static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ k0;
+                    std::uint32_t c2 = static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ k1;
+                    ctr[1] = static_cast<std::uint32_t>(p1);
+                    ctr[3] = static_cast<std::uint32_t>(p0);
+                    ctr[0] = c0;
+                    ctr[2] = c2;
+                    k0 += 0x9E3779B9u;
+                    k1 += 0xBB67AE85u;
+                }
+            }
+        };
+
+        // 53 random bits from two words, mapped to the open interval (0, 1)
+        inline double to_unit(std::uint32_t hi, std::uint32_t lo)
+        {
+            std::uint64_t bits = ((static_cast<std::uint64_t>(hi) << 32) | lo) >> 11;
+            return (static_cast<double>(bits) + 0.5) * (1.0 / 9007199254740992.0);
+        }
+    }
+}
+
+#endif // OPTIPRICER_RANDOM_HPP
@@ -0,0 +1,610 @@
+#ifndef OPTIPRICER_SIMD_FLOAT_HPP
+#define OPTIPRICER_SIMD_FLOAT_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include "greeks.hpp"
+#include "models.hpp"
+#include "simd.hpp"
+
+/*
+ * Single-precision counterparts of the simd.hpp batch kernels.
+ *
+ * A 64-byte vector holds 16 floats, so every operation covers twice the
+ * options of the double kernels and moves half the memory. The vector math
+ * is tuned to float rather than narrowed from the double versions: shorter
+ * polynomials, and the Abramowitz & Stegun 26.2.17 normal CDF in place of
+ * Hart's rational form.
+ *
+ * Error bounds of the vector math (measured against double references):
+ *   exp       relative error < 1e-7 on [-87, 88]; 0 below -87
+ *   log       error < 1.2e-7, relative above |log x| = 1 and absolute below
+ *   sqrt      relative error < 1e-7 for positive normal inputs
+ *   norm_cdf  absolute error < 3e-7
+ * Prices, deltas and the other Greeks agree with the double kernels to
+ * within ~3e-6 relative, with prices measured against the spot level.
+ *
+ * The implied volatility solver runs the safeguarded Newton search of
+ * models::solve_implied_volatility lane-parallel in float. Float prices
+ * cannot resolve an absolute tolerance finer than a few ulps of the forward,
+ * so a lane also converges once its price error is within 16 float ulps of
+ * the option's upper bound. The root then carries the float pricing error
+ * divided by vega. With refine, each converged lane takes one Newton step in
+ * double from the float root, which leaves only the rounding of the result
+ * wherever vega is not negligible. Quotes within float rounding of their
+ * intrinsic value may be classified BELOW_INTRINSIC where the double solver
+ * succeeds, or the reverse.
+ *
+ * Builds without vector extensions evaluate the double formulas and round
+ * the results, so the float entry points are available everywhere.
+ */
+
+namespace optipricer
+{
+    namespace simd
+    {
+        // Vector width in floats; float batch callers chunk work in multiples of it
+        constexpr std::size_t FLOAT_LANES = 16;
+
+#if defined(OPTIPRICER_SIMD)
+
+        typedef float vfloat __attribute__((vector_size(64)));
+        typedef std::int32_t vintf __attribute__((vector_size(64)));
+        typedef std::uint32_t vuintf __attribute__((vector_size(64)));
+
+        OPTIPRICER_SIMD_INLINE vfloat splatf(float x)
+        {
+            vfloat v;
+            for (std::size_t j = 0; j < FLOAT_LANES; ++j)
+            {
+                v[j] = x;
+            }
+            return v;
+        }
+
+        OPTIPRICER_SIMD_INLINE vintf splatf_int(std::int32_t x)
+        {
+            vintf v;
+            for (std::size_t j = 0; j < FLOAT_LANES; ++j)
+            {
+                v[j] = x;
+            }
+            return v;
+        }
+
+        OPTIPRICER_SIMD_INLINE vfloat select(vintf mask, vfloat a, vfloat b)
+        {
+            return (vfloat)((mask & (vintf)a) | (~mask & (vintf)b));
+        }
+
+        OPTIPRICER_SIMD_INLINE vintf select(vintf mask, vintf a, vintf b) { return (mask & a) | (~mask & b); }
+
+        OPTIPRICER_SIMD_INLINE vintf less(vfloat a, vfloat b) { return (vintf)(a < b); }
+
+        OPTIPRICER_SIMD_INLINE bool any(vintf mask)
+        {
+            std::int32_t acc = 0;
+            for (std::size_t j = 0; j < FLOAT_LANES; ++j)
+            {
+                acc |= mask[j];
+            }
+            return acc != 0;
+        }
+
+        OPTIPRICER_SIMD_INLINE vfloat abs(vfloat x) { return (vfloat)((vintf)x & splatf_int(0x7FFFFFFF)); }
+
+        OPTIPRICER_SIMD_INLINE vfloat min(vfloat a, vfloat b) { return select(less(a, b), a, b); }
+
+        // Converts small integers (|i| < 2^22) to float without a libcall
+        OPTIPRICER_SIMD_INLINE vfloat to_float(vintf i)
+        {
+            const vfloat magic = splatf(12582912.0f); // 1.5 * 2^23
+            return (vfloat)(i + (vintf)magic) - magic;
+        }
+
+        OPTIPRICER_SIMD_INLINE vfloat exp(vfloat x)
+        {
+            const vfloat magic = splatf(12582912.0f);
+            // Below -87 the 2^n scaling would leave the normal range; the true value is < 2e-38
+            vintf underflow = less(x, splatf(-87.0f));
+            x = select(underflow, splatf(-87.0f), x);
+            x = select(less(splatf(88.0f), x), splatf(88.0f), x);
+
+            // x = n * ln2 + r with |r| <= ln2 / 2 (Cody-Waite reduction)
+            vfloat kd = x * splatf(1.44269504f) + magic;
+            vintf n_bits = (vintf)kd - (vintf)magic;
+            vfloat n = kd - magic;
+            vfloat r = x - n * splatf(0.693359375f);
+            r = r - n * splatf(-2.12194440e-4f);
+
+            // Cephes expf minimax polynomial
+            vfloat p = splatf(1.9875691500e-4f);
+            p = p * r + splatf(1.3981999507e-3f);
+            p = p * r + splatf(8.3334519073e-3f);
+            p = p * r + splatf(4.1665795894e-2f);
+            p = p * r + splatf(1.6666665459e-1f);
+            p = p * r + splatf(5.0000001201e-1f);
+            p = p * r * r + r + splatf(1.0f);
+
+            vfloat result = (vfloat)((vintf)p + (n_bits << 23));
+            return select(underflow, splatf(0.0f), result);
+        }
+
+        OPTIPRICER_SIMD_INLINE vfloat log(vfloat x)
+        {
+            vintf bits = (vintf)x;
+            vintf e = (vintf)((vuintf)bits >> 23) - splatf_int(127);
+            vfloat m = (vfloat)((bits & splatf_int(0x007FFFFF)) | splatf_int(0x3F800000));
+
+            // Fold the mantissa into [sqrt(1/2), sqrt(2))
+            vintf high = less(splatf(1.41421356f), m);
+            m = select(high, m * splatf(0.5f), m);
+            e = e - high;
+
+            // log(m) = 2 atanh(s), s = (m - 1) / (m + 1), |s| < 0.1716
+            vfloat s = (m - splatf(1.0f)) / (m + splatf(1.0f));
+            vfloat s2 = s * s;
+            vfloat p = splatf(1.0f / 9.0f);
+            p = p * s2 + splatf(1.0f / 7.0f);
+            p = p * s2 + splatf(1.0f / 5.0f);
+            p = p * s2 + splatf(1.0f / 3.0f);
+            p = p * s2 + splatf(1.0f);
+            vfloat log_m = splatf(2.0f) * s * p;
+
+            vfloat ef = to_float(e);
+            return ef * splatf(0.693359375f) + (ef * splatf(-2.12194440e-4f) + log_m);
+        }
+
+        OPTIPRICER_SIMD_INLINE vfloat sqrt(vfloat x)
+        {
+            // Reciprocal square root seed from the exponent bits, then Newton
+            vfloat y = (vfloat)(splatf_int(0x5F375A86) - (vintf)((vuintf)x >> 1));
+            for (int k = 0; k < 3; ++k)
+            {
+                y = y * (splatf(1.5f) - splatf(0.5f) * x * y * y);
+            }
+            vfloat s = x * y;
+            return s + splatf(0.5f) * y * (x - s * s);
+        }
+
+        OPTIPRICER_SIMD_INLINE vfloat norm_pdf(vfloat x)
+        {
+            return splatf(static_cast<float>(1.0 / utils::SQRT_2PI)) * exp(splatf(-0.5f) * x * x);
+        }
+
+        // Abramowitz & Stegun 26.2.17; the density underflows to 0 past |x| ~ 13
+        OPTIPRICER_SIMD_INLINE vfloat norm_cdf(vfloat x)
+        {
+            vfloat ax = abs(x);
+            vfloat t = splatf(1.0f) / (splatf(1.0f) + splatf(0.2316419f) * ax);
+            vfloat poly = splatf(1.330274429f);
+            poly = poly * t + splatf(-1.821255978f);
+            poly = poly * t + splatf(1.781477937f);
+            poly = poly * t + splatf(-0.356563782f);
+            poly = poly * t + splatf(0.319381530f);
+            vfloat tail = norm_pdf(ax) * poly * t;
+            return select(less(splatf(0.0f), x), splatf(1.0f) - tail, tail);
+        }
+
+        // count < FLOAT_LANES pads the block with `pad`
+        OPTIPRICER_SIMD_INLINE vfloat load(Column<float> c, std::size_t i, std::size_t count, float pad)
+        {
+            if (c.stride == 0)
+            {
+                return splatf(c.data[0]);
+            }
+            vfloat v;
+            if (count == FLOAT_LANES)
+            {
+                std::memcpy(&v, c.data + i, sizeof(v));
+                return v;
+            }
+            for (std::size_t j = 0; j < FLOAT_LANES; ++j)
+            {
+                v[j] = j < count ? c.data[i + j] : pad;
+            }
+            return v;
+        }
+
+        OPTIPRICER_SIMD_INLINE vintf load_mask(Column<bool> c, std::size_t i, std::size_t count)
+        {
+            vintf m;
+            for (std::size_t j = 0; j < FLOAT_LANES; ++j)
+            {
+                m[j] = j < count && c[i + j] ? -1 : 0;
+            }
+            return m;
+        }
+
+        OPTIPRICER_SIMD_INLINE void store(float *out, vfloat v, std::size_t count)
+        {
+            if (count == FLOAT_LANES)
+            {
+                std::memcpy(out, &v, sizeof(v));
+                return;
+            }
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                out[j] = v[j];
+            }
+        }
+
+        // One block of float inputs; padding lanes get harmless at-the-money values
+        struct FloatBlock
+        {
+            vfloat S, K, r, T, sigma, q;
+            vintf is_call;
+        };
+
+        OPTIPRICER_SIMD_INLINE FloatBlock load_block(Column<float> S, Column<float> K, Column<float> r,
+                                                     Column<float> T, Column<float> sigma, Column<float> q,
+                                                     Column<bool> is_call, std::size_t i, std::size_t count)
+        {
+            return {load(S, i, count, 1.0f), load(K, i, count, 1.0f), load(r, i, count, 0.0f),
+                    load(T, i, count, 1.0f), load(sigma, i, count, 0.2f), load(q, i, count, 0.0f),
+                    load_mask(is_call, i, count)};
+        }
+
+        // d1 / d2 with the BlackScholesModel edge cases; degenerate flags sigma or T below 1e-10
+        OPTIPRICER_SIMD_INLINE void d1_d2(const FloatBlock &b, vfloat fwd_S, vfloat fwd_K, vfloat vol_sqrt_T,
+                                          vfloat &D1, vfloat &D2, vintf &degenerate)
+        {
+            D1 = (log(b.S / b.K) + (b.r - b.q + splatf(0.5f) * b.sigma * b.sigma) * b.T) / vol_sqrt_T;
+            degenerate = less(b.sigma, splatf(1e-10f)) | less(b.T, splatf(1e-10f));
+            vfloat limit = select(less(fwd_K, fwd_S), splatf(1e15f),
+                                  select(less(fwd_S, fwd_K), splatf(-1e15f), splatf(0.0f)));
+            D1 = select(degenerate, limit, D1);
+            D2 = select(degenerate, D1, D1 - vol_sqrt_T);
+        }
+
+        /**
+         * @brief Float price and (optionally) delta for n options.
+         *
+         * Inputs must already be valid BlackScholesModel parameters; delta may
+         * be nullptr when only prices are needed.
+         */
+        inline OPTIPRICER_SIMD_DISPATCH void bs_price_delta(Column<float> S, Column<float> K, Column<float> r,
+                                                            Column<float> T, Column<float> sigma, Column<float> q,
+                                                            Column<bool> is_call, float *price, float *delta,
+                                                            std::size_t n)
+        {
+            for (std::size_t i = 0; i < n; i += FLOAT_LANES)
+            {
+                const std::size_t count = std::min(FLOAT_LANES, n - i);
+                FloatBlock b = load_block(S, K, r, T, sigma, q, is_call, i, count);
+                vfloat df_q = exp(-b.q * b.T);
+                vfloat fwd_S = b.S * df_q;
+                vfloat fwd_K = b.K * exp(-b.r * b.T);
+                vfloat D1, D2;
+                vintf degenerate;
+                d1_d2(b, fwd_S, fwd_K, b.sigma * sqrt(b.T), D1, D2, degenerate);
+
+                vfloat omega = select(b.is_call, splatf(1.0f), splatf(-1.0f));
+                vfloat N1 = norm_cdf(omega * D1);
+                // + 0.0f turns the -0.0f of worthless puts into +0.0f
+                store(price + i, omega * (fwd_S * N1 - fwd_K * norm_cdf(omega * D2)) + splatf(0.0f), count);
+                if (delta != nullptr)
+                {
+                    store(delta + i, omega * df_q * N1 + splatf(0.0f), count);
+                }
+            }
+        }
+
+        /**
+         * @brief Float prices and Greeks of n call/put pairs, in the units of models::AllGreeks.
+         *
+         * Inputs must already be valid BlackScholesModel parameters. Edge cases
+         * (sigma or T below 1e-10) follow models::compute_all_greeks.
+         */
+        inline OPTIPRICER_SIMD_DISPATCH void all_greeks(Column<float> S, Column<float> K, Column<float> r,
+                                                        Column<float> T, Column<float> sigma, Column<float> q,
+                                                        models::AllGreeks32 *out, std::size_t n)
+        {
+            // Every pair has both sides, so the block's side mask is unused
+            const bool calls = true;
+            for (std::size_t i = 0; i < n; i += FLOAT_LANES)
+            {
+                const std::size_t count = std::min(FLOAT_LANES, n - i);
+                FloatBlock b = load_block(S, K, r, T, sigma, q, {&calls, 0}, i, count);
+                const vfloat zero = splatf(0.0f);
+                vfloat sqrt_T = sqrt(b.T);
+                vfloat vol_sqrt_T = b.sigma * sqrt_T;
+                vfloat df_r = exp(-b.r * b.T);
+                vfloat df_q = exp(-b.q * b.T);
+                vfloat fwd_S = b.S * df_q;
+                vfloat fwd_K = b.K * df_r;
+                vfloat D1, D2;
+                vintf degenerate;
+                d1_d2(b, fwd_S, fwd_K, vol_sqrt_T, D1, D2, degenerate);
+
+                vfloat N1 = norm_cdf(D1);
+                vfloat N2 = norm_cdf(D2);
+                vfloat N1_neg = norm_cdf(-D1);
+                vfloat N2_neg = norm_cdf(-D2);
+                vfloat pdf_d1 = norm_pdf(D1);
+                vfloat raw_vega = fwd_S * pdf_d1 * sqrt_T;
+
+                // The regular theta and rho formulas reduce to the degenerate-case limits
+                // once the decay term is dropped; the other degenerate Greeks are 0
+                vfloat theta_decay = select(degenerate, zero, -(fwd_S * pdf_d1 * b.sigma) / (splatf(2.0f) * sqrt_T));
+                vfloat charm_term = pdf_d1 * (splatf(2.0f) * (b.r - b.q) * b.T - D2 * vol_sqrt_T) /
+                                    (splatf(2.0f) * b.T * vol_sqrt_T);
+                const vfloat days = splatf(static_cast<float>(utils::DAYS_PER_YEAR));
+                const vfloat percent = splatf(static_cast<float>(utils::PERCENTAGE_DIVISOR));
+
+                const vfloat fields[14] = {
+                    fwd_S * N1 - fwd_K * N2,
+                    fwd_K * N2_neg - fwd_S * N1_neg,
+                    df_q * N1,
+                    df_q * (N1 - splatf(1.0f)),
+                    select(degenerate, zero, df_q * pdf_d1 / (b.S * vol_sqrt_T)),
+                    select(degenerate, zero, raw_vega / percent),
+                    (theta_decay + b.q * fwd_S * N1 - b.r * fwd_K * N2) / days,
+                    (theta_decay - b.q * fwd_S * N1_neg + b.r * fwd_K * N2_neg) / days,
+                    b.K * b.T * df_r * N2 / percent,
+                    -b.K * b.T * df_r * N2_neg / percent,
+                    select(degenerate, zero, -df_q * pdf_d1 * D2 / b.sigma),
+                    select(degenerate, zero, raw_vega * D1 * D2 / b.sigma),
+                    select(degenerate, zero, -df_q * (charm_term - b.q * N1) / days),
+                    select(degenerate, zero, -df_q * (charm_term + b.q * N1_neg) / days),
+                };
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    models::AllGreeks32 &g = out[i + j];
+                    g.call_price = fields[0][j];
+                    g.put_price = fields[1][j];
+                    g.call_delta = fields[2][j];
+                    g.put_delta = fields[3][j];
+                    g.gamma = fields[4][j];
+                    g.vega = fields[5][j];
+                    g.call_theta = fields[6][j];
+                    g.put_theta = fields[7][j];
+                    g.call_rho = fields[8][j];
+                    g.put_rho = fields[9][j];
+                    g.vanna = fields[10][j];
+                    g.volga = fields[11][j];
+                    g.call_charm = fields[12][j];
+                    g.put_charm = fields[13][j];
+                }
+            }
+        }
+
+        // One Newton step in double from the float roots of the lanes flagged in `refine`
+        OPTIPRICER_SIMD_INLINE vfloat refine_in_double(const FloatBlock &b, vfloat market_price, vfloat sigma,
+                                                       vintf refine)
+        {
+            for (std::size_t half = 0; half < FLOAT_LANES; half += LANES)
+            {
+                vdouble S = {}, K = {}, r = {}, T = {}, q = {}, m = {}, vol = {};
+                vint mask = {}, is_call = {};
+                for (std::size_t j = 0; j < LANES; ++j)
+                {
+                    S[j] = b.S[half + j];
+                    K[j] = b.K[half + j];
+                    r[j] = b.r[half + j];
+                    T[j] = b.T[half + j];
+                    q[j] = b.q[half + j];
+                    m[j] = market_price[half + j];
+                    vol[j] = sigma[half + j];
+                    mask[j] = refine[half + j];
+                    is_call[j] = b.is_call[half + j];
+                }
+                if (!any(mask))
+                {
+                    continue;
+                }
+                vdouble sqrt_T = sqrt(T);
+                vdouble fwd_S = S * exp(-q * T);
+                vdouble fwd_K = K * exp(-r * T);
+                vdouble vol_sqrt_T = vol * sqrt_T;
+                vdouble D1 = log(fwd_S / fwd_K) / vol_sqrt_T + splat(0.5) * vol_sqrt_T;
+                vdouble D2 = D1 - vol_sqrt_T;
+                vdouble omega = select(is_call, splat(1.0), splat(-1.0));
+                vdouble price = omega * (fwd_S * norm_cdf(omega * D1) - fwd_K * norm_cdf(omega * D2));
+                vdouble vega = fwd_S * norm_pdf(D1) * sqrt_T;
+                vdouble step = vol - (price - m) / vega;
+                // Keep the float root when the step is not usable (comparisons with NaN are false)
+                vint usable = mask & less(splat(1e-300), vega) & less(splat(0.0), step) &
+                              ~less(splat(models::IV_MAX_VOLATILITY), step);
+                vol = select(usable, step, vol);
+                for (std::size_t j = 0; j < LANES; ++j)
+                {
+                    sigma[half + j] = static_cast<float>(vol[j]);
+                }
+            }
+            return sigma;
+        }
+
+        /**
+         * @brief Float implied volatilities for n quotes, solved 16 at a time.
+         *
+         * Statuses follow models::solve_implied_volatility. Lanes converge when
+         * the price error is below tol or 16 float ulps of the upper price
+         * bound, or when the bracket is narrower than tol. refine adds one
+         * double-precision Newton step to every converged lane.
+         */
+        inline OPTIPRICER_SIMD_DISPATCH void implied_volatility(Column<float> market_price, Column<float> S,
+                                                                Column<float> K, Column<float> r, Column<float> T,
+                                                                Column<float> q, Column<bool> is_call, double tol,
+                                                                int max_iter, bool refine, float *sigma_out,
+                                                                std::int8_t *status_out, std::size_t n)
+        {
+            const vfloat zero = splatf(0.0f);
+            const vfloat nan = splatf(std::numeric_limits<float>::quiet_NaN());
+            const vfloat max_vol = splatf(static_cast<float>(models::IV_MAX_VOLATILITY));
+            const vfloat ftol = splatf(static_cast<float>(tol));
+            const vfloat ulps = splatf(16.0f * std::numeric_limits<float>::epsilon());
+            const vfloat infinity = splatf(std::numeric_limits<float>::infinity());
+            // The solver has no volatility input; the block's sigma slot stays at a placeholder
+            const float no_sigma = 0.2f;
+            for (std::size_t i = 0; i < n; i += FLOAT_LANES)
+            {
+                const std::size_t count = std::min(FLOAT_LANES, n - i);
+                FloatBlock b = load_block(S, K, r, T, {&no_sigma, 0}, q, is_call, i, count);
+                const vfloat m = load(market_price, i, count, 1.0f);
+
+                vintf status = splatf_int(static_cast<std::int32_t>(models::IVStatus::INVALID_INPUT));
+                vintf active = splatf_int(0);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    if (m[j] > 0.0f && std::isfinite(m[j]) &&
+                        models::BlackScholesModel::inputs_valid(b.K[j], 0.0, b.r[j], b.T[j], b.S[j], b.q[j]))
+                    {
+                        active[j] = -1;
+                    }
+                }
+
+                vfloat sqrt_T = sqrt(b.T);
+                vfloat fwd_S = b.S * exp(-b.q * b.T);
+                vfloat fwd_K = b.K * exp(-b.r * b.T);
+                vfloat gap = fwd_S - fwd_K;
+                vfloat intrinsic = select(b.is_call, gap, -gap);
+                intrinsic = select(less(intrinsic, zero), zero, intrinsic);
+                vfloat upper = select(b.is_call, fwd_S, fwd_K);
+                vintf below = active & less(m, intrinsic);
+                vintf above = active & less(upper, m);
+                status = select(below, splatf_int(static_cast<std::int32_t>(models::IVStatus::BELOW_INTRINSIC)), status);
+                status = select(above, splatf_int(static_cast<std::int32_t>(models::IVStatus::ABOVE_MAXIMUM)), status);
+                active = active & ~below & ~above;
+
+                // Corrado-Miller seed on the equivalent call, Brenner-Subrahmanyam fallback
+                vfloat call = select(b.is_call, m, m + gap);
+                vfloat a = call - splatf(0.5f) * gap;
+                vfloat disc = a * a - gap * gap / splatf(static_cast<float>(utils::PI));
+                disc = select(less(disc, zero), zero, disc);
+                const vfloat root_2pi = splatf(static_cast<float>(utils::SQRT_2PI));
+                vfloat sigma = root_2pi / (fwd_S + fwd_K) * (a + sqrt(disc)) / sqrt_T;
+                vintf usable = less(splatf(1e-3f), sigma) & less(sigma, infinity);
+                sigma = select(usable, sigma, root_2pi * call / (fwd_S * sqrt_T));
+                usable = less(splatf(1e-3f), sigma) & less(sigma, infinity);
+                sigma = min(select(usable, sigma, splatf(0.2f)), max_vol);
+
+                const vfloat price_tol = select(less(ftol, ulps * upper), ulps * upper, ftol);
+                const vfloat log_moneyness = log(fwd_S / fwd_K);
+                const vfloat omega = select(b.is_call, splatf(1.0f), splatf(-1.0f));
+                vfloat low = zero;
+                vfloat high = max_vol;
+                vintf bracketed = splatf_int(0);
+                vintf done = ~active;
+                for (int iter = 0; iter < max_iter && any(~done); ++iter)
+                {
+                    vfloat vol_sqrt_T = sigma * sqrt_T;
+                    vfloat D1 = log_moneyness / vol_sqrt_T + splatf(0.5f) * vol_sqrt_T;
+                    vfloat D2 = D1 - vol_sqrt_T;
+                    vfloat diff = omega * (fwd_S * norm_cdf(omega * D1) - fwd_K * norm_cdf(omega * D2)) - m;
+
+                    vintf converged = ~done & less(abs(diff), price_tol);
+                    status = select(converged, splatf_int(static_cast<std::int32_t>(models::IVStatus::OK)), status);
+                    done = done | converged;
+
+                    vintf over = ~done & less(zero, diff);
+                    vintf under = ~done & ~over;
+                    high = select(over, sigma, high);
+                    bracketed = bracketed | over;
+                    low = select(under, sigma, low);
+                    vintf too_high = under & ~bracketed & ~less(sigma, max_vol);
+                    status = select(too_high, splatf_int(static_cast<std::int32_t>(models::IVStatus::VOLATILITY_TOO_HIGH)),
+                                    status);
+                    done = done | too_high;
+
+                    vfloat vega = fwd_S * norm_pdf(D1) * sqrt_T;
+                    vfloat newton = select(less(splatf(1e-30f), vega), sigma - diff / vega, nan);
+                    vintf inside = less(low, newton) & less(newton, high);
+                    vfloat next = select(inside, newton,
+                                         select(bracketed, splatf(0.5f) * (low + high), min(splatf(2.0f) * sigma, max_vol)));
+                    sigma = select(done, sigma, next);
+
+                    vintf narrow = ~done & bracketed & less(high - low, ftol);
+                    sigma = select(narrow, splatf(0.5f) * (low + high), sigma);
+                    status = select(narrow, splatf_int(static_cast<std::int32_t>(models::IVStatus::OK)), status);
+                    done = done | narrow;
+                }
+                status = select(~done, splatf_int(static_cast<std::int32_t>(models::IVStatus::NOT_CONVERGED)), status);
+
+                vintf ok = status == splatf_int(static_cast<std::int32_t>(models::IVStatus::OK));
+                vintf keep = ok | (status == splatf_int(static_cast<std::int32_t>(models::IVStatus::NOT_CONVERGED)));
+                if (refine && any(ok))
+                {
+                    sigma = refine_in_double(b, m, sigma, ok);
+                }
+                store(sigma_out + i, select(keep, sigma, nan), count);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    status_out[i + j] = static_cast<std::int8_t>(status[j]);
+                }
+            }
+        }
+#else
+        inline void bs_price_delta(Column<float> S, Column<float> K, Column<float> r,
+                                   Column<float> T, Column<float> sigma, Column<float> q,
+                                   Column<bool> is_call, float *price, float *delta,
+                                   std::size_t n)
+        {
+            double p[64], d[64];
+            for (std::size_t i = 0; i < n; i += 64)
+            {
+                const std::size_t count = std::min<std::size_t>(64, n - i);
+                double in[6][64];
+                bool side[64];
+                const Column<float> cols[6] = {S, K, r, T, sigma, q};
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    for (std::size_t c = 0; c < 6; ++c)
+                    {
+                        in[c][j] = cols[c][i + j];
+                    }
+                    side[j] = is_call[i + j];
+                }
+                bs_price_delta({in[0], 1}, {in[1], 1}, {in[2], 1}, {in[3], 1}, {in[4], 1}, {in[5], 1}, {side, 1},
+                               p, d, count);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    price[i + j] = static_cast<float>(p[j]);
+                    if (delta != nullptr)
+                    {
+                        delta[i + j] = static_cast<float>(d[j]);
+                    }
+                }
+            }
+        }
+
+        inline void all_greeks(Column<float> S, Column<float> K, Column<float> r,
+                               Column<float> T, Column<float> sigma, Column<float> q,
+                               models::AllGreeks32 *out, std::size_t n)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                models::AllGreeks g = models::compute_all_greeks(S[i], K[i], r[i], T[i], sigma[i], q[i]);
+                out[i] = {static_cast<float>(g.call_price), static_cast<float>(g.put_price),
+                          static_cast<float>(g.call_delta), static_cast<float>(g.put_delta),
+                          static_cast<float>(g.gamma), static_cast<float>(g.vega),
+                          static_cast<float>(g.call_theta), static_cast<float>(g.put_theta),
+                          static_cast<float>(g.call_rho), static_cast<float>(g.put_rho),
+                          static_cast<float>(g.vanna), static_cast<float>(g.volga),
+                          static_cast<float>(g.call_charm), static_cast<float>(g.put_charm)};
+            }
+        }
+
+        inline void implied_volatility(Column<float> market_price, Column<float> S,
+                                       Column<float> K, Column<float> r, Column<float> T,
+                                       Column<float> q, Column<bool> is_call, double tol,
+                                       int max_iter, bool refine, float *sigma_out,
+                                       std::int8_t *status_out, std::size_t n)
+        {
+            (void)refine;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                models::IVResult result = models::solve_implied_volatility(market_price[i], K[i], r[i], T[i], S[i], q[i],
+                                                                           is_call[i], tol, max_iter);
+                sigma_out[i] = static_cast<float>(result.volatility);
+                status_out[i] = static_cast<std::int8_t>(result.status);
+            }
+        }
+#endif
+    }
+}
+
+#endif // OPTIPRICER_SIMD_FLOAT_HPP
@@ -0,0 +1,741 @@
+#ifndef OPTIPRICER_SNAPSHOT_HPP
+#define OPTIPRICER_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "parallel.hpp"
+#include "parity.hpp"
+#include "surface.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Binary columnar option chain snapshots, read through a memory map.
+ *
+ * File layout (native byte order, every offset from the start of the file
+ * and a multiple of 8):
+ *
+ *   FileHeader                      64 bytes: magic, version, byte-order mark,
+ *                                   snapshot count, index offset
+ *   per snapshot:
+ *     SnapshotRecord                timestamp, S, r, q, expiry count
+ *     ExpiryRecord[num_expiries]    T, strike count, offset of its columns
+ *     per expiry: NUM_COLUMNS columns of num_strikes doubles, one after the
+ *     other (strike, iv, call_price, put_price); NaN marks a missing value
+ *   uint64 index[num_snapshots]     offset of each SnapshotRecord
+ *
+ * SnapshotWriter appends snapshots and writes the index and the final header
+ * on close(), so a file whose writer did not finish is rejected rather than
+ * read half-written. Within a snapshot, expiries are sorted by T and strikes
+ * ascending, so readers can hand the columns straight to the engines.
+ */
+
+namespace optipricer
+{
+    namespace snapshot
+    {
+        enum SnapshotColumn : std::size_t
+        {
+            STRIKE,
+            IV,
+            CALL_PRICE,
+            PUT_PRICE,
+            NUM_COLUMNS
+        };
+
+        constexpr const char *COLUMN_NAMES[NUM_COLUMNS] = {"strike", "iv", "call_price", "put_price"};
+
+        constexpr std::uint32_t FORMAT_VERSION = 1;
+
+        namespace detail
+        {
+            constexpr char MAGIC[8] = {'O', 'P', 'T', 'S', 'N', 'A', 'P', '\0'};
+            constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+            struct FileHeader
+            {
+                char magic[8];
+                std::uint32_t version;
+                std::uint32_t byte_order;
+                std::uint64_t num_snapshots;
+                std::uint64_t index_offset;
+                std::uint64_t reserved[4];
+            };
+
+            struct SnapshotRecord
+            {
+                double timestamp;
+                double underlying_price;
+                double risk_free_rate;
+                double dividend_yield;
+                std::uint64_t num_expiries;
+                std::uint64_t reserved;
+            };
+
+            struct ExpiryRecord
+            {
+                double time_to_maturity;
+                std::uint64_t num_strikes;
+                std::uint64_t columns_offset;
+                std::uint64_t reserved;
+            };
+
+            static_assert(sizeof(FileHeader) == 64, "snapshot header layout");
+            static_assert(sizeof(SnapshotRecord) == 48, "snapshot record layout");
+            static_assert(sizeof(ExpiryRecord) == 32, "expiry record layout");
+
+            /**
+             * @brief Read-only mapping of a whole file, unmapped when the last reference goes
+             */
+            class Mapping
+            {
+            private:
+                const unsigned char *base = nullptr;
+                std::size_t length = 0;
+#if defined(_WIN32)
+                HANDLE file = INVALID_HANDLE_VALUE;
+                HANDLE view = nullptr;
+#endif
+
+            public:
+                explicit Mapping(const std::string &path)
+                {
+#if defined(_WIN32)
+                    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                       FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                    if (file == INVALID_HANDLE_VALUE)
+                    {
+                        throw std::runtime_error("Cannot open snapshot file: " + path);
+                    }
+                    LARGE_INTEGER size;
+                    if (!GetFileSizeEx(file, &size))
+                    {
+                        CloseHandle(file);
+                        throw std::runtime_error("Cannot read the size of snapshot file: " + path);
+                    }
+                    length = static_cast<std::size_t>(size.QuadPart);
+                    if (length > 0)
+                    {
+                        view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                        base = view ? static_cast<const unsigned char *>(MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0))
+                                    : nullptr;
+                        if (base == nullptr)
+                        {
+                            if (view)
+                            {
+                                CloseHandle(view);
+                            }
+                            CloseHandle(file);
+                            throw std::runtime_error("Cannot memory-map snapshot file: " + path);
+                        }
+                    }
+#else
+                    int fd = ::open(path.c_str(), O_RDONLY);
+                    if (fd < 0)
+                    {
+                        throw std::runtime_error("Cannot open snapshot file: " + path + " (" + std::strerror(errno) + ")");
+                    }
+                    struct stat info;
+                    if (::fstat(fd, &info) != 0)
+                    {
+                        ::close(fd);
+                        throw std::runtime_error("Cannot read the size of snapshot file: " + path);
+                    }
+                    length = static_cast<std::size_t>(info.st_size);
+                    if (length > 0)
+                    {
+                        void *p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                        if (p == MAP_FAILED)
+                        {
+                            ::close(fd);
+                            throw std::runtime_error("Cannot memory-map snapshot file: " + path + " (" +
+                                                     std::strerror(errno) + ")");
+                        }
+                        // Replays walk the file front to back
+                        ::madvise(p, length, MADV_SEQUENTIAL);
+                        base = static_cast<const unsigned char *>(p);
+                    }
+                    ::close(fd);
+#endif
+                }
+
+                Mapping(const Mapping &) = delete;
+                Mapping &operator=(const Mapping &) = delete;
+
+                ~Mapping()
+                {
+#if defined(_WIN32)
+                    if (base)
+                    {
+                        UnmapViewOfFile(base);
+                    }
+                    if (view)
+                    {
+                        CloseHandle(view);
+                    }
+                    if (file != INVALID_HANDLE_VALUE)
+                    {
+                        CloseHandle(file);
+                    }
+#else
+                    if (base)
+                    {
+                        ::munmap(const_cast<unsigned char *>(base), length);
+                    }
+#endif
+                }
+
+                const unsigned char *data() const { return base; }
+                std::size_t size() const { return length; }
+            };
+
+            // True when [offset, offset + count * item) lies inside a file of size bytes and offset is 8-aligned
+            inline bool in_bounds(std::uint64_t offset, std::uint64_t count, std::uint64_t item, std::size_t size)
+            {
+                if (offset % 8 != 0 || offset > size)
+                {
+                    return false;
+                }
+                return count <= (size - offset) / item;
+            }
+        }
+
+        /**
+         * @brief Columns of one expiry inside a mapped snapshot (no copies; valid while the reader lives)
+         */
+        struct ExpiryView
+        {
+            double time_to_maturity;
+            std::size_t num_strikes;
+            const double *columns;
+
+            const double *column(std::size_t c) const { return columns + c * num_strikes; }
+        };
+
+        /**
+         * @brief One chain snapshot of a SnapshotReader; holds the mapping alive
+         */
+        class ChainSnapshot
+        {
+        private:
+            std::shared_ptr<const detail::Mapping> mapping;
+            const detail::SnapshotRecord *record;
+            const detail::ExpiryRecord *expiry_records;
+
+        public:
+            ChainSnapshot(std::shared_ptr<const detail::Mapping> map, const detail::SnapshotRecord *rec)
+                : mapping(std::move(map)), record(rec),
+                  expiry_records(reinterpret_cast<const detail::ExpiryRecord *>(rec + 1))
+            {
+            }
+
+            double get_timestamp() const { return record->timestamp; }
+            double get_underlying_price() const { return record->underlying_price; }
+            double get_risk_free_rate() const { return record->risk_free_rate; }
+            double get_dividend_yield() const { return record->dividend_yield; }
+            std::size_t num_expiries() const { return static_cast<std::size_t>(record->num_expiries); }
+
+            ExpiryView expiry(std::size_t e) const
+            {
+                if (e >= num_expiries())
+                {
+                    throw std::out_of_range("Expiry index " + std::to_string(e) + " out of range for " +
+                                            std::to_string(num_expiries()) + " expiries");
+                }
+                const detail::ExpiryRecord &x = expiry_records[e];
+                return {x.time_to_maturity, static_cast<std::size_t>(x.num_strikes),
+                        reinterpret_cast<const double *>(mapping->data() + x.columns_offset)};
+            }
+
+            std::size_t num_quotes() const
+            {
+                std::size_t n = 0;
+                for (std::size_t e = 0; e < num_expiries(); ++e)
+                {
+                    n += static_cast<std::size_t>(expiry_records[e].num_strikes);
+                }
+                return n;
+            }
+
+            /**
+             * @brief Volatility surface over the union of every expiry's strikes.
+             *
+             * Strikes an expiry does not quote become NaN holes, filled by the
+             * surface as in VolatilitySurface.from_chain_data.
+             */
+            std::unique_ptr<surface::VolatilitySurface> build_surface() const
+            {
+                const std::size_t ne = num_expiries();
+                if (ne == 0)
+                {
+                    throw std::invalid_argument("Snapshot has no expiries to build a surface from");
+                }
+                std::vector<double> strikes, expiries(ne);
+                for (std::size_t e = 0; e < ne; ++e)
+                {
+                    const ExpiryView x = expiry(e);
+                    const std::size_t mid = strikes.size();
+                    strikes.insert(strikes.end(), x.column(STRIKE), x.column(STRIKE) + x.num_strikes);
+                    std::inplace_merge(strikes.begin(), strikes.begin() + static_cast<std::ptrdiff_t>(mid), strikes.end());
+                    strikes.erase(std::unique(strikes.begin(), strikes.end()), strikes.end());
+                    expiries[e] = x.time_to_maturity;
+                }
+
+                const std::size_t ns = strikes.size();
+                std::vector<double> grid(ne * ns, std::numeric_limits<double>::quiet_NaN());
+                for (std::size_t e = 0; e < ne; ++e)
+                {
+                    const ExpiryView x = expiry(e);
+                    const double *K = x.column(STRIKE);
+                    const double *iv = x.column(IV);
+                    std::size_t k = 0;
+                    for (std::size_t j = 0; j < x.num_strikes; ++j)
+                    {
+                        while (k + 1 < ns && strikes[k] < K[j])
+                        {
+                            ++k;
+                        }
+                        grid[e * ns + k] = iv[j];
+                    }
+                }
+                return std::unique_ptr<surface::VolatilitySurface>(
+                    new surface::VolatilitySurface(strikes, expiries, grid.data()));
+            }
+
+            /**
+             * @brief Put-call parity fit of every expiry, straight from the mapped columns.
+             *
+             * Expiries are fitted in parallel with parity::fit_expiry against the
+             * snapshot's spot and rate; the fits come back ordered by expiry.
+             */
+            std::vector<parity::ParityFit> fit_parity(bool fit_rate = false,
+                                                      double outlier_threshold = parity::DEFAULT_OUTLIER_THRESHOLD) const
+            {
+                const std::size_t ne = num_expiries();
+                if (ne == 0)
+                {
+                    throw std::invalid_argument("Snapshot has no expiries to fit");
+                }
+                std::vector<parity::ParityFit> fits(ne);
+                parallel::parallel_for(ne, 1, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t e = begin; e < end; ++e)
+                    {
+                        const ExpiryView x = expiry(e);
+                        fits[e] = parity::fit_expiry(get_underlying_price(), get_risk_free_rate(), x.time_to_maturity,
+                                                     x.column(STRIKE), x.column(CALL_PRICE), x.column(PUT_PRICE),
+                                                     nullptr, x.num_strikes, fit_rate, outlier_threshold);
+                    }
+                });
+                std::sort(fits.begin(), fits.end(),
+                          [](const parity::ParityFit &a, const parity::ParityFit &b) { return a.expiry < b.expiry; });
+                return fits;
+            }
+        };
+
+        /**
+         * @brief Memory-maps a snapshot file and hands out snapshots without parsing or copying.
+         *
+         * Opening checks the header and the index. A snapshot's expiry table and
+         * columns are bounds-checked, and its strikes checked to be sorted, the
+         * first time at() hands it out; timestamp() and find() read only the
+         * snapshot record. A truncated or corrupt file raises instead of reading
+         * outside the mapping.
+         */
+        class SnapshotReader
+        {
+        private:
+            std::shared_ptr<const detail::Mapping> mapping;
+            const std::uint64_t *index = nullptr;
+            std::size_t count = 0;
+            std::string path;
+            // Snapshots whose columns at() has checked; shared by copies of the reader
+            std::shared_ptr<std::atomic<bool>[]> checked;
+
+            [[noreturn]] void corrupt(const std::string &what) const
+            {
+                throw std::runtime_error("Corrupt snapshot file " + path + ": " + what);
+            }
+
+            const detail::SnapshotRecord *record_at(std::size_t i) const
+            {
+                if (i >= count)
+                {
+                    throw std::out_of_range("Snapshot index " + std::to_string(i) + " out of range for " +
+                                            std::to_string(count) + " snapshots");
+                }
+                if (!detail::in_bounds(index[i], 1, sizeof(detail::SnapshotRecord), mapping->size()))
+                {
+                    corrupt("snapshot " + std::to_string(i) + " out of bounds");
+                }
+                return reinterpret_cast<const detail::SnapshotRecord *>(mapping->data() + index[i]);
+            }
+
+            void check_columns(std::size_t i, const detail::SnapshotRecord *record) const
+            {
+                const std::size_t size = mapping->size();
+                const std::uint64_t records = index[i] + sizeof(detail::SnapshotRecord);
+                if (!detail::in_bounds(records, record->num_expiries, sizeof(detail::ExpiryRecord), size))
+                {
+                    corrupt("expiry table of snapshot " + std::to_string(i) + " out of bounds");
+                }
+                const auto *expiries = reinterpret_cast<const detail::ExpiryRecord *>(mapping->data() + records);
+                for (std::uint64_t e = 0; e < record->num_expiries; ++e)
+                {
+                    if (expiries[e].num_strikes > std::numeric_limits<std::uint64_t>::max() / NUM_COLUMNS ||
+                        !detail::in_bounds(expiries[e].columns_offset, expiries[e].num_strikes * NUM_COLUMNS,
+                                           sizeof(double), size))
+                    {
+                        corrupt("columns of snapshot " + std::to_string(i) + " out of bounds");
+                    }
+                    const auto *K = reinterpret_cast<const double *>(mapping->data() + expiries[e].columns_offset);
+                    for (std::uint64_t j = 0; j < expiries[e].num_strikes; ++j)
+                    {
+                        if (!(K[j] > (j ? K[j - 1] : 0.0)) || !std::isfinite(K[j]))
+                        {
+                            corrupt("strikes of snapshot " + std::to_string(i) + " are not positive, finite and "
+                                    "strictly increasing");
+                        }
+                    }
+                }
+            }
+
+        public:
+            explicit SnapshotReader(const std::string &file) : mapping(std::make_shared<detail::Mapping>(file)), path(file)
+            {
+                const std::size_t size = mapping->size();
+                if (size < sizeof(detail::FileHeader))
+                {
+                    corrupt("too short for a header");
+                }
+                detail::FileHeader header;
+                std::memcpy(&header, mapping->data(), sizeof(header));
+                if (std::memcmp(header.magic, detail::MAGIC, sizeof(header.magic)) != 0)
+                {
+                    corrupt("not an OptiPricer snapshot file");
+                }
+                if (header.byte_order != detail::BYTE_ORDER_MARK)
+                {
+                    corrupt("written on a machine with a different byte order");
+                }
+                if (header.version != FORMAT_VERSION)
+                {
+                    corrupt("unsupported format version " + std::to_string(header.version));
+                }
+                if (header.index_offset == 0)
+                {
+                    corrupt("the writer was not closed");
+                }
+                if (!detail::in_bounds(header.index_offset, header.num_snapshots, sizeof(std::uint64_t), size))
+                {
+                    corrupt("index out of bounds");
+                }
+                index = reinterpret_cast<const std::uint64_t *>(mapping->data() + header.index_offset);
+                count = static_cast<std::size_t>(header.num_snapshots);
+                checked.reset(new std::atomic<bool>[count]());
+            }
+
+            std::size_t size() const { return count; }
+            std::size_t file_size() const { return mapping->size(); }
+            const std::string &get_path() const { return path; }
+
+            ChainSnapshot at(std::size_t i) const
+            {
+                const detail::SnapshotRecord *record = record_at(i);
+                if (!checked[i].load())
+                {
+                    check_columns(i, record);
+                    checked[i].store(true);
+                }
+                return ChainSnapshot(mapping, record);
+            }
+
+            // Timestamp of snapshot i, read without touching its expiries
+            double timestamp(std::size_t i) const { return record_at(i)->timestamp; }
+
+            /**
+             * @brief Index of the last snapshot taken at or before timestamp (out_of_range if none)
+             */
+            std::size_t find(double timestamp) const
+            {
+                std::size_t lo = 0, hi = count;
+                while (lo < hi)
+                {
+                    const std::size_t mid = lo + (hi - lo) / 2;
+                    if (record_at(mid)->timestamp <= timestamp)
+                    {
+                        lo = mid + 1;
+                    }
+                    else
+                    {
+                        hi = mid;
+                    }
+                }
+                if (lo == 0)
+                {
+                    throw std::out_of_range("No snapshot at or before timestamp " + std::to_string(timestamp));
+                }
+                return lo - 1;
+            }
+
+            /**
+             * @brief Interpolated IV at n fixed (strike, expiry) points in every snapshot [begin, end).
+             *
+             * Builds each snapshot's surface and queries it, spread across the
+             * thread pool; out is row-major (end - begin, n).
+             */
+            void surface_series(std::size_t begin, std::size_t end, const double *strikes, const double *expiries,
+                                std::size_t n, double *out) const
+            {
+                if (begin > end || end > count)
+                {
+                    throw std::out_of_range("Snapshot range [" + std::to_string(begin) + ", " + std::to_string(end) +
+                                            ") out of range for " + std::to_string(count) + " snapshots");
+                }
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    at(i);
+                }
+                parallel::parallel_for(end - begin, 1, [&](std::size_t lo, std::size_t hi) {
+                    for (std::size_t i = lo; i < hi; ++i)
+                    {
+                        std::unique_ptr<surface::VolatilitySurface> s = at(begin + i).build_surface();
+                        s->get_iv_batch({strikes, 1}, {expiries, 1}, out + i * n, n);
+                    }
+                });
+            }
+        };
+
+        /**
+         * @brief Columns of one expiry handed to SnapshotWriter::append(); prices may be null
+         */
+        struct ExpiryColumns
+        {
+            double time_to_maturity;
+            const double *strikes;
+            const double *ivs;
+            const double *call_prices;
+            const double *put_prices;
+            std::size_t num_strikes;
+        };
+
+        /**
+         * @brief Appends chain snapshots to a new file; close() (or destruction) finalizes it.
+         *
+         * Timestamps must not decrease, so SnapshotReader::find() can bisect.
+         * Each expiry's strikes are sorted on the way in (duplicates are
+         * rejected) and expiries are ordered by time to maturity.
+         */
+        class SnapshotWriter
+        {
+        private:
+            std::FILE *file = nullptr;
+            std::string path;
+            std::vector<std::uint64_t> offsets;
+            std::uint64_t position = 0;
+            double last_timestamp = -std::numeric_limits<double>::infinity();
+            std::vector<unsigned char> buffer;
+
+            void write(const void *data, std::size_t bytes)
+            {
+                if (std::fwrite(data, 1, bytes, file) != bytes)
+                {
+                    throw std::runtime_error("Failed writing snapshot file: " + path);
+                }
+                position += bytes;
+            }
+
+            template <typename T>
+            static void put(std::vector<unsigned char> &out, std::size_t at, const T &value)
+            {
+                std::memcpy(out.data() + at, &value, sizeof(T));
+            }
+
+        public:
+            explicit SnapshotWriter(const std::string &file_path) : path(file_path)
+            {
+                file = std::fopen(path.c_str(), "wb");
+                if (file == nullptr)
+                {
+                    throw std::runtime_error("Cannot open snapshot file for writing: " + path);
+                }
+                // Placeholder until close(): index_offset 0 marks the file as unfinished
+                detail::FileHeader header{};
+                std::memcpy(header.magic, detail::MAGIC, sizeof(header.magic));
+                header.version = FORMAT_VERSION;
+                header.byte_order = detail::BYTE_ORDER_MARK;
+                write(&header, sizeof(header));
+            }
+
+            SnapshotWriter(const SnapshotWriter &) = delete;
+            SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+            ~SnapshotWriter()
+            {
+                try
+                {
+                    close();
+                }
+                catch (...)
+                {
+                }
+            }
+
+            void append(double timestamp, double S, double r, double q, const ExpiryColumns *expiries,
+                        std::size_t num_expiries)
+            {
+                if (file == nullptr)
+                {
+                    throw std::runtime_error("Snapshot writer is closed: " + path);
+                }
+                if (!std::isfinite(timestamp) || timestamp < last_timestamp)
+                {
+                    throw std::invalid_argument("Snapshot timestamps must be finite and non-decreasing, got " +
+                                                std::to_string(timestamp) + " after " + std::to_string(last_timestamp));
+                }
+                if (!(S > 0.0) || !std::isfinite(S) || !std::isfinite(r) || !(q >= 0.0) || !std::isfinite(q))
+                {
+                    throw std::invalid_argument("Invalid snapshot market data: underlying price must be positive, "
+                                                "rate finite and dividend yield non-negative");
+                }
+
+                std::vector<std::size_t> by_expiry(num_expiries);
+                std::iota(by_expiry.begin(), by_expiry.end(), std::size_t(0));
+                std::stable_sort(by_expiry.begin(), by_expiry.end(), [expiries](std::size_t a, std::size_t b) {
+                    return expiries[a].time_to_maturity < expiries[b].time_to_maturity;
+                });
+
+                std::size_t bytes = sizeof(detail::SnapshotRecord) + num_expiries * sizeof(detail::ExpiryRecord);
+                for (std::size_t e = 0; e < num_expiries; ++e)
+                {
+                    const ExpiryColumns &x = expiries[e];
+                    if (!(x.time_to_maturity > 0.0) || !std::isfinite(x.time_to_maturity))
+                    {
+                        throw std::invalid_argument("Time to maturity must be positive, got: " +
+                                                    std::to_string(x.time_to_maturity));
+                    }
+                    if (e > 0 && expiries[by_expiry[e]].time_to_maturity == expiries[by_expiry[e - 1]].time_to_maturity)
+                    {
+                        throw std::invalid_argument("Duplicate expiry in snapshot: " +
+                                                    std::to_string(expiries[by_expiry[e]].time_to_maturity));
+                    }
+                    bytes += NUM_COLUMNS * x.num_strikes * sizeof(double);
+                }
+
+                buffer.assign(bytes, 0);
+                detail::SnapshotRecord record{timestamp, S, r, q, num_expiries, 0};
+                put(buffer, 0, record);
+                std::size_t columns_at = sizeof(detail::SnapshotRecord) + num_expiries * sizeof(detail::ExpiryRecord);
+                std::vector<std::size_t> order;
+                for (std::size_t e = 0; e < num_expiries; ++e)
+                {
+                    const ExpiryColumns &x = expiries[by_expiry[e]];
+                    const std::size_t n = x.num_strikes;
+                    order.resize(n);
+                    std::iota(order.begin(), order.end(), std::size_t(0));
+                    std::stable_sort(order.begin(), order.end(),
+                                     [&x](std::size_t a, std::size_t b) { return x.strikes[a] < x.strikes[b]; });
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        const double K = x.strikes[order[j]];
+                        if (!(K > 0.0) || !std::isfinite(K))
+                        {
+                            throw std::invalid_argument("Strike price must be positive, got: " + std::to_string(K));
+                        }
+                        if (j > 0 && K == x.strikes[order[j - 1]])
+                        {
+                            throw std::invalid_argument("Duplicate strike " + std::to_string(K) + " at expiry " +
+                                                        std::to_string(x.time_to_maturity));
+                        }
+                        const double iv = x.ivs[order[j]];
+                        if (std::isinf(iv) || iv < 0.0)
+                        {
+                            throw std::invalid_argument("Implied volatility must be non-negative and finite "
+                                                        "(NaN marks a missing quote), got: " + std::to_string(iv));
+                        }
+                        const double nan = std::numeric_limits<double>::quiet_NaN();
+                        const double values[NUM_COLUMNS] = {K, iv, x.call_prices ? x.call_prices[order[j]] : nan,
+                                                            x.put_prices ? x.put_prices[order[j]] : nan};
+                        for (std::size_t c = 0; c < NUM_COLUMNS; ++c)
+                        {
+                            put(buffer, columns_at + (c * n + j) * sizeof(double), values[c]);
+                        }
+                    }
+                    detail::ExpiryRecord entry{x.time_to_maturity, n, position + columns_at, 0};
+                    put(buffer, sizeof(detail::SnapshotRecord) + e * sizeof(detail::ExpiryRecord), entry);
+                    columns_at += NUM_COLUMNS * n * sizeof(double);
+                }
+
+                offsets.push_back(position);
+                write(buffer.data(), buffer.size());
+                last_timestamp = timestamp;
+            }
+
+            std::size_t size() const { return offsets.size(); }
+
+            /**
+             * @brief Writes the index and the final header; further appends fail
+             */
+            void close()
+            {
+                if (file == nullptr)
+                {
+                    return;
+                }
+                std::FILE *f = file;
+                try
+                {
+                    detail::FileHeader header{};
+                    std::memcpy(header.magic, detail::MAGIC, sizeof(header.magic));
+                    header.version = FORMAT_VERSION;
+                    header.byte_order = detail::BYTE_ORDER_MARK;
+                    header.num_snapshots = offsets.size();
+                    header.index_offset = position;
+                    write(offsets.data(), offsets.size() * sizeof(std::uint64_t));
+                    if (std::fflush(f) != 0 || std::fseek(f, 0, SEEK_SET) != 0 ||
+                        std::fwrite(&header, sizeof(header), 1, f) != 1)
+                    {
+                        throw std::runtime_error("Failed finalizing snapshot file: " + path);
+                    }
+                }
+                catch (...)
+                {
+                    file = nullptr;
+                    std::fclose(f);
+                    throw;
+                }
+                file = nullptr;
+                if (std::fclose(f) != 0)
+                {
+                    throw std::runtime_error("Failed closing snapshot file: " + path);
+                }
+            }
+        };
+    }
+}
+
+#endif // OPTIPRICER_SNAPSHOT_HPP
@@ -0,0 +1,376 @@
+#ifndef OPTIPRICER_STATS_HPP
+#define OPTIPRICER_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(OPTIPRICER_STATS)
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+/*
+ * Opt-in instrumentation of the implied volatility solver and the pricing,
+ * Greeks and IV entry points.
+ *
+ * Compiled in only when OPTIPRICER_STATS is defined (for the extension,
+ * build with the OPTIPRICER_STATS environment variable set). Otherwise the
+ * hooks are empty inline functions and OPTIPRICER_STATS_TIMER expands to
+ * nothing, so the hot paths are unchanged, and snapshot() reports
+ * enabled = false with every count at zero.
+ *
+ * When enabled, each thread writes its own block of counters (no shared
+ * cache lines or locked instructions on the hot path); snapshot() sums the
+ * blocks of every thread that has recorded anything.
+ */
+
+namespace optipricer
+{
+    namespace stats
+    {
+        /**
+         * @brief Entry points with a per-call latency histogram
+         */
+        enum class Timer : int
+        {
+            PRICE = 0,                   // BlackScholesModel::call_price / put_price
+            GREEKS = 1,                  // GreeksCalculator::compute_all
+            IMPLIED_VOLATILITY = 2,      // calculate_implied_volatility
+            PRICE_BATCH = 3,             // price_batch / price_delta_batch, whole call
+            GREEKS_BATCH = 4,            // compute_all_batch, whole call
+            IMPLIED_VOLATILITY_BATCH = 5 // implied_volatility_batch, whole call
+        };
+
+        constexpr std::size_t NUM_TIMERS = 6;
+
+        inline const char *timer_name(Timer timer)
+        {
+            static const char *const names[NUM_TIMERS] = {"price", "greeks", "implied_volatility",
+                                                          "price_batch", "greeks_batch", "implied_volatility_batch"};
+            return names[static_cast<int>(timer)];
+        }
+
+        // Latency bucket b holds calls taking [2^b, 2^(b+1)) ns; the last one is open-ended
+        constexpr std::size_t LATENCY_BUCKETS = 32;
+        // Solves that needed 0, 1, ..., 15 iterations, then 16 or more
+        constexpr std::size_t ITERATION_BUCKETS = 17;
+
+        /**
+         * @brief Totals over every solve_implied_volatility() call.
+         *
+         * Each iteration that does not return ends in exactly one update: a
+         * Newton step, a bisection step inside the bracket, or a bracket
+         * expansion (doubling the volatility before an upper bound is known).
+         * Rejected solves are the ones refused before iterating (invalid
+         * inputs or a price outside the no-arbitrage bounds) plus those that
+         * ran into the volatility ceiling.
+         */
+        struct SolverCounts
+        {
+            std::uint64_t calls;
+            std::uint64_t converged;
+            std::uint64_t not_converged;
+            std::uint64_t rejected;
+            std::uint64_t iterations;
+            std::uint64_t newton_steps;
+            std::uint64_t bisection_steps;
+            std::uint64_t bracket_expansions;
+            std::uint64_t iteration_histogram[ITERATION_BUCKETS];
+        };
+
+        struct LatencyHistogram
+        {
+            std::uint64_t count;
+            std::uint64_t total_ns;
+            std::uint64_t buckets[LATENCY_BUCKETS];
+
+            double mean_ns() const { return count ? static_cast<double>(total_ns) / count : 0.0; }
+
+            /**
+             * @brief Upper edge of the bucket holding the p-quantile (0 if nothing was recorded)
+             */
+            double quantile_ns(double p) const
+            {
+                if (count == 0)
+                {
+                    return 0.0;
+                }
+                const double target = p * static_cast<double>(count);
+                std::uint64_t seen = 0;
+                for (std::size_t b = 0; b < LATENCY_BUCKETS; ++b)
+                {
+                    seen += buckets[b];
+                    if (static_cast<double>(seen) >= target && seen > 0)
+                    {
+                        return static_cast<double>(std::uint64_t(1) << (b + 1));
+                    }
+                }
+                return static_cast<double>(std::uint64_t(1) << LATENCY_BUCKETS);
+            }
+        };
+
+        struct Snapshot
+        {
+            bool enabled;
+            SolverCounts implied_volatility;
+            LatencyHistogram latency[NUM_TIMERS];
+        };
+
+        constexpr bool enabled()
+        {
+#if defined(OPTIPRICER_STATS)
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Step tally of one solve, kept on the solver's stack and recorded once at the end
+         */
+        struct SolverSteps
+        {
+#if defined(OPTIPRICER_STATS)
+            std::uint32_t newton = 0;
+            std::uint32_t bisection = 0;
+            std::uint32_t expansions = 0;
+
+            void newton_step() { ++newton; }
+            void bisection_step() { ++bisection; }
+            void bracket_expansion() { ++expansions; }
+#else
+            void newton_step() {}
+            void bisection_step() {}
+            void bracket_expansion() {}
+#endif
+        };
+
+#if defined(OPTIPRICER_STATS)
+        namespace detail
+        {
+            typedef std::atomic<std::uint64_t> Cell;
+
+            struct ThreadBlock
+            {
+                Cell calls{0}, converged{0}, not_converged{0}, rejected{0};
+                Cell iterations{0}, newton_steps{0}, bisection_steps{0}, bracket_expansions{0};
+                Cell iteration_histogram[ITERATION_BUCKETS];
+                Cell latency_count[NUM_TIMERS];
+                Cell latency_total[NUM_TIMERS];
+                Cell latency_buckets[NUM_TIMERS][LATENCY_BUCKETS];
+
+                ThreadBlock()
+                {
+                    for (Cell &c : iteration_histogram)
+                    {
+                        c.store(0, std::memory_order_relaxed);
+                    }
+                    for (std::size_t t = 0; t < NUM_TIMERS; ++t)
+                    {
+                        latency_count[t].store(0, std::memory_order_relaxed);
+                        latency_total[t].store(0, std::memory_order_relaxed);
+                        for (Cell &c : latency_buckets[t])
+                        {
+                            c.store(0, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            };
+
+            // Only the owning thread writes its block, so load + store replaces a locked add
+            inline void bump(Cell &cell, std::uint64_t n = 1)
+            {
+                cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<std::unique_ptr<ThreadBlock>> blocks;
+                Snapshot baseline{};
+            };
+
+            // Never destroyed, so threads recording during static destruction stay safe
+            inline Registry &registry()
+            {
+                static Registry *instance = new Registry();
+                return *instance;
+            }
+
+            inline ThreadBlock &local()
+            {
+                thread_local ThreadBlock *block = nullptr;
+                if (block == nullptr)
+                {
+                    std::unique_ptr<ThreadBlock> owned(new ThreadBlock());
+                    block = owned.get();
+                    Registry &reg = registry();
+                    std::lock_guard<std::mutex> lock(reg.mutex);
+                    reg.blocks.push_back(std::move(owned));
+                }
+                return *block;
+            }
+
+            inline std::size_t latency_bucket(std::uint64_t ns)
+            {
+                std::size_t b = 0;
+                while (ns > 1 && b + 1 < LATENCY_BUCKETS)
+                {
+                    ns >>= 1;
+                    ++b;
+                }
+                return b;
+            }
+
+            inline std::uint64_t read(const Cell &cell) { return cell.load(std::memory_order_relaxed); }
+
+            // Caller holds the registry mutex
+            inline Snapshot totals(const Registry &reg)
+            {
+                Snapshot s{};
+                s.enabled = true;
+                SolverCounts &iv = s.implied_volatility;
+                for (const std::unique_ptr<ThreadBlock> &block : reg.blocks)
+                {
+                    iv.calls += read(block->calls);
+                    iv.converged += read(block->converged);
+                    iv.not_converged += read(block->not_converged);
+                    iv.rejected += read(block->rejected);
+                    iv.iterations += read(block->iterations);
+                    iv.newton_steps += read(block->newton_steps);
+                    iv.bisection_steps += read(block->bisection_steps);
+                    iv.bracket_expansions += read(block->bracket_expansions);
+                    for (std::size_t b = 0; b < ITERATION_BUCKETS; ++b)
+                    {
+                        iv.iteration_histogram[b] += read(block->iteration_histogram[b]);
+                    }
+                    for (std::size_t t = 0; t < NUM_TIMERS; ++t)
+                    {
+                        s.latency[t].count += read(block->latency_count[t]);
+                        s.latency[t].total_ns += read(block->latency_total[t]);
+                        for (std::size_t b = 0; b < LATENCY_BUCKETS; ++b)
+                        {
+                            s.latency[t].buckets[b] += read(block->latency_buckets[t][b]);
+                        }
+                    }
+                }
+                return s;
+            }
+        }
+
+        inline void record_solve(bool converged, bool not_converged, int iterations, const SolverSteps &steps)
+        {
+            detail::ThreadBlock &block = detail::local();
+            const std::uint64_t n = iterations > 0 ? static_cast<std::uint64_t>(iterations) : 0;
+            detail::bump(block.calls);
+            detail::bump(converged ? block.converged : not_converged ? block.not_converged : block.rejected);
+            detail::bump(block.iterations, n);
+            detail::bump(block.newton_steps, steps.newton);
+            detail::bump(block.bisection_steps, steps.bisection);
+            detail::bump(block.bracket_expansions, steps.expansions);
+            detail::bump(block.iteration_histogram[n < ITERATION_BUCKETS - 1 ? n : ITERATION_BUCKETS - 1]);
+        }
+
+        inline void record_latency(Timer timer, std::uint64_t ns)
+        {
+            detail::ThreadBlock &block = detail::local();
+            const int t = static_cast<int>(timer);
+            detail::bump(block.latency_count[t]);
+            detail::bump(block.latency_total[t], ns);
+            detail::bump(block.latency_buckets[t][detail::latency_bucket(ns)]);
+        }
+
+        /**
+         * @brief Records the lifetime of the enclosing scope under one Timer
+         */
+        class ScopedTimer
+        {
+        private:
+            Timer timer;
+            std::chrono::steady_clock::time_point start;
+
+        public:
+            explicit ScopedTimer(Timer t) : timer(t), start(std::chrono::steady_clock::now()) {}
+            ScopedTimer(const ScopedTimer &) = delete;
+            ScopedTimer &operator=(const ScopedTimer &) = delete;
+            ~ScopedTimer()
+            {
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                record_latency(timer, static_cast<std::uint64_t>(
+                                          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        };
+
+        /**
+         * @brief Everything recorded since the last reset(), summed over threads
+         */
+        inline Snapshot snapshot()
+        {
+            detail::Registry &reg = detail::registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            Snapshot s = detail::totals(reg);
+            const Snapshot &base = reg.baseline;
+            SolverCounts &iv = s.implied_volatility;
+            const SolverCounts &iv0 = base.implied_volatility;
+            iv.calls -= iv0.calls;
+            iv.converged -= iv0.converged;
+            iv.not_converged -= iv0.not_converged;
+            iv.rejected -= iv0.rejected;
+            iv.iterations -= iv0.iterations;
+            iv.newton_steps -= iv0.newton_steps;
+            iv.bisection_steps -= iv0.bisection_steps;
+            iv.bracket_expansions -= iv0.bracket_expansions;
+            for (std::size_t b = 0; b < ITERATION_BUCKETS; ++b)
+            {
+                iv.iteration_histogram[b] -= iv0.iteration_histogram[b];
+            }
+            for (std::size_t t = 0; t < NUM_TIMERS; ++t)
+            {
+                s.latency[t].count -= base.latency[t].count;
+                s.latency[t].total_ns -= base.latency[t].total_ns;
+                for (std::size_t b = 0; b < LATENCY_BUCKETS; ++b)
+                {
+                    s.latency[t].buckets[b] -= base.latency[t].buckets[b];
+                }
+            }
+            return s;
+        }
+
+        /**
+         * @brief Zeroes what snapshot() reports.
+         *
+         * Threads own their counters, so this moves a baseline rather than
+         * writing to them; counts recorded concurrently land on one side of it.
+         */
+        inline void reset()
+        {
+            detail::Registry &reg = detail::registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.baseline = detail::totals(reg);
+        }
+
+#define OPTIPRICER_STATS_CONCAT_(a, b) a##b
+#define OPTIPRICER_STATS_CONCAT(a, b) OPTIPRICER_STATS_CONCAT_(a, b)
+#define OPTIPRICER_STATS_TIMER(timer) \
+    ::optipricer::stats::ScopedTimer OPTIPRICER_STATS_CONCAT(optipricer_stats_timer_, __LINE__)(timer)
+#else
+        inline void record_solve(bool, bool, int, const SolverSteps &) {}
+
+        inline Snapshot snapshot()
+        {
+            Snapshot s{};
+            s.enabled = false;
+            return s;
+        }
+
+        inline void reset() {}
+
+#define OPTIPRICER_STATS_TIMER(timer)
+#endif
+    }
+}
+
+#endif // OPTIPRICER_STATS_HPP
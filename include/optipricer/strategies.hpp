@@ -3,9 +3,15 @@
 
 #include "models.hpp"
 #include "greeks.hpp"
+#include "parallel.hpp"
+#include "pde.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <string>
 #include <stdexcept>
+#include <limits>
 
 namespace optipricer {
 namespace strategies {
@@ -18,9 +24,27 @@ struct Position {
     PositionType position_type;
     double quantity;
     double strike;
+    // Leg-specific volatility; NaN means the leg uses the strategy volatility
+    double volatility_override;
 
     Position(OptionType opt_type, PositionType pos_type, double qty, double K)
-        : option_type(opt_type), position_type(pos_type), quantity(qty), strike(K) {}
+        : option_type(opt_type), position_type(pos_type), quantity(qty), strike(K),
+          volatility_override(std::numeric_limits<double>::quiet_NaN()) {}
+
+    bool has_volatility_override() const { return !std::isnan(volatility_override); }
+};
+
+// Position-weighted strategy aggregates
+struct StrategyGreeks {
+    double value;
+    double delta;
+    double gamma;
+    double vega;
+    double theta;
+    double rho;
+    double vanna;
+    double volga;
+    double charm;
 };
 
 // --- Base OptionsStrategy Class ---
@@ -34,6 +58,13 @@ protected:
     double dividend_yield;
     std::string strategy_name;
 
+    mutable std::vector<models::AllGreeks> leg_cache;
+    mutable StrategyGreeks total_cache = {};
+    mutable bool cache_valid = false;
+
+    bool pde_pricing = false;
+    pde::PDESettings pde_settings;
+
     void validate_inputs() const {
         if (underlying_price <= 0.0) {
             throw std::invalid_argument("Underlying price must be positive, got: " + std::to_string(underlying_price));
@@ -64,6 +95,54 @@ protected:
         }
     }
 
+    void check_leg_index(size_t index) const {
+        if (index >= positions.size()) {
+            throw std::out_of_range("Leg index " + std::to_string(index) + " out of range for " +
+                                    std::to_string(positions.size()) + " positions");
+        }
+    }
+
+    // Fills leg_cache with one chain solve per distinct leg volatility, a call and a put column per leg
+    void price_legs_pde() const {
+        std::vector<bool> done(positions.size(), false);
+        std::vector<size_t> legs;
+        std::vector<double> strikes;
+        std::vector<pde::PDEResult> results;
+        for (size_t first = 0; first < positions.size(); ++first) {
+            if (done[first]) {
+                continue;
+            }
+            const Position& lead = positions[first];
+            double sigma = lead.has_volatility_override() ? lead.volatility_override : volatility;
+            legs.clear();
+            for (size_t i = first; i < positions.size(); ++i) {
+                const Position& pos = positions[i];
+                if (!done[i] && (pos.has_volatility_override() ? pos.volatility_override : volatility) == sigma) {
+                    legs.push_back(i);
+                    done[i] = true;
+                }
+            }
+            const size_t m = legs.size();
+            strikes.resize(2 * m);
+            std::unique_ptr<bool[]> calls(new bool[2 * m]);
+            for (size_t j = 0; j < m; ++j) {
+                strikes[j] = strikes[m + j] = positions[legs[j]].strike;
+                calls[j] = true;
+                calls[m + j] = false;
+            }
+            results.resize(2 * m);
+            pde::CrankNicolsonEngine engine(underlying_price, risk_free_rate, time_to_maturity, sigma, dividend_yield);
+            engine.price_chain({strikes.data(), 1}, {calls.get(), 1}, 2 * m, pde_settings, results.data());
+            for (size_t j = 0; j < m; ++j) {
+                const pde::PDEResult& c = results[j];
+                const pde::PDEResult& p = results[m + j];
+                const pde::PDEResult& own = positions[legs[j]].option_type == OptionType::CALL ? c : p;
+                leg_cache[legs[j]] = {c.price, p.price, c.delta, p.delta, own.gamma, own.vega, c.theta, p.theta,
+                                      c.rho, p.rho, own.vanna, own.volga, c.charm, p.charm};
+            }
+        }
+    }
+
 public:
     OptionsStrategy(double S, double sigma, double r, double T, const std::string& name, double q = 0.0)
         : underlying_price(S), volatility(sigma), risk_free_rate(r),
@@ -88,119 +167,143 @@ public:
             throw std::invalid_argument("Position parameters cannot be infinite");
         }
         positions.emplace_back(opt_type, pos_type, qty, strike);
+        cache_valid = false;
     }
 
 
-    double total_value() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            double value = (pos.option_type == OptionType::CALL) 
-                         ? model.call_price() 
-                         : model.put_price();
-            total += (pos.position_type == PositionType::LONG) ? value * pos.quantity
-                                                               : -value * pos.quantity;
+    /**
+     * @brief Re-marks the strategy in place.
+     *
+     * Inputs are checked like the constructor's; on failure the previous
+     * market state is kept. Positions and the leg cache storage are reused,
+     * so re-pricing afterwards does not allocate.
+     */
+    void update_market(double S, double sigma, double r, double T, double q) {
+        const double previous[5] = {underlying_price, volatility, risk_free_rate, time_to_maturity, dividend_yield};
+        underlying_price = S;
+        volatility = sigma;
+        risk_free_rate = r;
+        time_to_maturity = T;
+        dividend_yield = q;
+        try {
+            validate_inputs();
+        } catch (...) {
+            underlying_price = previous[0];
+            volatility = previous[1];
+            risk_free_rate = previous[2];
+            time_to_maturity = previous[3];
+            dividend_yield = previous[4];
+            throw;
         }
-        return total;
+        cache_valid = false;
     }
 
-    // Total Greeks (Delta example, similar for Gamma, Vega, Theta)
-    double total_delta() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            models::GreeksCalculator greeks(model);
-            double delta = (pos.option_type == OptionType::CALL) ? greeks.call_delta() : greeks.put_delta();
-            total += (pos.position_type == PositionType::LONG) ? delta * pos.quantity : -delta * pos.quantity;
+    // Prices leg `index` at its own volatility instead of the strategy's
+    void set_leg_volatility(size_t index, double sigma) {
+        check_leg_index(index);
+        if (std::isnan(sigma) || std::isinf(sigma) || sigma < 0.0 || sigma > 10.0) {
+            throw std::invalid_argument("Leg volatility must be within [0, 10], got: " + std::to_string(sigma));
         }
-        return total;
+        positions[index].volatility_override = sigma;
+        cache_valid = false;
     }
 
-    double total_gamma() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            models::GreeksCalculator greeks(model);
-            double g = greeks.gamma();
-            total += (pos.position_type == PositionType::LONG) ? g * pos.quantity : -g * pos.quantity;
-        }
-        return total;
+    // Returns leg `index` to the strategy volatility
+    void clear_leg_volatility(size_t index) {
+        check_leg_index(index);
+        positions[index].volatility_override = std::numeric_limits<double>::quiet_NaN();
+        cache_valid = false;
     }
 
-    double total_vega() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            models::GreeksCalculator greeks(model);
-            double v = greeks.vega();
-            total += (pos.position_type == PositionType::LONG) ? v * pos.quantity : -v * pos.quantity;
+    /**
+     * @brief Prices the legs with the Crank-Nicolson engine, e.g. to value American exercise.
+     *
+     * Legs sharing a volatility are solved together on one grid. The legs
+     * are vanillas, so a barrier in `settings` is rejected. value_grid()
+     * stays closed form.
+     */
+    void set_pde_pricing(const pde::PDESettings& settings) {
+        if (settings.barrier != pde::BarrierType::NONE) {
+            throw std::invalid_argument("Strategy legs are vanilla options; PDE settings cannot carry a barrier");
         }
-        return total;
+        pde::detail::check(1.0, settings);
+        pde_settings = settings;
+        pde_pricing = true;
+        cache_valid = false;
     }
 
-    double total_theta() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            models::GreeksCalculator greeks(model);
-            double theta = (pos.option_type == OptionType::CALL) ? greeks.call_theta() : greeks.put_theta();
-            total += (pos.position_type == PositionType::LONG) ? theta * pos.quantity : -theta * pos.quantity;
-        }
-        return total;
+    // Returns to Black-Scholes closed-form leg pricing
+    void set_closed_form_pricing() {
+        pde_pricing = false;
+        cache_valid = false;
     }
 
-    double total_rho() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            models::GreeksCalculator greeks(model);
-            double rho = (pos.option_type == OptionType::CALL) ? greeks.call_rho() : greeks.put_rho();
-            total += (pos.position_type == PositionType::LONG) ? rho * pos.quantity : -rho * pos.quantity;
+    bool uses_pde_pricing() const { return pde_pricing; }
+
+    /**
+     * @brief Prices and Greeks of every leg, computed once and cached.
+     *
+     * Entry i matches positions[i] and holds the unsigned, per-unit values for
+     * both the call and the put at that strike. With PDE pricing the shared
+     * fields (gamma, vega, vanna, volga) are those of the leg's own option
+     * type, since early exercise breaks call/put symmetry. The cache is
+     * dropped whenever positions, leg volatilities, the pricing method or the
+     * market state change. Like the rest of the class it is not safe to use
+     * one strategy from several threads at once.
+     */
+    const std::vector<models::AllGreeks>& leg_greeks() const {
+        if (!cache_valid) {
+            leg_cache.resize(positions.size());
+            if (pde_pricing) {
+                price_legs_pde();
+            } else {
+                const models::ExpiryContext expiry =
+                    models::ExpiryContext::unchecked(risk_free_rate, time_to_maturity, dividend_yield);
+                for (size_t i = 0; i < positions.size(); ++i) {
+                    const Position& pos = positions[i];
+                    double sigma = pos.has_volatility_override() ? pos.volatility_override : volatility;
+                    leg_cache[i] = models::compute_all_greeks(underlying_price, pos.strike, sigma, expiry);
+                }
+            }
+            StrategyGreeks totals = {};
+            for (size_t i = 0; i < positions.size(); ++i) {
+                const Position& pos = positions[i];
+                const models::AllGreeks& g = leg_cache[i];
+                double w = (pos.position_type == PositionType::LONG) ? pos.quantity : -pos.quantity;
+                bool call = pos.option_type == OptionType::CALL;
+                totals.value += w * (call ? g.call_price : g.put_price);
+                totals.delta += w * (call ? g.call_delta : g.put_delta);
+                totals.gamma += w * g.gamma;
+                totals.vega += w * g.vega;
+                totals.theta += w * (call ? g.call_theta : g.put_theta);
+                totals.rho += w * (call ? g.call_rho : g.put_rho);
+                totals.vanna += w * g.vanna;
+                totals.volga += w * g.volga;
+                totals.charm += w * (call ? g.call_charm : g.put_charm);
+            }
+            total_cache = totals;
+            cache_valid = true;
         }
-        return total;
+        return leg_cache;
     }
 
-    double total_vanna() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            models::GreeksCalculator greeks(model);
-            double v = greeks.vanna();
-            total += (pos.position_type == PositionType::LONG) ? v * pos.quantity : -v * pos.quantity;
-        }
-        return total;
+    // Every position-weighted aggregate from one pass over the legs
+    StrategyGreeks total_greeks() const {
+        leg_greeks();
+        return total_cache;
     }
 
-    double total_volga() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            models::GreeksCalculator greeks(model);
-            double v = greeks.volga();
-            total += (pos.position_type == PositionType::LONG) ? v * pos.quantity : -v * pos.quantity;
-        }
-        return total;
-    }
+    double total_value() const { return total_greeks().value; }
 
-    double total_charm() const {
-        double total = 0.0;
-        for (const auto& pos : positions) {
-            models::BlackScholesModel model(pos.strike, volatility, risk_free_rate,
-                                           time_to_maturity, underlying_price, dividend_yield);
-            models::GreeksCalculator greeks(model);
-            double c = (pos.option_type == OptionType::CALL) ? greeks.call_charm() : greeks.put_charm();
-            total += (pos.position_type == PositionType::LONG) ? c * pos.quantity : -c * pos.quantity;
-        }
-        return total;
-    }
+    // Total Greeks
+    double total_delta() const { return total_greeks().delta; }
+    double total_gamma() const { return total_greeks().gamma; }
+    double total_vega() const { return total_greeks().vega; }
+    double total_theta() const { return total_greeks().theta; }
+    double total_rho() const { return total_greeks().rho; }
+    double total_vanna() const { return total_greeks().vanna; }
+    double total_volga() const { return total_greeks().volga; }
+    double total_charm() const { return total_greeks().charm; }
 
     // Payoff at expiration
     double payoff_at_expiration(double S_T) const {
@@ -224,8 +327,126 @@ public:
         return total;
     }
 
+    /**
+     * @brief Expiry payoff at n underlying prices.
+     *
+     * The payoff is piecewise linear with kinks only at the strikes, so it is
+     * reduced once to a slope/intercept per segment between sorted strikes.
+     * Each point is then a segment lookup and one multiply-add instead of a
+     * pass over every leg.
+     */
+    void payoff_grid(const double* S_T, double* out, size_t n) const {
+        for (size_t i = 0; i < n; ++i) {
+            if (!(S_T[i] >= 0.0) || std::isinf(S_T[i])) {
+                throw std::invalid_argument("Stock price at expiration must be finite and non-negative at index " +
+                                            std::to_string(i) + ", got: " + std::to_string(S_T[i]));
+            }
+        }
+
+        // Below every strike only puts pay: slope -sum(w_put), intercept sum(w_put * K).
+        // Crossing strike K adds w to the slope and subtracts w * K from the intercept
+        // for calls and puts alike.
+        std::vector<std::pair<double, double>> kinks;  // (strike, signed quantity)
+        kinks.reserve(positions.size());
+        double slope = 0.0;
+        double intercept = 0.0;
+        for (const auto& pos : positions) {
+            double w = (pos.position_type == PositionType::LONG) ? pos.quantity : -pos.quantity;
+            if (pos.option_type == OptionType::PUT) {
+                slope -= w;
+                intercept += w * pos.strike;
+            }
+            kinks.emplace_back(pos.strike, w);
+        }
+        std::sort(kinks.begin(), kinks.end());
+
+        std::vector<double> strikes;
+        std::vector<double> slopes(1, slope);
+        std::vector<double> intercepts(1, intercept);
+        for (size_t k = 0; k < kinks.size(); ++k) {
+            slope += kinks[k].second;
+            intercept -= kinks[k].second * kinks[k].first;
+            if (k + 1 < kinks.size() && kinks[k + 1].first == kinks[k].first) {
+                continue;
+            }
+            strikes.push_back(kinks[k].first);
+            slopes.push_back(slope);
+            intercepts.push_back(intercept);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            size_t seg = static_cast<size_t>(std::upper_bound(strikes.begin(), strikes.end(), S_T[i]) - strikes.begin());
+            out[i] = slopes[seg] * S_T[i] + intercepts[seg];
+        }
+    }
+
+    /**
+     * @brief Strategy value over a spots x vols x times scenario lattice.
+     *
+     * out[(i * nv + j) * nt + k] is the value at spots[i], vols[j] and
+     * times[k] (years to expiry, 0 = at expiry), with r and q from the
+     * strategy. Legs with a volatility override keep their offset from the
+     * strategy volatility, floored at zero. Each (vol, time) scenario prices
+     * the whole spot axis per leg with the vectorized kernel, and scenarios
+     * are split across the thread pool.
+     */
+    void value_grid(const double* spots, size_t ns, const double* vols, size_t nv,
+                    const double* times, size_t nt, double* out) const {
+        for (size_t i = 0; i < ns; ++i) {
+            if (!(spots[i] > 0.0) || std::isinf(spots[i])) {
+                throw std::invalid_argument("Scenario spot must be positive and finite at index " +
+                                            std::to_string(i) + ", got: " + std::to_string(spots[i]));
+            }
+        }
+        for (size_t j = 0; j < nv; ++j) {
+            if (!(vols[j] >= 0.0 && vols[j] <= 10.0)) {
+                throw std::invalid_argument("Scenario volatility must be within [0, 10] at index " +
+                                            std::to_string(j) + ", got: " + std::to_string(vols[j]));
+            }
+        }
+        for (size_t k = 0; k < nt; ++k) {
+            if (!(times[k] >= 0.0 && times[k] <= 100.0)) {
+                throw std::invalid_argument("Scenario time must be within [0, 100] years at index " +
+                                            std::to_string(k) + ", got: " + std::to_string(times[k]));
+            }
+        }
+
+        size_t scenarios = nv * nt;
+        size_t work = std::max<size_t>(ns * std::max<size_t>(positions.size(), 1), 1);
+        size_t grain = std::max<size_t>(4096 / work, 1);
+        parallel::parallel_for(scenarios, grain, [&](size_t begin, size_t end) {
+            std::vector<double> leg_value(ns);
+            std::vector<double> acc(ns);
+            for (size_t s = begin; s < end; ++s) {
+                double v = vols[s / nt];
+                double T = times[s % nt];
+                std::fill(acc.begin(), acc.end(), 0.0);
+                for (const auto& pos : positions) {
+                    double sigma = pos.has_volatility_override()
+                                 ? std::max(v + pos.volatility_override - volatility, 0.0)
+                                 : v;
+                    bool is_call = pos.option_type == OptionType::CALL;
+                    double w = (pos.position_type == PositionType::LONG) ? pos.quantity : -pos.quantity;
+                    simd::bs_price_delta({spots, 1}, {&pos.strike, 0}, {&risk_free_rate, 0}, {&T, 0},
+                                         {&sigma, 0}, {&dividend_yield, 0}, {&is_call, 0},
+                                         leg_value.data(), nullptr, ns);
+                    for (size_t i = 0; i < ns; ++i) {
+                        acc[i] += w * leg_value[i];
+                    }
+                }
+                for (size_t i = 0; i < ns; ++i) {
+                    out[i * scenarios + s] = acc[i];
+                }
+            }
+        });
+    }
+
     const std::vector<Position>& get_positions() const { return positions; }
     const std::string& get_name() const { return strategy_name; }
+    double get_underlying_price() const { return underlying_price; }
+    double get_volatility() const { return volatility; }
+    double get_risk_free_rate() const { return risk_free_rate; }
+    double get_time_to_maturity() const { return time_to_maturity; }
     double get_dividend_yield() const { return dividend_yield; }
 };
 
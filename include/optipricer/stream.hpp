@@ -0,0 +1,386 @@
+#ifndef OPTIPRICER_STREAM_HPP
+#define OPTIPRICER_STREAM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "greeks.hpp"
+#include "models.hpp"
+#include "parallel.hpp"
+
+namespace optipricer
+{
+    namespace stream
+    {
+        using utils::Column;
+
+        enum StreamColumn : std::size_t
+        {
+            STRIKE,
+            TIME_TO_MATURITY,
+            BID,
+            ASK,
+            MID,
+            SPOT,
+            IV,
+            PRICE,
+            DELTA,
+            GAMMA,
+            VEGA,
+            THETA,
+            RHO,
+            VANNA,
+            VOLGA,
+            CHARM,
+            NUM_COLUMNS
+        };
+
+        constexpr const char *COLUMN_NAMES[NUM_COLUMNS] = {
+            "strike", "time_to_maturity", "bid", "ask", "mid", "spot", "iv", "price",
+            "delta", "gamma", "vega", "theta", "rho", "vanna", "volga", "charm"};
+
+        /**
+         * @brief Turns a live quote feed into implied volatilities and Greeks per contract.
+         *
+         * Contracts (strike, expiry, call/put, dividend yield) are registered up
+         * front, up to a fixed capacity. One producer thread push()es (id, bid,
+         * ask, spot) updates; one consumer calls process() once per
+         * micro-interval, which solves the IV of the quote mid and the fused
+         * Greeks of that contract's side for every contract whose mid or spot
+         * moved since it was last solved.
+         *
+         * Updates coalesce instead of queueing: each contract has one slot
+         * holding its latest quote, and the preallocated ring only carries the
+         * ids of contracts with an unprocessed update, each at most once. So a
+         * burst of ticks on one strike costs one solve, and however far the
+         * consumer falls behind, the backlog never exceeds the contract count.
+         *
+         * Results live in one block of NUM_COLUMNS * capacity() doubles, column
+         * c starting at data() + c * capacity(), so views stay valid as more
+         * contracts are added. They are only written by process(); read them
+         * from the consumer thread between calls.
+         */
+        class TickPipeline
+        {
+        private:
+            // Latest quote of one contract; a seqlock, written by the producer only
+            struct Slot
+            {
+                std::atomic<std::uint32_t> sequence{0};
+                std::atomic<double> bid{0.0};
+                std::atomic<double> ask{0.0};
+                std::atomic<double> spot{0.0};
+                std::atomic<bool> pending{false};
+            };
+
+            double risk_free_rate;
+            double tol;
+            int max_iter;
+            std::size_t max_contracts;
+            std::atomic<std::size_t> count{0};
+
+            std::unique_ptr<Slot[]> slots;
+            std::vector<models::ExpiryContext> expiries;
+            std::vector<std::uint8_t> calls;
+            std::vector<std::uint8_t> solved;
+            std::vector<double> values;
+            std::vector<std::int8_t> statuses;
+
+            // Single-producer single-consumer ring of contract ids; never overflows
+            // because an id is only enqueued while its pending flag is clear
+            std::unique_ptr<std::uint32_t[]> ring;
+            std::size_t ring_mask;
+            std::atomic<std::size_t> ring_tail{0};
+            std::size_t ring_head = 0;
+
+            std::atomic<std::uint64_t> received{0};
+            std::atomic<std::uint64_t> coalesced{0};
+            std::uint64_t batches = 0;
+            std::uint64_t solves = 0;
+            std::uint64_t unchanged = 0;
+            std::vector<std::uint32_t> changed;
+            std::chrono::steady_clock::time_point last_batch;
+
+            double *column_ptr(std::size_t c) { return values.data() + c * max_contracts; }
+
+            void read_slot(const Slot &slot, double &bid, double &ask, double &spot) const
+            {
+                for (;;)
+                {
+                    const std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+                    if (before & 1u)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    bid = slot.bid.load(std::memory_order_relaxed);
+                    ask = slot.ask.load(std::memory_order_relaxed);
+                    spot = slot.spot.load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.sequence.load(std::memory_order_relaxed) == before)
+                    {
+                        return;
+                    }
+                }
+            }
+
+            void solve(std::size_t i)
+            {
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                const double K = column_ptr(STRIKE)[i];
+                const double S = column_ptr(SPOT)[i];
+                const bool is_call = calls[i] != 0;
+                models::IVResult result = {nan, models::IVStatus::INVALID_INPUT, 0};
+                if (column_ptr(BID)[i] <= column_ptr(ASK)[i])
+                {
+                    result = models::solve_implied_volatility(column_ptr(MID)[i], K, S, expiries[i], is_call, tol,
+                                                              max_iter);
+                }
+                statuses[i] = static_cast<std::int8_t>(result.status);
+
+                if (result.status != models::IVStatus::OK && result.status != models::IVStatus::NOT_CONVERGED)
+                {
+                    for (std::size_t c = IV; c < NUM_COLUMNS; ++c)
+                    {
+                        column_ptr(c)[i] = nan;
+                    }
+                    return;
+                }
+                const models::AllGreeks g = models::compute_all_greeks(S, K, result.volatility, expiries[i]);
+                column_ptr(IV)[i] = result.volatility;
+                column_ptr(PRICE)[i] = is_call ? g.call_price : g.put_price;
+                column_ptr(DELTA)[i] = is_call ? g.call_delta : g.put_delta;
+                column_ptr(GAMMA)[i] = g.gamma;
+                column_ptr(VEGA)[i] = g.vega;
+                column_ptr(THETA)[i] = is_call ? g.call_theta : g.put_theta;
+                column_ptr(RHO)[i] = is_call ? g.call_rho : g.put_rho;
+                column_ptr(VANNA)[i] = g.vanna;
+                column_ptr(VOLGA)[i] = g.volga;
+                column_ptr(CHARM)[i] = is_call ? g.call_charm : g.put_charm;
+            }
+
+        public:
+            /**
+             * @param r Risk-free rate shared by every contract
+             * @param capacity Most contracts this pipeline will hold; storage is allocated once
+             * @param tolerance, iterations Passed to solve_implied_volatility() as tol and max_iter
+             */
+            TickPipeline(double r, std::size_t capacity, double tolerance = 1e-6, int iterations = 100)
+                : risk_free_rate(r), tol(tolerance), max_iter(iterations), max_contracts(capacity)
+            {
+                if (!std::isfinite(r))
+                {
+                    throw std::invalid_argument("Risk-free rate must be finite, got: " + std::to_string(r));
+                }
+                if (capacity == 0 || capacity > UINT32_MAX)
+                {
+                    throw std::invalid_argument("Capacity must be between 1 and 2^32 - 1, got: " +
+                                                std::to_string(capacity));
+                }
+                if (!(tol > 0.0) || max_iter <= 0)
+                {
+                    throw std::invalid_argument("tol and max_iter must be positive");
+                }
+
+                std::size_t ring_size = 1;
+                while (ring_size < capacity)
+                {
+                    ring_size <<= 1;
+                }
+                ring.reset(new std::uint32_t[ring_size]);
+                ring_mask = ring_size - 1;
+                slots.reset(new Slot[capacity]);
+                expiries.reserve(capacity);
+                calls.reserve(capacity);
+                solved.reserve(capacity);
+                changed.reserve(capacity);
+                values.assign(NUM_COLUMNS * capacity, std::numeric_limits<double>::quiet_NaN());
+                statuses.assign(capacity, static_cast<std::int8_t>(models::IVStatus::INVALID_INPUT));
+                last_batch = std::chrono::steady_clock::now();
+            }
+
+            TickPipeline(const TickPipeline &) = delete;
+            TickPipeline &operator=(const TickPipeline &) = delete;
+
+            /**
+             * @brief Registers a contract and returns its id (0, 1, 2, ... in order of registration).
+             *
+             * Consumer side: may be called while the producer is pushing updates
+             * for contracts already registered.
+             */
+            std::size_t add_contract(double K, double T, bool is_call, double q = 0.0)
+            {
+                const std::size_t id = count.load(std::memory_order_relaxed);
+                if (id >= max_contracts)
+                {
+                    throw std::invalid_argument("Pipeline is full: capacity is " + std::to_string(max_contracts) +
+                                                " contracts");
+                }
+                models::BlackScholesModel checked(K, 0.2, risk_free_rate, T, K, q);
+                (void)checked;
+
+                expiries.push_back(models::ExpiryContext(risk_free_rate, T, q));
+                calls.push_back(is_call ? 1 : 0);
+                solved.push_back(0);
+                column_ptr(STRIKE)[id] = K;
+                column_ptr(TIME_TO_MATURITY)[id] = T;
+                count.store(id + 1, std::memory_order_release);
+                return id;
+            }
+
+            /**
+             * @brief Records the latest quote of one contract (producer side).
+             *
+             * Never blocks and never allocates. If the contract already has an
+             * unprocessed update, the new quote replaces it.
+             */
+            void push(std::size_t id, double bid, double ask, double spot)
+            {
+                if (id >= count.load(std::memory_order_acquire))
+                {
+                    throw std::out_of_range("Contract id " + std::to_string(id) + " out of range for " +
+                                            std::to_string(count.load(std::memory_order_relaxed)) + " contracts");
+                }
+                Slot &slot = slots[id];
+                const std::uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+                slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                slot.bid.store(bid, std::memory_order_relaxed);
+                slot.ask.store(ask, std::memory_order_relaxed);
+                slot.spot.store(spot, std::memory_order_relaxed);
+                slot.sequence.store(sequence + 2, std::memory_order_release);
+
+                received.store(received.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                if (slot.pending.exchange(true, std::memory_order_acq_rel))
+                {
+                    coalesced.store(coalesced.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return;
+                }
+                const std::size_t tail = ring_tail.load(std::memory_order_relaxed);
+                ring[tail & ring_mask] = static_cast<std::uint32_t>(id);
+                ring_tail.store(tail + 1, std::memory_order_release);
+            }
+
+            /**
+             * @brief push() for n updates; stride-0 columns broadcast one value.
+             *
+             * Every id is checked first, so an out-of-range id pushes nothing.
+             */
+            void push(Column<std::size_t> ids, Column<double> bid, Column<double> ask, Column<double> spot,
+                      std::size_t n)
+            {
+                const std::size_t registered = count.load(std::memory_order_acquire);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (ids[i] >= registered)
+                    {
+                        throw std::out_of_range("Contract id " + std::to_string(ids[i]) + " at index " +
+                                                std::to_string(i) + " out of range for " +
+                                                std::to_string(registered) + " contracts");
+                    }
+                }
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    push(ids[i], bid[i], ask[i], spot[i]);
+                }
+            }
+
+            /**
+             * @brief Drains every pending update and re-solves the contracts that moved (consumer side).
+             *
+             * A contract whose mid and spot equal the inputs of its last solve is
+             * skipped. Crossed quotes (bid > ask) and quotes the solver rejects
+             * get a non-OK status() and NaN results. Returns the number of
+             * contracts re-solved; their ids are in updated().
+             */
+            std::size_t process()
+            {
+                last_batch = std::chrono::steady_clock::now();
+                changed.clear();
+                const std::size_t tail = ring_tail.load(std::memory_order_acquire);
+                for (; ring_head != tail; ++ring_head)
+                {
+                    const std::uint32_t id = ring[ring_head & ring_mask];
+                    // Clear first: a quote pushed from here on re-enqueues the contract
+                    slots[id].pending.exchange(false, std::memory_order_acq_rel);
+                    double bid, ask, spot;
+                    read_slot(slots[id], bid, ask, spot);
+
+                    const double mid = 0.5 * (bid + ask);
+                    const bool same = solved[id] && mid == column_ptr(MID)[id] && spot == column_ptr(SPOT)[id] &&
+                                      (bid <= ask) == (column_ptr(BID)[id] <= column_ptr(ASK)[id]);
+                    column_ptr(BID)[id] = bid;
+                    column_ptr(ASK)[id] = ask;
+                    if (same)
+                    {
+                        ++unchanged;
+                        continue;
+                    }
+                    column_ptr(MID)[id] = mid;
+                    column_ptr(SPOT)[id] = spot;
+                    solved[id] = 1;
+                    changed.push_back(id);
+                }
+
+                parallel::parallel_for(changed.size(), 256, [this](std::size_t begin, std::size_t end) {
+                    for (std::size_t k = begin; k < end; ++k)
+                    {
+                        solve(changed[k]);
+                    }
+                });
+                ++batches;
+                solves += changed.size();
+                return changed.size();
+            }
+
+            /**
+             * @brief Sleeps until interval seconds after the previous batch started, then process()es.
+             *
+             * Everything pushed meanwhile coalesces into one batch, so a loop of
+             * these calls runs at most one solve per contract per interval.
+             */
+            std::size_t process_after(double interval)
+            {
+                if (interval > 0.0)
+                {
+                    std::this_thread::sleep_until(
+                        last_batch + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(interval)));
+                }
+                return process();
+            }
+
+            // Ids re-solved by the last process(), in the order their updates arrived
+            const std::vector<std::uint32_t> &updated() const { return changed; }
+
+            std::size_t size() const { return count.load(std::memory_order_acquire); }
+            std::size_t capacity() const { return max_contracts; }
+            const double *data() const { return values.data(); }
+            const double *column(std::size_t c) const { return values.data() + c * max_contracts; }
+            // models::IVStatus of each contract's last solve (INVALID_INPUT until its first quote)
+            const std::int8_t *status() const { return statuses.data(); }
+            bool is_call(std::size_t id) const { return calls.at(id) != 0; }
+
+            // Contracts with an update not yet seen by process()
+            std::size_t pending() const { return ring_tail.load(std::memory_order_acquire) - ring_head; }
+            std::uint64_t updates_received() const { return received.load(std::memory_order_relaxed); }
+            // Updates that replaced a still-pending quote instead of adding work
+            std::uint64_t updates_coalesced() const { return coalesced.load(std::memory_order_relaxed); }
+            std::uint64_t num_batches() const { return batches; }
+            std::uint64_t num_solves() const { return solves; }
+            // Pending contracts whose mid and spot had not moved, so no solve was run
+            std::uint64_t num_unchanged() const { return unchanged; }
+            double get_risk_free_rate() const { return risk_free_rate; }
+        };
+    }
+}
+
+#endif // OPTIPRICER_STREAM_HPP
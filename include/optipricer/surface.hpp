@@ -0,0 +1,558 @@
+#ifndef OPTIPRICER_SURFACE_HPP
+#define OPTIPRICER_SURFACE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "parallel.hpp"
+#include "utils.hpp"
+
+namespace optipricer
+{
+    namespace surface
+    {
+        /**
+         * @brief Sorted grid axis with O(1) bracketing when the knots are evenly spaced.
+         *
+         * Strike ladders are usually uniform, so the cell index is computed
+         * directly; otherwise (or for the final rounding fix-up) it falls back
+         * to binary search.
+         */
+        class Axis
+        {
+        private:
+            std::vector<double> knots;
+            bool uniform = false;
+            double origin = 0.0;
+            double inv_step = 0.0;
+
+        public:
+            Axis() = default;
+
+            explicit Axis(std::vector<double> sorted_knots) : knots(std::move(sorted_knots))
+            {
+                std::size_t n = knots.size();
+                if (n < 2)
+                {
+                    return;
+                }
+                double step = (knots[n - 1] - knots[0]) / static_cast<double>(n - 1);
+                double scale = std::max(std::abs(knots[0]), std::abs(knots[n - 1]));
+                uniform = step > 0.0;
+                for (std::size_t i = 1; uniform && i + 1 < n; ++i)
+                {
+                    uniform = std::abs(knots[i] - (knots[0] + step * static_cast<double>(i))) <= 1e-9 * scale;
+                }
+                origin = knots[0];
+                inv_step = uniform ? 1.0 / step : 0.0;
+            }
+
+            std::size_t size() const { return knots.size(); }
+            const std::vector<double> &values() const { return knots; }
+            double operator[](std::size_t i) const { return knots[i]; }
+
+            /**
+             * @brief Cell [knots[i], knots[i + 1]] holding x, and the weight t of knots[i + 1].
+             *
+             * Queries outside the axis clamp to the end knot (t is 0 or 1). A
+             * single-knot axis always returns i = 0, t = 0.
+             */
+            void locate(double x, std::size_t &i, double &t) const
+            {
+                std::size_t n = knots.size();
+                if (n < 2 || x <= knots[0])
+                {
+                    i = 0;
+                    t = 0.0;
+                    return;
+                }
+                if (x >= knots[n - 1])
+                {
+                    i = n - 2;
+                    t = 1.0;
+                    return;
+                }
+                if (uniform)
+                {
+                    i = std::min(static_cast<std::size_t>((x - origin) * inv_step), n - 2);
+                    // Rounding can land one cell off next to a knot
+                    if (x < knots[i])
+                    {
+                        --i;
+                    }
+                    else if (x >= knots[i + 1] && i + 2 < n)
+                    {
+                        ++i;
+                    }
+                }
+                else
+                {
+                    i = static_cast<std::size_t>(std::upper_bound(knots.begin(), knots.end(), x) - knots.begin()) - 1;
+                }
+                t = (x - knots[i]) / (knots[i + 1] - knots[i]);
+            }
+
+            // Index of the knot closest to x (lower knot on ties)
+            std::size_t nearest(double x) const
+            {
+                std::size_t i;
+                double t;
+                locate(x, i, t);
+                return (t > 0.5 && i + 1 < knots.size()) ? i + 1 : i;
+            }
+        };
+
+        /**
+         * @brief One immutable version of the surface's quotes.
+         *
+         * Holds the raw quotes (NaN = missing), one row per expiry, and a
+         * hole-free copy the interpolation runs on: each hole is filled
+         * linearly along its expiry's strikes (flat past the last quote), and an
+         * expiry with no quotes at all is filled linearly between neighbouring
+         * expiries. Rows are immutable and shared, so a new version only owns
+         * the rows an update changed. Readers keep a snapshot alive for as long
+         * as they use it, so a query never sees a half-applied update.
+         */
+        class SurfaceSnapshot
+        {
+        private:
+            friend class VolatilitySurface;
+
+            // One expiry's quotes, shared by every snapshot it did not change in
+            struct Row
+            {
+                std::vector<double> raw;
+                std::vector<double> filled;
+                std::uint64_t version = 0;
+                bool quoted = false;
+            };
+
+            std::shared_ptr<const Axis> strike_axis;
+            std::shared_ptr<const Axis> expiry_axis;
+            std::vector<std::shared_ptr<const Row>> rows;
+            std::uint64_t surface_version = 0;
+
+            // Fills the holes of a row along the strike axis and records whether it has any quote
+            static void fill_row(const Axis &K, Row &r)
+            {
+                const std::size_t ns = K.size();
+                const double *src = r.raw.data();
+                double *row = r.filled.data();
+                std::size_t prev = ns; // last quoted column, ns = none yet
+                bool quoted = false;
+                for (std::size_t k = 0; k <= ns; ++k)
+                {
+                    if (k < ns && std::isnan(src[k]))
+                    {
+                        continue;
+                    }
+                    if (k < ns)
+                    {
+                        row[k] = src[k];
+                        quoted = true;
+                    }
+                    // Fill the gap (prev, k)
+                    std::size_t first = prev == ns ? 0 : prev + 1;
+                    for (std::size_t j = first; j < k; ++j)
+                    {
+                        if (prev == ns)
+                        {
+                            row[j] = k < ns ? src[k] : std::numeric_limits<double>::quiet_NaN();
+                        }
+                        else if (k == ns)
+                        {
+                            row[j] = src[prev];
+                        }
+                        else
+                        {
+                            double w = (K[j] - K[prev]) / (K[k] - K[prev]);
+                            row[j] = src[prev] + w * (src[k] - src[prev]);
+                        }
+                    }
+                    prev = k;
+                }
+                r.quoted = quoted;
+            }
+
+            /**
+             * @brief Re-derives expiries without quotes from the quoted ones either side.
+             *
+             * An empty row is rebuilt, and stamped with this snapshot's version,
+             * only when a row in the span between its quoted neighbours (both
+             * included) is in changed; that covers neighbours whose quotes moved
+             * and neighbours that appeared or disappeared. Other empty rows stay
+             * shared, and quoted rows are left untouched.
+             */
+            void fill_empty_rows(const std::vector<bool> &changed)
+            {
+                const Axis &E = *expiry_axis;
+                const std::size_t ns = strike_axis->size();
+                const std::size_t ne = E.size();
+                std::vector<std::size_t> quoted_rows;
+                std::vector<std::size_t> changed_before(ne + 1, 0); // changed rows in [0, e)
+                for (std::size_t e = 0; e < ne; ++e)
+                {
+                    if (rows[e]->quoted)
+                    {
+                        quoted_rows.push_back(e);
+                    }
+                    changed_before[e + 1] = changed_before[e] + (changed[e] ? 1 : 0);
+                }
+                if (quoted_rows.empty())
+                {
+                    throw std::invalid_argument("iv_matrix contains no finite volatilities");
+                }
+                if (quoted_rows.size() == ne)
+                {
+                    return;
+                }
+                for (std::size_t e = 0; e < ne; ++e)
+                {
+                    if (rows[e]->quoted)
+                    {
+                        continue;
+                    }
+                    auto above = std::upper_bound(quoted_rows.begin(), quoted_rows.end(), e);
+                    const std::size_t first = above == quoted_rows.begin() ? 0 : *(above - 1);
+                    const std::size_t last = above == quoted_rows.end() ? ne - 1 : *above;
+                    if (changed_before[last + 1] == changed_before[first])
+                    {
+                        continue;
+                    }
+                    const double *hi = above == quoted_rows.end() ? nullptr : rows[*above]->filled.data();
+                    const double *lo = above == quoted_rows.begin() ? nullptr : rows[*(above - 1)]->filled.data();
+                    double w = 0.0;
+                    if (lo && hi)
+                    {
+                        w = (E[e] - E[*(above - 1)]) / (E[*above] - E[*(above - 1)]);
+                    }
+                    std::shared_ptr<Row> row = std::make_shared<Row>(*rows[e]);
+                    for (std::size_t k = 0; k < ns; ++k)
+                    {
+                        row->filled[k] = !lo ? hi[k] : !hi ? lo[k] : lo[k] + w * (hi[k] - lo[k]);
+                    }
+                    row->version = surface_version;
+                    rows[e] = std::move(row);
+                }
+            }
+
+            std::vector<double> gather(std::vector<double> Row::*field) const
+            {
+                const std::size_t ns = strike_axis->size();
+                std::vector<double> grid(rows.size() * ns);
+                for (std::size_t e = 0; e < rows.size(); ++e)
+                {
+                    const std::vector<double> &row = (*rows[e]).*field;
+                    std::copy(row.begin(), row.end(), grid.begin() + static_cast<std::ptrdiff_t>(e * ns));
+                }
+                return grid;
+            }
+
+        public:
+            /**
+             * @brief Bilinearly interpolated IV; NaN inputs give NaN
+             */
+            double get_iv(double strike, double expiry) const
+            {
+                if (std::isnan(strike) || std::isnan(expiry))
+                {
+                    return std::numeric_limits<double>::quiet_NaN();
+                }
+                const std::size_t ns = strike_axis->size();
+                std::size_t k, e;
+                double t_s, t_e;
+                strike_axis->locate(strike, k, t_s);
+                expiry_axis->locate(expiry, e, t_e);
+                std::size_t k1 = std::min(k + 1, ns - 1);
+                std::size_t e1 = std::min(e + 1, expiry_axis->size() - 1);
+
+                const double *near = rows[e]->filled.data();
+                const double *far = rows[e1]->filled.data();
+                double iv_near = near[k] * (1.0 - t_s) + near[k1] * t_s;
+                double iv_far = far[k] * (1.0 - t_s) + far[k1] * t_s;
+                return iv_near * (1.0 - t_e) + iv_far * t_e;
+            }
+
+            std::size_t num_strikes() const { return strike_axis->size(); }
+            std::size_t num_expiries() const { return expiry_axis->size(); }
+            const std::vector<double> &strikes() const { return strike_axis->values(); }
+            const std::vector<double> &expiries() const { return expiry_axis->values(); }
+
+            // Quotes of expiry row e as given (NaN = missing), and its hole-free counterpart
+            const std::vector<double> &raw_row(std::size_t e) const { return rows[e]->raw; }
+            const std::vector<double> &filled_row(std::size_t e) const { return rows[e]->filled; }
+            // Row-major copies of every row
+            std::vector<double> raw_ivs() const { return gather(&Row::raw); }
+            std::vector<double> filled_ivs() const { return gather(&Row::filled); }
+
+            // Bumped by every update; equal versions mean identical quotes
+            std::uint64_t version() const { return surface_version; }
+            // Version of the update that last changed expiry row e (its quotes, or the fill of an
+            // empty row from its neighbours), for caches built per slice
+            std::uint64_t slice_version(std::size_t e) const { return rows[e]->version; }
+        };
+
+        /**
+         * @brief Implied volatility surface over sorted strikes and expiries.
+         *
+         * The quotes live in a SurfaceSnapshot. An update copies only the rows it
+         * changes, refills them and publishes a new version that shares every
+         * other row with the old one. Queries run concurrently with updates and
+         * always see one complete version.
+         *
+         * Publication is lock-free for readers. There are two slots: readers
+         * copy the shared_ptr out of the live slot while counted in that slot's
+         * reader count, and retry if the live slot flipped meanwhile. A writer
+         * fills the spare slot, once the copies still in flight from it are done,
+         * and then flips it live. Readers never wait, neither on the writer
+         * mutex nor on the lock pool behind std::atomic_load of a shared_ptr.
+         * Updates are serialized among themselves. The axes are fixed at
+         * construction and shared by every snapshot.
+         */
+        class VolatilitySurface
+        {
+        private:
+            using Row = SurfaceSnapshot::Row;
+
+            std::shared_ptr<const SurfaceSnapshot> slots[2];
+            mutable std::atomic<unsigned> readers[2] = {};
+            std::atomic<unsigned> live{0};
+            std::mutex write_mutex;
+
+            // Writers only, under write_mutex
+            void publish(std::shared_ptr<const SurfaceSnapshot> next)
+            {
+                const unsigned spare = 1 - live.load();
+                while (readers[spare].load() != 0)
+                {
+                    std::this_thread::yield();
+                }
+                slots[spare] = std::move(next);
+                live.store(spare);
+            }
+
+            static std::vector<std::size_t> sorted_order(const std::vector<double> &v, const char *what)
+            {
+                std::vector<std::size_t> order(v.size());
+                std::iota(order.begin(), order.end(), std::size_t(0));
+                std::sort(order.begin(), order.end(), [&v](std::size_t a, std::size_t b) { return v[a] < v[b]; });
+                for (std::size_t i = 0; i < v.size(); ++i)
+                {
+                    if (!std::isfinite(v[order[i]]))
+                    {
+                        throw std::invalid_argument(std::string(what) + " must be finite, got: " + std::to_string(v[order[i]]));
+                    }
+                    if (i > 0 && v[order[i]] == v[order[i - 1]])
+                    {
+                        throw std::invalid_argument(std::string("Duplicate ") + what + ": " + std::to_string(v[order[i]]));
+                    }
+                }
+                return order;
+            }
+
+            static double checked_iv(double v)
+            {
+                if (std::isinf(v) || v < 0.0)
+                {
+                    throw std::invalid_argument("Implied volatility must be non-negative and finite (NaN marks a missing quote), got: " +
+                                                std::to_string(v));
+                }
+                return v;
+            }
+
+            static std::size_t knot_index(const Axis &axis, double x, const char *what)
+            {
+                const std::vector<double> &v = axis.values();
+                auto it = std::lower_bound(v.begin(), v.end(), x);
+                if (it == v.end() || *it != x)
+                {
+                    throw std::invalid_argument(std::string(what) + " is not on the surface grid: " + std::to_string(x));
+                }
+                return static_cast<std::size_t>(it - v.begin());
+            }
+
+            /**
+             * @brief Copy-on-write update: edit(base, row) changes raw quotes through row(e).
+             *
+             * row(e) returns the raw quotes of a private copy of expiry row e,
+             * made on first use; rows never asked for stay shared with base. The
+             * new snapshot is published only once it is complete, so a failed
+             * update leaves the surface unchanged.
+             */
+            template <typename Edit>
+            void update(Edit edit)
+            {
+                std::lock_guard<std::mutex> lock(write_mutex);
+                const std::shared_ptr<const SurfaceSnapshot> &base = slots[live.load()];
+                std::vector<std::shared_ptr<Row>> changed(base->num_expiries());
+                edit(*base, [&](std::size_t e) {
+                    if (!changed[e])
+                    {
+                        changed[e] = std::make_shared<Row>(*base->rows[e]);
+                    }
+                    return changed[e]->raw.data();
+                });
+
+                std::shared_ptr<SurfaceSnapshot> draft = std::make_shared<SurfaceSnapshot>(*base);
+                draft->surface_version = base->surface_version + 1;
+                std::vector<bool> touched(changed.size(), false);
+                for (std::size_t e = 0; e < changed.size(); ++e)
+                {
+                    if (changed[e])
+                    {
+                        touched[e] = true;
+                        changed[e]->version = draft->surface_version;
+                        SurfaceSnapshot::fill_row(*draft->strike_axis, *changed[e]);
+                        draft->rows[e] = std::move(changed[e]);
+                    }
+                }
+                draft->fill_empty_rows(touched);
+                publish(std::move(draft));
+            }
+
+        public:
+            /**
+             * @brief Builds the surface; iv is row-major with one row of strikes.size() values per expiry.
+             *
+             * Strikes and expiries may be given in any order; rows and columns
+             * of iv are permuted to match the sorted axes.
+             */
+            VolatilitySurface(const std::vector<double> &strikes, const std::vector<double> &expiries, const double *iv)
+            {
+                if (strikes.empty() || expiries.empty())
+                {
+                    throw std::invalid_argument("strikes and expiries must be non-empty.");
+                }
+                std::vector<std::size_t> s_order = sorted_order(strikes, "strike");
+                std::vector<std::size_t> e_order = sorted_order(expiries, "expiry");
+
+                const std::size_t ns = strikes.size();
+                const std::size_t ne = expiries.size();
+                std::vector<double> s_sorted(ns), e_sorted(ne);
+                for (std::size_t k = 0; k < ns; ++k)
+                {
+                    s_sorted[k] = strikes[s_order[k]];
+                }
+                for (std::size_t e = 0; e < ne; ++e)
+                {
+                    e_sorted[e] = expiries[e_order[e]];
+                }
+
+                std::shared_ptr<SurfaceSnapshot> grid = std::make_shared<SurfaceSnapshot>();
+                grid->strike_axis = std::make_shared<const Axis>(std::move(s_sorted));
+                grid->expiry_axis = std::make_shared<const Axis>(std::move(e_sorted));
+                grid->rows.reserve(ne);
+                for (std::size_t e = 0; e < ne; ++e)
+                {
+                    std::shared_ptr<Row> row = std::make_shared<Row>();
+                    row->raw.resize(ns);
+                    row->filled.resize(ns);
+                    for (std::size_t k = 0; k < ns; ++k)
+                    {
+                        row->raw[k] = checked_iv(iv[e_order[e] * ns + s_order[k]]);
+                    }
+                    SurfaceSnapshot::fill_row(*grid->strike_axis, *row);
+                    grid->rows.push_back(std::move(row));
+                }
+                grid->fill_empty_rows(std::vector<bool>(ne, true));
+                slots[0] = std::move(grid);
+            }
+
+            VolatilitySurface(const VolatilitySurface &) = delete;
+            VolatilitySurface &operator=(const VolatilitySurface &) = delete;
+
+            /**
+             * @brief Current version of the quotes; safe to call while another thread updates
+             */
+            std::shared_ptr<const SurfaceSnapshot> snapshot() const
+            {
+                for (;;)
+                {
+                    const unsigned i = live.load();
+                    readers[i].fetch_add(1);
+                    // Still live: the writer cannot be refilling slot i until we leave it
+                    if (live.load() == i)
+                    {
+                        std::shared_ptr<const SurfaceSnapshot> grid = slots[i];
+                        readers[i].fetch_sub(1);
+                        return grid;
+                    }
+                    readers[i].fetch_sub(1);
+                }
+            }
+
+            double get_iv(double strike, double expiry) const { return snapshot()->get_iv(strike, expiry); }
+
+            /**
+             * @brief get_iv() for n (strike, expiry) pairs against one snapshot, split across the thread pool
+             */
+            void get_iv_batch(utils::Column<double> strike, utils::Column<double> expiry, double *out, std::size_t n) const
+            {
+                std::shared_ptr<const SurfaceSnapshot> grid = snapshot();
+                const SurfaceSnapshot &g = *grid;
+                parallel::parallel_for(n, 8192, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        out[i] = g.get_iv(strike[i], expiry[i]);
+                    }
+                });
+            }
+
+            /**
+             * @brief Replaces n quotes at existing (strike, expiry) knots in one update; NaN removes a quote
+             */
+            void set_ivs(utils::Column<double> strike, utils::Column<double> expiry, utils::Column<double> iv, std::size_t n)
+            {
+                update([&](const SurfaceSnapshot &g, auto row) {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        std::size_t k = knot_index(*g.strike_axis, strike[i], "strike");
+                        std::size_t e = knot_index(*g.expiry_axis, expiry[i], "expiry");
+                        row(e)[k] = checked_iv(iv[i]);
+                    }
+                });
+            }
+
+            void set_iv(double strike, double expiry, double iv)
+            {
+                set_ivs({&strike, 0}, {&expiry, 0}, {&iv, 0}, 1);
+            }
+
+            /**
+             * @brief Replaces the whole row of an existing expiry; ivs follows the sorted strike axis
+             */
+            void set_slice(double expiry, const double *ivs)
+            {
+                update([&](const SurfaceSnapshot &g, auto row) {
+                    const std::size_t ns = g.num_strikes();
+                    double *dst = row(knot_index(*g.expiry_axis, expiry, "expiry"));
+                    for (std::size_t k = 0; k < ns; ++k)
+                    {
+                        dst[k] = checked_iv(ivs[k]);
+                    }
+                });
+            }
+
+            std::size_t num_strikes() const { return snapshot()->num_strikes(); }
+            std::size_t num_expiries() const { return snapshot()->num_expiries(); }
+            // The axes never change and are shared by every snapshot, so these stay valid across updates
+            const std::vector<double> &strikes() const { return snapshot()->strikes(); }
+            const std::vector<double> &expiries() const { return snapshot()->expiries(); }
+            std::uint64_t version() const { return snapshot()->version(); }
+            std::size_t nearest_strike_index(double strike) const { return snapshot()->strike_axis->nearest(strike); }
+        };
+    }
+}
+
+#endif // OPTIPRICER_SURFACE_HPP
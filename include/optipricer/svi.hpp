@@ -0,0 +1,715 @@
+#ifndef OPTIPRICER_SVI_HPP
+#define OPTIPRICER_SVI_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "batch.hpp"
+#include "parallel.hpp"
+#include "parity.hpp"
+#include "utils.hpp"
+
+namespace optipricer
+{
+    namespace svi
+    {
+        /**
+         * @brief Raw SVI smile: total variance w(k) = a + b (rho (k - m) + sqrt((k - m)^2 + sigma^2)).
+         *
+         * k is log-moneyness log(K / F) and w = iv^2 * T.
+         */
+        struct SviParams
+        {
+            double a;
+            double b;
+            double rho;
+            double m;
+            double sigma;
+
+            double total_variance(double k) const
+            {
+                double d = k - m;
+                return a + b * (rho * d + std::sqrt(d * d + sigma * sigma));
+            }
+
+            // Smallest total variance of the smile
+            double min_variance() const { return a + b * sigma * std::sqrt(1.0 - rho * rho); }
+        };
+
+        /**
+         * @brief Fitted slice: parameters plus the fit quality in volatility terms
+         */
+        struct SviFit
+        {
+            SviParams params;
+            double expiry;
+            double rmse;
+            int iterations;
+            int num_quotes;
+        };
+
+        enum class SmileModel
+        {
+            SVI,  // Independent raw SVI per expiry
+            SSVI  // One surface-wide SSVI (rho, eta, gamma) over per-expiry ATM variances
+        };
+
+        namespace detail
+        {
+            // Solves (A) x = b for a small symmetric positive definite A; false if A is not SPD
+            template <std::size_t P>
+            bool cholesky_solve(std::array<double, P * P> A, std::array<double, P> &x)
+            {
+                for (std::size_t j = 0; j < P; ++j)
+                {
+                    double d = A[j * P + j];
+                    for (std::size_t k = 0; k < j; ++k)
+                    {
+                        d -= A[j * P + k] * A[j * P + k];
+                    }
+                    if (!(d > 0.0))
+                    {
+                        return false;
+                    }
+                    A[j * P + j] = std::sqrt(d);
+                    for (std::size_t i = j + 1; i < P; ++i)
+                    {
+                        double s = A[i * P + j];
+                        for (std::size_t k = 0; k < j; ++k)
+                        {
+                            s -= A[i * P + k] * A[j * P + k];
+                        }
+                        A[i * P + j] = s / A[j * P + j];
+                    }
+                }
+                for (std::size_t i = 0; i < P; ++i)
+                {
+                    for (std::size_t k = 0; k < i; ++k)
+                    {
+                        x[i] -= A[i * P + k] * x[k];
+                    }
+                    x[i] /= A[i * P + i];
+                }
+                for (std::size_t i = P; i-- > 0;)
+                {
+                    for (std::size_t k = i + 1; k < P; ++k)
+                    {
+                        x[i] -= A[k * P + i] * x[k];
+                    }
+                    x[i] /= A[i * P + i];
+                }
+                return true;
+            }
+
+            /**
+             * @brief Projected Levenberg-Marquardt over P parameters.
+             *
+             * residual(p, i, J) returns residual i and, when J is non-null,
+             * writes its P partial derivatives. project(p) maps a trial point
+             * back into the feasible set. Returns the number of iterations; p
+             * and cost hold the best point found.
+             */
+            template <std::size_t P, typename Residual, typename Project>
+            int levenberg_marquardt(std::array<double, P> &p, std::size_t n, Residual residual, Project project,
+                                    int max_iter, double &cost)
+            {
+                auto sum_squares = [&](const std::array<double, P> &q) {
+                    double s = 0.0;
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        double r = residual(q, i, static_cast<double *>(nullptr));
+                        s += r * r;
+                    }
+                    return s;
+                };
+
+                project(p);
+                cost = sum_squares(p);
+                double lambda = 1e-3;
+                int iter = 0;
+                while (iter < max_iter)
+                {
+                    ++iter;
+                    std::array<double, P * P> JtJ{};
+                    std::array<double, P> g{};
+                    std::array<double, P> J;
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        double r = residual(p, i, J.data());
+                        for (std::size_t a = 0; a < P; ++a)
+                        {
+                            g[a] += J[a] * r;
+                            for (std::size_t b = 0; b <= a; ++b)
+                            {
+                                JtJ[a * P + b] += J[a] * J[b];
+                            }
+                        }
+                    }
+                    for (std::size_t a = 0; a < P; ++a)
+                    {
+                        for (std::size_t b = 0; b < a; ++b)
+                        {
+                            JtJ[b * P + a] = JtJ[a * P + b];
+                        }
+                    }
+
+                    bool improved = false;
+                    while (lambda < 1e12)
+                    {
+                        std::array<double, P * P> A = JtJ;
+                        std::array<double, P> step;
+                        for (std::size_t a = 0; a < P; ++a)
+                        {
+                            A[a * P + a] += lambda * std::max(JtJ[a * P + a], 1e-12);
+                            step[a] = -g[a];
+                        }
+                        if (!cholesky_solve<P>(A, step))
+                        {
+                            lambda *= 4.0;
+                            continue;
+                        }
+                        std::array<double, P> trial;
+                        for (std::size_t a = 0; a < P; ++a)
+                        {
+                            trial[a] = p[a] + step[a];
+                        }
+                        project(trial);
+                        double trial_cost = sum_squares(trial);
+                        if (trial_cost < cost)
+                        {
+                            double decrease = cost - trial_cost;
+                            p = trial;
+                            cost = trial_cost;
+                            lambda = std::max(lambda / 3.0, 1e-12);
+                            improved = decrease > 1e-12 * (cost + 1e-30);
+                            break;
+                        }
+                        lambda *= 4.0;
+                    }
+                    if (!improved)
+                    {
+                        break;
+                    }
+                }
+                return iter;
+            }
+
+            constexpr double MAX_RHO = 0.999;
+            constexpr double MIN_SIGMA = 1e-4;
+            // Roger Lee's moment bound: total variance grows at most 2 |k| in the wings
+            constexpr double MAX_WING_SLOPE = 2.0;
+
+            inline void project_svi(std::array<double, 5> &p, double k_lo, double k_hi)
+            {
+                double &a = p[0], &b = p[1], &rho = p[2], &m = p[3], &sigma = p[4];
+                rho = std::min(std::max(rho, -MAX_RHO), MAX_RHO);
+                b = std::min(std::max(b, 0.0), MAX_WING_SLOPE / (1.0 + std::abs(rho)));
+                m = std::min(std::max(m, k_lo - 1.0), k_hi + 1.0);
+                sigma = std::min(std::max(sigma, MIN_SIGMA), 10.0);
+                // Keep the smile's minimum variance non-negative
+                a = std::max(a, -b * sigma * std::sqrt(1.0 - rho * rho));
+            }
+
+            // Weighted RMS implied volatility error of a slice (weight may be null for equal weights)
+            inline double vol_rmse(const SviParams &p, const double *k, const double *w, const double *weight,
+                                   std::size_t n, double T)
+            {
+                double s = 0.0;
+                double total = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    double d = std::sqrt(std::max(p.total_variance(k[i]), 0.0) / T) - std::sqrt(w[i] / T);
+                    double wt = weight ? weight[i] : 1.0;
+                    s += wt * d * d;
+                    total += wt;
+                }
+                return total > 0.0 ? std::sqrt(s / total) : 0.0;
+            }
+
+            // ATM total variance of one slice: linear in k between the quotes either side of 0, flat outside
+            inline double atm_variance(const double *k, const double *w, std::size_t n)
+            {
+                const double *hi = std::lower_bound(k, k + n, 0.0);
+                if (hi == k)
+                {
+                    return w[0];
+                }
+                if (hi == k + n)
+                {
+                    return w[n - 1];
+                }
+                std::size_t i = static_cast<std::size_t>(hi - k);
+                double t = (0.0 - k[i - 1]) / (k[i] - k[i - 1]);
+                return w[i - 1] + t * (w[i] - w[i - 1]);
+            }
+        }
+
+        /**
+         * @brief Fits raw SVI to one expiry's quotes in total-variance space.
+         *
+         * k must be sorted ascending with w[i] = iv_i^2 * T; weight (null for
+         * equal weights) scales each quote's squared error. The fit is a
+         * projected Levenberg-Marquardt with the analytic Jacobian, started
+         * from the smile's minimum and wing slopes. Feasible points keep b
+         * within Lee's wing bound, |rho| < 1 and a non-negative minimum
+         * variance, which rules out the usual butterfly violations in the
+         * wings. Needs at least 5 quotes.
+         */
+        inline SviFit fit_svi_slice(const double *k, const double *w, const double *weight, std::size_t n, double T,
+                                    int max_iter = 100)
+        {
+            if (n < 5)
+            {
+                throw std::invalid_argument("SVI needs at least 5 quotes per expiry, got " + std::to_string(n) +
+                                            " at T=" + std::to_string(T));
+            }
+            const double k_lo = k[0];
+            const double k_hi = k[n - 1];
+
+            // Start at the variance minimum with slopes matched to the end quotes
+            std::size_t lo = static_cast<std::size_t>(std::min_element(w, w + n) - w);
+            double m0 = k[lo];
+            double left = k_lo < m0 ? (w[0] - w[lo]) / (k_lo - m0) : 0.0;
+            double right = k_hi > m0 ? (w[n - 1] - w[lo]) / (k_hi - m0) : 0.0;
+            double b0 = std::max(0.5 * (right - left), 1e-3);
+            double rho0 = (right + left) / (right - left + 1e-300);
+            double sigma0 = 0.1;
+            rho0 = std::min(std::max(rho0, -0.9), 0.9);
+            std::array<double, 5> p = {w[lo] - b0 * sigma0 * std::sqrt(1.0 - rho0 * rho0), b0, rho0, m0, sigma0};
+
+            auto residual = [k, w, weight](const std::array<double, 5> &q, std::size_t i, double *J) {
+                double d = k[i] - q[3];
+                double s = std::sqrt(d * d + q[4] * q[4]);
+                double root = weight ? std::sqrt(weight[i]) : 1.0;
+                if (J)
+                {
+                    J[0] = root;
+                    J[1] = root * (q[2] * d + s);
+                    J[2] = root * q[1] * d;
+                    J[3] = -root * q[1] * (q[2] + d / s);
+                    J[4] = root * q[1] * q[4] / s;
+                }
+                return root * (q[0] + q[1] * (q[2] * d + s) - w[i]);
+            };
+            auto project = [k_lo, k_hi](std::array<double, 5> &q) { detail::project_svi(q, k_lo, k_hi); };
+
+            double cost;
+            SviFit fit;
+            fit.iterations = detail::levenberg_marquardt<5>(p, n, residual, project, max_iter, cost);
+            fit.params = {p[0], p[1], p[2], p[3], p[4]};
+            fit.expiry = T;
+            fit.rmse = detail::vol_rmse(fit.params, k, w, weight, n, T);
+            fit.num_quotes = static_cast<int>(n);
+            return fit;
+        }
+
+        /**
+         * @brief Smile surface made of one raw SVI slice per expiry.
+         *
+         * A query (K, T) takes k = log(K / F(T)) with F(T) = S e^{(r - q) T},
+         * where r and q are either flat or, for a surface calibrated with a
+         * put-call parity carry curve, interpolated by parity::carry_at; it
+         * evaluates the two neighbouring slices at that k and interpolates
+         * total variance linearly in T; before the first and after the last
+         * expiry the slice's implied volatility is held flat. Each slice costs
+         * five doubles, however many strikes it was fitted to.
+         *
+         * SmileModel::SSVI fits the Gatheral-Jacquier surface
+         * w = theta/2 (1 + rho phi k + sqrt((phi k + rho)^2 + 1 - rho^2)) with
+         * phi = eta theta^-gamma, theta the per-expiry ATM variance (made
+         * non-decreasing in T), and the no-butterfly conditions
+         * theta phi (1 + |rho|) <= 4 and theta phi^2 (1 + |rho|) <= 4 imposed
+         * on every expiry. Each SSVI slice is stored as its equivalent raw
+         * SVI parameters. Independent SVI slices are butterfly-aware in the
+         * wings but, unlike SSVI, do not rule out calendar arbitrage.
+         */
+        class SviSurface
+        {
+        private:
+            double underlying_price;
+            double risk_free_rate;
+            double dividend_yield;
+            // Per-expiry rate and dividend yield from put-call parity; empty for a flat r and q
+            std::vector<parity::ParityFit> carry_curve;
+            std::vector<double> expiry_axis;
+            std::vector<SviFit> fits;
+
+            struct Slice
+            {
+                double T;
+                std::vector<double> k;
+                std::vector<double> w;
+                std::vector<double> weight;
+            };
+
+            static void check_market(double S, double r, double q)
+            {
+                if (!(S > 0.0) || !std::isfinite(S))
+                {
+                    throw std::invalid_argument("Underlying price must be positive and finite, got: " + std::to_string(S));
+                }
+                if (!std::isfinite(r) || !std::isfinite(q))
+                {
+                    throw std::invalid_argument("Rates must be finite");
+                }
+            }
+
+            // Groups quotes by expiry (exact match), dropping NaN volatilities; weight may be null
+            std::vector<Slice> group(utils::Column<double> T, utils::Column<double> K, utils::Column<double> iv,
+                                     const double *weight, std::size_t n) const
+            {
+                std::vector<std::size_t> order;
+                order.reserve(n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (std::isnan(iv[i]))
+                    {
+                        continue;
+                    }
+                    if (!(T[i] > 0.0) || !std::isfinite(T[i]) || !(K[i] > 0.0) || !std::isfinite(K[i]) ||
+                        !(iv[i] >= 0.0) || !std::isfinite(iv[i]))
+                    {
+                        throw std::invalid_argument("Invalid quote at index " + std::to_string(i) +
+                                                    ": expiry and strike must be positive and iv non-negative");
+                    }
+                    order.push_back(i);
+                }
+                std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                    return T[a] < T[b] || (T[a] == T[b] && K[a] < K[b]);
+                });
+
+                std::vector<Slice> slices;
+                for (std::size_t i : order)
+                {
+                    if (slices.empty() || slices.back().T != T[i])
+                    {
+                        slices.push_back({T[i], {}, {}, {}});
+                    }
+                    Slice &s = slices.back();
+                    double k = std::log(K[i] / forward(T[i]));
+                    if (!s.k.empty() && s.k.back() == k)
+                    {
+                        throw std::invalid_argument("Duplicate strike " + std::to_string(K[i]) +
+                                                    " at T=" + std::to_string(T[i]));
+                    }
+                    s.k.push_back(k);
+                    s.w.push_back(iv[i] * iv[i] * T[i]);
+                    s.weight.push_back(weight ? weight[i] : 1.0);
+                }
+                if (slices.empty())
+                {
+                    throw std::invalid_argument("No finite implied volatilities to calibrate to");
+                }
+                return slices;
+            }
+
+            void fit_ssvi(const std::vector<Slice> &slices, int max_iter)
+            {
+                const std::size_t ns = slices.size();
+                std::vector<double> theta(ns);
+                std::vector<double> qk, qw, qroot, qtheta;
+                for (std::size_t j = 0; j < ns; ++j)
+                {
+                    // ATM variance from a raw SVI fit of the slice where there are enough quotes
+                    const Slice &s = slices[j];
+                    double atm = s.k.size() >= 5
+                                     ? fit_svi_slice(s.k.data(), s.w.data(), s.weight.data(), s.k.size(), s.T, max_iter).params.total_variance(0.0)
+                                     : detail::atm_variance(s.k.data(), s.w.data(), s.k.size());
+                    theta[j] = std::max(atm, 1e-12);
+                    // No calendar arbitrage at the money
+                    if (j > 0)
+                    {
+                        theta[j] = std::max(theta[j], theta[j - 1]);
+                    }
+                }
+                for (std::size_t j = 0; j < ns; ++j)
+                {
+                    qk.insert(qk.end(), slices[j].k.begin(), slices[j].k.end());
+                    qw.insert(qw.end(), slices[j].w.begin(), slices[j].w.end());
+                    for (double wt : slices[j].weight)
+                    {
+                        qroot.push_back(std::sqrt(wt));
+                    }
+                    qtheta.insert(qtheta.end(), slices[j].k.size(), theta[j]);
+                }
+                if (qk.size() < 3)
+                {
+                    throw std::invalid_argument("SSVI needs at least 3 quotes, got " + std::to_string(qk.size()));
+                }
+
+                auto residual = [&](const std::array<double, 3> &p, std::size_t i, double *J) {
+                    double rho = p[0], eta = p[1], gamma = p[2];
+                    double th = qtheta[i];
+                    double phi = eta * std::pow(th, -gamma);
+                    double u = phi * qk[i];
+                    double R = std::sqrt((u + rho) * (u + rho) + 1.0 - rho * rho);
+                    if (J)
+                    {
+                        double dw_dphi = 0.5 * th * qk[i] * (rho + (u + rho) / R);
+                        J[0] = qroot[i] * 0.5 * th * (u + u / R);
+                        J[1] = qroot[i] * dw_dphi * phi / eta;
+                        J[2] = -qroot[i] * dw_dphi * phi * std::log(th);
+                    }
+                    return qroot[i] * (0.5 * th * (1.0 + rho * u + R) - qw[i]);
+                };
+                auto project = [&theta](std::array<double, 3> &p) {
+                    double &rho = p[0], &eta = p[1], &gamma = p[2];
+                    rho = std::min(std::max(rho, -detail::MAX_RHO), detail::MAX_RHO);
+                    gamma = std::min(std::max(gamma, 0.0), 1.0);
+                    eta = std::max(eta, 1e-6);
+                    for (double th : theta)
+                    {
+                        double limit = 4.0 / (1.0 + std::abs(rho));
+                        eta = std::min(eta, limit / std::pow(th, 1.0 - gamma));
+                        eta = std::min(eta, std::sqrt(limit / std::pow(th, 1.0 - 2.0 * gamma)));
+                    }
+                };
+
+                // A few skew starts; the problem is small enough that this costs microseconds
+                std::array<double, 3> best = {0.0, 1.0, 0.5};
+                double best_cost = std::numeric_limits<double>::infinity();
+                int iterations = 0;
+                for (double rho0 : {-0.5, 0.0, 0.5})
+                {
+                    std::array<double, 3> p = {rho0, 1.0, 0.5};
+                    double cost;
+                    iterations += detail::levenberg_marquardt<3>(p, qk.size(), residual, project, max_iter, cost);
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best = p;
+                    }
+                }
+
+                double rho = best[0];
+                for (std::size_t j = 0; j < ns; ++j)
+                {
+                    double phi = best[1] * std::pow(theta[j], -best[2]);
+                    SviFit fit;
+                    fit.params = {0.5 * theta[j] * (1.0 - rho * rho), 0.5 * theta[j] * phi, rho, -rho / phi,
+                                  std::sqrt(1.0 - rho * rho) / phi};
+                    fit.expiry = slices[j].T;
+                    fit.rmse = detail::vol_rmse(fit.params, slices[j].k.data(), slices[j].w.data(), slices[j].weight.data(),
+                                                slices[j].k.size(), slices[j].T);
+                    fit.iterations = iterations;
+                    fit.num_quotes = static_cast<int>(slices[j].k.size());
+                    fits.push_back(fit);
+                }
+            }
+
+            SviSurface(double S, double r, double q) : underlying_price(S), risk_free_rate(r), dividend_yield(q)
+            {
+                check_market(S, r, q);
+            }
+
+            void calibrate(utils::Column<double> T, utils::Column<double> K, utils::Column<double> iv,
+                           const double *weight, std::size_t n, SmileModel model, int max_iter)
+            {
+                std::vector<Slice> slices = group(T, K, iv, weight, n);
+                if (model == SmileModel::SSVI)
+                {
+                    fit_ssvi(slices, max_iter);
+                }
+                else
+                {
+                    fits.resize(slices.size());
+                    parallel::parallel_for(slices.size(), 1, [&](std::size_t begin, std::size_t end) {
+                        for (std::size_t j = begin; j < end; ++j)
+                        {
+                            fits[j] = fit_svi_slice(slices[j].k.data(), slices[j].w.data(), slices[j].weight.data(),
+                                                    slices[j].k.size(), slices[j].T, max_iter);
+                        }
+                    });
+                }
+                for (const SviFit &f : fits)
+                {
+                    expiry_axis.push_back(f.expiry);
+                }
+            }
+
+            // Inverts prices with per-quote carry, then fits the vega-weighted volatilities
+            void calibrate_prices(utils::Column<double> T, utils::Column<double> K, utils::Column<double> price,
+                                  utils::Column<bool> is_call, utils::Column<double> rate,
+                                  utils::Column<double> q, std::size_t n, SmileModel model, int max_iter)
+            {
+                const double S = underlying_price;
+                std::vector<double> iv(n);
+                std::vector<double> vega(n);
+                std::vector<std::int8_t> status(n);
+                models::implied_volatility_batch(price, {&S, 0}, K, rate, T, q, is_call, 1e-8, 100,
+                                                 iv.data(), status.data(), n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (status[i] != static_cast<std::int8_t>(models::IVStatus::OK))
+                    {
+                        iv[i] = std::numeric_limits<double>::quiet_NaN();
+                        continue;
+                    }
+                    double sqrt_T = std::sqrt(T[i]);
+                    double d1 = (std::log(S / K[i]) + (rate[i] - q[i] + 0.5 * iv[i] * iv[i]) * T[i]) / (iv[i] * sqrt_T);
+                    vega[i] = S * std::exp(-q[i] * T[i]) * utils::norm_pdf(d1) * sqrt_T;
+                }
+                calibrate(T, K, {iv.data(), 1}, vega.data(), n, model, max_iter);
+            }
+
+        public:
+            /**
+             * @brief Surface from already known slices (e.g. a saved calibration)
+             */
+            SviSurface(double S, double r, double q, const std::vector<SviFit> &slices)
+                : underlying_price(S), risk_free_rate(r), dividend_yield(q), fits(slices)
+            {
+                check_market(S, r, q);
+                if (fits.empty())
+                {
+                    throw std::invalid_argument("SviSurface needs at least one slice");
+                }
+                std::sort(fits.begin(), fits.end(), [](const SviFit &a, const SviFit &b) { return a.expiry < b.expiry; });
+                for (std::size_t j = 0; j < fits.size(); ++j)
+                {
+                    if (!(fits[j].expiry > 0.0) || (j > 0 && fits[j].expiry == fits[j - 1].expiry))
+                    {
+                        throw std::invalid_argument("Slice expiries must be positive and distinct");
+                    }
+                    expiry_axis.push_back(fits[j].expiry);
+                }
+            }
+
+            /**
+             * @brief Calibrates to n implied volatility quotes, equally weighted; NaN quotes are skipped
+             */
+            static SviSurface from_quotes(double S, double r, double q, utils::Column<double> T, utils::Column<double> K,
+                                          utils::Column<double> iv, std::size_t n, SmileModel model = SmileModel::SVI,
+                                          int max_iter = 100)
+            {
+                SviSurface surface(S, r, q);
+                surface.calibrate(T, K, iv, nullptr, n, model, max_iter);
+                return surface;
+            }
+
+            /**
+             * @brief Calibrates to n option prices, inverted with the batch IV solver.
+             *
+             * Quotes the solver rejects (below intrinsic, not converged, ...)
+             * are left out of the fit. The rest are weighted by Black-Scholes
+             * vega, so far-wing quotes whose price barely pins down a
+             * volatility count for correspondingly little.
+             */
+            static SviSurface from_prices(double S, double r, double q, utils::Column<double> T, utils::Column<double> K,
+                                          utils::Column<double> price, utils::Column<bool> is_call, std::size_t n,
+                                          SmileModel model = SmileModel::SVI, int max_iter = 100)
+            {
+                SviSurface surface(S, r, q);
+                surface.calibrate_prices(T, K, price, is_call, {&r, 0}, {&q, 0}, n, model, max_iter);
+                return surface;
+            }
+
+            /**
+             * @brief Calibrates to n option prices under a put-call parity carry curve.
+             *
+             * Each quote is inverted with the rate and dividend yield of its
+             * expiry (parity::carry_at), and log-moneyness uses the same forwards,
+             * so per-expiry carry no longer shows up as skew. The flat rate and
+             * dividend yield reported by the surface are those of the first fit.
+             */
+            static SviSurface from_prices(double S, const std::vector<parity::ParityFit> &carry,
+                                          utils::Column<double> T, utils::Column<double> K,
+                                          utils::Column<double> price, utils::Column<bool> is_call, std::size_t n,
+                                          SmileModel model = SmileModel::SVI, int max_iter = 100)
+            {
+                if (carry.empty())
+                {
+                    throw std::invalid_argument("Carry needs at least one parity fit");
+                }
+                std::vector<parity::ParityFit> curve(carry);
+                std::sort(curve.begin(), curve.end(),
+                          [](const parity::ParityFit &a, const parity::ParityFit &b) { return a.expiry < b.expiry; });
+                for (std::size_t j = 0; j < curve.size(); ++j)
+                {
+                    if (!(curve[j].expiry > 0.0) || (j > 0 && curve[j].expiry == curve[j - 1].expiry))
+                    {
+                        throw std::invalid_argument("Carry expiries must be positive and distinct");
+                    }
+                }
+                SviSurface surface(S, curve.front().rate, curve.front().dividend_yield);
+                surface.carry_curve = std::move(curve);
+                std::vector<double> rate(n), q(n);
+                parity::carry_batch(surface.carry_curve, T, rate.data(), q.data(), n);
+                surface.calibrate_prices(T, K, price, is_call, {rate.data(), 1}, {q.data(), 1}, n, model, max_iter);
+                return surface;
+            }
+
+            double forward(double T) const
+            {
+                if (carry_curve.empty())
+                {
+                    return underlying_price * std::exp((risk_free_rate - dividend_yield) * T);
+                }
+                parity::Carry c = parity::carry_at(carry_curve, T);
+                return underlying_price * std::exp((c.rate - c.dividend_yield) * T);
+            }
+
+            /**
+             * @brief Total variance at log-moneyness k and expiry T, linear in T between slices
+             */
+            double total_variance(double k, double T) const
+            {
+                const std::size_t ns = fits.size();
+                if (T <= expiry_axis[0])
+                {
+                    return fits[0].params.total_variance(k) * (T / expiry_axis[0]);
+                }
+                if (T >= expiry_axis[ns - 1])
+                {
+                    return fits[ns - 1].params.total_variance(k) * (T / expiry_axis[ns - 1]);
+                }
+                std::size_t j = static_cast<std::size_t>(
+                    std::upper_bound(expiry_axis.begin(), expiry_axis.end(), T) - expiry_axis.begin());
+                double t = (T - expiry_axis[j - 1]) / (expiry_axis[j] - expiry_axis[j - 1]);
+                double w0 = fits[j - 1].params.total_variance(k);
+                double w1 = fits[j].params.total_variance(k);
+                return w0 + t * (w1 - w0);
+            }
+
+            /**
+             * @brief Implied volatility at (K, T); NaN for non-positive or NaN inputs
+             */
+            double get_iv(double strike, double expiry) const
+            {
+                if (!(strike > 0.0) || !(expiry > 0.0))
+                {
+                    return std::numeric_limits<double>::quiet_NaN();
+                }
+                double w = total_variance(std::log(strike / forward(expiry)), expiry);
+                return std::sqrt(std::max(w, 0.0) / expiry);
+            }
+
+            void get_iv_batch(utils::Column<double> strike, utils::Column<double> expiry, double *out, std::size_t n) const
+            {
+                parallel::parallel_for(n, 8192, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        out[i] = get_iv(strike[i], expiry[i]);
+                    }
+                });
+            }
+
+            std::size_t num_slices() const { return fits.size(); }
+            const std::vector<SviFit> &slices() const { return fits; }
+            const std::vector<double> &expiries() const { return expiry_axis; }
+            double get_underlying_price() const { return underlying_price; }
+            double get_risk_free_rate() const { return risk_free_rate; }
+            double get_dividend_yield() const { return dividend_yield; }
+            const std::vector<parity::ParityFit> &carry() const { return carry_curve; }
+        };
+    }
+}
+
+#endif // OPTIPRICER_SVI_HPP
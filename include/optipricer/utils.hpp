@@ -2,6 +2,7 @@
 #define OPTIPRICER_UTILS_HPP
 
 #include <cmath>
+#include <cstddef>
 
 namespace optipricer
 {
@@ -12,6 +13,24 @@ namespace optipricer
         constexpr double DAYS_PER_YEAR = 365.0;
         constexpr double PERCENTAGE_DIVISOR = 100.0;
         constexpr double SQRT_2PI = 2.506628274631000502415765284811;
+        constexpr double PI = 3.141592653589793238462643383279;
+
+        /**
+         * @brief Read-only strided view over one batch input.
+         *
+         * A stride of 1 walks a contiguous array, a stride of 0 repeats a single
+         * value for every element, which is how scalar arguments are broadcast
+         * against array arguments.
+         */
+        template <typename T>
+        struct Column
+        {
+            const T *data;
+            std::size_t stride;
+
+            T operator[](std::size_t i) const { return data[i * stride]; }
+            Column from(std::size_t i) const { return {data + i * stride, stride}; }
+        };
 
         /**
          * @brief Standard normal cumulative distribution function (CDF)
@@ -33,6 +52,63 @@ namespace optipricer
             return (1.0 / SQRT_2PI) * std::exp(-0.5 * x * x);
         }
 
+        /**
+         * @brief Inverse of the standard normal CDF (Wichura 1988, AS241 PPND16)
+         * @param p Probability in (0, 1); 0 and 1 map to -inf and +inf
+         * @return z with norm_cdf(z) = p, relative error about 1e-16
+         */
+        inline double norm_inv_cdf(double p)
+        {
+            double q = p - 0.5;
+            if (std::abs(q) <= 0.425)
+            {
+                double r = 0.180625 - q * q;
+                double num = ((((((2.5090809287301226727e+3 * r + 3.3430575583588128105e+4) * r +
+                                  6.7265770927008700853e+4) * r + 4.5921953931549871457e+4) * r +
+                                1.3731693765509461125e+4) * r + 1.9715909503065514427e+3) * r +
+                              1.3314166789178437745e+2) * r + 3.3871328727963666080e+0;
+                double den = ((((((5.2264952788528545610e+3 * r + 2.8729085735721942674e+4) * r +
+                                  3.9307895800092710610e+4) * r + 2.1213794301586595867e+4) * r +
+                                5.3941960214247511077e+3) * r + 6.8718700749205790830e+2) * r +
+                              4.2313330701600911252e+1) * r + 1.0;
+                return q * num / den;
+            }
+            double r = q < 0.0 ? p : 1.0 - p;
+            if (r <= 0.0)
+            {
+                return q < 0.0 ? -HUGE_VAL : HUGE_VAL;
+            }
+            r = std::sqrt(-std::log(r));
+            double z;
+            if (r <= 5.0)
+            {
+                r -= 1.6;
+                double num = ((((((7.74545014278341407640e-4 * r + 2.27238449892691845833e-2) * r +
+                                  2.41780725177450611770e-1) * r + 1.27045825245236838258e+0) * r +
+                                3.64784832476320460504e+0) * r + 5.76949722146069140550e+0) * r +
+                              4.63033784615654529590e+0) * r + 1.42343711074968357734e+0;
+                double den = ((((((1.05075007164441684324e-9 * r + 5.47593808499534494600e-4) * r +
+                                  1.51986665636164571966e-2) * r + 1.48103976427480074590e-1) * r +
+                                6.89767334985100004550e-1) * r + 1.67638483018380384940e+0) * r +
+                              2.05319162663775882187e+0) * r + 1.0;
+                z = num / den;
+            }
+            else
+            {
+                r -= 5.0;
+                double num = ((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r +
+                                  1.24266094738807843860e-3) * r + 2.65321895265761230930e-2) * r +
+                                2.96560571828504891230e-1) * r + 1.78482653991729133580e+0) * r +
+                              5.46378491116411436990e+0) * r + 6.65790464350110377720e+0;
+                double den = ((((((2.04426310338993978564e-15 * r + 1.42151175831644588870e-7) * r +
+                                  1.84631831751005468180e-5) * r + 7.86869131145613259100e-4) * r +
+                                1.48753612908506148525e-2) * r + 1.36929880922735805310e-1) * r +
+                              5.99832206555887937690e-1) * r + 1.0;
+                z = num / den;
+            }
+            return q < 0.0 ? -z : z;
+        }
+
     } // namespace utils
 } // namespace optipricer
 
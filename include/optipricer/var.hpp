@@ -0,0 +1,169 @@
+#ifndef OPTIPRICER_VAR_HPP
+#define OPTIPRICER_VAR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "portfolio.hpp"
+#include "utils.hpp"
+
+/*
+ * Value at risk and expected shortfall from scenario P&L.
+ *
+ * Historical figures come from the empirical tail: with n scenarios at
+ * confidence c the tail is the ceil((1 - c) * n) worst outcomes (at least
+ * one), VaR is the smallest loss in it and ES the mean loss over it. The
+ * parametric figures fit a normal distribution to the same P&L. Losses are
+ * reported as positive numbers.
+ *
+ * Contributions split the historical figures by underlying: VaR's are each
+ * underlying's loss in the VaR scenario and ES's its mean loss over the tail,
+ * so both sum to the book-wide number.
+ */
+
+namespace optipricer
+{
+    namespace var
+    {
+        struct VaRResult
+        {
+            double confidence;
+            std::size_t num_scenarios;
+            std::size_t num_underlyings;
+            // Number of worst scenarios averaged into the expected shortfall
+            std::size_t tail_size;
+            // Scenario whose loss is the historical VaR
+            std::size_t var_scenario;
+            double value_at_risk;
+            double expected_shortfall;
+            double parametric_var;
+            double parametric_es;
+            double mean_pnl;
+            double pnl_stddev;
+            std::vector<double> var_contributions;
+            std::vector<double> es_contributions;
+            // Book P&L per scenario, and per scenario and underlying (row-major)
+            std::vector<double> pnl;
+            std::vector<double> pnl_by_underlying;
+        };
+
+        /**
+         * @brief VaR, ES and per-underlying contributions of n scenarios' P&L.
+         *
+         * pnl_by_underlying[s * nu + u] is underlying u's P&L in scenario s.
+         * Ties in the tail are broken by scenario index, so results are
+         * reproducible.
+         */
+        inline VaRResult from_pnl(std::vector<double> pnl_by_underlying, std::size_t n, std::size_t nu,
+                                  double confidence)
+        {
+            if (!(confidence > 0.0 && confidence < 1.0))
+            {
+                throw std::invalid_argument("Confidence must be within (0, 1), got: " + std::to_string(confidence));
+            }
+            if (n == 0)
+            {
+                throw std::invalid_argument("VaR needs at least one scenario");
+            }
+            if (pnl_by_underlying.size() != n * nu)
+            {
+                throw std::invalid_argument("Expected " + std::to_string(n * nu) + " scenario P&L values, got " +
+                                            std::to_string(pnl_by_underlying.size()));
+            }
+
+            VaRResult result;
+            result.confidence = confidence;
+            result.num_scenarios = n;
+            result.num_underlyings = nu;
+            result.pnl.assign(n, 0.0);
+            for (std::size_t s = 0; s < n; ++s)
+            {
+                for (std::size_t u = 0; u < nu; ++u)
+                {
+                    result.pnl[s] += pnl_by_underlying[s * nu + u];
+                }
+            }
+
+            // Absorb the rounding in (1 - c) * n so that 1% of 500 is 5, not 6
+            const double expected_tail = (1.0 - confidence) * static_cast<double>(n);
+            std::size_t tail = static_cast<std::size_t>(std::ceil(expected_tail - 1e-9 * std::max(expected_tail, 1.0)));
+            tail = std::min(std::max<std::size_t>(tail, 1), n);
+
+            std::vector<std::size_t> order(n);
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            const std::vector<double> &pnl = result.pnl;
+            std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(tail), order.end(),
+                              [&pnl](std::size_t a, std::size_t b) { return pnl[a] != pnl[b] ? pnl[a] < pnl[b] : a < b; });
+
+            result.tail_size = tail;
+            result.var_scenario = order[tail - 1];
+            result.value_at_risk = -pnl[result.var_scenario];
+            result.var_contributions.assign(nu, 0.0);
+            result.es_contributions.assign(nu, 0.0);
+            double tail_loss = 0.0;
+            for (std::size_t k = 0; k < tail; ++k)
+            {
+                tail_loss -= pnl[order[k]];
+                for (std::size_t u = 0; u < nu; ++u)
+                {
+                    result.es_contributions[u] -= pnl_by_underlying[order[k] * nu + u];
+                }
+            }
+            result.expected_shortfall = tail_loss / static_cast<double>(tail);
+            for (std::size_t u = 0; u < nu; ++u)
+            {
+                result.var_contributions[u] = -pnl_by_underlying[result.var_scenario * nu + u];
+                result.es_contributions[u] /= static_cast<double>(tail);
+            }
+
+            double mean = 0.0;
+            for (double x : pnl)
+            {
+                mean += x;
+            }
+            mean /= static_cast<double>(n);
+            double sum_sq = 0.0;
+            for (double x : pnl)
+            {
+                sum_sq += (x - mean) * (x - mean);
+            }
+            const double stddev = n > 1 ? std::sqrt(sum_sq / static_cast<double>(n - 1)) : 0.0;
+            const double z = utils::norm_inv_cdf(confidence);
+            result.mean_pnl = mean;
+            result.pnl_stddev = stddev;
+            result.parametric_var = -mean + z * stddev;
+            result.parametric_es = -mean + stddev * utils::norm_pdf(z) / (1.0 - confidence);
+            result.pnl_by_underlying = std::move(pnl_by_underlying);
+            return result;
+        }
+
+        /**
+         * @brief VaR and ES of a book over n historical spot / volatility shocks.
+         *
+         * Shocks are laid out as in Portfolio::scenario_pnl (scenario-major, one
+         * column per underlying; vol_shocks may be nullptr). FULL mode revalues
+         * every leg under every scenario in bounded memory; TAYLOR mode uses the
+         * book's Greeks.
+         */
+        inline VaRResult historical_var(const portfolio::Portfolio &book, const double *spot_shocks,
+                                        const double *vol_shocks, std::size_t n, double confidence,
+                                        double horizon = 0.0,
+                                        portfolio::ScenarioMode mode = portfolio::ScenarioMode::FULL)
+        {
+            if (!(confidence > 0.0 && confidence < 1.0))
+            {
+                throw std::invalid_argument("Confidence must be within (0, 1), got: " + std::to_string(confidence));
+            }
+            const std::size_t nu = book.num_underlyings();
+            std::vector<double> pnl(n * nu);
+            book.scenario_pnl(spot_shocks, vol_shocks, n, horizon, mode, pnl.data());
+            return from_pnl(std::move(pnl), n, nu, confidence);
+        }
+    }
+}
+
+#endif // OPTIPRICER_VAR_HPP
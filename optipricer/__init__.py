@@ -3,9 +3,12 @@ OptiPricer: A high-performance options pricing and analysis library.
 Optimized for European-style stock and index options.
 """
 
+import numpy as np
+
 from . import models
 from . import strategies
 from . import nse
+from ._core import get_num_threads, reset_stats, set_num_threads, stats
 
 # Lazy import for viz — only loaded when explicitly accessed.
 # This avoids polluting the namespace when matplotlib is not installed.
@@ -18,10 +21,14 @@ def __getattr__(name):
     raise AttributeError(f"module 'optipricer' has no attribute {name!r}")
 
 # High-level Facade API
-def price(S: float, K: float, r: float, T: float, vol: float, q: float = 0.0, option: str = 'call') -> float:
+def price(S, K, r, T, vol, q=0.0, option: str = 'call'):
     """
     Calculate the Black-Scholes-Merton option price.
 
+    Any of the numeric inputs may be a NumPy array (or list); scalars are
+    broadcast against the arrays and the whole batch is priced in a single
+    native call.
+
     Parameters:
         S (float): Current price of the underlying asset
         K (float): Strike price of the option
@@ -32,21 +39,35 @@ def price(S: float, K: float, r: float, T: float, vol: float, q: float = 0.0, op
         option (str): Option type, either 'call' or 'put' (default 'call')
 
     Returns:
-        float: Calculated option price
+        float | numpy.ndarray: Calculated option price(s)
     """
     opt = option.lower().strip()
     if opt not in ('call', 'put'):
         raise ValueError(f"Invalid option type: '{option}'. Must be 'call' or 'put'.")
-    
+
+    if any(np.ndim(x) > 0 for x in (S, K, r, T, vol, q)):
+        return models.price_batch(S, K, r, T, vol, q, is_call=(opt == 'call'))
+
     model = models.BlackScholesModel(strike_price=K, volatility=vol, risk_free_rate=r, time_to_maturity=T, underlying_price=S, dividend_yield=q)
     return model.call_price() if opt == 'call' else model.put_price()
 
-def greeks(S: float, K: float, r: float, T: float, vol: float, q: float = 0.0) -> dict:
+_GREEK_KEYS = (
+    # First-order Greeks
+    'call_delta', 'put_delta', 'gamma', 'vega', 'call_theta', 'put_theta', 'call_rho', 'put_rho',
+    # Second-order Greeks
+    'vanna', 'volga', 'call_charm', 'put_charm',
+)
+
+def greeks(S, K, r, T, vol, q=0.0) -> dict:
     """
     Calculate option sensitivity measures (Greeks) for both call and put options.
     Includes first-order Greeks (Delta, Gamma, Vega, Theta, Rho) and
     second-order Greeks (Vanna, Volga, Charm).
 
+    All Greeks come from one fused native evaluation. Any of the numeric
+    inputs may be a NumPy array, in which case each value in the returned
+    dict is an array with the broadcast shape.
+
     Parameters:
         S (float): Current price of the underlying asset
         K (float): Strike price of the option
@@ -60,29 +81,23 @@ def greeks(S: float, K: float, r: float, T: float, vol: float, q: float = 0.0) -
               First-order: 'call_delta', 'put_delta', 'gamma', 'vega', 'call_theta', 'put_theta', 'call_rho', 'put_rho'
               Second-order: 'vanna', 'volga', 'call_charm', 'put_charm'
     """
+    if any(np.ndim(x) > 0 for x in (S, K, r, T, vol, q)):
+        batch = models.greeks_batch(S, K, r, T, vol, q)
+        return {key: batch[key] for key in _GREEK_KEYS}
+
     model = models.BlackScholesModel(strike_price=K, volatility=vol, risk_free_rate=r, time_to_maturity=T, underlying_price=S, dividend_yield=q)
-    calc = models.GreeksCalculator(model)
-    return {
-        # First-order Greeks
-        'call_delta': calc.call_delta(),
-        'put_delta': calc.put_delta(),
-        'gamma': calc.gamma(),
-        'vega': calc.vega(),
-        'call_theta': calc.call_theta(),
-        'put_theta': calc.put_theta(),
-        'call_rho': calc.call_rho(),
-        'put_rho': calc.put_rho(),
-        # Second-order Greeks
-        'vanna': calc.vanna(),
-        'volga': calc.volga(),
-        'call_charm': calc.call_charm(),
-        'put_charm': calc.put_charm(),
-    }
+    result = models.GreeksCalculator(model).compute_all()
+    return {key: getattr(result, key) for key in _GREEK_KEYS}
 
 def implied_vol(market_price: float, S: float, K: float, r: float, T: float, q: float = 0.0, option: str = 'call', tol: float = 1e-6, max_iter: int = 100) -> float:
     """
     Calculate the implied volatility of an option given its market price.
 
+    Any of the numeric inputs may be a NumPy array, in which case the batch is
+    solved natively across threads and quotes that cannot be inverted come
+    back as NaN instead of raising. Use models.implied_volatility_batch for
+    the per-element status codes.
+
     Parameters:
         market_price (float): Market price of the option
         S (float): Current price of the underlying asset
@@ -95,13 +110,17 @@ def implied_vol(market_price: float, S: float, K: float, r: float, T: float, q:
         max_iter (int): Maximum number of iterations for solver (default 100)
 
     Returns:
-        float: Solved implied volatility (e.g. 0.25 for 25%)
+        float | numpy.ndarray: Solved implied volatility (e.g. 0.25 for 25%)
     """
     opt = option.lower().strip()
     if opt not in ('call', 'put'):
         raise ValueError(f"Invalid option type: '{option}'. Must be 'call' or 'put'.")
     
     is_call = (opt == 'call')
+    if any(np.ndim(x) > 0 for x in (market_price, S, K, r, T, q)):
+        iv, _ = models.implied_volatility_batch(market_price, S, K, r, T, q, is_call=is_call, tol=tol, max_iter=max_iter)
+        return iv
     return models.calculate_implied_volatility(market_price, strike_price=K, risk_free_rate=r, time_to_maturity=T, underlying_price=S, dividend_yield=q, is_call=is_call, tol=tol, max_iter=max_iter)
 
-__all__ = ['price', 'greeks', 'implied_vol', 'models', 'strategies', 'nse', 'viz']
+__all__ = ['price', 'greeks', 'implied_vol', 'set_num_threads', 'get_num_threads', 'stats', 'reset_stats',
+           'models', 'strategies', 'nse', 'viz']
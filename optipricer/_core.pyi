@@ -1,6 +1,10 @@
 """Type stubs for optipricer._core C++ extension module."""
 
-from typing import List
+from typing import Callable, Dict, List, Optional, Sequence, Tuple, Union, overload
+
+import numpy as np
+
+ArrayLike = Union[float, bool, Sequence[float], np.ndarray]
 
 def norm_cdf(x: float) -> float:
     """Standard normal cumulative distribution function."""
@@ -10,9 +14,70 @@ def norm_pdf(x: float) -> float:
     """Standard normal probability density function."""
     ...
 
+def set_num_threads(n: int) -> None:
+    """Set the number of native threads used for batch work (0 = one per hardware thread)."""
+    ...
+
+def get_num_threads() -> int:
+    """Number of native threads used for batch work."""
+    ...
+
+def stats() -> Dict[str, object]:
+    """
+    Solver and entry-point counters recorded since the last reset_stats().
+
+    Keys: 'enabled' (False unless the extension was built with
+    OPTIPRICER_STATS=1, in which case every count stays 0);
+    'implied_volatility' with calls, converged, not_converged, rejected,
+    iterations, newton_steps, bisection_steps, bracket_expansions and
+    iteration_histogram (solves needing 0..15 iterations, then 16+); and
+    'latency', one entry per instrumented entry point (price, greeks,
+    implied_volatility and their *_batch forms) with count, total_ns,
+    mean_ns, p50_ns / p90_ns / p99_ns (upper edges of power-of-two buckets)
+    and the raw buckets ([2**b, 2**(b+1)) ns).
+    """
+    ...
+
+def reset_stats() -> None:
+    """Zero the counters reported by stats()."""
+    ...
+
 
 class models:
+    class AllGreeks:
+        call_price: float
+        put_price: float
+        call_delta: float
+        put_delta: float
+        gamma: float
+        vega: float
+        call_theta: float
+        put_theta: float
+        call_rho: float
+        put_rho: float
+        vanna: float
+        volga: float
+        call_charm: float
+        put_charm: float
+        def to_dict(self) -> Dict[str, float]: ...
+        def __repr__(self) -> str: ...
+
+    class ExpiryContext:
+        def __init__(self, risk_free_rate: float, time_to_maturity: float, dividend_yield: float = 0.0) -> None: ...
+        @staticmethod
+        def unchecked(
+            risk_free_rate: float, time_to_maturity: float, dividend_yield: float = 0.0
+        ) -> "models.ExpiryContext": ...
+        def get_risk_free_rate(self) -> float: ...
+        def get_time_to_maturity(self) -> float: ...
+        def get_dividend_yield(self) -> float: ...
+        def get_discount_factor(self) -> float: ...
+        def get_dividend_discount(self) -> float: ...
+        def get_sqrt_time(self) -> float: ...
+        def __repr__(self) -> str: ...
+
     class BlackScholesModel:
+        @overload
         def __init__(
             self,
             strike_price: float,
@@ -22,6 +87,32 @@ class models:
             underlying_price: float,
             dividend_yield: float = 0.0,
         ) -> None: ...
+        @overload
+        def __init__(
+            self,
+            strike_price: float,
+            volatility: float,
+            underlying_price: float,
+            expiry: 'models.ExpiryContext',
+        ) -> None: ...
+        @overload
+        @staticmethod
+        def unchecked(
+            strike_price: float,
+            volatility: float,
+            risk_free_rate: float,
+            time_to_maturity: float,
+            underlying_price: float,
+            dividend_yield: float = 0.0,
+        ) -> "models.BlackScholesModel": ...
+        @overload
+        @staticmethod
+        def unchecked(
+            strike_price: float,
+            volatility: float,
+            underlying_price: float,
+            expiry: 'models.ExpiryContext',
+        ) -> "models.BlackScholesModel": ...
         def d1(self) -> float: ...
         def d2(self) -> float: ...
         def call_price(self) -> float: ...
@@ -31,7 +122,12 @@ class models:
         def get_risk_free_rate(self) -> float: ...
         def get_time_to_maturity(self) -> float: ...
         def get_underlying_price(self) -> float: ...
+        def get_underlying_price(self) -> float: ...
+        def get_volatility(self) -> float: ...
+        def get_risk_free_rate(self) -> float: ...
+        def get_time_to_maturity(self) -> float: ...
         def get_dividend_yield(self) -> float: ...
+        def get_expiry(self) -> 'models.ExpiryContext': ...
         def __repr__(self) -> str: ...
 
     class GreeksCalculator:
@@ -51,8 +147,11 @@ class models:
         def volga(self) -> float: ...
         def call_charm(self) -> float: ...
         def put_charm(self) -> float: ...
+        # Fused evaluation
+        def compute_all(self) -> 'models.AllGreeks': ...
         def __repr__(self) -> str: ...
 
+    @overload
     @staticmethod
     def calculate_implied_volatility(
         market_price: float,
@@ -65,7 +164,720 @@ class models:
         tol: float = 1e-6,
         max_iter: int = 100,
     ) -> float: ...
+    @overload
+    @staticmethod
+    def calculate_implied_volatility(
+        market_price: float,
+        strike_price: float,
+        underlying_price: float,
+        expiry: 'models.ExpiryContext',
+        is_call: bool = True,
+        tol: float = 1e-6,
+        max_iter: int = 100,
+    ) -> float: ...
+
+    # The batch functions run in float32, and return float32, when every array argument is float32
+    @staticmethod
+    def price_batch(
+        S: ArrayLike,
+        K: ArrayLike,
+        r: ArrayLike,
+        T: ArrayLike,
+        sigma: ArrayLike,
+        q: ArrayLike = 0.0,
+        is_call: ArrayLike = True,
+        out: Optional[np.ndarray] = None,
+    ) -> np.ndarray: ...
+
+    @staticmethod
+    def price_delta_batch(
+        S: ArrayLike,
+        K: ArrayLike,
+        r: ArrayLike,
+        T: ArrayLike,
+        sigma: ArrayLike,
+        q: ArrayLike = 0.0,
+        is_call: ArrayLike = True,
+        out: Optional[Tuple[np.ndarray, np.ndarray]] = None,
+    ) -> Tuple[np.ndarray, np.ndarray]: ...
+
+    @staticmethod
+    def greeks_batch(
+        S: ArrayLike,
+        K: ArrayLike,
+        r: ArrayLike,
+        T: ArrayLike,
+        sigma: ArrayLike,
+        q: ArrayLike = 0.0,
+        out: Optional[np.ndarray] = None,
+    ) -> np.ndarray: ...
 
+    class IVStatus:
+        OK: 'models.IVStatus'
+        INVALID_INPUT: 'models.IVStatus'
+        BELOW_INTRINSIC: 'models.IVStatus'
+        ABOVE_MAXIMUM: 'models.IVStatus'
+        VOLATILITY_TOO_HIGH: 'models.IVStatus'
+        NOT_CONVERGED: 'models.IVStatus'
+
+    @staticmethod
+    def implied_volatility_batch(
+        market_price: ArrayLike,
+        S: ArrayLike,
+        K: ArrayLike,
+        r: ArrayLike,
+        T: ArrayLike,
+        q: ArrayLike = 0.0,
+        is_call: ArrayLike = True,
+        tol: float = 1e-6,
+        max_iter: int = 100,
+        refine: bool = False,
+        out: Optional[Tuple[np.ndarray, np.ndarray]] = None,
+    ) -> Tuple[np.ndarray, np.ndarray]: ...
+
+    class Workspace:
+        def __init__(self) -> None: ...
+        def price_batch(
+            self,
+            S: ArrayLike,
+            K: ArrayLike,
+            r: ArrayLike,
+            T: ArrayLike,
+            sigma: ArrayLike,
+            q: ArrayLike = 0.0,
+            is_call: ArrayLike = True,
+        ) -> np.ndarray: ...
+        def price_delta_batch(
+            self,
+            S: ArrayLike,
+            K: ArrayLike,
+            r: ArrayLike,
+            T: ArrayLike,
+            sigma: ArrayLike,
+            q: ArrayLike = 0.0,
+            is_call: ArrayLike = True,
+        ) -> Tuple[np.ndarray, np.ndarray]: ...
+        def greeks_batch(
+            self,
+            S: ArrayLike,
+            K: ArrayLike,
+            r: ArrayLike,
+            T: ArrayLike,
+            sigma: ArrayLike,
+            q: ArrayLike = 0.0,
+        ) -> np.ndarray: ...
+        def implied_volatility_batch(
+            self,
+            market_price: ArrayLike,
+            S: ArrayLike,
+            K: ArrayLike,
+            r: ArrayLike,
+            T: ArrayLike,
+            q: ArrayLike = 0.0,
+            is_call: ArrayLike = True,
+            tol: float = 1e-6,
+            max_iter: int = 100,
+        ) -> Tuple[np.ndarray, np.ndarray]: ...
+        def clear(self) -> None: ...
+
+
+class chain:
+    COLUMN_NAMES: Tuple[str, ...]
+
+    class OptionChain:
+        underlying_price: float
+        risk_free_rate: float
+        time_to_maturity: float
+        dividend_yield: float
+        def __init__(
+            self,
+            underlying_price: float,
+            risk_free_rate: float,
+            time_to_maturity: float,
+            strikes: Sequence[float],
+            volatilities: Sequence[float],
+            dividend_yield: float = 0.0,
+        ) -> None: ...
+        def reprice(self, underlying_price: float) -> None: ...
+        def column(self, name: str) -> np.ndarray: ...
+        def columns(self) -> Dict[str, np.ndarray]: ...
+        def values(self) -> np.ndarray: ...
+        def atm_index(self) -> int: ...
+        def __len__(self) -> int: ...
+
+
+class surface:
+    class VolatilitySurface:
+        def __init__(
+            self,
+            strikes: Sequence[float],
+            expiries: Sequence[float],
+            iv_matrix: ArrayLike,
+        ) -> None: ...
+        def get_iv(self, strike: float, expiry: float) -> float: ...
+        def get_iv_batch(self, strikes: ArrayLike, expiries: ArrayLike) -> np.ndarray: ...
+        def strikes(self) -> np.ndarray: ...
+        def expiries(self) -> np.ndarray: ...
+        def raw_ivs(self) -> np.ndarray: ...
+        def filled_ivs(self) -> np.ndarray: ...
+        def nearest_strike_index(self, strike: float) -> int: ...
+        def set_iv(self, strike: float, expiry: float, iv: float) -> None: ...
+        def set_ivs(self, strikes: ArrayLike, expiries: ArrayLike, ivs: ArrayLike) -> None: ...
+        def set_slice(self, expiry: float, ivs: ArrayLike) -> None: ...
+        @property
+        def version(self) -> int: ...
+        def slice_version(self, expiry_index: int) -> int: ...
+
+
+class parity:
+    DEFAULT_OUTLIER_THRESHOLD: float
+
+    class ParityFit:
+        expiry: float
+        forward: float
+        rate: float
+        dividend_yield: float
+        discount_factor: float
+        rmse: float
+        num_quotes: int
+        num_used: int
+
+    @staticmethod
+    def calibrate(
+        S: float,
+        r: float,
+        T: ArrayLike,
+        K: ArrayLike,
+        call_price: ArrayLike,
+        put_price: ArrayLike,
+        weights: Optional[ArrayLike] = None,
+        fit_rate: bool = False,
+        outlier_threshold: float = 4.0,
+    ) -> List["parity.ParityFit"]: ...
+
+    @staticmethod
+    def carry(fits: Sequence["parity.ParityFit"], T: ArrayLike) -> Tuple[np.ndarray, np.ndarray]:
+        """Per-element (rate, dividend_yield) for expiries T, interpolated between fits."""
+        ...
+
+
+class svi:
+    class SmileModel:
+        SVI: "svi.SmileModel"
+        SSVI: "svi.SmileModel"
+
+    class SviParams:
+        a: float
+        b: float
+        rho: float
+        m: float
+        sigma: float
+        def __init__(self, a: float, b: float, rho: float, m: float, sigma: float) -> None: ...
+        def total_variance(self, k: float) -> float: ...
+        def min_variance(self) -> float: ...
+        def to_dict(self) -> Dict[str, float]: ...
+
+    class SviFit:
+        params: "svi.SviParams"
+        expiry: float
+        rmse: float
+        iterations: int
+        num_quotes: int
+
+    @staticmethod
+    def fit_slice(
+        k: ArrayLike,
+        w: ArrayLike,
+        T: float,
+        weights: ArrayLike = None,
+        max_iter: int = 100,
+    ) -> "svi.SviFit": ...
+
+    class SviSurface:
+        underlying_price: float
+        risk_free_rate: float
+        dividend_yield: float
+        carry: List["parity.ParityFit"]
+        def __init__(
+            self,
+            S: float,
+            r: float,
+            expiries: Sequence[float],
+            params: Sequence["svi.SviParams"],
+            q: float = 0.0,
+        ) -> None: ...
+        @staticmethod
+        def from_quotes(
+            S: float,
+            r: float,
+            T: ArrayLike,
+            K: ArrayLike,
+            iv: ArrayLike,
+            q: float = 0.0,
+            model: "svi.SmileModel" = ...,
+            max_iter: int = 100,
+        ) -> "svi.SviSurface": ...
+        @overload
+        @staticmethod
+        def from_prices(
+            S: float,
+            r: float,
+            T: ArrayLike,
+            K: ArrayLike,
+            price: ArrayLike,
+            is_call: ArrayLike = True,
+            q: float = 0.0,
+            model: "svi.SmileModel" = ...,
+            max_iter: int = 100,
+        ) -> "svi.SviSurface": ...
+        @overload
+        @staticmethod
+        def from_prices(
+            S: float,
+            carry: Sequence["parity.ParityFit"],
+            T: ArrayLike,
+            K: ArrayLike,
+            price: ArrayLike,
+            is_call: ArrayLike = True,
+            model: "svi.SmileModel" = ...,
+            max_iter: int = 100,
+        ) -> "svi.SviSurface": ...
+        def get_iv(self, strike: float, expiry: float) -> float: ...
+        def get_iv_batch(self, strikes: ArrayLike, expiries: ArrayLike) -> np.ndarray: ...
+        def total_variance(self, k: float, T: float) -> float: ...
+        def forward(self, T: float) -> float: ...
+        def slices(self) -> List["svi.SviFit"]: ...
+        def expiries(self) -> List[float]: ...
+        def __len__(self) -> int: ...
+
+
+class heston:
+    class HestonParams:
+        v0: float
+        kappa: float
+        theta: float
+        xi: float
+        rho: float
+        def __init__(self, v0: float, kappa: float, theta: float, xi: float, rho: float) -> None: ...
+        def to_dict(self) -> Dict[str, float]: ...
+
+    class HestonResult:
+        price: float
+        delta: float
+        gamma: float
+        def to_dict(self) -> Dict[str, float]: ...
+
+    class HestonFit:
+        params: "heston.HestonParams"
+        expiry: float
+        rmse: float
+        iterations: int
+        num_quotes: int
+
+    class HestonExpiry:
+        num_terms: int
+        strikes: np.ndarray
+        underlying_price: float
+        risk_free_rate: float
+        time_to_maturity: float
+        dividend_yield: float
+        def __init__(
+            self,
+            underlying_price: float,
+            risk_free_rate: float,
+            time_to_maturity: float,
+            strikes: ArrayLike,
+            reference: "heston.HestonParams",
+            dividend_yield: float = 0.0,
+            terms: int = 0,
+        ) -> None: ...
+        def price_chain(self, params: "heston.HestonParams", is_call: ArrayLike = True) -> np.ndarray: ...
+        def prices(self, params: "heston.HestonParams", is_call: ArrayLike = True) -> np.ndarray: ...
+        def __len__(self) -> int: ...
+
+    @staticmethod
+    def calibrate(
+        S: float,
+        r: float,
+        T: float,
+        strikes: ArrayLike,
+        iv: ArrayLike,
+        q: float = 0.0,
+        weights: ArrayLike = None,
+        initial: "heston.HestonParams" = None,
+        max_iter: int = 100,
+    ) -> "heston.HestonFit": ...
+
+
+class mc:
+    class PathPayoff:
+        EUROPEAN: "mc.PathPayoff"
+        ASIAN: "mc.PathPayoff"
+        UP_AND_OUT: "mc.PathPayoff"
+        UP_AND_IN: "mc.PathPayoff"
+        DOWN_AND_OUT: "mc.PathPayoff"
+        DOWN_AND_IN: "mc.PathPayoff"
+
+    class Sampler:
+        PSEUDO_RANDOM: "mc.Sampler"
+        SOBOL: "mc.Sampler"
+
+    SOBOL_DIMENSIONS: int
+
+    class MCResult:
+        price: float
+        std_error: float
+        paths: int
+
+    class MonteCarloEngine:
+        underlying_price: float
+        risk_free_rate: float
+        time_to_maturity: float
+        volatility: float
+        dividend_yield: float
+        def __init__(
+            self,
+            underlying_price: float,
+            risk_free_rate: float,
+            time_to_maturity: float,
+            volatility: float,
+            dividend_yield: float = 0.0,
+        ) -> None: ...
+        def price(
+            self,
+            strike: float,
+            payoff: "mc.PathPayoff" = ...,
+            is_call: bool = True,
+            barrier: float = ...,
+            paths: int = 100000,
+            steps: int = 1,
+            seed: int = 42,
+            antithetic: bool = True,
+            control_variate: bool = True,
+            sampler: "mc.Sampler" = ...,
+            replicates: int = 16,
+        ) -> "mc.MCResult": ...
+
+
+class lattice:
+    class LatticeMethod:
+        CRR: "lattice.LatticeMethod"
+        LEISEN_REIMER: "lattice.LatticeMethod"
+        TRINOMIAL: "lattice.LatticeMethod"
+
+    class LatticeResult:
+        price: float
+        delta: float
+        gamma: float
+        theta: float
+        def to_dict(self) -> Dict[str, float]: ...
+        def __repr__(self) -> str: ...
+
+    class LatticeEngine:
+        underlying_price: float
+        risk_free_rate: float
+        time_to_maturity: float
+        volatility: float
+        dividend_yield: float
+        def __init__(
+            self,
+            underlying_price: float,
+            risk_free_rate: float,
+            time_to_maturity: float,
+            volatility: float,
+            dividend_yield: float = 0.0,
+        ) -> None: ...
+        def price(
+            self,
+            strike: float,
+            is_call: bool = True,
+            american: bool = True,
+            method: "lattice.LatticeMethod" = ...,
+            steps: int = 201,
+            richardson: bool = True,
+        ) -> "lattice.LatticeResult": ...
+
+    @staticmethod
+    def price_batch(
+        S: ArrayLike,
+        K: ArrayLike,
+        r: ArrayLike,
+        T: ArrayLike,
+        sigma: ArrayLike,
+        q: ArrayLike = 0.0,
+        is_call: ArrayLike = True,
+        american: bool = True,
+        method: "lattice.LatticeMethod" = ...,
+        steps: int = 201,
+        richardson: bool = True,
+    ) -> np.ndarray: ...
+
+
+class pde:
+    class BarrierType:
+        NONE: "pde.BarrierType"
+        UP_AND_OUT: "pde.BarrierType"
+        DOWN_AND_OUT: "pde.BarrierType"
+        UP_AND_IN: "pde.BarrierType"
+        DOWN_AND_IN: "pde.BarrierType"
+
+    class PDEResult:
+        price: float
+        delta: float
+        gamma: float
+        vega: float
+        theta: float
+        rho: float
+        vanna: float
+        volga: float
+        charm: float
+        def to_dict(self) -> Dict[str, float]: ...
+        def __repr__(self) -> str: ...
+
+    class CrankNicolsonEngine:
+        underlying_price: float
+        risk_free_rate: float
+        time_to_maturity: float
+        volatility: float
+        dividend_yield: float
+        def __init__(
+            self,
+            underlying_price: float,
+            risk_free_rate: float,
+            time_to_maturity: float,
+            volatility: float,
+            dividend_yield: float = 0.0,
+        ) -> None: ...
+        def price(
+            self,
+            strike: float,
+            is_call: bool = True,
+            american: bool = True,
+            barrier: "pde.BarrierType" = ...,
+            barrier_level: float = ...,
+            space_steps: int = 400,
+            time_steps: int = 200,
+            sensitivities: bool = True,
+        ) -> "pde.PDEResult": ...
+        def price_chain(
+            self,
+            strikes: ArrayLike,
+            is_call: ArrayLike = True,
+            american: bool = True,
+            barrier: "pde.BarrierType" = ...,
+            barrier_level: float = ...,
+            space_steps: int = 400,
+            time_steps: int = 200,
+            sensitivities: bool = True,
+        ) -> np.ndarray: ...
+
+
+class portfolio:
+    class BookGreeks:
+        value: float
+        delta: float
+        gamma: float
+        vega: float
+        theta: float
+        rho: float
+        vanna: float
+        volga: float
+        charm: float
+        def to_dict(self) -> Dict[str, float]: ...
+        def __repr__(self) -> str: ...
+
+    class PortfolioRisk:
+        total: "portfolio.BookGreeks"
+        # Structured array indexed by underlying id (BookGreeks fields)
+        by_underlying: np.ndarray
+        # Structured array: underlying, time_to_maturity, num_legs and the BookGreeks fields
+        by_expiry: np.ndarray
+        def __repr__(self) -> str: ...
+
+    class ScenarioMode:
+        FULL: 'portfolio.ScenarioMode'
+        TAYLOR: 'portfolio.ScenarioMode'
+
+    class ScenarioCube:
+        mode: "portfolio.ScenarioMode"
+        spot_shifts: np.ndarray
+        vol_shifts: np.ndarray
+        # Unshocked value per underlying
+        base_values: np.ndarray
+        # Shape (underlyings, len(spot_shifts), len(vol_shifts))
+        pnl: np.ndarray
+        # Shape (len(spot_shifts), len(vol_shifts)), summed over underlyings
+        total: np.ndarray
+        def __repr__(self) -> str: ...
+
+    class VaRResult:
+        confidence: float
+        num_scenarios: int
+        tail_size: int
+        var_scenario: int
+        # Losses are positive
+        value_at_risk: float
+        expected_shortfall: float
+        # Normal fit to the scenario P&L
+        parametric_var: float
+        parametric_es: float
+        mean_pnl: float
+        pnl_stddev: float
+        var_contributions: np.ndarray
+        es_contributions: np.ndarray
+        pnl: np.ndarray
+        # Shape (scenarios, underlyings)
+        pnl_by_underlying: np.ndarray
+        def __repr__(self) -> str: ...
+
+    class Portfolio:
+        def __init__(self, risk_free_rate: float = 0.0) -> None: ...
+        def add_underlying(self, underlying_price: float, dividend_yield: float = 0.0) -> int: ...
+        def add_leg(
+            self,
+            underlying: int,
+            strike: float,
+            time_to_maturity: float,
+            volatility: float,
+            quantity: float,
+            is_call: bool = True,
+        ) -> None: ...
+        def add_legs(
+            self,
+            underlying: ArrayLike,
+            strike: ArrayLike,
+            time_to_maturity: ArrayLike,
+            volatility: ArrayLike,
+            quantity: ArrayLike,
+            is_call: ArrayLike = True,
+        ) -> None: ...
+        def set_underlying_price(self, underlying: int, underlying_price: float) -> None: ...
+        def set_risk_free_rate(self, risk_free_rate: float) -> None: ...
+        def valuate(self) -> "portfolio.PortfolioRisk": ...
+        def scenarios(
+            self,
+            spot_shifts: ArrayLike,
+            vol_shifts: ArrayLike,
+            mode: "portfolio.ScenarioMode" = ...,
+        ) -> "portfolio.ScenarioCube":
+            """P&L cube over relative spot shifts x absolute volatility shifts."""
+            ...
+        def scenario_pnl(
+            self,
+            spot_shocks: ArrayLike,
+            vol_shocks: Optional[ArrayLike] = None,
+            horizon: float = 0.0,
+            mode: "portfolio.ScenarioMode" = ...,
+        ) -> np.ndarray:
+            """P&L per historical scenario and underlying, shape (scenarios, underlyings)."""
+            ...
+        def value_at_risk(
+            self,
+            spot_shocks: ArrayLike,
+            vol_shocks: Optional[ArrayLike] = None,
+            confidence: float = 0.99,
+            horizon: float = 0.0,
+            mode: "portfolio.ScenarioMode" = ...,
+        ) -> "portfolio.VaRResult": ...
+        @staticmethod
+        def from_strategy(strategy: "strategies.OptionsStrategy") -> "portfolio.Portfolio": ...
+        def __len__(self) -> int: ...
+        def num_underlyings(self) -> int: ...
+        def num_expiries(self) -> int: ...
+        def get_risk_free_rate(self) -> float: ...
+        def get_underlying_price(self, underlying: int) -> float: ...
+        def get_dividend_yield(self, underlying: int) -> float: ...
+        def __repr__(self) -> str: ...
+
+class stream:
+    COLUMN_NAMES: Tuple[str, ...]
+
+    class TickPipeline:
+        capacity: int
+        risk_free_rate: float
+        # Contracts with an update not yet processed
+        pending: int
+        updates_received: int
+        # Updates that replaced a still-pending quote instead of adding work
+        updates_coalesced: int
+        num_batches: int
+        num_solves: int
+        # Processed updates whose mid and spot had not moved
+        num_unchanged: int
+        def __init__(self, risk_free_rate: float, capacity: int, tol: float = 1e-6, max_iter: int = 100) -> None: ...
+        def add_contract(
+            self, strike: float, time_to_maturity: float, is_call: bool = True, dividend_yield: float = 0.0
+        ) -> int: ...
+        def add_contracts(
+            self,
+            strike: ArrayLike,
+            time_to_maturity: ArrayLike,
+            is_call: ArrayLike = True,
+            dividend_yield: ArrayLike = 0.0,
+        ) -> np.ndarray: ...
+        def push(self, instrument: int, bid: float, ask: float, spot: float) -> None: ...
+        def push_many(self, instrument: ArrayLike, bid: ArrayLike, ask: ArrayLike, spot: ArrayLike) -> None: ...
+        def process(self, interval: float = 0.0, callback: Optional[Callable[[np.ndarray], object]] = None) -> np.ndarray:
+            """Drain pending updates and re-solve every contract whose mid or spot moved; returns their ids."""
+            ...
+        def updated(self) -> np.ndarray: ...
+        def column(self, name: str) -> np.ndarray: ...
+        def columns(self) -> Dict[str, np.ndarray]: ...
+        def values(self) -> np.ndarray: ...
+        def status(self) -> np.ndarray: ...
+        def __len__(self) -> int: ...
+        def __repr__(self) -> str: ...
+
+class snapshot:
+    COLUMN_NAMES: Tuple[str, ...]
+    FORMAT_VERSION: int
+
+    class ChainSnapshot:
+        timestamp: float
+        underlying_price: float
+        risk_free_rate: float
+        dividend_yield: float
+        def __len__(self) -> int: ...
+        def num_quotes(self) -> int: ...
+        def expiries(self) -> np.ndarray: ...
+        def column(self, expiry: int, name: str) -> np.ndarray:
+            """Read-only view of one column of one expiry, straight from the mapped file."""
+            ...
+        def columns(self, expiry: int) -> Dict[str, np.ndarray]: ...
+        def to_chain_data(self) -> List[Dict[str, object]]: ...
+        def surface(self) -> "surface.VolatilitySurface": ...
+        def fit_parity(self, fit_rate: bool = False, outlier_threshold: float = 4.0) -> List["parity.ParityFit"]: ...
+        def __repr__(self) -> str: ...
+
+    class SnapshotReader:
+        path: str
+        file_size: int
+        def __init__(self, path: str) -> None: ...
+        def __len__(self) -> int: ...
+        def __getitem__(self, index: int) -> "snapshot.ChainSnapshot": ...
+        def find(self, timestamp: float) -> int: ...
+        def timestamps(self) -> np.ndarray: ...
+        def surface_series(
+            self, strikes: ArrayLike, expiries: ArrayLike, start: int = 0, stop: Optional[int] = None
+        ) -> np.ndarray:
+            """Interpolated IV at fixed (strike, expiry) points in every snapshot of [start, stop)."""
+            ...
+        def __repr__(self) -> str: ...
+
+    class SnapshotWriter:
+        def __init__(self, path: str) -> None: ...
+        def append(
+            self,
+            timestamp: float,
+            underlying_price: float,
+            chain_data: List[Dict[str, ArrayLike]],
+            risk_free_rate: float = 0.0,
+            dividend_yield: float = 0.0,
+        ) -> None: ...
+        def close(self) -> None: ...
+        def __len__(self) -> int: ...
+        def __enter__(self) -> "snapshot.SnapshotWriter": ...
+        def __exit__(self, *args: object) -> None: ...
 
 class strategies:
     class OptionType:
@@ -81,6 +893,7 @@ class strategies:
         position_type: 'strategies.PositionType'
         quantity: float
         strike: float
+        volatility_override: float
         def __init__(
             self,
             option_type: 'strategies.OptionType',
@@ -90,6 +903,19 @@ class strategies:
         ) -> None: ...
         def __repr__(self) -> str: ...
 
+    class StrategyGreeks:
+        value: float
+        delta: float
+        gamma: float
+        vega: float
+        theta: float
+        rho: float
+        vanna: float
+        volga: float
+        charm: float
+        def to_dict(self) -> Dict[str, float]: ...
+        def __repr__(self) -> str: ...
+
     class OptionsStrategy:
         def __init__(
             self,
@@ -107,6 +933,21 @@ class strategies:
             quantity: float,
             strike: float,
         ) -> None: ...
+        def update_market(
+            self,
+            underlying_price: float,
+            volatility: float,
+            risk_free_rate: float,
+            time_to_maturity: float,
+            dividend_yield: float,
+        ) -> None: ...
+        def set_leg_volatility(self, index: int, volatility: float) -> None: ...
+        def clear_leg_volatility(self, index: int) -> None: ...
+        def set_pde_pricing(self, american: bool = True, space_steps: int = 400, time_steps: int = 200) -> None: ...
+        def set_closed_form_pricing(self) -> None: ...
+        def uses_pde_pricing(self) -> bool: ...
+        def total_greeks(self) -> 'strategies.StrategyGreeks': ...
+        def leg_greeks(self) -> List['models.AllGreeks']: ...
         def total_value(self) -> float: ...
         def total_delta(self) -> float: ...
         def total_gamma(self) -> float: ...
@@ -117,6 +958,14 @@ class strategies:
         def total_volga(self) -> float: ...
         def total_charm(self) -> float: ...
         def payoff_at_expiration(self, underlying_price: float) -> float: ...
+        def payoff_grid(self, underlying_prices: ArrayLike) -> np.ndarray: ...
+        def value_grid(self, spots: ArrayLike, vols: ArrayLike, times: ArrayLike) -> np.ndarray: ...
+        def scenarios(
+            self,
+            spot_shifts: ArrayLike,
+            vol_shifts: ArrayLike,
+            mode: "portfolio.ScenarioMode" = ...,
+        ) -> "portfolio.ScenarioCube": ...
         def get_positions(self) -> List['strategies.Position']: ...
         def get_name(self) -> str: ...
         def get_dividend_yield(self) -> float: ...
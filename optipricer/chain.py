@@ -5,7 +5,8 @@ Generates a complete options chain (prices, Greeks, IVs) for a set of strikes,
 similar to what a broker terminal displays.
 """
 
-from .models import BlackScholesModel, GreeksCalculator
+from ._core.chain import COLUMN_NAMES
+from ._core.chain import OptionChain as _NativeOptionChain
 
 
 class OptionChain:
@@ -16,6 +17,11 @@ class OptionChain:
     Each row contains call/put prices, all first and second-order Greeks,
     and can optionally solve implied volatilities from market data.
 
+    The chain is computed natively and stored by column; columns() and
+    to_dataframe() expose those columns without copying. Those views follow
+    update() and build() in place for as long as the native chain is reused,
+    i.e. until build() sees r, T, q, the strikes or the volatilities change.
+
     Parameters:
         S (float): Current underlying price
         r (float): Risk-free rate (annualized)
@@ -24,11 +30,14 @@ class OptionChain:
         strikes (list[float]): List of strike prices to include
         vol (float, optional): Flat volatility to use for all strikes (if not using per-strike IVs)
         iv_map (dict, optional): Mapping of strike -> implied volatility (overrides flat vol)
+        surface (optional): Fitted volatility surface, e.g. an SviSurface or
+            VolatilitySurface; any object with get_iv_batch(strikes, expiry).
+            Replaces iv_map and vol when given.
     """
 
     def __init__(self, S: float, r: float, T: float, strikes: list,
-                 vol: float = 0.20, q: float = 0.0, iv_map: dict = None):
-        if not strikes:
+                 vol: float = 0.20, q: float = 0.0, iv_map: dict = None, surface=None):
+        if len(strikes) == 0:
             raise ValueError("strikes list must not be empty.")
         
         self.S = S
@@ -38,51 +47,97 @@ class OptionChain:
         self.strikes = sorted(strikes)
         self.vol = vol
         self.iv_map = iv_map or {}
-        self._chain = None  # Lazily computed
+        self.surface = surface
+        self._native = None  # Lazily computed
+        self._native_inputs = None  # (S, everything else) the native chain was priced with
+        self._chain = None   # Row view, only built on request
+
+    @classmethod
+    def from_parity(cls, S: float, fit, strikes: list, vol: float = 0.20,
+                    iv_map: dict = None, surface=None) -> 'OptionChain':
+        """
+        Build the chain of one expiry priced with its put-call parity carry.
+
+        Parameters:
+            S (float): Current underlying price
+            fit (parity.ParityFit): Fit of this expiry from parity.calibrate;
+                supplies T, r and q
+            strikes, vol, iv_map, surface: As for OptionChain()
+
+        Returns:
+            OptionChain: Chain whose forward matches the fitted one
+        """
+        return cls(S, fit.rate, fit.expiry, strikes, vol, fit.dividend_yield, iv_map, surface)
 
     def _get_vol(self, strike: float) -> float:
         """Get volatility for a specific strike (from iv_map or flat vol)."""
         return self.iv_map.get(strike, self.vol)
 
-    def _build_row(self, strike: float) -> dict:
-        """Build a single chain row for one strike."""
-        sigma = self._get_vol(strike)
-        model = BlackScholesModel(
-            strike_price=strike, volatility=sigma, risk_free_rate=self.r,
-            time_to_maturity=self.T, underlying_price=self.S, dividend_yield=self.q
-        )
-        calc = GreeksCalculator(model)
+    def _inputs(self) -> tuple:
+        """Everything the native chain is priced from apart from S."""
+        if self.surface is not None:
+            vols = [float(v) for v in self.surface.get_iv_batch(self.strikes, self.T)]
+        else:
+            vols = [self._get_vol(k) for k in self.strikes]
+        return (self.r, self.T, self.q, tuple(self.strikes), tuple(vols))
+
+    def _engine(self, inputs: tuple = None) -> _NativeOptionChain:
+        """Native chain, computed on first use."""
+        if self._native is None:
+            inputs = inputs or self._inputs()
+            r, T, q, strikes, vols = inputs
+            self._native = _NativeOptionChain(self.S, r, T, list(strikes), list(vols), q)
+            self._native_inputs = (self.S, inputs)
+        return self._native
+
+    def columns(self) -> dict:
+        """
+        Return the chain as read-only NumPy arrays keyed by column name.
 
-        return {
-            'strike': strike,
-            'iv': sigma,
-            'call_price': model.call_price(),
-            'put_price': model.put_price(),
-            # First-order Greeks
-            'call_delta': calc.call_delta(),
-            'put_delta': calc.put_delta(),
-            'gamma': calc.gamma(),
-            'vega': calc.vega(),
-            'call_theta': calc.call_theta(),
-            'put_theta': calc.put_theta(),
-            'call_rho': calc.call_rho(),
-            'put_rho': calc.put_rho(),
-            # Second-order Greeks
-            'vanna': calc.vanna(),
-            'volga': calc.volga(),
-            'call_charm': calc.call_charm(),
-            'put_charm': calc.put_charm(),
-        }
+        The arrays are views into the native chain; nothing is copied. They
+        keep tracking update() and build() unless build() has to rebuild the
+        chain (see build()), after which they hold the previous values.
+
+        Returns:
+            dict[str, numpy.ndarray]: One array per entry of COLUMN_NAMES.
+        """
+        return self._engine().columns()
+
+    def update(self, S: float) -> None:
+        """
+        Reprice the chain at a new underlying price.
+
+        Arrays previously returned by columns() are updated in place.
+        """
+        engine = self._engine()
+        engine.reprice(S)
+        self.S = S
+        self._native_inputs = (S, self._native_inputs[1])
+        self._chain = None
 
     def build(self) -> list:
         """
         Build the full option chain.
 
+        Picks up any change to the chain's attributes. If only S moved, the
+        existing native chain is repriced in place, so arrays from columns()
+        and to_dataframe() stay live; if r, T, q, the strikes or the
+        volatilities (iv_map, vol or the surface) changed, the chain is rebuilt
+        and previously returned arrays are detached from it.
+
         Returns:
             list[dict]: A list of dictionaries, one per strike, each containing
                         prices and Greeks for both call and put.
         """
-        self._chain = [self._build_row(k) for k in self.strikes]
+        inputs = self._inputs()
+        if self._native is not None and self._native_inputs[1] == inputs:
+            if self._native_inputs[0] != self.S:
+                self._native.reprice(self.S)
+                self._native_inputs = (self.S, inputs)
+        else:
+            self._native = None
+        cols = self._engine(inputs).values().tolist()
+        self._chain = [dict(zip(COLUMN_NAMES, row)) for row in zip(*cols)]
         return self._chain
 
     def to_dict(self) -> list:
@@ -100,6 +155,8 @@ class OptionChain:
         """
         Return the chain as a pandas DataFrame.
 
+        The frame wraps the native column block; no per-row objects are built.
+
         Returns:
             pandas.DataFrame: Option chain with strikes as rows and metrics as columns.
 
@@ -114,9 +171,9 @@ class OptionChain:
                 "Install it with: pip install pandas"
             )
 
-        if self._chain is None:
-            self.build()
-        return pd.DataFrame(self._chain).set_index('strike')
+        values = self._engine().values()
+        return pd.DataFrame(values[1:].T, index=pd.Index(values[0], name='strike'),
+                            columns=list(COLUMN_NAMES[1:]), copy=False)
 
     def atm_strike(self) -> float:
         """
@@ -134,20 +191,18 @@ class OptionChain:
         Returns:
             dict: Summary statistics of the chain.
         """
-        if self._chain is None:
-            self.build()
-
-        atm = self.atm_strike()
-        atm_row = next(r for r in self._chain if r['strike'] == atm)
+        engine = self._engine()
+        cols = engine.columns()
+        i = engine.atm_index()
 
         return {
             'underlying': self.S,
-            'atm_strike': atm,
-            'atm_call_price': atm_row['call_price'],
-            'atm_put_price': atm_row['put_price'],
-            'atm_iv': atm_row['iv'],
-            'atm_call_delta': atm_row['call_delta'],
-            'atm_gamma': atm_row['gamma'],
+            'atm_strike': float(cols['strike'][i]),
+            'atm_call_price': float(cols['call_price'][i]),
+            'atm_put_price': float(cols['put_price'][i]),
+            'atm_iv': float(cols['iv'][i]),
+            'atm_call_delta': float(cols['call_delta'][i]),
+            'atm_gamma': float(cols['gamma'][i]),
             'num_strikes': len(self.strikes),
             'min_strike': self.strikes[0],
             'max_strike': self.strikes[-1],
@@ -178,4 +233,4 @@ def generate_nifty_strikes(spot: float, step: float = 50.0, count: int = 21) ->
     return [atm + (i - half) * step for i in range(count)]
 
 
-__all__ = ['OptionChain', 'generate_nifty_strikes']
+__all__ = ['COLUMN_NAMES', 'OptionChain', 'generate_nifty_strikes']
@@ -0,0 +1,39 @@
+"""
+Heston stochastic volatility: COS-method pricing and per-expiry calibration.
+
+HestonExpiry fixes the truncation range and the strike basis once, so every
+strike of an expiry is priced from one pass over the characteristic
+function; calibrate() reuses one HestonExpiry through all of its iterations.
+"""
+
+import numpy as np
+
+from ._core.heston import HestonExpiry, HestonFit, HestonParams, HestonResult, calibrate
+
+
+def price(S, K, r, T, params: HestonParams, q=0.0, option: str = 'call'):
+    """
+    Heston price, delta and gamma of one option or of every strike in K.
+
+    Parameters:
+        S, r, T, q: As in optipricer.price()
+        K (float | array): Strike(s) of one expiry
+        params (HestonParams): Model parameters; also set the COS range
+        option (str): 'call' or 'put'
+
+    Returns:
+        numpy.record | numpy.ndarray: price, delta and gamma (attribute
+        access); a structured array with those fields for array K
+    """
+    opt = option.lower().strip()
+    if opt not in ('call', 'put'):
+        raise ValueError(f"Invalid option type: '{option}'. Must be 'call' or 'put'.")
+
+    strikes = np.atleast_1d(np.asarray(K, dtype=float))
+    chain = HestonExpiry(S, r, T, strikes.ravel(), params, q).price_chain(params, opt == 'call')
+    if np.ndim(K) == 0:
+        return chain.view(np.recarray)[0]
+    return chain.reshape(strikes.shape)
+
+
+__all__ = ['HestonExpiry', 'HestonFit', 'HestonParams', 'HestonResult', 'calibrate', 'price']
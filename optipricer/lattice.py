@@ -0,0 +1,54 @@
+"""
+Lattice (binomial / trinomial tree) pricing for American and European options.
+
+Backward induction runs natively over a single rolling buffer, and delta,
+gamma and theta are read off the tree nodes at t = 0 rather than by bumping.
+"""
+
+import numpy as np
+
+from ._core.lattice import LatticeEngine, LatticeMethod, LatticeResult, price_batch
+
+_METHODS = {
+    'crr': LatticeMethod.CRR,
+    'leisen_reimer': LatticeMethod.LEISEN_REIMER,
+    'lr': LatticeMethod.LEISEN_REIMER,
+    'trinomial': LatticeMethod.TRINOMIAL,
+}
+
+
+def price(S, K, r, T, vol, q=0.0, option: str = 'call', american: bool = True, method: str = 'leisen_reimer',
+          steps: int = 201, richardson: bool = True):
+    """
+    Lattice price and Greeks of an American (or European) option.
+
+    Any of the numeric inputs may be a NumPy array, e.g. every strike of a
+    chain; the batch is then priced across the native thread pool.
+
+    Parameters:
+        S, K, r, T, vol, q: As in optipricer.price()
+        option (str): 'call' or 'put'
+        american (bool): Allow early exercise (default True)
+        method (str): 'crr', 'leisen_reimer' (or 'lr') or 'trinomial'
+        steps (int): Time steps; Leisen-Reimer rounds up to an odd count
+        richardson (bool): Extrapolate from steps and ~steps / 2
+
+    Returns:
+        LatticeResult | numpy.ndarray: price, delta, gamma and theta (per
+        day); a structured array with those fields for array inputs
+    """
+    opt = option.lower().strip()
+    if opt not in ('call', 'put'):
+        raise ValueError(f"Invalid option type: '{option}'. Must be 'call' or 'put'.")
+    key = method.lower()
+    if key not in _METHODS:
+        raise ValueError(f"method must be one of {sorted(_METHODS)}, got {method!r}")
+
+    if any(np.ndim(x) > 0 for x in (S, K, r, T, vol, q)):
+        return price_batch(S, K, r, T, vol, q, opt == 'call', american, _METHODS[key], steps, richardson)
+
+    engine = LatticeEngine(S, r, T, vol, q)
+    return engine.price(K, opt == 'call', american, _METHODS[key], steps, richardson)
+
+
+__all__ = ['LatticeEngine', 'LatticeMethod', 'LatticeResult', 'price', 'price_batch']
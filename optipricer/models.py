@@ -1,4 +1,17 @@
 from ._core import norm_cdf, norm_pdf
-from ._core.models import BlackScholesModel, GreeksCalculator, calculate_implied_volatility
+from ._core.models import (
+    AllGreeks,
+    BlackScholesModel,
+    ExpiryContext,
+    GreeksCalculator,
+    IVStatus,
+    calculate_implied_volatility,
+    greeks_batch,
+    implied_volatility_batch,
+    price_batch,
+    price_delta_batch,
+    Workspace,
+)
 
-__all__ = ['BlackScholesModel', 'GreeksCalculator', 'calculate_implied_volatility', 'norm_cdf', 'norm_pdf']
+__all__ = ['AllGreeks', 'BlackScholesModel', 'ExpiryContext', 'GreeksCalculator', 'IVStatus',
+           'calculate_implied_volatility', 'greeks_batch', 'implied_volatility_batch', 'price_batch', 'price_delta_batch', 'Workspace', 'norm_cdf', 'norm_pdf']
@@ -0,0 +1,67 @@
+"""
+Monte Carlo pricing for path-dependent options (Asian, barrier) under
+Black-Scholes dynamics.
+
+Paths are generated natively with a counter-based (Philox) generator, so an
+estimate depends only on its seed, never on the thread count. The 'sobol'
+sampler swaps the draws for a scrambled Sobol sequence with a Brownian
+bridge, which usually reaches a given accuracy with far fewer paths.
+"""
+
+from ._core.mc import SOBOL_DIMENSIONS, MCResult, MonteCarloEngine, PathPayoff, Sampler
+
+_PAYOFFS = {
+    'european': PathPayoff.EUROPEAN,
+    'asian': PathPayoff.ASIAN,
+    'up_and_out': PathPayoff.UP_AND_OUT,
+    'up_and_in': PathPayoff.UP_AND_IN,
+    'down_and_out': PathPayoff.DOWN_AND_OUT,
+    'down_and_in': PathPayoff.DOWN_AND_IN,
+}
+
+_SAMPLERS = {
+    'pseudo': Sampler.PSEUDO_RANDOM,
+    'sobol': Sampler.SOBOL,
+}
+
+
+def price(S, K, r, T, vol, q=0.0, option: str = 'call', payoff: str = 'european', barrier: float = None,
+          paths: int = 100000, steps: int = 1, seed: int = 42, antithetic: bool = True,
+          control_variate: bool = True, sampler: str = 'pseudo', replicates: int = 16) -> MCResult:
+    """
+    Monte Carlo price of a European, Asian or barrier option.
+
+    Parameters:
+        S, K, r, T, vol, q: As in optipricer.price()
+        option (str): 'call' or 'put'
+        payoff (str): 'european', 'asian', 'up_and_out', 'up_and_in',
+            'down_and_out' or 'down_and_in'
+        barrier (float): Barrier level, required for barrier payoffs
+        paths (int): Number of simulated paths
+        steps (int): Monitoring dates per path (average / barrier checks)
+        seed (int): Generator seed
+        antithetic (bool): Pair every path with its mirror image
+        control_variate (bool): Use the closed-form European price as a control
+        sampler (str): 'pseudo' (Philox) or 'sobol' (randomized quasi-Monte Carlo)
+        replicates (int): Independent scrambles for 'sobol'; the paths are split
+            between them and std_error is their spread. Keep paths / replicates
+            a power of two.
+
+    Returns:
+        MCResult: price, std_error and the number of paths simulated
+    """
+    opt = option.lower().strip()
+    if opt not in ('call', 'put'):
+        raise ValueError(f"Invalid option type: '{option}'. Must be 'call' or 'put'.")
+    key = payoff.lower()
+    if key not in _PAYOFFS:
+        raise ValueError(f"payoff must be one of {sorted(_PAYOFFS)}, got {payoff!r}")
+    method = sampler.lower()
+    if method not in _SAMPLERS:
+        raise ValueError(f"sampler must be one of {sorted(_SAMPLERS)}, got {sampler!r}")
+    engine = MonteCarloEngine(S, r, T, vol, q)
+    return engine.price(K, _PAYOFFS[key], opt == 'call', float('nan') if barrier is None else barrier,
+                        paths, steps, seed, antithetic, control_variate, _SAMPLERS[method], replicates)
+
+
+__all__ = ['SOBOL_DIMENSIONS', 'MCResult', 'MonteCarloEngine', 'PathPayoff', 'Sampler', 'price']
@@ -0,0 +1,13 @@
+"""
+Implied forward and dividend yield per expiry from put-call parity.
+
+calibrate() regresses call - put prices on strike for every expiry at once,
+natively and in parallel, rejecting stale quotes, and returns one ParityFit
+per expiry. carry() turns those fits into per-quote rate and dividend yield
+arrays for the batch functions; SviSurface.from_prices and
+OptionChain.from_parity take the fits directly.
+"""
+
+from ._core.parity import DEFAULT_OUTLIER_THRESHOLD, ParityFit, calibrate, carry
+
+__all__ = ['DEFAULT_OUTLIER_THRESHOLD', 'ParityFit', 'calibrate', 'carry']
@@ -0,0 +1,62 @@
+"""
+Crank-Nicolson finite-difference pricing for American and barrier options.
+
+A whole chain shares one log-spot grid: every strike is another right-hand
+side of the same tridiagonal solve, so pricing a chain costs about as much
+as pricing one option.
+"""
+
+import math
+
+import numpy as np
+
+from ._core.pde import BarrierType, CrankNicolsonEngine, PDEResult
+
+_BARRIERS = {
+    'none': BarrierType.NONE,
+    'up_and_out': BarrierType.UP_AND_OUT,
+    'down_and_out': BarrierType.DOWN_AND_OUT,
+    'up_and_in': BarrierType.UP_AND_IN,
+    'down_and_in': BarrierType.DOWN_AND_IN,
+}
+
+
+def price(S, K, r, T, vol, q=0.0, option: str = 'call', american: bool = True, barrier: str = 'none',
+          barrier_level: float = math.nan, space_steps: int = 400, time_steps: int = 200,
+          sensitivities: bool = True):
+    """
+    PDE price and Greeks of an American (or European) option, optionally with a barrier.
+
+    K may be a NumPy array, e.g. every strike of a chain; all of them are
+    priced from one backward solve.
+
+    Parameters:
+        S, K, r, T, vol, q: As in optipricer.price()
+        option (str): 'call' or 'put'
+        american (bool): Allow early exercise (default True)
+        barrier (str): 'none', 'up_and_out', 'down_and_out', 'up_and_in' or
+            'down_and_in'; knock-ins must be European
+        barrier_level (float): Barrier level, continuously monitored
+        space_steps (int): Grid intervals in log-spot
+        time_steps (int): Time steps (the first two are Rannacher-smoothed)
+        sensitivities (bool): Also compute vega, rho, vanna and volga
+
+    Returns:
+        PDEResult | numpy.ndarray: price and Greeks in the units of
+        models.AllGreeks; a structured array with those fields for array K
+    """
+    opt = option.lower().strip()
+    if opt not in ('call', 'put'):
+        raise ValueError(f"Invalid option type: '{option}'. Must be 'call' or 'put'.")
+    key = barrier.lower()
+    if key not in _BARRIERS:
+        raise ValueError(f"barrier must be one of {sorted(_BARRIERS)}, got {barrier!r}")
+
+    engine = CrankNicolsonEngine(S, r, T, vol, q)
+    args = (opt == 'call', american, _BARRIERS[key], barrier_level, space_steps, time_steps, sensitivities)
+    if np.ndim(K) > 0:
+        return engine.price_chain(K, *args)
+    return engine.price(K, *args)
+
+
+__all__ = ['BarrierType', 'CrankNicolsonEngine', 'PDEResult', 'price']
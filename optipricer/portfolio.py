@@ -0,0 +1,14 @@
+"""
+Large option books stored by column.
+
+A Portfolio keeps every leg (strike, expiry, volatility, signed quantity,
+call flag, underlying id) in contiguous columns grouped by underlying and
+expiry, so valuing the whole book is one vectorized pass with per-underlying
+and per-expiry rollups. Portfolio.scenarios() revalues the book over a
+spot x volatility ladder, fully or by a second-order Taylor expansion, and
+Portfolio.value_at_risk() turns historical shocks into VaR / ES.
+"""
+
+from ._core.portfolio import BookGreeks, Portfolio, PortfolioRisk, ScenarioCube, ScenarioMode, VaRResult
+
+__all__ = ['BookGreeks', 'Portfolio', 'PortfolioRisk', 'ScenarioCube', 'ScenarioMode', 'VaRResult']
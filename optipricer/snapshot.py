@@ -0,0 +1,19 @@
+"""
+Memory-mapped columnar option chain snapshots.
+
+A SnapshotWriter appends timestamped chain snapshots (spot, rates and, per
+expiry, sorted strike / IV / call / put columns) to a single file. A
+SnapshotReader maps that file and hands out ChainSnapshot views whose
+columns are read-only numpy arrays over the mapping, so replaying a day of
+snapshots through the surface engine costs page faults rather than parsing.
+"""
+
+from ._core.snapshot import (
+    COLUMN_NAMES,
+    FORMAT_VERSION,
+    ChainSnapshot,
+    SnapshotReader,
+    SnapshotWriter,
+)
+
+__all__ = ['COLUMN_NAMES', 'FORMAT_VERSION', 'ChainSnapshot', 'SnapshotReader', 'SnapshotWriter']
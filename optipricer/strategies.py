@@ -3,6 +3,7 @@ from ._core.strategies import (
     PositionType,
     Position,
     OptionsStrategy,
+    StrategyGreeks,
     LongCall,
     ShortCall,
     LongPut,
@@ -70,6 +71,7 @@ __all__ = [
     'PositionType',
     'Position',
     'OptionsStrategy',
+    'StrategyGreeks',
     'LongCall',
     'ShortCall',
     'LongPut',
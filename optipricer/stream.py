@@ -0,0 +1,13 @@
+"""
+Streaming quotes to implied volatilities and Greeks.
+
+A TickPipeline holds a fixed set of contracts. A feed pushes (instrument,
+bid, ask, spot) updates as they arrive; each process() call drains them in
+one batch and re-solves only the contracts whose mid or spot moved. Updates
+that arrive faster than they are processed coalesce to the latest quote per
+contract, so the backlog is bounded by the number of contracts.
+"""
+
+from ._core.stream import COLUMN_NAMES, TickPipeline
+
+__all__ = ['COLUMN_NAMES', 'TickPipeline']
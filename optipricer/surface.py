@@ -5,7 +5,10 @@ Models implied volatility across strikes and expiries, enabling
 interpolation and 3D visualization of the vol surface/smile.
 """
 
-import math
+import numpy as np
+
+from ._core.surface import VolatilitySurface as _NativeSurface
+from ._core.svi import SmileModel, SviFit, SviParams, SviSurface, fit_slice
 
 
 class VolatilitySurface:
@@ -15,18 +18,21 @@ class VolatilitySurface:
 
     The surface can be constructed from raw IV data (e.g., from NSE option
     chain snapshots) and provides bilinear interpolation for arbitrary
-    (strike, expiry) queries.
+    (strike, expiry) queries. The grid lives in the native core; missing
+    quotes (NaN) are filled from neighbouring strikes, then neighbouring
+    expiries, before interpolating. Quotes can be replaced in place with
+    update(), update_many() and update_slice().
 
     Parameters:
-        strikes (list[float]): Sorted list of strike prices
-        expiries (list[float]): Sorted list of expiry times (in years)
+        strikes (list[float]): Strike prices (any order)
+        expiries (list[float]): Expiry times in years (any order)
         iv_matrix (list[list[float]]): 2D matrix of IVs, where
             iv_matrix[i][j] is the IV for expiries[i] and strikes[j].
-            Shape: (len(expiries), len(strikes))
+            Shape: (len(expiries), len(strikes)). NaN marks a missing quote.
     """
 
     def __init__(self, strikes: list, expiries: list, iv_matrix: list):
-        if not strikes or not expiries:
+        if len(strikes) == 0 or len(expiries) == 0:
             raise ValueError("strikes and expiries must be non-empty.")
         if len(iv_matrix) != len(expiries):
             raise ValueError(
@@ -38,16 +44,32 @@ class VolatilitySurface:
                     f"iv_matrix row {i} has {len(row)} columns but expected {len(strikes)} (one per strike)."
                 )
 
-        self.strikes = sorted(strikes)
-        self.expiries = sorted(expiries)
-        # Re-sort matrix rows to match sorted expiries
-        self.iv_matrix = iv_matrix
+        # The native surface sorts both axes and permutes the matrix to match
+        self._native = _NativeSurface(list(strikes), list(expiries), np.asarray(iv_matrix, dtype=float))
+
+    @property
+    def strikes(self) -> list:
+        """Sorted strike axis."""
+        return self._native.strikes().tolist()
+
+    @property
+    def expiries(self) -> list:
+        """Sorted expiry axis."""
+        return self._native.expiries().tolist()
+
+    @property
+    def iv_matrix(self) -> list:
+        """IV grid as quoted (NaN = missing), rows matching the sorted expiries."""
+        return self._native.raw_ivs().tolist()
 
     @classmethod
     def from_chain_data(cls, chain_data: list) -> 'VolatilitySurface':
         """
         Construct a VolatilitySurface from a list of chain snapshots.
 
+        Strikes missing from an expiry's snapshot become NaN holes in the
+        grid; they are filled natively when interpolating.
+
         Parameters:
             chain_data (list[dict]): Each dict must have:
                 - 'expiry' (float): Time to maturity in years
@@ -79,6 +101,24 @@ class VolatilitySurface:
 
         return cls(strikes, expiries, iv_matrix)
 
+    @classmethod
+    def from_snapshot(cls, snapshot) -> 'VolatilitySurface':
+        """
+        Construct a VolatilitySurface from a snapshot.ChainSnapshot.
+
+        Equivalent to from_chain_data(snapshot.to_chain_data()), but the
+        grid is merged natively straight from the mapped columns.
+
+        Parameters:
+            snapshot (ChainSnapshot): A snapshot read by snapshot.SnapshotReader
+
+        Returns:
+            VolatilitySurface: Constructed surface object
+        """
+        surface = cls.__new__(cls)
+        surface._native = snapshot.surface()
+        return surface
+
     def get_iv(self, strike: float, expiry: float) -> float:
         """
         Get interpolated implied volatility for a given strike and expiry.
@@ -91,40 +131,100 @@ class VolatilitySurface:
         Returns:
             float: Interpolated implied volatility
         """
-        # Find bounding indices for strike
-        si = self._find_bracket(self.strikes, strike)
-        # Find bounding indices for expiry
-        ei = self._find_bracket(self.expiries, expiry)
-
-        # Bilinear interpolation
-        s0, s1 = self.strikes[si], self.strikes[min(si + 1, len(self.strikes) - 1)]
-        e0, e1 = self.expiries[ei], self.expiries[min(ei + 1, len(self.expiries) - 1)]
-
-        # Get the 4 corner IVs
-        iv00 = self.iv_matrix[ei][si]
-        iv01 = self.iv_matrix[ei][min(si + 1, len(self.strikes) - 1)]
-        iv10 = self.iv_matrix[min(ei + 1, len(self.expiries) - 1)][si]
-        iv11 = self.iv_matrix[min(ei + 1, len(self.expiries) - 1)][min(si + 1, len(self.strikes) - 1)]
-
-        # Handle edge cases (exact match or boundary)
-        if s0 == s1:
-            t_s = 0.0
-        else:
-            t_s = (strike - s0) / (s1 - s0)
-
-        if e0 == e1:
-            t_e = 0.0
-        else:
-            t_e = (expiry - e0) / (e1 - e0)
-
-        # Clamp to [0, 1]
-        t_s = max(0.0, min(1.0, t_s))
-        t_e = max(0.0, min(1.0, t_e))
-
-        # Bilinear
-        iv_top = iv00 * (1 - t_s) + iv01 * t_s
-        iv_bot = iv10 * (1 - t_s) + iv11 * t_s
-        return iv_top * (1 - t_e) + iv_bot * t_e
+        return self._native.get_iv(strike, expiry)
+
+    def get_iv_batch(self, strikes, expiries):
+        """
+        Vectorized get_iv() over arrays of strikes and expiries.
+
+        Parameters:
+            strikes (array-like): Strike prices
+            expiries (array-like): Expiry times in years; scalars broadcast
+
+        Returns:
+            numpy.ndarray: Interpolated implied volatilities
+        """
+        return self._native.get_iv_batch(strikes, expiries)
+
+    def update(self, strike: float, expiry: float, iv: float):
+        """
+        Replace the quote at one (strike, expiry) grid point in place.
+
+        Only the affected expiry row is refilled; queries running on other
+        threads keep seeing the previous version until the update lands.
+
+        Parameters:
+            strike (float): A strike on the grid
+            expiry (float): An expiry on the grid
+            iv (float): New implied volatility (NaN removes the quote)
+        """
+        self._native.set_iv(strike, expiry, iv)
+
+    def update_many(self, strikes, expiries, ivs):
+        """
+        Replace several grid quotes as a single update.
+
+        Parameters:
+            strikes (array-like): Strikes on the grid
+            expiries (array-like): Expiries on the grid; scalars broadcast
+            ivs (array-like): New implied volatilities (NaN removes a quote)
+        """
+        self._native.set_ivs(strikes, expiries, ivs)
+
+    def update_slice(self, expiry: float, ivs, strikes: list = None):
+        """
+        Replace the smile of one expiry in place.
+
+        Parameters:
+            expiry (float): An expiry on the grid
+            ivs (array-like): New implied volatilities
+            strikes (list[float], optional): Strikes matching ivs. Grid strikes
+                not listed become missing quotes, as in from_chain_data. If
+                omitted, ivs must follow the sorted strike axis.
+        """
+        if strikes is not None:
+            if len(strikes) != len(ivs):
+                raise ValueError(f"strikes has {len(strikes)} entries but ivs has {len(ivs)}.")
+            grid = self.strikes
+            row = np.full(len(grid), np.nan)
+            index = {k: i for i, k in enumerate(grid)}
+            for k, v in zip(strikes, ivs):
+                if k not in index:
+                    raise ValueError(f"strike {k} is not on the surface grid.")
+                row[index[k]] = v
+            ivs = row
+        self._native.set_slice(expiry, np.asarray(ivs, dtype=float))
+
+    @property
+    def version(self) -> int:
+        """Number of updates applied since construction."""
+        return self._native.version
+
+    def fit_svi(self, S: float, r: float, q: float = 0.0, model: str = 'svi') -> SviSurface:
+        """
+        Fit a parametric smile to the quoted grid points.
+
+        Each expiry is reduced to a handful of SVI parameters, so the fitted
+        surface is smooth between strikes, cheap to evaluate and far smaller
+        than the grid. Missing quotes are simply left out of the fit.
+
+        Parameters:
+            S (float): Underlying price, used for the forward / log-moneyness
+            r (float): Risk-free rate (annualized)
+            q (float): Continuous dividend yield (default 0.0)
+            model (str): 'svi' for an independent raw SVI per expiry (needs
+                5+ quotes each), or 'ssvi' for one calendar-consistent SSVI
+                surface across all expiries
+
+        Returns:
+            SviSurface: Fitted surface with get_iv() / get_iv_batch()
+        """
+        models = {'svi': SmileModel.SVI, 'ssvi': SmileModel.SSVI}
+        key = model.lower()
+        if key not in models:
+            raise ValueError(f"model must be 'svi' or 'ssvi', got {model!r}.")
+        K, T = np.meshgrid(self._native.strikes(), self._native.expiries())
+        return SviSurface.from_quotes(S, r, T.ravel(), K.ravel(), self._native.raw_ivs().ravel(), q, models[key])
 
     def smile(self, expiry_index: int = 0) -> tuple:
         """
@@ -138,7 +238,7 @@ class VolatilitySurface:
         """
         if expiry_index < 0 or expiry_index >= len(self.expiries):
             raise IndexError(f"expiry_index {expiry_index} out of range [0, {len(self.expiries) - 1}]")
-        return list(self.strikes), list(self.iv_matrix[expiry_index])
+        return self.strikes, self._native.raw_ivs()[expiry_index].tolist()
 
     def term_structure(self, strike: float) -> tuple:
         """
@@ -150,9 +250,8 @@ class VolatilitySurface:
         Returns:
             tuple: (expiries, ivs) — two lists of equal length
         """
-        si = self._find_nearest(self.strikes, strike)
-        ivs = [self.iv_matrix[ei][si] for ei in range(len(self.expiries))]
-        return list(self.expiries), ivs
+        si = self._native.nearest_strike_index(strike)
+        return self.expiries, self._native.raw_ivs()[:, si].tolist()
 
     def plot(self, title: str = None):
         """
@@ -220,29 +319,13 @@ class VolatilitySurface:
         plt.tight_layout()
         return plt.gcf()
 
-    @staticmethod
-    def _find_bracket(sorted_list: list, value: float) -> int:
-        """Find the index i such that sorted_list[i] <= value < sorted_list[i+1]."""
-        if value <= sorted_list[0]:
-            return 0
-        if value >= sorted_list[-1]:
-            return len(sorted_list) - 1
-        for i in range(len(sorted_list) - 1):
-            if sorted_list[i] <= value < sorted_list[i + 1]:
-                return i
-        return len(sorted_list) - 2
-
-    @staticmethod
-    def _find_nearest(sorted_list: list, value: float) -> int:
-        """Find the index of the nearest element."""
-        return min(range(len(sorted_list)), key=lambda i: abs(sorted_list[i] - value))
-
     def __repr__(self) -> str:
+        strikes, expiries = self.strikes, self.expiries
         return (
-            f"VolatilitySurface(strikes=[{self.strikes[0]}...{self.strikes[-1]}], "
-            f"expiries=[{self.expiries[0]:.4f}...{self.expiries[-1]:.4f}], "
-            f"shape=({len(self.expiries)}, {len(self.strikes)}))"
+            f"VolatilitySurface(strikes=[{strikes[0]}...{strikes[-1]}], "
+            f"expiries=[{expiries[0]:.4f}...{expiries[-1]:.4f}], "
+            f"shape=({len(expiries)}, {len(strikes)}))"
         )
 
 
-__all__ = ['VolatilitySurface']
+__all__ = ['SmileModel', 'SviFit', 'SviParams', 'SviSurface', 'VolatilitySurface', 'fit_slice']
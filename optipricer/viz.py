@@ -35,7 +35,7 @@ def plot_payoff(strategy, underlying_range=None, title=None):
         underlying_range = np.array(underlying_range)
 
     # Compute payoffs at expiration
-    payoffs = np.array([strategy.payoff_at_expiration(s) for s in underlying_range])
+    payoffs = strategy.payoff_grid(underlying_range)
     
     # Net profit includes premium entry cost (total strategy value)
     entry_cost = strategy.total_value()
@@ -1,6 +1,15 @@
 from pybind11.setup_helpers import Pybind11Extension, build_ext
 from pybind11 import get_include
 from setuptools import setup
+import os
+import sys
+
+# The SIMD kernels pass 64-byte vectors between always_inline helpers only,
+# so GCC/Clang's ABI notes about them are noise.
+extra_compile_args = [] if sys.platform == "win32" else ["-Wno-psabi"]
+
+# OPTIPRICER_STATS=1 pip install . compiles in the counters behind optipricer.stats()
+define_macros = [("OPTIPRICER_STATS", "1")] if os.environ.get("OPTIPRICER_STATS", "0") not in ("", "0") else []
 
 ext_modules = [
     Pybind11Extension(
@@ -13,7 +22,9 @@ ext_modules = [
             get_include(),
         ],
         language='c++',
-        cxx_std=14,
+        cxx_std=17,
+        extra_compile_args=extra_compile_args,
+        define_macros=define_macros,
     ),
 ]
 
@@ -1,12 +1,34 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/operators.h>
+#include <pybind11/numpy.h>
 #include "optipricer/models.hpp"
+#include "optipricer/batch.hpp"
+#include "optipricer/chain.hpp"
+#include "optipricer/heston.hpp"
+#include "optipricer/lattice.hpp"
+#include "optipricer/parity.hpp"
+#include "optipricer/pde.hpp"
+#include "optipricer/portfolio.hpp"
+#include "optipricer/snapshot.hpp"
+#include "optipricer/montecarlo.hpp"
+#include "optipricer/parallel.hpp"
+#include "optipricer/stats.hpp"
+#include "optipricer/stream.hpp"
+#include "optipricer/surface.hpp"
+#include "optipricer/var.hpp"
+#include "optipricer/svi.hpp"
 #include "optipricer/greeks.hpp"
 #include "optipricer/strategies.hpp"
 #include "optipricer/utils.hpp"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -26,6 +48,436 @@ inline std::string format_double(double val, int precision = 4) {
     return str;
 }
 
+template <typename T>
+using ArrayIn = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+// Batch operand that reads a Python number in place instead of converting it
+// into a temporary 0-d array, so per-tick scalars (spot, rate, flags) cost
+// no allocation. Anything else goes through ArrayIn's conversion; without
+// conversion only arrays already of dtype T are taken, so the float32 batch
+// overloads claim float32 arrays of any layout before float64 converts them.
+template <typename T>
+struct Operand {
+    py::object owner;
+    const T *values = nullptr;
+    T scalar{};
+    py::ssize_t ndim = 0;
+    const py::ssize_t *shape = nullptr;
+    py::ssize_t size = 1;
+};
+
+namespace pybind11 {
+namespace detail {
+template <typename T>
+struct type_caster<Operand<T>> {
+    PYBIND11_TYPE_CASTER(Operand<T>, make_caster<ArrayIn<T>>::name);
+
+    bool load(handle src, bool convert) {
+        if (load_scalar(src.ptr())) {
+            return true;
+        }
+        if (!convert && !py::array_t<T>::check_(src)) {
+            return false;
+        }
+        auto array = ArrayIn<T>::ensure(src);
+        if (!array) {
+            PyErr_Clear();
+            return false;
+        }
+        value.values = array.data();
+        value.ndim = array.ndim();
+        value.shape = array.shape();
+        value.size = array.size();
+        value.owner = std::move(array);
+        return true;
+    }
+
+private:
+    bool load_scalar(PyObject *src) {
+        if (std::is_same<T, bool>::value) {
+            if (!PyBool_Check(src)) {
+                return false;
+            }
+            value.scalar = static_cast<T>(src == Py_True);
+            return true;
+        }
+        if (!PyFloat_Check(src) && !PyLong_Check(src)) {
+            return false;
+        }
+        double x = PyFloat_AsDouble(src);
+        if (x == -1.0 && PyErr_Occurred()) {
+            PyErr_Clear();
+            return false;
+        }
+        value.scalar = static_cast<T>(x);
+        return true;
+    }
+};
+} // namespace detail
+} // namespace pybind11
+
+struct BatchArg {
+    const char *name;
+    py::ssize_t ndim;
+    const py::ssize_t *shape;
+    py::ssize_t size;
+
+    BatchArg(const char *name, const py::array &array)
+        : name(name), ndim(array.ndim()), shape(array.shape()), size(array.size()) {}
+    template <typename T>
+    BatchArg(const char *name, const Operand<T> &operand)
+        : name(name), ndim(operand.ndim), shape(operand.shape), size(operand.size) {}
+};
+
+// Broadcast shape borrowed from the argument that defines it, so working it out
+// allocates nothing; valid while the arguments are alive.
+struct BatchShape {
+    py::ssize_t ndim = 0;
+    const py::ssize_t *dims = nullptr;
+
+    std::vector<py::ssize_t> vector() const { return std::vector<py::ssize_t>(dims, dims + ndim); }
+
+    bool matches(const py::array &a) const {
+        return a.ndim() == ndim && std::equal(dims, dims + ndim, a.shape());
+    }
+};
+
+// Batch arguments broadcast the way NumPy does for the case that matters here:
+// every argument is either a single value or an array of one common shape.
+inline BatchShape broadcast(std::initializer_list<BatchArg> args) {
+    BatchShape shape;
+    BatchShape scalar_shape;
+    const char *shape_owner = nullptr;
+    for (const auto &arg : args) {
+        if (arg.size == 1) {
+            if (arg.ndim > scalar_shape.ndim) {
+                scalar_shape = {arg.ndim, arg.shape};
+            }
+            continue;
+        }
+        if (shape_owner == nullptr) {
+            shape = {arg.ndim, arg.shape};
+            shape_owner = arg.name;
+        } else if (arg.ndim != shape.ndim || !std::equal(arg.shape, arg.shape + arg.ndim, shape.dims)) {
+            throw std::invalid_argument(std::string("Cannot broadcast '") + arg.name + "' against '" + shape_owner +
+                                        "': batch arguments must share one shape or be scalars");
+        }
+    }
+    return shape_owner == nullptr ? scalar_shape : shape;
+}
+
+inline std::vector<py::ssize_t> broadcast_shape(std::initializer_list<BatchArg> args) {
+    return broadcast(args).vector();
+}
+
+inline std::size_t shape_size(const std::vector<py::ssize_t> &shape) {
+    std::size_t n = 1;
+    for (auto d : shape) {
+        n *= static_cast<std::size_t>(d);
+    }
+    return n;
+}
+
+inline std::size_t shape_size(const BatchShape &shape) {
+    std::size_t n = 1;
+    for (py::ssize_t i = 0; i < shape.ndim; ++i) {
+        n *= static_cast<std::size_t>(shape.dims[i]);
+    }
+    return n;
+}
+
+template <typename T>
+optipricer::models::Column<T> as_column(const ArrayIn<T> &a) {
+    return {a.data(), a.size() == 1 ? std::size_t(0) : std::size_t(1)};
+}
+
+template <typename T>
+optipricer::models::Column<T> as_column(const Operand<T> &a) {
+    return {a.values == nullptr ? &a.scalar : a.values, a.size == 1 ? std::size_t(0) : std::size_t(1)};
+}
+
+// Result column for a batch call: a fresh array when out is None, otherwise the
+// caller's array, which must already have the result dtype and broadcast shape
+// and be C-contiguous and writeable so it is filled in place.
+template <typename T>
+py::array_t<T> result_array(const py::handle &out, const char *name, const BatchShape &shape) {
+    if (out.is_none()) {
+        return py::array_t<T>(shape.vector());
+    }
+    if (!py::isinstance<py::array_t<T>>(out)) {
+        throw std::invalid_argument(std::string("'") + name + "' must be a numpy array of dtype " +
+                                    py::str(py::dtype::of<T>()).cast<std::string>());
+    }
+    auto array = py::reinterpret_borrow<py::array_t<T>>(out);
+    if (!shape.matches(array)) {
+        throw std::invalid_argument(std::string("'") + name + "' has shape " +
+                                    py::str(array.attr("shape")).cast<std::string>() + ", expected " +
+                                    py::str(py::tuple(py::cast(shape.vector()))).cast<std::string>());
+    }
+    if (!(array.flags() & py::array::c_style) || !array.writeable()) {
+        throw std::invalid_argument(std::string("'") + name + "' must be C-contiguous and writeable");
+    }
+    return array;
+}
+
+// The two halves of a paired out=(a, b) argument; None when out is None
+inline std::pair<py::handle, py::handle> result_pair(const py::object &out) {
+    if (out.is_none()) {
+        return {out, out};
+    }
+    if (!py::isinstance<py::tuple>(out) || py::len(out) != 2) {
+        throw std::invalid_argument("'out' must be a tuple of two numpy arrays");
+    }
+    return {PyTuple_GET_ITEM(out.ptr(), 0), PyTuple_GET_ITEM(out.ptr(), 1)};
+}
+
+// Result buffers kept by models.Workspace between batch calls. A buffer is
+// replaced only when the broadcast shape changes.
+struct BatchWorkspace {
+    py::object price;
+    py::object price_delta;
+    py::object greeks;
+    py::object implied_volatility;
+
+    template <typename T>
+    py::object single(py::object &slot, const BatchShape &shape) {
+        if (!slot || !shape.matches(py::reinterpret_borrow<py::array>(slot))) {
+            slot = py::array_t<T>(shape.vector());
+        }
+        return slot;
+    }
+
+    template <typename A, typename B>
+    py::object pair(py::object &slot, const BatchShape &shape) {
+        if (!slot || !shape.matches(py::reinterpret_borrow<py::array>(PyTuple_GET_ITEM(slot.ptr(), 0))) ||
+            !shape.matches(py::reinterpret_borrow<py::array>(PyTuple_GET_ITEM(slot.ptr(), 1)))) {
+            slot = py::make_tuple(py::array_t<A>(shape.vector()), py::array_t<B>(shape.vector()));
+        }
+        return slot;
+    }
+
+    std::size_t num_buffers() const {
+        return (price ? 1 : 0) + (price_delta ? 2 : 0) + (greeks ? 1 : 0) + (implied_volatility ? 2 : 0);
+    }
+
+    void clear() {
+        price = py::object();
+        price_delta = py::object();
+        greeks = py::object();
+        implied_volatility = py::object();
+    }
+};
+
+// Batch entry points shared by the models functions and Workspace, bound once
+// per element type. With out=None each call allocates its results; given
+// caller arrays nothing is allocated.
+template <typename Real>
+py::object price_batch(Operand<Real> S, Operand<Real> K, Operand<Real> r, Operand<Real> T, Operand<Real> sigma,
+                       Operand<Real> q, Operand<bool> is_call, py::object out) {
+    auto shape = broadcast({{"S", S}, {"K", K}, {"r", r}, {"T", T},
+                            {"sigma", sigma}, {"q", q}, {"is_call", is_call}});
+    auto price = result_array<Real>(out, "out", shape);
+    auto n = static_cast<std::size_t>(price.size());
+    Real *dst = price.mutable_data();
+    {
+        py::gil_scoped_release release;
+        optipricer::models::price_batch(as_column(S), as_column(K), as_column(r), as_column(T),
+                                        as_column(sigma), as_column(q), as_column(is_call), dst, n);
+    }
+    return std::move(price);
+}
+
+template <typename Real>
+py::object price_delta_batch(Operand<Real> S, Operand<Real> K, Operand<Real> r, Operand<Real> T,
+                             Operand<Real> sigma, Operand<Real> q, Operand<bool> is_call, py::object out) {
+    auto shape = broadcast({{"S", S}, {"K", K}, {"r", r}, {"T", T},
+                            {"sigma", sigma}, {"q", q}, {"is_call", is_call}});
+    auto dst = result_pair(out);
+    auto price = result_array<Real>(dst.first, "out[0]", shape);
+    auto delta = result_array<Real>(dst.second, "out[1]", shape);
+    auto n = static_cast<std::size_t>(price.size());
+    Real *price_dst = price.mutable_data();
+    Real *delta_dst = delta.mutable_data();
+    {
+        py::gil_scoped_release release;
+        optipricer::models::price_delta_batch(as_column(S), as_column(K), as_column(r), as_column(T),
+                                              as_column(sigma), as_column(q), as_column(is_call),
+                                              price_dst, delta_dst, n);
+    }
+    return out.is_none() ? py::object(py::make_tuple(price, delta)) : out;
+}
+
+template <typename Real>
+using BatchGreeks = typename std::conditional<std::is_same<Real, float>::value, optipricer::models::AllGreeks32,
+                                              optipricer::models::AllGreeks>::type;
+
+template <typename Real>
+py::object greeks_batch(Operand<Real> S, Operand<Real> K, Operand<Real> r, Operand<Real> T, Operand<Real> sigma,
+                        Operand<Real> q, py::object out) {
+    auto shape = broadcast({{"S", S}, {"K", K}, {"r", r}, {"T", T},
+                            {"sigma", sigma}, {"q", q}});
+    auto greeks = result_array<BatchGreeks<Real>>(out, "out", shape);
+    auto n = static_cast<std::size_t>(greeks.size());
+    BatchGreeks<Real> *dst = greeks.mutable_data();
+    {
+        py::gil_scoped_release release;
+        optipricer::models::compute_all_batch(as_column(S), as_column(K), as_column(r), as_column(T),
+                                              as_column(sigma), as_column(q), dst, n);
+    }
+    return std::move(greeks);
+}
+
+// refine only applies to float32 quotes; float64 roots are already solved in double
+template <typename Real>
+py::object implied_volatility_batch(Operand<Real> market_price, Operand<Real> S, Operand<Real> K, Operand<Real> r,
+                                    Operand<Real> T, Operand<Real> q, Operand<bool> is_call, double tol,
+                                    int max_iter, bool refine, py::object out) {
+    auto shape = broadcast({{"market_price", market_price}, {"S", S}, {"K", K}, {"r", r},
+                            {"T", T}, {"q", q}, {"is_call", is_call}});
+    auto dst = result_pair(out);
+    auto sigma = result_array<Real>(dst.first, "out[0]", shape);
+    auto status = result_array<std::int8_t>(dst.second, "out[1]", shape);
+    auto n = static_cast<std::size_t>(sigma.size());
+    Real *sigma_dst = sigma.mutable_data();
+    std::int8_t *status_dst = status.mutable_data();
+    {
+        py::gil_scoped_release release;
+        if constexpr (std::is_same<Real, float>::value) {
+            optipricer::models::implied_volatility_batch(as_column(market_price), as_column(S), as_column(K),
+                                                         as_column(r), as_column(T), as_column(q),
+                                                         as_column(is_call), tol, max_iter, refine,
+                                                         sigma_dst, status_dst, n);
+        } else {
+            (void)refine;
+            optipricer::models::implied_volatility_batch(as_column(market_price), as_column(S), as_column(K),
+                                                         as_column(r), as_column(T), as_column(q),
+                                                         as_column(is_call), tol, max_iter,
+                                                         sigma_dst, status_dst, n);
+        }
+    }
+    return out.is_none() ? py::object(py::make_tuple(sigma, status)) : out;
+}
+
+// Read-only NumPy view over memory owned by a bound C++ object; the view keeps
+// the owner alive through its base reference.
+template <typename T>
+inline py::array readonly_view(const py::object &owner, const T *data, std::vector<py::ssize_t> shape,
+                               std::vector<py::ssize_t> strides = {}) {
+    py::array_t<T> view(shape, strides, data, owner);
+    view.attr("setflags")(py::arg("write") = false);
+    return view;
+}
+
+template <typename T>
+using RecordField = std::pair<const char *, double T::*>;
+
+// Field order shared by the AllGreeks attributes, to_dict() and __repr__
+static const RecordField<optipricer::models::AllGreeks> ALL_GREEKS_FIELDS[] = {
+    {"call_price", &optipricer::models::AllGreeks::call_price},
+    {"put_price", &optipricer::models::AllGreeks::put_price},
+    {"call_delta", &optipricer::models::AllGreeks::call_delta},
+    {"put_delta", &optipricer::models::AllGreeks::put_delta},
+    {"gamma", &optipricer::models::AllGreeks::gamma},
+    {"vega", &optipricer::models::AllGreeks::vega},
+    {"call_theta", &optipricer::models::AllGreeks::call_theta},
+    {"put_theta", &optipricer::models::AllGreeks::put_theta},
+    {"call_rho", &optipricer::models::AllGreeks::call_rho},
+    {"put_rho", &optipricer::models::AllGreeks::put_rho},
+    {"vanna", &optipricer::models::AllGreeks::vanna},
+    {"volga", &optipricer::models::AllGreeks::volga},
+    {"call_charm", &optipricer::models::AllGreeks::call_charm},
+    {"put_charm", &optipricer::models::AllGreeks::put_charm},
+};
+
+static const RecordField<optipricer::strategies::StrategyGreeks> STRATEGY_GREEKS_FIELDS[] = {
+    {"value", &optipricer::strategies::StrategyGreeks::value},
+    {"delta", &optipricer::strategies::StrategyGreeks::delta},
+    {"gamma", &optipricer::strategies::StrategyGreeks::gamma},
+    {"vega", &optipricer::strategies::StrategyGreeks::vega},
+    {"theta", &optipricer::strategies::StrategyGreeks::theta},
+    {"rho", &optipricer::strategies::StrategyGreeks::rho},
+    {"vanna", &optipricer::strategies::StrategyGreeks::vanna},
+    {"volga", &optipricer::strategies::StrategyGreeks::volga},
+    {"charm", &optipricer::strategies::StrategyGreeks::charm},
+};
+
+static const RecordField<optipricer::portfolio::BookGreeks> BOOK_GREEKS_FIELDS[] = {
+    {"value", &optipricer::portfolio::BookGreeks::value},
+    {"delta", &optipricer::portfolio::BookGreeks::delta},
+    {"gamma", &optipricer::portfolio::BookGreeks::gamma},
+    {"vega", &optipricer::portfolio::BookGreeks::vega},
+    {"theta", &optipricer::portfolio::BookGreeks::theta},
+    {"rho", &optipricer::portfolio::BookGreeks::rho},
+    {"vanna", &optipricer::portfolio::BookGreeks::vanna},
+    {"volga", &optipricer::portfolio::BookGreeks::volga},
+    {"charm", &optipricer::portfolio::BookGreeks::charm},
+};
+
+static const RecordField<optipricer::lattice::LatticeResult> LATTICE_RESULT_FIELDS[] = {
+    {"price", &optipricer::lattice::LatticeResult::price},
+    {"delta", &optipricer::lattice::LatticeResult::delta},
+    {"gamma", &optipricer::lattice::LatticeResult::gamma},
+    {"theta", &optipricer::lattice::LatticeResult::theta},
+};
+
+static const RecordField<optipricer::pde::PDEResult> PDE_RESULT_FIELDS[] = {
+    {"price", &optipricer::pde::PDEResult::price},
+    {"delta", &optipricer::pde::PDEResult::delta},
+    {"gamma", &optipricer::pde::PDEResult::gamma},
+    {"vega", &optipricer::pde::PDEResult::vega},
+    {"theta", &optipricer::pde::PDEResult::theta},
+    {"rho", &optipricer::pde::PDEResult::rho},
+    {"vanna", &optipricer::pde::PDEResult::vanna},
+    {"volga", &optipricer::pde::PDEResult::volga},
+    {"charm", &optipricer::pde::PDEResult::charm},
+};
+
+static const RecordField<optipricer::heston::HestonParams> HESTON_PARAMS_FIELDS[] = {
+    {"v0", &optipricer::heston::HestonParams::v0},
+    {"kappa", &optipricer::heston::HestonParams::kappa},
+    {"theta", &optipricer::heston::HestonParams::theta},
+    {"xi", &optipricer::heston::HestonParams::xi},
+    {"rho", &optipricer::heston::HestonParams::rho},
+};
+
+static const RecordField<optipricer::heston::HestonResult> HESTON_RESULT_FIELDS[] = {
+    {"price", &optipricer::heston::HestonResult::price},
+    {"delta", &optipricer::heston::HestonResult::delta},
+    {"gamma", &optipricer::heston::HestonResult::gamma},
+};
+
+static const RecordField<optipricer::svi::SviParams> SVI_PARAMS_FIELDS[] = {
+    {"a", &optipricer::svi::SviParams::a},
+    {"b", &optipricer::svi::SviParams::b},
+    {"rho", &optipricer::svi::SviParams::rho},
+    {"m", &optipricer::svi::SviParams::m},
+    {"sigma", &optipricer::svi::SviParams::sigma},
+};
+
+// Read-only attributes, to_dict() and __repr__ for a plain struct of doubles
+template <typename T, std::size_t N>
+void bind_record_fields(py::class_<T> &cls, const char *name, const RecordField<T> (&fields)[N]) {
+    for (const auto &field : fields) {
+        cls.def_readonly(field.first, field.second);
+    }
+    cls.def("to_dict", [&fields](const T &record) {
+           py::dict d;
+           for (const auto &field : fields) {
+               d[field.first] = record.*field.second;
+           }
+           return d;
+       }, "Return all fields as a dict")
+       .def("__repr__", [name, &fields](const T &record) {
+           std::string out = std::string(name) + "(";
+           bool first = true;
+           for (const auto &field : fields) {
+               out += (first ? "" : ", ") + std::string(field.first) + "=" + format_double(record.*field.second, 6);
+               first = false;
+           }
+           return out + ")";
+       });
+}
+
 PYBIND11_MODULE(_core, m)
 {
      m.doc() = "OptiPricer: A comprehensive options pricing and analysis library";
@@ -46,9 +498,104 @@ PYBIND11_MODULE(_core, m)
      m.def("norm_pdf", &optipricer::utils::norm_pdf, "Standard normal probability density function",
            py::arg("x"));
 
+     // Native thread pool used by the batch, chain and IV entry points
+     m.def("set_num_threads",
+           [](int n) {
+                if (n < 0) {
+                     throw std::invalid_argument("Number of threads must be non-negative, got: " + std::to_string(n));
+                }
+                optipricer::parallel::set_num_threads(static_cast<unsigned>(n));
+           },
+           "Set the number of native threads used for batch work (0 = one per hardware thread)",
+           py::arg("n"), py::call_guard<py::gil_scoped_release>());
+     m.def("get_num_threads", &optipricer::parallel::get_num_threads,
+           "Number of native threads used for batch work");
+
+     // Instrumentation counters; all zero unless built with OPTIPRICER_STATS
+     m.def("stats",
+           []() {
+                namespace stats = optipricer::stats;
+                const stats::Snapshot snap = stats::snapshot();
+                const stats::SolverCounts &iv = snap.implied_volatility;
+                py::dict solver;
+                solver["calls"] = iv.calls;
+                solver["converged"] = iv.converged;
+                solver["not_converged"] = iv.not_converged;
+                solver["rejected"] = iv.rejected;
+                solver["iterations"] = iv.iterations;
+                solver["newton_steps"] = iv.newton_steps;
+                solver["bisection_steps"] = iv.bisection_steps;
+                solver["bracket_expansions"] = iv.bracket_expansions;
+                solver["iteration_histogram"] = std::vector<std::uint64_t>(
+                    iv.iteration_histogram, iv.iteration_histogram + stats::ITERATION_BUCKETS);
+
+                py::dict latency;
+                for (std::size_t t = 0; t < stats::NUM_TIMERS; ++t) {
+                     const stats::LatencyHistogram &h = snap.latency[t];
+                     py::dict entry;
+                     entry["count"] = h.count;
+                     entry["total_ns"] = h.total_ns;
+                     entry["mean_ns"] = h.mean_ns();
+                     entry["p50_ns"] = h.quantile_ns(0.50);
+                     entry["p90_ns"] = h.quantile_ns(0.90);
+                     entry["p99_ns"] = h.quantile_ns(0.99);
+                     entry["buckets"] = std::vector<std::uint64_t>(h.buckets, h.buckets + stats::LATENCY_BUCKETS);
+                     latency[stats::timer_name(static_cast<stats::Timer>(t))] = entry;
+                }
+
+                py::dict out;
+                out["enabled"] = snap.enabled;
+                out["implied_volatility"] = solver;
+                out["latency"] = latency;
+                return out;
+           },
+           "Solver and entry-point counters recorded since the last reset_stats()");
+     m.def("reset_stats", &optipricer::stats::reset, "Zero the counters reported by stats()");
+
      // Models submodule
      py::module_ models = m.def_submodule("models", "Options pricing models");
 
+     PYBIND11_NUMPY_DTYPE(optipricer::models::AllGreeks, call_price, put_price, call_delta, put_delta,
+                          gamma, vega, call_theta, put_theta, call_rho, put_rho,
+                          vanna, volga, call_charm, put_charm);
+     PYBIND11_NUMPY_DTYPE(optipricer::models::AllGreeks32, call_price, put_price, call_delta, put_delta,
+                          gamma, vega, call_theta, put_theta, call_rho, put_rho,
+                          vanna, volga, call_charm, put_charm);
+
+     py::class_<optipricer::models::AllGreeks> all_greeks(models, "AllGreeks",
+                                                          "Every price and Greek of one call/put pair");
+     bind_record_fields(all_greeks, "AllGreeks", ALL_GREEKS_FIELDS);
+
+     py::class_<optipricer::models::ExpiryContext>(models, "ExpiryContext",
+                                                   "r, q, T, both discount factors and sqrt(T) of one expiry, "
+                                                   "shared by every strike priced against it")
+          .def(py::init<double, double, double>(),
+               "Precompute the strike-independent terms of one expiry\n\n"
+               "Raises:\n"
+               "  ValueError: If time_to_maturity or dividend_yield is out of range, NaN or infinite",
+               py::arg("risk_free_rate"), py::arg("time_to_maturity"), py::arg("dividend_yield") = 0.0)
+          .def_static("unchecked", &optipricer::models::ExpiryContext::unchecked,
+                      "ExpiryContext without input validation, for values checked elsewhere\n\n"
+                      "Out-of-range inputs give meaningless results instead of a ValueError.",
+                      py::arg("risk_free_rate"), py::arg("time_to_maturity"), py::arg("dividend_yield") = 0.0)
+          .def("get_risk_free_rate", &optipricer::models::ExpiryContext::get_risk_free_rate,
+               "Get risk-free rate")
+          .def("get_time_to_maturity", &optipricer::models::ExpiryContext::get_time_to_maturity,
+               "Get time to maturity")
+          .def("get_dividend_yield", &optipricer::models::ExpiryContext::get_dividend_yield,
+               "Get dividend yield")
+          .def("get_discount_factor", &optipricer::models::ExpiryContext::get_discount_factor,
+               "Get exp(-r * T)")
+          .def("get_dividend_discount", &optipricer::models::ExpiryContext::get_dividend_discount,
+               "Get exp(-q * T)")
+          .def("get_sqrt_time", &optipricer::models::ExpiryContext::get_sqrt_time,
+               "Get sqrt(T)")
+          .def("__repr__", [](const optipricer::models::ExpiryContext &expiry) {
+               return "ExpiryContext(risk_free_rate=" + format_double(expiry.get_risk_free_rate()) +
+                      ", time_to_maturity=" + format_double(expiry.get_time_to_maturity()) +
+                      ", dividend_yield=" + format_double(expiry.get_dividend_yield()) + ")";
+          });
+
      py::class_<optipricer::models::BlackScholesModel>(models, "BlackScholesModel")
           .def(py::init<double, double, double, double, double, double>(),
                "Initialize Black-Scholes model\n\n"
@@ -63,6 +610,23 @@ PYBIND11_MODULE(_core, m)
                "  ValueError: If any parameter is invalid (negative, zero, NaN, or infinite)",
                py::arg("strike_price"), py::arg("volatility"), py::arg("risk_free_rate"),
                py::arg("time_to_maturity"), py::arg("underlying_price"), py::arg("dividend_yield") = 0.0)
+          .def(py::init<double, double, double, const optipricer::models::ExpiryContext &>(),
+               "Initialize a Black-Scholes model for one strike of an expiry\n\n"
+               "The discount factors and sqrt(T) are taken from the ExpiryContext\n"
+               "instead of being recomputed.",
+               py::arg("strike_price"), py::arg("volatility"), py::arg("underlying_price"), py::arg("expiry"))
+          .def_static("unchecked",
+                      py::overload_cast<double, double, double, double, double, double>(
+                           &optipricer::models::BlackScholesModel::unchecked),
+                      "BlackScholesModel without input validation, for values checked elsewhere\n\n"
+                      "Prices match the validated constructor for valid inputs; out-of-range\n"
+                      "inputs give meaningless results instead of a ValueError.",
+                      py::arg("strike_price"), py::arg("volatility"), py::arg("risk_free_rate"),
+                      py::arg("time_to_maturity"), py::arg("underlying_price"), py::arg("dividend_yield") = 0.0)
+          .def_static("unchecked",
+                      py::overload_cast<double, double, double, const optipricer::models::ExpiryContext &>(
+                           &optipricer::models::BlackScholesModel::unchecked),
+                      py::arg("strike_price"), py::arg("volatility"), py::arg("underlying_price"), py::arg("expiry"))
           .def("d1", &optipricer::models::BlackScholesModel::d1,
                "Calculate d1 parameter")
           .def("d2", &optipricer::models::BlackScholesModel::d2,
@@ -83,6 +647,8 @@ PYBIND11_MODULE(_core, m)
                "Get underlying price")
           .def("get_dividend_yield", &optipricer::models::BlackScholesModel::get_dividend_yield,
                "Get dividend yield")
+          .def("get_expiry", &optipricer::models::BlackScholesModel::get_expiry,
+               "Get the expiry context (r, q, T and discount factors)")
           .def("__repr__", [](const optipricer::models::BlackScholesModel &model) {
                return "BlackScholesModel(strike_price=" + format_double(model.get_strike_price()) +
                       ", volatility=" + format_double(model.get_volatility()) +
@@ -92,11 +658,168 @@ PYBIND11_MODULE(_core, m)
                       ", dividend_yield=" + format_double(model.get_dividend_yield()) + ")";
           });
 
-     models.def("calculate_implied_volatility", &optipricer::models::calculate_implied_volatility,
+     models.def("calculate_implied_volatility",
+                static_cast<double (*)(double, double, double, double, double, double, bool, double, int)>(
+                    &optipricer::models::calculate_implied_volatility),
                 "Calculate implied volatility for an option",
                 py::arg("market_price"), py::arg("strike_price"), py::arg("risk_free_rate"),
                 py::arg("time_to_maturity"), py::arg("underlying_price"), py::arg("dividend_yield") = 0.0,
-                py::arg("is_call") = true, py::arg("tol") = 1e-6, py::arg("max_iter") = 100);
+                py::arg("is_call") = true, py::arg("tol") = 1e-6, py::arg("max_iter") = 100,
+                py::call_guard<py::gil_scoped_release>());
+     models.def("calculate_implied_volatility",
+                static_cast<double (*)(double, double, double, const optipricer::models::ExpiryContext &, bool, double, int)>(
+                    &optipricer::models::calculate_implied_volatility),
+                "Calculate implied volatility for an option of a precomputed expiry",
+                py::arg("market_price"), py::arg("strike_price"), py::arg("underlying_price"), py::arg("expiry"),
+                py::arg("is_call") = true, py::arg("tol") = 1e-6, py::arg("max_iter") = 100,
+                py::call_guard<py::gil_scoped_release>());
+
+     models.def("price_batch", price_batch<double>,
+                "Price a batch of European options in one native call\n\n"
+                "Every argument is either a scalar or an array; scalars are broadcast\n"
+                "against the common array shape. The GIL is released while pricing and\n"
+                "large batches are split across the native thread pool\n"
+                "(see optipricer.set_num_threads).\n\n"
+                "When every array argument is float32 the batch is priced in single\n"
+                "precision and float32 results are returned (see the float32 overload).\n\n"
+                "Pass out= a float64 array of the broadcast shape (C-contiguous,\n"
+                "writeable) to have prices written into it instead of a new array.\n\n"
+                "Returns:\n"
+                "  numpy.ndarray of option prices with the broadcast shape (out, if given)\n\n"
+                "Raises:\n"
+                "  ValueError: If shapes do not broadcast, any element is invalid or out\n"
+                "  does not match",
+                py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+                py::arg("q") = 0.0, py::arg("is_call") = true, py::arg("out") = py::none());
+     models.def("price_batch", price_batch<float>,
+                "Single-precision price_batch, chosen when every array argument is float32\n\n"
+                "Prices agree with the float64 path to within ~1e-6 of the spot level;\n"
+                "out= takes a float32 array. Mixing float32 and float64 arrays prices in\n"
+                "float64.",
+                py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+                py::arg("q") = 0.0, py::arg("is_call") = true, py::arg("out") = py::none());
+
+     models.def("price_delta_batch", price_delta_batch<double>,
+                "Price a batch of European options and their deltas in one native call\n\n"
+                "Arguments broadcast exactly like price_batch; out= takes a (price, delta)\n"
+                "tuple of float64 arrays to fill in place.\n\n"
+                "Returns:\n"
+                "  (price, delta) tuple of numpy.ndarray with the broadcast shape (out, if given)",
+                py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+                py::arg("q") = 0.0, py::arg("is_call") = true, py::arg("out") = py::none());
+     models.def("price_delta_batch", price_delta_batch<float>,
+                "Single-precision price_delta_batch, chosen when every array argument is\n"
+                "float32; out= takes a (price, delta) tuple of float32 arrays.",
+                py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+                py::arg("q") = 0.0, py::arg("is_call") = true, py::arg("out") = py::none());
+
+     models.def("greeks_batch", greeks_batch<double>,
+                "Calculate prices and every Greek for a batch of call/put pairs\n\n"
+                "Arguments broadcast exactly like price_batch; out= takes a structured\n"
+                "array of the AllGreeks dtype (e.g. a previous result) to fill in place.\n\n"
+                "Returns:\n"
+                "  numpy structured array with one field per AllGreeks attribute",
+                py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+                py::arg("q") = 0.0, py::arg("out") = py::none());
+     models.def("greeks_batch", greeks_batch<float>,
+                "Single-precision greeks_batch, chosen when every array argument is\n"
+                "float32. The structured result has the AllGreeks fields as float32,\n"
+                "each within ~3e-6 relative of the float64 path.",
+                py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+                py::arg("q") = 0.0, py::arg("out") = py::none());
+
+     py::enum_<optipricer::models::IVStatus>(models, "IVStatus", "Per-element status of the implied volatility solver")
+          .value("OK", optipricer::models::IVStatus::OK)
+          .value("INVALID_INPUT", optipricer::models::IVStatus::INVALID_INPUT)
+          .value("BELOW_INTRINSIC", optipricer::models::IVStatus::BELOW_INTRINSIC)
+          .value("ABOVE_MAXIMUM", optipricer::models::IVStatus::ABOVE_MAXIMUM)
+          .value("VOLATILITY_TOO_HIGH", optipricer::models::IVStatus::VOLATILITY_TOO_HIGH)
+          .value("NOT_CONVERGED", optipricer::models::IVStatus::NOT_CONVERGED);
+
+     models.def("implied_volatility_batch", implied_volatility_batch<double>,
+                "Solve implied volatility for a batch of quotes across threads\n\n"
+                "Arguments broadcast exactly like price_batch. Invalid quotes do not\n"
+                "raise; they are reported through the status array instead. out= takes\n"
+                "an (iv, status) tuple of float64 and int8 arrays to fill in place.\n"
+                "refine only affects float32 quotes (see the float32 overload).\n\n"
+                "Returns:\n"
+                "  (iv, status) tuple; iv is NaN wherever status is not IVStatus.OK or\n"
+                "  IVStatus.NOT_CONVERGED, status holds int8 IVStatus codes",
+                py::arg("market_price"), py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"),
+                py::arg("q") = 0.0, py::arg("is_call") = true, py::arg("tol") = 1e-6, py::arg("max_iter") = 100,
+                py::arg("refine") = false, py::arg("out") = py::none());
+     models.def("implied_volatility_batch", implied_volatility_batch<float>,
+                "Single-precision implied_volatility_batch, chosen when every array\n"
+                "argument is float32\n\n"
+                "Each root carries the float pricing error divided by vega. With\n"
+                "refine=True every converged root takes one final Newton step in double,\n"
+                "bringing it to within float32 rounding of the float64 solution wherever\n"
+                "vega is not negligible. out= takes an (iv, status) tuple of float32 and\n"
+                "int8 arrays.",
+                py::arg("market_price"), py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"),
+                py::arg("q") = 0.0, py::arg("is_call") = true, py::arg("tol") = 1e-6, py::arg("max_iter") = 100,
+                py::arg("refine") = false, py::arg("out") = py::none());
+
+     py::class_<BatchWorkspace>(models, "Workspace",
+                                "Reusable result buffers for repeated batch calls\n\n"
+                                "Each method takes the same arguments as the module function of the same\n"
+                                "name and writes into arrays the workspace keeps between calls, so a\n"
+                                "steady stream of same-shaped batches (e.g. a chain repriced every tick)\n"
+                                "allocates nothing. A method returns the same array objects for as long\n"
+                                "as the broadcast shape stays the same, overwriting them on every call;\n"
+                                "copy a result to keep it. A workspace must not be shared between threads.\n"
+                                "Buffers are float64; float32 inputs are converted.")
+          .def(py::init<>())
+          .def("price_batch",
+               [](BatchWorkspace &ws, Operand<double> S, Operand<double> K, Operand<double> r,
+                             Operand<double> T, Operand<double> sigma, Operand<double> q, Operand<bool> is_call) {
+                    auto shape = broadcast({{"S", S}, {"K", K}, {"r", r}, {"T", T},
+                                            {"sigma", sigma}, {"q", q}, {"is_call", is_call}});
+                    return price_batch<double>(S, K, r, T, sigma, q, is_call, ws.single<double>(ws.price, shape));
+               },
+               "models.price_batch into the workspace's price buffer",
+               py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+               py::arg("q") = 0.0, py::arg("is_call") = true)
+          .def("price_delta_batch",
+               [](BatchWorkspace &ws, Operand<double> S, Operand<double> K, Operand<double> r,
+                                   Operand<double> T, Operand<double> sigma, Operand<double> q, Operand<bool> is_call) {
+                    auto shape = broadcast({{"S", S}, {"K", K}, {"r", r}, {"T", T},
+                                            {"sigma", sigma}, {"q", q}, {"is_call", is_call}});
+                    return price_delta_batch<double>(S, K, r, T, sigma, q, is_call,
+                                                     ws.pair<double, double>(ws.price_delta, shape));
+               },
+               "models.price_delta_batch into the workspace's (price, delta) buffers",
+               py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+               py::arg("q") = 0.0, py::arg("is_call") = true)
+          .def("greeks_batch",
+               [](BatchWorkspace &ws, Operand<double> S, Operand<double> K, Operand<double> r,
+                              Operand<double> T, Operand<double> sigma, Operand<double> q) {
+                    auto shape = broadcast({{"S", S}, {"K", K}, {"r", r}, {"T", T},
+                                            {"sigma", sigma}, {"q", q}});
+                    return greeks_batch<double>(S, K, r, T, sigma, q,
+                                                ws.single<optipricer::models::AllGreeks>(ws.greeks, shape));
+               },
+               "models.greeks_batch into the workspace's Greeks buffer",
+               py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+               py::arg("q") = 0.0)
+          .def("implied_volatility_batch",
+               [](BatchWorkspace &ws, Operand<double> market_price, Operand<double> S, Operand<double> K,
+                  Operand<double> r, Operand<double> T, Operand<double> q, Operand<bool> is_call, double tol,
+                  int max_iter) {
+                    auto shape = broadcast({{"market_price", market_price}, {"S", S}, {"K", K}, {"r", r},
+                                            {"T", T}, {"q", q}, {"is_call", is_call}});
+                    return implied_volatility_batch<double>(market_price, S, K, r, T, q, is_call, tol, max_iter,
+                                                            false,
+                                                            ws.pair<double, std::int8_t>(ws.implied_volatility,
+                                                                                         shape));
+               },
+               "models.implied_volatility_batch into the workspace's (iv, status) buffers",
+               py::arg("market_price"), py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"),
+               py::arg("q") = 0.0, py::arg("is_call") = true, py::arg("tol") = 1e-6, py::arg("max_iter") = 100)
+          .def("clear", &BatchWorkspace::clear, "Release every buffer the workspace holds")
+          .def("__repr__", [](const BatchWorkspace &ws) {
+               return "Workspace(buffers=" + std::to_string(ws.num_buffers()) + ")";
+          });
 
      py::class_<optipricer::models::GreeksCalculator>(models, "GreeksCalculator")
           .def(py::init<const optipricer::models::BlackScholesModel &>(),
@@ -126,6 +849,8 @@ PYBIND11_MODULE(_core, m)
                "Calculate call charm (delta decay per day)")
           .def("put_charm", &optipricer::models::GreeksCalculator::put_charm,
                "Calculate put charm (delta decay per day)")
+          .def("compute_all", &optipricer::models::GreeksCalculator::compute_all,
+               "Calculate both prices and every Greek in one fused pass")
           .def("__repr__", [](const optipricer::models::GreeksCalculator &calc) {
                const auto& model = calc.get_model();
                return "GreeksCalculator(model=BlackScholesModel(S=" + format_double(model.get_underlying_price()) +
@@ -137,6 +862,1277 @@ PYBIND11_MODULE(_core, m)
           });
 
      // Strategies submodule
+     py::module_ chain = m.def_submodule("chain", "Column-oriented option chain engine");
+
+     py::tuple column_names(optipricer::chain::NUM_COLUMNS);
+     for (std::size_t c = 0; c < optipricer::chain::NUM_COLUMNS; ++c) {
+          column_names[c] = optipricer::chain::COLUMN_NAMES[c];
+     }
+     chain.attr("COLUMN_NAMES") = column_names;
+
+     py::class_<optipricer::chain::OptionChain>(chain, "OptionChain")
+          .def(py::init<double, double, double, const std::vector<double> &, const std::vector<double> &, double>(),
+               "Price every strike of one expiry; strikes are sorted with their volatilities",
+               py::arg("underlying_price"), py::arg("risk_free_rate"), py::arg("time_to_maturity"),
+               py::arg("strikes"), py::arg("volatilities"), py::arg("dividend_yield") = 0.0,
+               py::call_guard<py::gil_scoped_release>())
+          .def("reprice", &optipricer::chain::OptionChain::reprice,
+               "Reprice every strike at a new underlying price, updating existing views in place",
+               py::arg("underlying_price"), py::call_guard<py::gil_scoped_release>())
+          .def("column",
+               [](py::object self, const std::string &name) {
+                    const auto &c = self.cast<const optipricer::chain::OptionChain &>();
+                    for (std::size_t k = 0; k < optipricer::chain::NUM_COLUMNS; ++k) {
+                         if (name == optipricer::chain::COLUMN_NAMES[k]) {
+                              return readonly_view(self, c.column(k), {static_cast<py::ssize_t>(c.size())});
+                         }
+                    }
+                    throw py::key_error("Unknown chain column: '" + name + "'");
+               },
+               "Read-only view of one column (no copy)", py::arg("name"))
+          .def("columns",
+               [](py::object self) {
+                    const auto &c = self.cast<const optipricer::chain::OptionChain &>();
+                    py::dict out;
+                    for (std::size_t k = 0; k < optipricer::chain::NUM_COLUMNS; ++k) {
+                         out[optipricer::chain::COLUMN_NAMES[k]] =
+                              readonly_view(self, c.column(k), {static_cast<py::ssize_t>(c.size())});
+                    }
+                    return out;
+               },
+               "Dict of read-only column views keyed by COLUMN_NAMES (no copy)")
+          .def("values",
+               [](py::object self) {
+                    const auto &c = self.cast<const optipricer::chain::OptionChain &>();
+                    return readonly_view(self, c.data(),
+                                         {static_cast<py::ssize_t>(optipricer::chain::NUM_COLUMNS),
+                                          static_cast<py::ssize_t>(c.size())});
+               },
+               "Read-only (len(COLUMN_NAMES), n) view of the whole column block (no copy)")
+          .def("atm_index", &optipricer::chain::OptionChain::atm_index,
+               "Index of the strike closest to the underlying price")
+          .def("__len__", &optipricer::chain::OptionChain::size)
+          .def_property_readonly("underlying_price", &optipricer::chain::OptionChain::get_underlying_price)
+          .def_property_readonly("risk_free_rate", &optipricer::chain::OptionChain::get_risk_free_rate)
+          .def_property_readonly("time_to_maturity", &optipricer::chain::OptionChain::get_time_to_maturity)
+          .def_property_readonly("dividend_yield", &optipricer::chain::OptionChain::get_dividend_yield);
+
+     py::module_ surface = m.def_submodule("surface", "Native implied volatility surface");
+
+     py::class_<optipricer::surface::VolatilitySurface>(surface, "VolatilitySurface")
+          .def(py::init([](const std::vector<double> &strikes, const std::vector<double> &expiries, ArrayIn<double> iv) {
+                    if (iv.ndim() != 2 || iv.shape(0) != static_cast<py::ssize_t>(expiries.size()) ||
+                        iv.shape(1) != static_cast<py::ssize_t>(strikes.size())) {
+                         throw std::invalid_argument("iv_matrix must have shape (len(expiries), len(strikes))");
+                    }
+                    return std::unique_ptr<optipricer::surface::VolatilitySurface>(
+                         new optipricer::surface::VolatilitySurface(strikes, expiries, iv.data()));
+               }),
+               "Build a surface from strikes, expiries and a (len(expiries), len(strikes)) IV grid; NaN marks a missing quote",
+               py::arg("strikes"), py::arg("expiries"), py::arg("iv_matrix"))
+          .def("get_iv", &optipricer::surface::VolatilitySurface::get_iv,
+               "Bilinearly interpolated implied volatility",
+               py::arg("strike"), py::arg("expiry"))
+          .def("get_iv_batch",
+               [](const optipricer::surface::VolatilitySurface &s, ArrayIn<double> strikes, ArrayIn<double> expiries) {
+                    auto shape = broadcast_shape({{"strikes", strikes}, {"expiries", expiries}});
+                    py::array_t<double> out(shape);
+                    auto n = static_cast<std::size_t>(out.size());
+                    double *dst = out.mutable_data();
+                    {
+                         py::gil_scoped_release release;
+                         s.get_iv_batch(as_column(strikes), as_column(expiries), dst, n);
+                    }
+                    return out;
+               },
+               "Interpolated IV for arrays of strikes and expiries (scalars broadcast)",
+               py::arg("strikes"), py::arg("expiries"))
+          .def("strikes", [](const optipricer::surface::VolatilitySurface &s) { return py::array_t<double>(
+                    static_cast<py::ssize_t>(s.num_strikes()), s.strikes().data()); },
+               "Sorted strike axis")
+          .def("expiries", [](const optipricer::surface::VolatilitySurface &s) { return py::array_t<double>(
+                    static_cast<py::ssize_t>(s.num_expiries()), s.expiries().data()); },
+               "Sorted expiry axis")
+          .def("raw_ivs", [](const optipricer::surface::VolatilitySurface &s) {
+                    auto g = s.snapshot();
+                    std::vector<double> grid = g->raw_ivs();
+                    return py::array_t<double>({static_cast<py::ssize_t>(g->num_expiries()), static_cast<py::ssize_t>(g->num_strikes())},
+                                               grid.data()); },
+               "IV grid as quoted (NaN = missing), one row per expiry")
+          .def("filled_ivs", [](const optipricer::surface::VolatilitySurface &s) {
+                    auto g = s.snapshot();
+                    std::vector<double> grid = g->filled_ivs();
+                    return py::array_t<double>({static_cast<py::ssize_t>(g->num_expiries()), static_cast<py::ssize_t>(g->num_strikes())},
+                                               grid.data()); },
+               "Hole-free IV grid used for interpolation")
+          .def("set_iv", &optipricer::surface::VolatilitySurface::set_iv,
+               "Replace the quote at an existing (strike, expiry) knot; NaN removes it",
+               py::arg("strike"), py::arg("expiry"), py::arg("iv"),
+               py::call_guard<py::gil_scoped_release>())
+          .def("set_ivs",
+               [](optipricer::surface::VolatilitySurface &s, ArrayIn<double> strikes, ArrayIn<double> expiries, ArrayIn<double> ivs) {
+                    auto shape = broadcast_shape({{"strikes", strikes}, {"expiries", expiries}, {"ivs", ivs}});
+                    std::size_t n = shape_size(shape);
+                    py::gil_scoped_release release;
+                    s.set_ivs(as_column(strikes), as_column(expiries), as_column(ivs), n);
+               },
+               "Replace many quotes in a single update (scalars broadcast)",
+               py::arg("strikes"), py::arg("expiries"), py::arg("ivs"))
+          .def("set_slice",
+               [](optipricer::surface::VolatilitySurface &s, double expiry, ArrayIn<double> ivs) {
+                    if (ivs.ndim() != 1 || static_cast<std::size_t>(ivs.size()) != s.num_strikes()) {
+                         throw std::invalid_argument("ivs must be a 1-D array with one entry per strike, got " +
+                                                     std::to_string(ivs.size()) + " for " + std::to_string(s.num_strikes()) + " strikes");
+                    }
+                    py::gil_scoped_release release;
+                    s.set_slice(expiry, ivs.data());
+               },
+               "Replace every quote of an existing expiry; ivs follows the sorted strike axis",
+               py::arg("expiry"), py::arg("ivs"))
+          .def_property_readonly("version", &optipricer::surface::VolatilitySurface::version,
+                                 "Incremented by every update")
+          .def("slice_version",
+               [](const optipricer::surface::VolatilitySurface &s, std::size_t expiry_index) {
+                    auto g = s.snapshot();
+                    if (expiry_index >= g->num_expiries()) {
+                         throw std::out_of_range("expiry_index out of range");
+                    }
+                    return g->slice_version(expiry_index);
+               },
+               "Version of the update that last changed the given expiry row",
+               py::arg("expiry_index"))
+          .def("nearest_strike_index", &optipricer::surface::VolatilitySurface::nearest_strike_index,
+               "Index of the strike closest to the given value", py::arg("strike"));
+
+     py::module_ parity = m.def_submodule("parity", "Implied forward and dividend yield per expiry from put-call parity");
+
+     py::class_<optipricer::parity::ParityFit>(parity, "ParityFit",
+                                              "Forward, rate and dividend yield implied by one expiry's call/put quotes")
+          .def_readonly("expiry", &optipricer::parity::ParityFit::expiry)
+          .def_readonly("forward", &optipricer::parity::ParityFit::forward)
+          .def_readonly("rate", &optipricer::parity::ParityFit::rate, "The given rate, or the regressed one with fit_rate")
+          .def_readonly("dividend_yield", &optipricer::parity::ParityFit::dividend_yield)
+          .def_readonly("discount_factor", &optipricer::parity::ParityFit::discount_factor)
+          .def_readonly("rmse", &optipricer::parity::ParityFit::rmse,
+                        "Weighted RMS parity residual of the quotes used, in price units")
+          .def_readonly("num_quotes", &optipricer::parity::ParityFit::num_quotes)
+          .def_readonly("num_used", &optipricer::parity::ParityFit::num_used,
+                        "Quotes left in the fit after outlier rejection")
+          .def("__repr__", [](const optipricer::parity::ParityFit &f) {
+               return "ParityFit(expiry=" + format_double(f.expiry, 6) + ", forward=" + format_double(f.forward) +
+                      ", rate=" + format_double(f.rate, 6) + ", dividend_yield=" + format_double(f.dividend_yield, 6) +
+                      ", num_used=" + std::to_string(f.num_used) + "/" + std::to_string(f.num_quotes) + ")";
+          });
+
+     parity.attr("DEFAULT_OUTLIER_THRESHOLD") = optipricer::parity::DEFAULT_OUTLIER_THRESHOLD;
+
+     parity.def("calibrate",
+                [](double S, double r, ArrayIn<double> T, ArrayIn<double> K, ArrayIn<double> call_price,
+                   ArrayIn<double> put_price, py::object weights, bool fit_rate, double outlier_threshold) {
+                     ArrayIn<double> wt;
+                     std::size_t n;
+                     if (weights.is_none()) {
+                          n = shape_size(broadcast_shape({{"T", T}, {"K", K}, {"call_price", call_price},
+                                                          {"put_price", put_price}}));
+                     } else {
+                          wt = ArrayIn<double>::ensure(weights);
+                          if (!wt) {
+                               throw std::invalid_argument("weights must be an array of numbers");
+                          }
+                          n = shape_size(broadcast_shape({{"T", T}, {"K", K}, {"call_price", call_price},
+                                                          {"put_price", put_price}, {"weights", wt}}));
+                     }
+                     optipricer::utils::Column<double> weight = {nullptr, 0};
+                     if (!weights.is_none()) {
+                          weight = as_column(wt);
+                     }
+                     py::gil_scoped_release release;
+                     return optipricer::parity::calibrate(S, r, as_column(T), as_column(K), as_column(call_price),
+                                                          as_column(put_price), weight, n, fit_rate, outlier_threshold);
+                },
+                "Fit forward and dividend yield for every expiry of a set of call/put quotes\n\n"
+                "Rows are grouped by exact expiry and expiries are fitted in parallel,\n"
+                "regressing call - put on strike. r is held fixed unless fit_rate is\n"
+                "set, in which case each expiry's discount factor is regressed too.\n"
+                "Quotes whose parity residual exceeds outlier_threshold robust standard\n"
+                "deviations are dropped (0 disables this); NaN prices mark missing quotes.\n\n"
+                "Returns:\n"
+                "  list[ParityFit] ordered by expiry\n\n"
+                "Raises:\n"
+                "  ValueError: If any quote is invalid or an expiry cannot be fitted",
+                py::arg("S"), py::arg("r"), py::arg("T"), py::arg("K"), py::arg("call_price"), py::arg("put_price"),
+                py::arg("weights") = py::none(), py::arg("fit_rate") = false,
+                py::arg("outlier_threshold") = optipricer::parity::DEFAULT_OUTLIER_THRESHOLD);
+
+     parity.def("carry",
+                [](const std::vector<optipricer::parity::ParityFit> &fits, ArrayIn<double> T) {
+                     std::vector<py::ssize_t> shape(T.shape(), T.shape() + T.ndim());
+                     py::array_t<double> rate(shape), q(shape);
+                     auto n = static_cast<std::size_t>(T.size());
+                     double *rate_dst = rate.mutable_data();
+                     double *q_dst = q.mutable_data();
+                     {
+                          py::gil_scoped_release release;
+                          optipricer::parity::carry_batch(fits, as_column(T), rate_dst, q_dst, n);
+                     }
+                     return py::make_tuple(rate, q);
+                },
+                "Per-element (rate, dividend_yield) arrays for expiries T\n\n"
+                "Fitted expiries get their own fit; in between, r*T and q*T are\n"
+                "interpolated linearly, and outside the fitted range the nearest fit\n"
+                "is held flat. Pass the result as r= and q= of the batch functions.",
+                py::arg("fits"), py::arg("T"));
+
+     py::module_ svi = m.def_submodule("svi", "Parametric SVI/SSVI smile calibration");
+
+     py::enum_<optipricer::svi::SmileModel>(svi, "SmileModel", "Smile parameterization used by SviSurface calibration")
+          .value("SVI", optipricer::svi::SmileModel::SVI)
+          .value("SSVI", optipricer::svi::SmileModel::SSVI);
+
+     py::class_<optipricer::svi::SviParams> svi_params(svi, "SviParams", "Raw SVI parameters of one expiry slice");
+     svi_params.def(py::init([](double a, double b, double rho, double m, double sigma) {
+                         return optipricer::svi::SviParams{a, b, rho, m, sigma};
+                    }),
+                    py::arg("a"), py::arg("b"), py::arg("rho"), py::arg("m"), py::arg("sigma"))
+          .def("total_variance", &optipricer::svi::SviParams::total_variance,
+               "Total variance iv^2 * T at log-moneyness k", py::arg("k"))
+          .def("min_variance", &optipricer::svi::SviParams::min_variance, "Smallest total variance of the smile");
+     bind_record_fields(svi_params, "SviParams", SVI_PARAMS_FIELDS);
+
+     py::class_<optipricer::svi::SviFit>(svi, "SviFit", "Calibrated slice and its fit quality")
+          .def_readonly("params", &optipricer::svi::SviFit::params)
+          .def_readonly("expiry", &optipricer::svi::SviFit::expiry)
+          .def_readonly("rmse", &optipricer::svi::SviFit::rmse, "Weighted RMS implied volatility error")
+          .def_readonly("iterations", &optipricer::svi::SviFit::iterations)
+          .def_readonly("num_quotes", &optipricer::svi::SviFit::num_quotes)
+          .def("__repr__", [](const optipricer::svi::SviFit &f) {
+               return "SviFit(expiry=" + format_double(f.expiry, 6) + ", rmse=" + format_double(f.rmse, 6) +
+                      ", num_quotes=" + std::to_string(f.num_quotes) + ")";
+          });
+
+     svi.def("fit_slice",
+             [](ArrayIn<double> k, ArrayIn<double> w, double T, py::object weights, int max_iter) {
+                  if (k.ndim() != 1 || w.ndim() != 1 || k.size() != w.size()) {
+                       throw std::invalid_argument("k and w must be 1-D arrays of equal length");
+                  }
+                  ArrayIn<double> wt;
+                  if (!weights.is_none()) {
+                       wt = ArrayIn<double>::ensure(weights);
+                       if (!wt || wt.ndim() != 1 || wt.size() != k.size()) {
+                            throw std::invalid_argument("weights must be a 1-D array matching k");
+                       }
+                  }
+                  for (py::ssize_t i = 1; i < k.size(); ++i) {
+                       if (!(k.data()[i] > k.data()[i - 1])) {
+                            throw std::invalid_argument("k must be strictly increasing");
+                       }
+                  }
+                  const double *weight = weights.is_none() ? nullptr : wt.data();
+                  py::gil_scoped_release release;
+                  return optipricer::svi::fit_svi_slice(k.data(), w.data(), weight, static_cast<std::size_t>(k.size()), T, max_iter);
+             },
+             "Fit raw SVI to one slice of (log-moneyness, total variance) quotes",
+             py::arg("k"), py::arg("w"), py::arg("T"), py::arg("weights") = py::none(), py::arg("max_iter") = 100);
+
+     py::class_<optipricer::svi::SviSurface>(svi, "SviSurface")
+          .def(py::init([](double S, double r, const std::vector<double> &expiries,
+                           const std::vector<optipricer::svi::SviParams> &params, double q) {
+                    if (expiries.size() != params.size()) {
+                         throw std::invalid_argument("expiries and params must have the same length");
+                    }
+                    std::vector<optipricer::svi::SviFit> slices;
+                    for (std::size_t j = 0; j < params.size(); ++j) {
+                         slices.push_back({params[j], expiries[j], std::numeric_limits<double>::quiet_NaN(), 0, 0});
+                    }
+                    return optipricer::svi::SviSurface(S, r, q, slices);
+               }),
+               "Surface from known slice parameters (e.g. a saved calibration)",
+               py::arg("S"), py::arg("r"), py::arg("expiries"), py::arg("params"), py::arg("q") = 0.0)
+          .def_static("from_quotes",
+                      [](double S, double r, ArrayIn<double> T, ArrayIn<double> K, ArrayIn<double> iv, double q,
+                         optipricer::svi::SmileModel model, int max_iter) {
+                           auto shape = broadcast_shape({{"T", T}, {"K", K}, {"iv", iv}});
+                           std::size_t n = shape_size(shape);
+                           py::gil_scoped_release release;
+                           return optipricer::svi::SviSurface::from_quotes(S, r, q, as_column(T), as_column(K), as_column(iv),
+                                                                          n, model, max_iter);
+                      },
+                      "Calibrate to implied volatility quotes grouped by expiry; NaN quotes are skipped",
+                      py::arg("S"), py::arg("r"), py::arg("T"), py::arg("K"), py::arg("iv"), py::arg("q") = 0.0,
+                      py::arg("model") = optipricer::svi::SmileModel::SVI, py::arg("max_iter") = 100)
+          .def_static("from_prices",
+                      [](double S, double r, ArrayIn<double> T, ArrayIn<double> K, ArrayIn<double> price,
+                         ArrayIn<bool> is_call, double q, optipricer::svi::SmileModel model, int max_iter) {
+                           auto shape = broadcast_shape({{"T", T}, {"K", K}, {"price", price}, {"is_call", is_call}});
+                           std::size_t n = shape_size(shape);
+                           py::gil_scoped_release release;
+                           return optipricer::svi::SviSurface::from_prices(S, r, q, as_column(T), as_column(K), as_column(price),
+                                                                          as_column(is_call), n, model, max_iter);
+                      },
+                      "Calibrate to option prices via the batch IV solver, vega-weighted",
+                      py::arg("S"), py::arg("r"), py::arg("T"), py::arg("K"), py::arg("price"), py::arg("is_call") = true,
+                      py::arg("q") = 0.0, py::arg("model") = optipricer::svi::SmileModel::SVI, py::arg("max_iter") = 100)
+          .def_static("from_prices",
+                      [](double S, const std::vector<optipricer::parity::ParityFit> &carry, ArrayIn<double> T,
+                         ArrayIn<double> K, ArrayIn<double> price, ArrayIn<bool> is_call,
+                         optipricer::svi::SmileModel model, int max_iter) {
+                           auto shape = broadcast_shape({{"T", T}, {"K", K}, {"price", price}, {"is_call", is_call}});
+                           std::size_t n = shape_size(shape);
+                           py::gil_scoped_release release;
+                           return optipricer::svi::SviSurface::from_prices(S, carry, as_column(T), as_column(K),
+                                                                          as_column(price), as_column(is_call), n,
+                                                                          model, max_iter);
+                      },
+                      "Calibrate to option prices with each expiry's rate and dividend yield taken\n"
+                      "from a parity.calibrate carry curve, for the IV solve and the forwards",
+                      py::arg("S"), py::arg("carry"), py::arg("T"), py::arg("K"), py::arg("price"),
+                      py::arg("is_call") = true, py::arg("model") = optipricer::svi::SmileModel::SVI,
+                      py::arg("max_iter") = 100)
+          .def("get_iv", &optipricer::svi::SviSurface::get_iv, "Implied volatility at (strike, expiry)",
+               py::arg("strike"), py::arg("expiry"))
+          .def("get_iv_batch",
+               [](const optipricer::svi::SviSurface &s, ArrayIn<double> strikes, ArrayIn<double> expiries) {
+                    auto shape = broadcast_shape({{"strikes", strikes}, {"expiries", expiries}});
+                    py::array_t<double> out(shape);
+                    auto n = static_cast<std::size_t>(out.size());
+                    double *dst = out.mutable_data();
+                    {
+                         py::gil_scoped_release release;
+                         s.get_iv_batch(as_column(strikes), as_column(expiries), dst, n);
+                    }
+                    return out;
+               },
+               "Implied volatility for arrays of strikes and expiries (scalars broadcast)",
+               py::arg("strikes"), py::arg("expiries"))
+          .def("total_variance", &optipricer::svi::SviSurface::total_variance,
+               "Total variance at log-moneyness k and expiry T", py::arg("k"), py::arg("T"))
+          .def("forward", &optipricer::svi::SviSurface::forward, "Forward price used for log-moneyness", py::arg("T"))
+          .def("slices", &optipricer::svi::SviSurface::slices, "Calibrated slices ordered by expiry")
+          .def("expiries", &optipricer::svi::SviSurface::expiries, "Slice expiries in ascending order")
+          .def("__len__", &optipricer::svi::SviSurface::num_slices)
+          .def_property_readonly("underlying_price", &optipricer::svi::SviSurface::get_underlying_price)
+          .def_property_readonly("risk_free_rate", &optipricer::svi::SviSurface::get_risk_free_rate)
+          .def_property_readonly("dividend_yield", &optipricer::svi::SviSurface::get_dividend_yield)
+          .def_property_readonly("carry", &optipricer::svi::SviSurface::carry,
+                                 "Parity fits the surface was calibrated with; empty for a flat r and q");
+
+     py::module_ heston = m.def_submodule("heston", "Heston stochastic volatility: COS pricing and calibration");
+
+     py::class_<optipricer::heston::HestonParams> heston_params(heston, "HestonParams",
+                                                                "Heston parameters (variances, not volatilities)");
+     heston_params.def(py::init([](double v0, double kappa, double theta, double xi, double rho) {
+                            return optipricer::heston::HestonParams{v0, kappa, theta, xi, rho};
+                       }),
+                       py::arg("v0"), py::arg("kappa"), py::arg("theta"), py::arg("xi"), py::arg("rho"));
+     bind_record_fields(heston_params, "HestonParams", HESTON_PARAMS_FIELDS);
+
+     PYBIND11_NUMPY_DTYPE(optipricer::heston::HestonResult, price, delta, gamma);
+
+     py::class_<optipricer::heston::HestonResult> heston_result(heston, "HestonResult",
+                                                                "Heston price with spot delta and gamma");
+     bind_record_fields(heston_result, "HestonResult", HESTON_RESULT_FIELDS);
+
+     py::class_<optipricer::heston::HestonFit>(heston, "HestonFit", "Calibrated expiry and its fit quality")
+          .def_readonly("params", &optipricer::heston::HestonFit::params)
+          .def_readonly("expiry", &optipricer::heston::HestonFit::expiry)
+          .def_readonly("rmse", &optipricer::heston::HestonFit::rmse, "Weighted RMS implied volatility error (vega-scaled)")
+          .def_readonly("iterations", &optipricer::heston::HestonFit::iterations)
+          .def_readonly("num_quotes", &optipricer::heston::HestonFit::num_quotes)
+          .def("__repr__", [](const optipricer::heston::HestonFit &f) {
+               return "HestonFit(expiry=" + format_double(f.expiry, 6) + ", rmse=" + format_double(f.rmse, 6) +
+                      ", num_quotes=" + std::to_string(f.num_quotes) + ")";
+          });
+
+     // is_call is one flag for the whole chain or one per strike
+     auto chain_flags = [](const optipricer::heston::HestonExpiry &expiry, const ArrayIn<bool> &is_call) {
+          if (is_call.size() != 1 && static_cast<std::size_t>(is_call.size()) != expiry.size()) {
+               throw std::invalid_argument("is_call must be a scalar or have one entry per strike");
+          }
+          return as_column(is_call);
+     };
+
+     py::class_<optipricer::heston::HestonExpiry>(heston, "HestonExpiry",
+                                                  "COS pricer for all strikes of one expiry, with the basis cached")
+          .def(py::init([](double S, double r, double T, ArrayIn<double> strikes,
+                           const optipricer::heston::HestonParams &reference, double q, std::size_t terms) {
+                    if (strikes.ndim() != 1) {
+                         throw std::invalid_argument("strikes must be a 1-D array");
+                    }
+                    return optipricer::heston::HestonExpiry(S, r, q, T, strikes.data(),
+                                                            static_cast<std::size_t>(strikes.size()), reference, terms);
+               }),
+               "Fix the truncation range (from the cumulants under `reference`) and the strike basis\n\n"
+               "terms = 0 picks the number of cosine terms from the width of the range.",
+               py::arg("underlying_price"), py::arg("risk_free_rate"), py::arg("time_to_maturity"),
+               py::arg("strikes"), py::arg("reference"), py::arg("dividend_yield") = 0.0, py::arg("terms") = 0)
+          .def("price_chain",
+               [chain_flags](const optipricer::heston::HestonExpiry &expiry,
+                             const optipricer::heston::HestonParams &params, ArrayIn<bool> is_call) {
+                    auto flags = chain_flags(expiry, is_call);
+                    py::array_t<optipricer::heston::HestonResult> out(static_cast<py::ssize_t>(expiry.size()));
+                    auto *dst = out.mutable_data();
+                    {
+                         py::gil_scoped_release release;
+                         expiry.price_chain(params, flags, dst);
+                    }
+                    return out;
+               },
+               "Prices, deltas and gammas of every strike (structured array: price, delta, gamma)",
+               py::arg("params"), py::arg("is_call") = true)
+          .def("prices",
+               [chain_flags](const optipricer::heston::HestonExpiry &expiry,
+                             const optipricer::heston::HestonParams &params, ArrayIn<bool> is_call) {
+                    auto flags = chain_flags(expiry, is_call);
+                    py::array_t<double> out(static_cast<py::ssize_t>(expiry.size()));
+                    double *dst = out.mutable_data();
+                    {
+                         py::gil_scoped_release release;
+                         expiry.prices(params, flags, dst);
+                    }
+                    return out;
+               },
+               "Prices of every strike; repeated calls with the same params reuse the cached characteristic function",
+               py::arg("params"), py::arg("is_call") = true)
+          .def("__len__", &optipricer::heston::HestonExpiry::size)
+          .def_property_readonly("num_terms", &optipricer::heston::HestonExpiry::num_terms)
+          .def_property_readonly("strikes", [](py::object self) {
+               const auto &expiry = self.cast<const optipricer::heston::HestonExpiry &>();
+               return readonly_view(self, expiry.get_strikes().data(), {static_cast<py::ssize_t>(expiry.size())});
+          })
+          .def_property_readonly("underlying_price", &optipricer::heston::HestonExpiry::get_underlying_price)
+          .def_property_readonly("risk_free_rate", &optipricer::heston::HestonExpiry::get_risk_free_rate)
+          .def_property_readonly("time_to_maturity", &optipricer::heston::HestonExpiry::get_time_to_maturity)
+          .def_property_readonly("dividend_yield", &optipricer::heston::HestonExpiry::get_dividend_yield);
+
+     heston.def("calibrate",
+                [](double S, double r, double T, ArrayIn<double> strikes, ArrayIn<double> iv, double q,
+                   py::object weights, py::object initial, int max_iter) {
+                     if (strikes.ndim() != 1 || iv.ndim() != 1 || strikes.size() != iv.size()) {
+                          throw std::invalid_argument("strikes and iv must be 1-D arrays of equal length");
+                     }
+                     ArrayIn<double> wt;
+                     if (!weights.is_none()) {
+                          wt = ArrayIn<double>::ensure(weights);
+                          if (!wt || wt.ndim() != 1 || wt.size() != strikes.size()) {
+                               throw std::invalid_argument("weights must be a 1-D array matching strikes");
+                          }
+                     }
+                     const double *weight = weights.is_none() ? nullptr : wt.data();
+                     optipricer::heston::HestonParams start = {};
+                     const bool has_start = !initial.is_none();
+                     if (has_start) {
+                          start = initial.cast<optipricer::heston::HestonParams>();
+                     }
+                     py::gil_scoped_release release;
+                     return optipricer::heston::calibrate(S, r, q, T, strikes.data(), iv.data(), weight,
+                                                          static_cast<std::size_t>(strikes.size()),
+                                                          has_start ? &start : nullptr, max_iter);
+                },
+                "Fit Heston to one expiry's implied volatilities (NaN quotes are skipped)\n\n"
+                "Quotes are priced out of the money and price errors are scaled by vega, so rmse\n"
+                "is close to the implied volatility error. initial defaults to the ATM variance.",
+                py::arg("S"), py::arg("r"), py::arg("T"), py::arg("strikes"), py::arg("iv"), py::arg("q") = 0.0,
+                py::arg("weights") = py::none(), py::arg("initial") = py::none(), py::arg("max_iter") = 100);
+
+     py::module_ mc = m.def_submodule("mc", "Monte Carlo pricing of path-dependent options");
+
+     py::enum_<optipricer::mc::PathPayoff>(mc, "PathPayoff", "Payoff of a simulated path")
+          .value("EUROPEAN", optipricer::mc::PathPayoff::EUROPEAN)
+          .value("ASIAN", optipricer::mc::PathPayoff::ASIAN)
+          .value("UP_AND_OUT", optipricer::mc::PathPayoff::UP_AND_OUT)
+          .value("UP_AND_IN", optipricer::mc::PathPayoff::UP_AND_IN)
+          .value("DOWN_AND_OUT", optipricer::mc::PathPayoff::DOWN_AND_OUT)
+          .value("DOWN_AND_IN", optipricer::mc::PathPayoff::DOWN_AND_IN);
+
+     py::enum_<optipricer::mc::Sampler>(mc, "Sampler", "Source of the path draws")
+          .value("PSEUDO_RANDOM", optipricer::mc::Sampler::PSEUDO_RANDOM)
+          .value("SOBOL", optipricer::mc::Sampler::SOBOL);
+     mc.attr("SOBOL_DIMENSIONS") = optipricer::mc::SOBOL_DIMENSIONS;
+
+     py::class_<optipricer::mc::MCResult>(mc, "MCResult", "Monte Carlo estimate and its standard error")
+          .def_readonly("price", &optipricer::mc::MCResult::price)
+          .def_readonly("std_error", &optipricer::mc::MCResult::std_error)
+          .def_readonly("paths", &optipricer::mc::MCResult::paths, "Simulated paths (antithetic twins included)")
+          .def("__repr__", [](const optipricer::mc::MCResult &r) {
+               return "MCResult(price=" + format_double(r.price, 6) + ", std_error=" + format_double(r.std_error, 6) +
+                      ", paths=" + std::to_string(r.paths) + ")";
+          });
+
+     py::class_<optipricer::mc::MonteCarloEngine>(mc, "MonteCarloEngine")
+          .def(py::init<double, double, double, double, double>(),
+               py::arg("underlying_price"), py::arg("risk_free_rate"), py::arg("time_to_maturity"),
+               py::arg("volatility"), py::arg("dividend_yield") = 0.0)
+          .def("price",
+               [](const optipricer::mc::MonteCarloEngine &engine, double strike, optipricer::mc::PathPayoff payoff,
+                  bool is_call, double barrier, std::size_t paths, std::size_t steps, std::uint64_t seed,
+                  bool antithetic, bool control_variate, optipricer::mc::Sampler sampler, std::size_t replicates) {
+                    optipricer::mc::MCSettings settings;
+                    settings.paths = paths;
+                    settings.steps = steps;
+                    settings.seed = seed;
+                    settings.antithetic = antithetic;
+                    settings.control_variate = control_variate;
+                    settings.sampler = sampler;
+                    settings.replicates = replicates;
+                    return engine.price({payoff, is_call, strike, barrier}, settings);
+               },
+               "Price an option on simulated paths; the same seed always gives the same estimate",
+               py::arg("strike"), py::arg("payoff") = optipricer::mc::PathPayoff::EUROPEAN, py::arg("is_call") = true,
+               py::arg("barrier") = std::numeric_limits<double>::quiet_NaN(), py::arg("paths") = 100000,
+               py::arg("steps") = 1, py::arg("seed") = 42, py::arg("antithetic") = true,
+               py::arg("control_variate") = true, py::arg("sampler") = optipricer::mc::Sampler::PSEUDO_RANDOM,
+               py::arg("replicates") = 16, py::call_guard<py::gil_scoped_release>())
+          .def_property_readonly("underlying_price", &optipricer::mc::MonteCarloEngine::get_underlying_price)
+          .def_property_readonly("risk_free_rate", &optipricer::mc::MonteCarloEngine::get_risk_free_rate)
+          .def_property_readonly("time_to_maturity", &optipricer::mc::MonteCarloEngine::get_time_to_maturity)
+          .def_property_readonly("volatility", &optipricer::mc::MonteCarloEngine::get_volatility)
+          .def_property_readonly("dividend_yield", &optipricer::mc::MonteCarloEngine::get_dividend_yield);
+
+     py::module_ lattice = m.def_submodule("lattice", "Binomial and trinomial lattices for American options");
+
+     py::enum_<optipricer::lattice::LatticeMethod>(lattice, "LatticeMethod", "Tree construction")
+          .value("CRR", optipricer::lattice::LatticeMethod::CRR)
+          .value("LEISEN_REIMER", optipricer::lattice::LatticeMethod::LEISEN_REIMER)
+          .value("TRINOMIAL", optipricer::lattice::LatticeMethod::TRINOMIAL);
+
+     PYBIND11_NUMPY_DTYPE(optipricer::lattice::LatticeResult, price, delta, gamma, theta);
+
+     py::class_<optipricer::lattice::LatticeResult> lattice_result(lattice, "LatticeResult",
+                                                                   "Lattice price with delta, gamma and theta (per day)");
+     bind_record_fields(lattice_result, "LatticeResult", LATTICE_RESULT_FIELDS);
+
+     auto lattice_settings = [](bool american, optipricer::lattice::LatticeMethod method, std::size_t steps,
+                                bool richardson) {
+          optipricer::lattice::LatticeSettings settings;
+          settings.american = american;
+          settings.method = method;
+          settings.steps = steps;
+          settings.richardson = richardson;
+          return settings;
+     };
+
+     py::class_<optipricer::lattice::LatticeEngine>(lattice, "LatticeEngine")
+          .def(py::init<double, double, double, double, double>(),
+               py::arg("underlying_price"), py::arg("risk_free_rate"), py::arg("time_to_maturity"),
+               py::arg("volatility"), py::arg("dividend_yield") = 0.0)
+          .def("price",
+               [lattice_settings](const optipricer::lattice::LatticeEngine &engine, double strike, bool is_call,
+                                  bool american, optipricer::lattice::LatticeMethod method, std::size_t steps,
+                                  bool richardson) {
+                    return engine.price(strike, is_call, lattice_settings(american, method, steps, richardson));
+               },
+               "Price one option by backward induction; the Greeks come from the t = 0 nodes",
+               py::arg("strike"), py::arg("is_call") = true, py::arg("american") = true,
+               py::arg("method") = optipricer::lattice::LatticeMethod::LEISEN_REIMER, py::arg("steps") = 201,
+               py::arg("richardson") = true, py::call_guard<py::gil_scoped_release>())
+          .def_property_readonly("underlying_price", &optipricer::lattice::LatticeEngine::get_underlying_price)
+          .def_property_readonly("risk_free_rate", &optipricer::lattice::LatticeEngine::get_risk_free_rate)
+          .def_property_readonly("time_to_maturity", &optipricer::lattice::LatticeEngine::get_time_to_maturity)
+          .def_property_readonly("volatility", &optipricer::lattice::LatticeEngine::get_volatility)
+          .def_property_readonly("dividend_yield", &optipricer::lattice::LatticeEngine::get_dividend_yield);
+
+     lattice.def("price_batch",
+                 [lattice_settings](ArrayIn<double> S, ArrayIn<double> K, ArrayIn<double> r, ArrayIn<double> T,
+                                    ArrayIn<double> sigma, ArrayIn<double> q, ArrayIn<bool> is_call, bool american,
+                                    optipricer::lattice::LatticeMethod method, std::size_t steps, bool richardson) {
+                      auto shape = broadcast_shape({{"S", S}, {"K", K}, {"r", r}, {"T", T},
+                                                    {"sigma", sigma}, {"q", q}, {"is_call", is_call}});
+                      py::array_t<optipricer::lattice::LatticeResult> out(shape);
+                      auto n = static_cast<std::size_t>(out.size());
+                      optipricer::lattice::LatticeResult *dst = out.mutable_data();
+                      auto settings = lattice_settings(american, method, steps, richardson);
+                      {
+                           py::gil_scoped_release release;
+                           optipricer::lattice::price_batch(as_column(S), as_column(K), as_column(r), as_column(T),
+                                                            as_column(sigma), as_column(q), as_column(is_call),
+                                                            settings, dst, n);
+                      }
+                      return out;
+                 },
+                 "Price a batch of options (e.g. a whole chain) on the lattice across the thread pool\n\n"
+                 "Arguments broadcast exactly like models.price_batch.\n\n"
+                 "Returns:\n"
+                 "  numpy structured array with fields price, delta, gamma, theta\n\n"
+                 "Raises:\n"
+                 "  ValueError: If shapes do not broadcast or any element is invalid",
+                 py::arg("S"), py::arg("K"), py::arg("r"), py::arg("T"), py::arg("sigma"),
+                 py::arg("q") = 0.0, py::arg("is_call") = true, py::arg("american") = true,
+                 py::arg("method") = optipricer::lattice::LatticeMethod::LEISEN_REIMER, py::arg("steps") = 201,
+                 py::arg("richardson") = true);
+
+     py::module_ pde = m.def_submodule("pde", "Crank-Nicolson finite differences for American and barrier options");
+
+     py::enum_<optipricer::pde::BarrierType>(pde, "BarrierType", "Continuously monitored barrier, zero rebate")
+          .value("NONE", optipricer::pde::BarrierType::NONE)
+          .value("UP_AND_OUT", optipricer::pde::BarrierType::UP_AND_OUT)
+          .value("DOWN_AND_OUT", optipricer::pde::BarrierType::DOWN_AND_OUT)
+          .value("UP_AND_IN", optipricer::pde::BarrierType::UP_AND_IN)
+          .value("DOWN_AND_IN", optipricer::pde::BarrierType::DOWN_AND_IN);
+
+     PYBIND11_NUMPY_DTYPE(optipricer::pde::PDEResult, price, delta, gamma, vega, theta, rho, vanna, volga, charm);
+
+     py::class_<optipricer::pde::PDEResult> pde_result(pde, "PDEResult",
+                                                       "PDE price and Greeks in the units of models.AllGreeks");
+     bind_record_fields(pde_result, "PDEResult", PDE_RESULT_FIELDS);
+
+     auto pde_settings = [](bool american, optipricer::pde::BarrierType barrier, double barrier_level,
+                            std::size_t space_steps, std::size_t time_steps, bool sensitivities) {
+          optipricer::pde::PDESettings settings;
+          settings.american = american;
+          settings.barrier = barrier;
+          settings.barrier_level = barrier_level;
+          settings.space_steps = space_steps;
+          settings.time_steps = time_steps;
+          settings.sensitivities = sensitivities;
+          return settings;
+     };
+     const double no_barrier = std::numeric_limits<double>::quiet_NaN();
+
+     py::class_<optipricer::pde::CrankNicolsonEngine>(pde, "CrankNicolsonEngine")
+          .def(py::init<double, double, double, double, double>(),
+               py::arg("underlying_price"), py::arg("risk_free_rate"), py::arg("time_to_maturity"),
+               py::arg("volatility"), py::arg("dividend_yield") = 0.0)
+          .def("price",
+               [pde_settings](const optipricer::pde::CrankNicolsonEngine &engine, double strike, bool is_call,
+                              bool american, optipricer::pde::BarrierType barrier, double barrier_level,
+                              std::size_t space_steps, std::size_t time_steps, bool sensitivities) {
+                    return engine.price(strike, is_call, pde_settings(american, barrier, barrier_level, space_steps,
+                                                                      time_steps, sensitivities));
+               },
+               "Price one option by a backward Crank-Nicolson solve",
+               py::arg("strike"), py::arg("is_call") = true, py::arg("american") = true,
+               py::arg("barrier") = optipricer::pde::BarrierType::NONE, py::arg("barrier_level") = no_barrier,
+               py::arg("space_steps") = 400, py::arg("time_steps") = 200, py::arg("sensitivities") = true,
+               py::call_guard<py::gil_scoped_release>())
+          .def("price_chain",
+               [pde_settings](const optipricer::pde::CrankNicolsonEngine &engine, ArrayIn<double> strikes,
+                              ArrayIn<bool> is_call, bool american, optipricer::pde::BarrierType barrier,
+                              double barrier_level, std::size_t space_steps, std::size_t time_steps,
+                              bool sensitivities) {
+                    auto shape = broadcast_shape({{"strikes", strikes}, {"is_call", is_call}});
+                    py::array_t<optipricer::pde::PDEResult> out(shape);
+                    auto n = static_cast<std::size_t>(out.size());
+                    optipricer::pde::PDEResult *dst = out.mutable_data();
+                    auto settings = pde_settings(american, barrier, barrier_level, space_steps, time_steps, sensitivities);
+                    {
+                         py::gil_scoped_release release;
+                         engine.price_chain(as_column(strikes), as_column(is_call), n, settings, dst);
+                    }
+                    return out;
+               },
+               "Price every strike of a chain from one backward solve on a shared grid\n\n"
+               "strikes and is_call broadcast against each other; sensitivities adds four\n"
+               "re-solves (volatility and rate bumps) on the same grid.\n\n"
+               "Returns:\n"
+               "  numpy structured array with the PDEResult fields\n\n"
+               "Raises:\n"
+               "  ValueError: If shapes do not broadcast or any input or setting is invalid",
+               py::arg("strikes"), py::arg("is_call") = true, py::arg("american") = true,
+               py::arg("barrier") = optipricer::pde::BarrierType::NONE, py::arg("barrier_level") = no_barrier,
+               py::arg("space_steps") = 400, py::arg("time_steps") = 200, py::arg("sensitivities") = true)
+          .def_property_readonly("underlying_price", &optipricer::pde::CrankNicolsonEngine::get_underlying_price)
+          .def_property_readonly("risk_free_rate", &optipricer::pde::CrankNicolsonEngine::get_risk_free_rate)
+          .def_property_readonly("time_to_maturity", &optipricer::pde::CrankNicolsonEngine::get_time_to_maturity)
+          .def_property_readonly("volatility", &optipricer::pde::CrankNicolsonEngine::get_volatility)
+          .def_property_readonly("dividend_yield", &optipricer::pde::CrankNicolsonEngine::get_dividend_yield);
+
+     // Portfolio submodule
+     py::module_ portfolio = m.def_submodule("portfolio", "Column-oriented book of options across underlyings and expiries");
+
+     PYBIND11_NUMPY_DTYPE(optipricer::portfolio::BookGreeks, value, delta, gamma, vega, theta, rho, vanna, volga, charm);
+     PYBIND11_NUMPY_DTYPE(optipricer::portfolio::ExpiryRollup, underlying, time_to_maturity, num_legs,
+                          value, delta, gamma, vega, theta, rho, vanna, volga, charm);
+
+     py::class_<optipricer::portfolio::BookGreeks> book_greeks(portfolio, "BookGreeks",
+                                                               "Quantity-weighted value and Greeks of a set of legs");
+     bind_record_fields(book_greeks, "BookGreeks", BOOK_GREEKS_FIELDS);
+
+     py::class_<optipricer::portfolio::PortfolioRisk>(portfolio, "PortfolioRisk",
+                                                      "Book total with rollups by underlying and by expiry")
+          .def_readonly("total", &optipricer::portfolio::PortfolioRisk::total)
+          .def_property_readonly("by_underlying", [](const optipricer::portfolio::PortfolioRisk &risk) {
+               py::array_t<optipricer::portfolio::BookGreeks> out(static_cast<py::ssize_t>(risk.by_underlying.size()));
+               std::copy(risk.by_underlying.begin(), risk.by_underlying.end(), out.mutable_data());
+               return out;
+          }, "Structured array indexed by underlying id, with the BookGreeks fields")
+          .def_property_readonly("by_expiry", [](const optipricer::portfolio::PortfolioRisk &risk) {
+               py::array_t<optipricer::portfolio::ExpiryRollup> out(static_cast<py::ssize_t>(risk.by_expiry.size()));
+               std::copy(risk.by_expiry.begin(), risk.by_expiry.end(), out.mutable_data());
+               return out;
+          }, "Structured array with one row per (underlying, time_to_maturity) group, sorted by both")
+          .def("__repr__", [](const optipricer::portfolio::PortfolioRisk &risk) {
+               return "PortfolioRisk(value=" + format_double(risk.total.value, 6) +
+                      ", underlyings=" + std::to_string(risk.by_underlying.size()) +
+                      ", expiries=" + std::to_string(risk.by_expiry.size()) + ")";
+          });
+
+     py::enum_<optipricer::portfolio::ScenarioMode>(portfolio, "ScenarioMode", "How each scenario cell is valued")
+          .value("FULL", optipricer::portfolio::ScenarioMode::FULL)
+          .value("TAYLOR", optipricer::portfolio::ScenarioMode::TAYLOR);
+
+     py::class_<optipricer::portfolio::ScenarioCube>(portfolio, "ScenarioCube",
+                                                     "Book P&L over a spot x volatility scenario ladder")
+          .def_readonly("mode", &optipricer::portfolio::ScenarioCube::mode)
+          .def_property_readonly("spot_shifts", [](py::object self) {
+               const auto &cube = self.cast<const optipricer::portfolio::ScenarioCube &>();
+               return readonly_view(self, cube.spot_shifts.data(), {static_cast<py::ssize_t>(cube.num_spot_shifts())});
+          })
+          .def_property_readonly("vol_shifts", [](py::object self) {
+               const auto &cube = self.cast<const optipricer::portfolio::ScenarioCube &>();
+               return readonly_view(self, cube.vol_shifts.data(), {static_cast<py::ssize_t>(cube.num_vol_shifts())});
+          })
+          .def_property_readonly("base_values", [](py::object self) {
+               const auto &cube = self.cast<const optipricer::portfolio::ScenarioCube &>();
+               return readonly_view(self, cube.base_values.data(), {static_cast<py::ssize_t>(cube.num_underlyings())});
+          }, "Unshocked value of each underlying's legs")
+          .def_property_readonly("pnl", [](py::object self) {
+               const auto &cube = self.cast<const optipricer::portfolio::ScenarioCube &>();
+               return readonly_view(self, cube.pnl.data(),
+                                    {static_cast<py::ssize_t>(cube.num_underlyings()),
+                                     static_cast<py::ssize_t>(cube.num_spot_shifts()),
+                                     static_cast<py::ssize_t>(cube.num_vol_shifts())});
+          }, "P&L of shape (underlyings, len(spot_shifts), len(vol_shifts))")
+          .def_property_readonly("total", [](const optipricer::portfolio::ScenarioCube &cube) {
+               py::array_t<double> out({static_cast<py::ssize_t>(cube.num_spot_shifts()),
+                                        static_cast<py::ssize_t>(cube.num_vol_shifts())});
+               double *dst = out.mutable_data();
+               for (std::size_t i = 0; i < cube.num_spot_shifts(); ++i) {
+                    for (std::size_t j = 0; j < cube.num_vol_shifts(); ++j) {
+                         dst[i * cube.num_vol_shifts() + j] = cube.total(i, j);
+                    }
+               }
+               return out;
+          }, "Book-wide P&L of shape (len(spot_shifts), len(vol_shifts))")
+          .def("__repr__", [](const optipricer::portfolio::ScenarioCube &cube) {
+               return std::string("ScenarioCube(mode=") +
+                      (cube.mode == optipricer::portfolio::ScenarioMode::FULL ? "FULL" : "TAYLOR") +
+                      ", underlyings=" + std::to_string(cube.num_underlyings()) +
+                      ", spot_shifts=" + std::to_string(cube.num_spot_shifts()) +
+                      ", vol_shifts=" + std::to_string(cube.num_vol_shifts()) + ")";
+          });
+
+     auto scenario_ladder = [](const optipricer::portfolio::Portfolio &book, ArrayIn<double> spot_shifts,
+                               ArrayIn<double> vol_shifts, optipricer::portfolio::ScenarioMode mode) {
+          if (spot_shifts.ndim() > 1 || vol_shifts.ndim() > 1) {
+               throw std::invalid_argument("spot_shifts and vol_shifts must be scalars or 1-D arrays");
+          }
+          py::gil_scoped_release release;
+          return book.scenarios(spot_shifts.data(), static_cast<std::size_t>(spot_shifts.size()), vol_shifts.data(),
+                                static_cast<std::size_t>(vol_shifts.size()), mode);
+     };
+
+     py::class_<optipricer::var::VaRResult>(portfolio, "VaRResult",
+                                            "Historical and parametric VaR / expected shortfall of scenario P&L")
+          .def_readonly("confidence", &optipricer::var::VaRResult::confidence)
+          .def_readonly("num_scenarios", &optipricer::var::VaRResult::num_scenarios)
+          .def_readonly("tail_size", &optipricer::var::VaRResult::tail_size)
+          .def_readonly("var_scenario", &optipricer::var::VaRResult::var_scenario)
+          .def_readonly("value_at_risk", &optipricer::var::VaRResult::value_at_risk)
+          .def_readonly("expected_shortfall", &optipricer::var::VaRResult::expected_shortfall)
+          .def_readonly("parametric_var", &optipricer::var::VaRResult::parametric_var)
+          .def_readonly("parametric_es", &optipricer::var::VaRResult::parametric_es)
+          .def_readonly("mean_pnl", &optipricer::var::VaRResult::mean_pnl)
+          .def_readonly("pnl_stddev", &optipricer::var::VaRResult::pnl_stddev)
+          .def_property_readonly("var_contributions", [](py::object self) {
+               const auto &r = self.cast<const optipricer::var::VaRResult &>();
+               return readonly_view(self, r.var_contributions.data(), {static_cast<py::ssize_t>(r.num_underlyings)});
+          }, "Each underlying's loss in the VaR scenario; sums to value_at_risk")
+          .def_property_readonly("es_contributions", [](py::object self) {
+               const auto &r = self.cast<const optipricer::var::VaRResult &>();
+               return readonly_view(self, r.es_contributions.data(), {static_cast<py::ssize_t>(r.num_underlyings)});
+          }, "Each underlying's mean loss over the tail; sums to expected_shortfall")
+          .def_property_readonly("pnl", [](py::object self) {
+               const auto &r = self.cast<const optipricer::var::VaRResult &>();
+               return readonly_view(self, r.pnl.data(), {static_cast<py::ssize_t>(r.num_scenarios)});
+          }, "Book P&L per scenario")
+          .def_property_readonly("pnl_by_underlying", [](py::object self) {
+               const auto &r = self.cast<const optipricer::var::VaRResult &>();
+               return readonly_view(self, r.pnl_by_underlying.data(),
+                                    {static_cast<py::ssize_t>(r.num_scenarios), static_cast<py::ssize_t>(r.num_underlyings)});
+          }, "P&L of shape (scenarios, underlyings)")
+          .def("__repr__", [](const optipricer::var::VaRResult &r) {
+               return "VaRResult(confidence=" + format_double(r.confidence, 4) +
+                      ", value_at_risk=" + format_double(r.value_at_risk, 6) +
+                      ", expected_shortfall=" + format_double(r.expected_shortfall, 6) +
+                      ", scenarios=" + std::to_string(r.num_scenarios) + ")";
+          });
+
+     // Shocks as (scenarios, underlyings) rows; a 1-D array shocks every underlying alike
+     auto scenario_shocks = [](const optipricer::portfolio::Portfolio &book, const char *name, ArrayIn<double> shocks,
+                               std::size_t expected_rows) {
+          const std::size_t nu = book.num_underlyings();
+          if (shocks.ndim() == 2 && static_cast<std::size_t>(shocks.shape(1)) == nu) {
+               const std::size_t rows = static_cast<std::size_t>(shocks.shape(0));
+               if (expected_rows != static_cast<std::size_t>(-1) && rows != expected_rows) {
+                    throw std::invalid_argument(std::string(name) + " has " + std::to_string(rows) +
+                                                " scenarios but spot_shocks has " + std::to_string(expected_rows));
+               }
+               return std::vector<double>(shocks.data(), shocks.data() + rows * nu);
+          }
+          if (shocks.ndim() == 1) {
+               const std::size_t rows = static_cast<std::size_t>(shocks.shape(0));
+               if (expected_rows != static_cast<std::size_t>(-1) && rows != expected_rows) {
+                    throw std::invalid_argument(std::string(name) + " has " + std::to_string(rows) +
+                                                " scenarios but spot_shocks has " + std::to_string(expected_rows));
+               }
+               std::vector<double> out(rows * nu);
+               for (std::size_t s = 0; s < rows; ++s) {
+                    std::fill(out.begin() + static_cast<std::ptrdiff_t>(s * nu),
+                              out.begin() + static_cast<std::ptrdiff_t>((s + 1) * nu), shocks.data()[s]);
+               }
+               return out;
+          }
+          throw std::invalid_argument(std::string(name) + " must have shape (scenarios,) or (scenarios, " +
+                                      std::to_string(nu) + ")");
+     };
+
+     py::class_<optipricer::portfolio::Portfolio>(portfolio, "Portfolio")
+          .def(py::init<double>(), py::arg("risk_free_rate") = 0.0)
+          .def("add_underlying", &optipricer::portfolio::Portfolio::add_underlying,
+               "Register an underlying and return its integer id",
+               py::arg("underlying_price"), py::arg("dividend_yield") = 0.0)
+          .def("add_leg", &optipricer::portfolio::Portfolio::add_leg,
+               "Add one leg; quantity is signed (negative for short)",
+               py::arg("underlying"), py::arg("strike"), py::arg("time_to_maturity"), py::arg("volatility"),
+               py::arg("quantity"), py::arg("is_call") = true)
+          .def("add_legs",
+               [](optipricer::portfolio::Portfolio &book, ArrayIn<std::size_t> underlying, ArrayIn<double> strike,
+                  ArrayIn<double> T, ArrayIn<double> volatility, ArrayIn<double> quantity, ArrayIn<bool> is_call) {
+                    auto shape = broadcast_shape({{"underlying", underlying}, {"strike", strike}, {"time_to_maturity", T},
+                                                  {"volatility", volatility}, {"quantity", quantity}, {"is_call", is_call}});
+                    py::gil_scoped_release release;
+                    book.add_legs(as_column(underlying), as_column(strike), as_column(T), as_column(volatility),
+                                  as_column(quantity), as_column(is_call), shape_size(shape));
+               },
+               "Append many legs from arrays (scalars broadcast); nothing is added if any leg is invalid",
+               py::arg("underlying"), py::arg("strike"), py::arg("time_to_maturity"), py::arg("volatility"),
+               py::arg("quantity"), py::arg("is_call") = true)
+          .def("set_underlying_price", &optipricer::portfolio::Portfolio::set_underlying_price,
+               py::arg("underlying"), py::arg("underlying_price"))
+          .def("set_risk_free_rate", &optipricer::portfolio::Portfolio::set_risk_free_rate, py::arg("risk_free_rate"))
+          .def("valuate", &optipricer::portfolio::Portfolio::valuate,
+               "Value the whole book in one pass: total, per-underlying and per-expiry aggregates",
+               py::call_guard<py::gil_scoped_release>())
+          .def("scenarios", scenario_ladder,
+               "P&L cube over relative spot shifts x absolute volatility shifts\n\n"
+               "Every underlying moves by the same relative shift (0.05 = +5%); every leg's\n"
+               "volatility by the same absolute shift (0.01 = +1 vol point), floored at zero.\n"
+               "FULL reprices every leg per cell; TAYLOR uses the book's delta, gamma, vega,\n"
+               "vanna and volga.",
+               py::arg("spot_shifts"), py::arg("vol_shifts"),
+               py::arg("mode") = optipricer::portfolio::ScenarioMode::FULL)
+          .def("scenario_pnl",
+               [scenario_shocks](const optipricer::portfolio::Portfolio &book, ArrayIn<double> spot_shocks,
+                                 py::object vol_shocks, double horizon, optipricer::portfolio::ScenarioMode mode) {
+                    const std::size_t nu = book.num_underlyings();
+                    std::vector<double> spot = scenario_shocks(book, "spot_shocks", spot_shocks, static_cast<std::size_t>(-1));
+                    const std::size_t n = nu > 0 ? spot.size() / nu : 0;
+                    std::vector<double> vol;
+                    if (!vol_shocks.is_none()) {
+                         vol = scenario_shocks(book, "vol_shocks", vol_shocks.cast<ArrayIn<double>>(), n);
+                    }
+                    py::array_t<double> out({static_cast<py::ssize_t>(n), static_cast<py::ssize_t>(nu)});
+                    double *dst = out.mutable_data();
+                    {
+                         py::gil_scoped_release release;
+                         book.scenario_pnl(spot.data(), vol.empty() ? nullptr : vol.data(), n, horizon, mode, dst);
+                    }
+                    return out;
+               },
+               "P&L per historical scenario and underlying\n\n"
+               "spot_shocks (relative) and vol_shocks (absolute, optional) have shape\n"
+               "(scenarios, underlyings), or (scenarios,) to shock every underlying alike;\n"
+               "horizon (years) brings every expiry closer, so theta is included.\n\n"
+               "Returns:\n"
+               "  numpy array of shape (scenarios, underlyings)",
+               py::arg("spot_shocks"), py::arg("vol_shocks") = py::none(), py::arg("horizon") = 0.0,
+               py::arg("mode") = optipricer::portfolio::ScenarioMode::FULL)
+          .def("value_at_risk",
+               [scenario_shocks](const optipricer::portfolio::Portfolio &book, ArrayIn<double> spot_shocks,
+                                 py::object vol_shocks, double confidence, double horizon,
+                                 optipricer::portfolio::ScenarioMode mode) {
+                    const std::size_t nu = book.num_underlyings();
+                    std::vector<double> spot = scenario_shocks(book, "spot_shocks", spot_shocks, static_cast<std::size_t>(-1));
+                    const std::size_t n = nu > 0 ? spot.size() / nu : 0;
+                    std::vector<double> vol;
+                    if (!vol_shocks.is_none()) {
+                         vol = scenario_shocks(book, "vol_shocks", vol_shocks.cast<ArrayIn<double>>(), n);
+                    }
+                    py::gil_scoped_release release;
+                    return optipricer::var::historical_var(book, spot.data(), vol.empty() ? nullptr : vol.data(), n,
+                                                           confidence, horizon, mode);
+               },
+               "Historical and parametric (normal) VaR / ES over scenario shocks, with per-underlying contributions\n\n"
+               "Shocks are laid out as in scenario_pnl; scenarios stream through in blocks, so\n"
+               "memory does not grow with legs x scenarios.",
+               py::arg("spot_shocks"), py::arg("vol_shocks") = py::none(), py::arg("confidence") = 0.99,
+               py::arg("horizon") = 0.0, py::arg("mode") = optipricer::portfolio::ScenarioMode::FULL)
+          .def_static("from_strategy", &optipricer::portfolio::Portfolio::from_strategy,
+                      "One-underlying book holding a strategy's legs as European options", py::arg("strategy"))
+          .def("__len__", &optipricer::portfolio::Portfolio::size)
+          .def("num_underlyings", &optipricer::portfolio::Portfolio::num_underlyings)
+          .def("num_expiries", &optipricer::portfolio::Portfolio::num_expiries)
+          .def("get_risk_free_rate", &optipricer::portfolio::Portfolio::get_risk_free_rate)
+          .def("get_underlying_price", &optipricer::portfolio::Portfolio::get_underlying_price, py::arg("underlying"))
+          .def("get_dividend_yield", &optipricer::portfolio::Portfolio::get_dividend_yield, py::arg("underlying"))
+          .def("__repr__", [](const optipricer::portfolio::Portfolio &book) {
+               return "Portfolio(legs=" + std::to_string(book.size()) +
+                      ", underlyings=" + std::to_string(book.num_underlyings()) +
+                      ", risk_free_rate=" + format_double(book.get_risk_free_rate()) + ")";
+          });
+
+     // Streaming submodule
+     py::module_ stream = m.def_submodule("stream", "Coalescing quote-to-Greeks pipeline for live feeds");
+
+     py::tuple stream_column_names(optipricer::stream::NUM_COLUMNS);
+     for (std::size_t c = 0; c < optipricer::stream::NUM_COLUMNS; ++c) {
+          stream_column_names[c] = optipricer::stream::COLUMN_NAMES[c];
+     }
+     stream.attr("COLUMN_NAMES") = stream_column_names;
+
+     auto stream_updated = [](const optipricer::stream::TickPipeline &pipe) {
+          const std::vector<std::uint32_t> &ids = pipe.updated();
+          py::array_t<std::int64_t> out(static_cast<py::ssize_t>(ids.size()));
+          std::copy(ids.begin(), ids.end(), out.mutable_data());
+          return out;
+     };
+
+     py::class_<optipricer::stream::TickPipeline>(stream, "TickPipeline")
+          .def(py::init<double, std::size_t, double, int>(),
+               "Preallocate a pipeline for up to capacity contracts sharing one risk-free rate",
+               py::arg("risk_free_rate"), py::arg("capacity"), py::arg("tol") = 1e-6, py::arg("max_iter") = 100)
+          .def("add_contract", &optipricer::stream::TickPipeline::add_contract,
+               "Register a contract and return its integer id",
+               py::arg("strike"), py::arg("time_to_maturity"), py::arg("is_call") = true,
+               py::arg("dividend_yield") = 0.0)
+          .def("add_contracts",
+               [](optipricer::stream::TickPipeline &pipe, ArrayIn<double> strike, ArrayIn<double> T,
+                  ArrayIn<bool> is_call, ArrayIn<double> q) {
+                    auto shape = broadcast_shape({{"strike", strike}, {"time_to_maturity", T},
+                                                  {"is_call", is_call}, {"dividend_yield", q}});
+                    const std::size_t n = shape_size(shape);
+                    if (pipe.size() + n > pipe.capacity()) {
+                         throw std::invalid_argument("Adding " + std::to_string(n) + " contracts exceeds capacity " +
+                                                     std::to_string(pipe.capacity()));
+                    }
+                    auto K = as_column(strike), expiry = as_column(T), dividend = as_column(q);
+                    auto call = as_column(is_call);
+                    for (std::size_t i = 0; i < n; ++i) {
+                         optipricer::models::BlackScholesModel checked(K[i], 0.2, pipe.get_risk_free_rate(), expiry[i],
+                                                                       K[i], dividend[i]);
+                         (void)checked;
+                    }
+                    py::array_t<std::int64_t> ids(static_cast<py::ssize_t>(n));
+                    std::int64_t *dst = ids.mutable_data();
+                    for (std::size_t i = 0; i < n; ++i) {
+                         dst[i] = static_cast<std::int64_t>(pipe.add_contract(K[i], expiry[i], call[i], dividend[i]));
+                    }
+                    return ids;
+               },
+               "Register many contracts from arrays (scalars broadcast) and return their ids;\n"
+               "nothing is added if any contract is invalid",
+               py::arg("strike"), py::arg("time_to_maturity"), py::arg("is_call") = true,
+               py::arg("dividend_yield") = 0.0)
+          .def("push",
+               [](optipricer::stream::TickPipeline &pipe, std::size_t id, double bid, double ask, double spot) {
+                    pipe.push(id, bid, ask, spot);
+               },
+               "Record the latest quote of one contract; replaces any update not yet processed",
+               py::arg("instrument"), py::arg("bid"), py::arg("ask"), py::arg("spot"))
+          .def("push_many",
+               [](optipricer::stream::TickPipeline &pipe, ArrayIn<std::size_t> ids, ArrayIn<double> bid,
+                  ArrayIn<double> ask, ArrayIn<double> spot) {
+                    auto shape = broadcast_shape({{"instrument", ids}, {"bid", bid}, {"ask", ask}, {"spot", spot}});
+                    py::gil_scoped_release release;
+                    pipe.push(as_column(ids), as_column(bid), as_column(ask), as_column(spot), shape_size(shape));
+               },
+               "push() for arrays of updates (scalars broadcast, e.g. one spot for every contract)",
+               py::arg("instrument"), py::arg("bid"), py::arg("ask"), py::arg("spot"))
+          .def("process",
+               [stream_updated](optipricer::stream::TickPipeline &pipe, double interval, py::object callback) {
+                    {
+                         py::gil_scoped_release release;
+                         pipe.process_after(interval);
+                    }
+                    py::array_t<std::int64_t> ids = stream_updated(pipe);
+                    if (!callback.is_none() && ids.size() > 0) {
+                         callback(ids);
+                    }
+                    return ids;
+               },
+               "Drain pending updates and re-solve IV and Greeks for every contract whose mid or spot moved\n\n"
+               "With interval > 0, first sleeps (GIL released) until interval seconds after the\n"
+               "previous batch, so updates arriving meanwhile coalesce into this one. Solved\n"
+               "values land in the column views in place.\n\n"
+               "Returns:\n"
+               "  numpy int64 array of the re-solved contract ids, also passed to callback(ids)\n"
+               "  when there are any",
+               py::arg("interval") = 0.0, py::arg("callback") = py::none())
+          .def("updated", stream_updated, "Contract ids re-solved by the last process()")
+          .def("column",
+               [](py::object self, const std::string &name) {
+                    const auto &pipe = self.cast<const optipricer::stream::TickPipeline &>();
+                    for (std::size_t k = 0; k < optipricer::stream::NUM_COLUMNS; ++k) {
+                         if (name == optipricer::stream::COLUMN_NAMES[k]) {
+                              return readonly_view(self, pipe.column(k), {static_cast<py::ssize_t>(pipe.size())});
+                         }
+                    }
+                    throw py::key_error("Unknown stream column: '" + name + "'");
+               },
+               "Read-only view of one column over the contracts registered so far (no copy)", py::arg("name"))
+          .def("columns",
+               [](py::object self) {
+                    const auto &pipe = self.cast<const optipricer::stream::TickPipeline &>();
+                    py::dict out;
+                    for (std::size_t k = 0; k < optipricer::stream::NUM_COLUMNS; ++k) {
+                         out[optipricer::stream::COLUMN_NAMES[k]] =
+                              readonly_view(self, pipe.column(k), {static_cast<py::ssize_t>(pipe.size())});
+                    }
+                    return out;
+               },
+               "Dict of read-only column views keyed by COLUMN_NAMES (no copy)")
+          .def("values",
+               [](py::object self) {
+                    const auto &pipe = self.cast<const optipricer::stream::TickPipeline &>();
+                    return readonly_view(self, pipe.data(),
+                                         {static_cast<py::ssize_t>(optipricer::stream::NUM_COLUMNS),
+                                          static_cast<py::ssize_t>(pipe.size())},
+                                         {static_cast<py::ssize_t>(pipe.capacity() * sizeof(double)),
+                                          static_cast<py::ssize_t>(sizeof(double))});
+               },
+               "Read-only (len(COLUMN_NAMES), n) view of the column block (no copy)")
+          .def("status",
+               [](py::object self) {
+                    const auto &pipe = self.cast<const optipricer::stream::TickPipeline &>();
+                    return readonly_view(self, pipe.status(), {static_cast<py::ssize_t>(pipe.size())});
+               },
+               "Read-only int8 view of each contract's models.IVStatus (no copy)")
+          .def("__len__", &optipricer::stream::TickPipeline::size)
+          .def_property_readonly("capacity", &optipricer::stream::TickPipeline::capacity)
+          .def_property_readonly("risk_free_rate", &optipricer::stream::TickPipeline::get_risk_free_rate)
+          .def_property_readonly("pending", &optipricer::stream::TickPipeline::pending,
+                                 "Contracts with an update not yet processed")
+          .def_property_readonly("updates_received", &optipricer::stream::TickPipeline::updates_received)
+          .def_property_readonly("updates_coalesced", &optipricer::stream::TickPipeline::updates_coalesced,
+                                 "Updates that replaced a still-pending quote instead of adding work")
+          .def_property_readonly("num_batches", &optipricer::stream::TickPipeline::num_batches)
+          .def_property_readonly("num_solves", &optipricer::stream::TickPipeline::num_solves)
+          .def_property_readonly("num_unchanged", &optipricer::stream::TickPipeline::num_unchanged,
+                                 "Processed updates whose mid and spot had not moved")
+          .def("__repr__", [](const optipricer::stream::TickPipeline &pipe) {
+               return "TickPipeline(contracts=" + std::to_string(pipe.size()) +
+                      ", capacity=" + std::to_string(pipe.capacity()) +
+                      ", pending=" + std::to_string(pipe.pending()) + ")";
+          });
+
+     // Snapshot submodule
+     py::module_ snapshot = m.def_submodule("snapshot", "Memory-mapped columnar option chain snapshots");
+
+     py::tuple snapshot_column_names(optipricer::snapshot::NUM_COLUMNS);
+     for (std::size_t c = 0; c < optipricer::snapshot::NUM_COLUMNS; ++c) {
+          snapshot_column_names[c] = optipricer::snapshot::COLUMN_NAMES[c];
+     }
+     snapshot.attr("COLUMN_NAMES") = snapshot_column_names;
+     snapshot.attr("FORMAT_VERSION") = optipricer::snapshot::FORMAT_VERSION;
+
+     auto snapshot_column = [](const optipricer::snapshot::ExpiryView &x, const std::string &name) {
+          for (std::size_t k = 0; k < optipricer::snapshot::NUM_COLUMNS; ++k) {
+               if (name == optipricer::snapshot::COLUMN_NAMES[k]) {
+                    return k;
+               }
+          }
+          throw py::key_error("Unknown snapshot column: '" + name + "'");
+     };
+
+     py::class_<optipricer::snapshot::ChainSnapshot>(snapshot, "ChainSnapshot",
+                                                     "One chain snapshot inside a mapped file; columns are views, not copies")
+          .def_property_readonly("timestamp", &optipricer::snapshot::ChainSnapshot::get_timestamp)
+          .def_property_readonly("underlying_price", &optipricer::snapshot::ChainSnapshot::get_underlying_price)
+          .def_property_readonly("risk_free_rate", &optipricer::snapshot::ChainSnapshot::get_risk_free_rate)
+          .def_property_readonly("dividend_yield", &optipricer::snapshot::ChainSnapshot::get_dividend_yield)
+          .def("__len__", &optipricer::snapshot::ChainSnapshot::num_expiries)
+          .def("num_quotes", &optipricer::snapshot::ChainSnapshot::num_quotes)
+          .def("expiries",
+               [](const optipricer::snapshot::ChainSnapshot &snap) {
+                    py::array_t<double> out(static_cast<py::ssize_t>(snap.num_expiries()));
+                    for (std::size_t e = 0; e < snap.num_expiries(); ++e) {
+                         out.mutable_data()[e] = snap.expiry(e).time_to_maturity;
+                    }
+                    return out;
+               },
+               "Times to maturity, ascending")
+          .def("column",
+               [snapshot_column](py::object self, std::size_t expiry, const std::string &name) {
+                    const auto x = self.cast<const optipricer::snapshot::ChainSnapshot &>().expiry(expiry);
+                    return readonly_view(self, x.column(snapshot_column(x, name)),
+                                         {static_cast<py::ssize_t>(x.num_strikes)});
+               },
+               "Read-only view of one column of one expiry, straight from the mapped file", py::arg("expiry"),
+               py::arg("name"))
+          .def("columns",
+               [](py::object self, std::size_t expiry) {
+                    const auto x = self.cast<const optipricer::snapshot::ChainSnapshot &>().expiry(expiry);
+                    py::dict out;
+                    for (std::size_t k = 0; k < optipricer::snapshot::NUM_COLUMNS; ++k) {
+                         out[optipricer::snapshot::COLUMN_NAMES[k]] =
+                              readonly_view(self, x.column(k), {static_cast<py::ssize_t>(x.num_strikes)});
+                    }
+                    return out;
+               },
+               "Dict of read-only column views of one expiry keyed by COLUMN_NAMES", py::arg("expiry"))
+          .def("to_chain_data",
+               [](py::object self) {
+                    const auto &snap = self.cast<const optipricer::snapshot::ChainSnapshot &>();
+                    py::list out;
+                    for (std::size_t e = 0; e < snap.num_expiries(); ++e) {
+                         const auto x = snap.expiry(e);
+                         const py::ssize_t n = static_cast<py::ssize_t>(x.num_strikes);
+                         py::dict entry;
+                         entry["expiry"] = x.time_to_maturity;
+                         entry["strikes"] = readonly_view(self, x.column(optipricer::snapshot::STRIKE), {n});
+                         entry["ivs"] = readonly_view(self, x.column(optipricer::snapshot::IV), {n});
+                         entry["call_prices"] = readonly_view(self, x.column(optipricer::snapshot::CALL_PRICE), {n});
+                         entry["put_prices"] = readonly_view(self, x.column(optipricer::snapshot::PUT_PRICE), {n});
+                         out.append(entry);
+                    }
+                    return out;
+               },
+               "The snapshot as VolatilitySurface.from_chain_data input, with view columns")
+          .def("surface", &optipricer::snapshot::ChainSnapshot::build_surface,
+               "Native VolatilitySurface over the union of every expiry's strikes",
+               py::call_guard<py::gil_scoped_release>())
+          .def("fit_parity", &optipricer::snapshot::ChainSnapshot::fit_parity,
+               "parity.calibrate over every expiry of the snapshot, read from the mapped columns",
+               py::arg("fit_rate") = false,
+               py::arg("outlier_threshold") = optipricer::parity::DEFAULT_OUTLIER_THRESHOLD,
+               py::call_guard<py::gil_scoped_release>())
+          .def("__repr__", [](const optipricer::snapshot::ChainSnapshot &snap) {
+               return "ChainSnapshot(timestamp=" + format_double(snap.get_timestamp(), 3) +
+                      ", underlying_price=" + format_double(snap.get_underlying_price()) +
+                      ", expiries=" + std::to_string(snap.num_expiries()) +
+                      ", quotes=" + std::to_string(snap.num_quotes()) + ")";
+          });
+
+     auto snapshot_index = [](const optipricer::snapshot::SnapshotReader &reader, py::ssize_t i) {
+          const auto n = static_cast<py::ssize_t>(reader.size());
+          if (i < 0) {
+               i += n;
+          }
+          if (i < 0 || i >= n) {
+               throw py::index_error("Snapshot index out of range for " + std::to_string(n) + " snapshots");
+          }
+          return static_cast<std::size_t>(i);
+     };
+
+     py::class_<optipricer::snapshot::SnapshotReader>(snapshot, "SnapshotReader")
+          .def(py::init<const std::string &>(), "Memory-map a snapshot file written by SnapshotWriter",
+               py::arg("path"))
+          .def("__len__", &optipricer::snapshot::SnapshotReader::size)
+          .def("__getitem__",
+               [snapshot_index](const optipricer::snapshot::SnapshotReader &reader, py::ssize_t i) {
+                    return reader.at(snapshot_index(reader, i));
+               },
+               py::arg("index"))
+          .def("find", &optipricer::snapshot::SnapshotReader::find,
+               "Index of the last snapshot taken at or before timestamp", py::arg("timestamp"))
+          .def("timestamps",
+               [](const optipricer::snapshot::SnapshotReader &reader) {
+                    py::array_t<double> out(static_cast<py::ssize_t>(reader.size()));
+                    double *dst = out.mutable_data();
+                    py::gil_scoped_release release;
+                    for (std::size_t i = 0; i < reader.size(); ++i) {
+                         dst[i] = reader.timestamp(i);
+                    }
+                    return out;
+               },
+               "Timestamp of every snapshot")
+          .def("surface_series",
+               [](const optipricer::snapshot::SnapshotReader &reader, ArrayIn<double> strikes, ArrayIn<double> expiries,
+                  std::size_t start, py::object stop) {
+                    auto shape = broadcast_shape({{"strikes", strikes}, {"expiries", expiries}});
+                    const std::size_t n = shape_size(shape);
+                    const std::size_t end = stop.is_none() ? reader.size() : stop.cast<std::size_t>();
+                    if (start > end || end > reader.size()) {
+                         throw py::index_error("Snapshot range out of range for " + std::to_string(reader.size()) +
+                                               " snapshots");
+                    }
+                    std::vector<double> K(n), T(n);
+                    auto k = as_column(strikes), t = as_column(expiries);
+                    for (std::size_t i = 0; i < n; ++i) {
+                         K[i] = k[i];
+                         T[i] = t[i];
+                    }
+                    py::array_t<double> out({static_cast<py::ssize_t>(end - start), static_cast<py::ssize_t>(n)});
+                    double *dst = out.mutable_data();
+                    {
+                         py::gil_scoped_release release;
+                         reader.surface_series(start, end, K.data(), T.data(), n, dst);
+                    }
+                    return out;
+               },
+               "Interpolated IV at fixed (strike, expiry) points in every snapshot of [start, stop)\n\n"
+               "Each snapshot's surface is built and queried natively, across threads.\n\n"
+               "Returns:\n"
+               "  numpy array of shape (stop - start, n) for n broadcast query points",
+               py::arg("strikes"), py::arg("expiries"), py::arg("start") = 0, py::arg("stop") = py::none())
+          .def_property_readonly("path", &optipricer::snapshot::SnapshotReader::get_path)
+          .def_property_readonly("file_size", &optipricer::snapshot::SnapshotReader::file_size)
+          .def("__repr__", [](const optipricer::snapshot::SnapshotReader &reader) {
+               return "SnapshotReader(path='" + reader.get_path() + "', snapshots=" + std::to_string(reader.size()) + ")";
+          });
+
+     py::class_<optipricer::snapshot::SnapshotWriter>(snapshot, "SnapshotWriter")
+          .def(py::init<const std::string &>(), "Create (or truncate) a snapshot file", py::arg("path"))
+          .def("append",
+               [](optipricer::snapshot::SnapshotWriter &writer, double timestamp, double S, py::sequence chain_data,
+                  double r, double q) {
+                    // Keep the converted arrays alive until the snapshot is written
+                    std::vector<ArrayIn<double>> arrays;
+                    std::vector<optipricer::snapshot::ExpiryColumns> expiries;
+                    arrays.reserve(4 * chain_data.size());
+                    for (py::handle item : chain_data) {
+                         py::dict entry = item.cast<py::dict>();
+                         auto column = [&](const char *key, std::size_t n, bool required) -> const double * {
+                              if (!entry.contains(key)) {
+                                   if (required) {
+                                        throw std::invalid_argument(std::string("chain_data entry is missing '") + key + "'");
+                                   }
+                                   return nullptr;
+                              }
+                              arrays.push_back(entry[key].cast<ArrayIn<double>>());
+                              if (n != static_cast<std::size_t>(-1) && static_cast<std::size_t>(arrays.back().size()) != n) {
+                                   throw std::invalid_argument(std::string("'") + key + "' has " +
+                                                               std::to_string(arrays.back().size()) + " entries but 'strikes' has " +
+                                                               std::to_string(n));
+                              }
+                              return arrays.back().data();
+                         };
+                         if (!entry.contains("expiry")) {
+                              throw std::invalid_argument("chain_data entry is missing 'expiry'");
+                         }
+                         optipricer::snapshot::ExpiryColumns x;
+                         x.time_to_maturity = entry["expiry"].cast<double>();
+                         x.strikes = column("strikes", static_cast<std::size_t>(-1), true);
+                         x.num_strikes = static_cast<std::size_t>(arrays.back().size());
+                         x.ivs = column("ivs", x.num_strikes, true);
+                         x.call_prices = column("call_prices", x.num_strikes, false);
+                         x.put_prices = column("put_prices", x.num_strikes, false);
+                         expiries.push_back(x);
+                    }
+                    py::gil_scoped_release release;
+                    writer.append(timestamp, S, r, q, expiries.data(), expiries.size());
+               },
+               "Append one snapshot; chain_data is a list of dicts as in VolatilitySurface.from_chain_data\n"
+               "('expiry', 'strikes', 'ivs', optionally 'call_prices' and 'put_prices'). Timestamps\n"
+               "must not decrease.",
+               py::arg("timestamp"), py::arg("underlying_price"), py::arg("chain_data"),
+               py::arg("risk_free_rate") = 0.0, py::arg("dividend_yield") = 0.0)
+          .def("close", &optipricer::snapshot::SnapshotWriter::close,
+               "Write the index and header; the file is unreadable until this runs")
+          .def("__len__", &optipricer::snapshot::SnapshotWriter::size)
+          .def("__enter__", [](py::object self) { return self; })
+          .def("__exit__", [](optipricer::snapshot::SnapshotWriter &writer, py::args) { writer.close(); });
+
      py::module_ strategies = m.def_submodule("strategies", "Options trading strategies");
 
      py::enum_<optipricer::strategies::OptionType>(strategies, "OptionType")
@@ -154,6 +2150,8 @@ PYBIND11_MODULE(_core, m)
           .def_readwrite("position_type", &optipricer::strategies::Position::position_type)
           .def_readwrite("quantity", &optipricer::strategies::Position::quantity)
           .def_readwrite("strike", &optipricer::strategies::Position::strike)
+          .def_readonly("volatility_override", &optipricer::strategies::Position::volatility_override,
+                        "Leg-specific volatility, NaN when the leg uses the strategy volatility")
           .def("__repr__", [](const optipricer::strategies::Position &p) {
                std::string o_type = (p.option_type == optipricer::strategies::OptionType::CALL) ? "OptionType.CALL" : "OptionType.PUT";
                std::string p_type = (p.position_type == optipricer::strategies::PositionType::LONG) ? "PositionType.LONG" : "PositionType.SHORT";
@@ -163,6 +2161,10 @@ PYBIND11_MODULE(_core, m)
                       ", strike=" + format_double(p.strike) + ")";
           });
 
+     py::class_<optipricer::strategies::StrategyGreeks> strategy_greeks(strategies, "StrategyGreeks",
+                                                                       "Position-weighted value and Greeks of a strategy");
+     bind_record_fields(strategy_greeks, "StrategyGreeks", STRATEGY_GREEKS_FIELDS);
+
      py::class_<optipricer::strategies::OptionsStrategy>(strategies, "OptionsStrategy")
           .def(py::init<double, double, double, double, const std::string&, double>(),
                py::arg("underlying_price"), py::arg("volatility"), py::arg("risk_free_rate"),
@@ -170,6 +2172,32 @@ PYBIND11_MODULE(_core, m)
           .def("add_position", &optipricer::strategies::OptionsStrategy::add_position,
                "Add a position to the strategy",
                py::arg("option_type"), py::arg("position_type"), py::arg("quantity"), py::arg("strike"))
+          .def("update_market", &optipricer::strategies::OptionsStrategy::update_market,
+               "Re-mark the strategy in place; existing positions and leg overrides are kept",
+               py::arg("underlying_price"), py::arg("volatility"), py::arg("risk_free_rate"),
+               py::arg("time_to_maturity"), py::arg("dividend_yield"))
+          .def("set_leg_volatility", &optipricer::strategies::OptionsStrategy::set_leg_volatility,
+               "Price one leg at its own volatility instead of the strategy volatility",
+               py::arg("index"), py::arg("volatility"))
+          .def("clear_leg_volatility", &optipricer::strategies::OptionsStrategy::clear_leg_volatility,
+               "Return one leg to the strategy volatility",
+               py::arg("index"))
+          .def("set_pde_pricing",
+               [pde_settings, no_barrier](optipricer::strategies::OptionsStrategy &strategy, bool american,
+                                          std::size_t space_steps, std::size_t time_steps) {
+                    strategy.set_pde_pricing(pde_settings(american, optipricer::pde::BarrierType::NONE, no_barrier,
+                                                          space_steps, time_steps, true));
+               },
+               "Price the legs with the Crank-Nicolson engine, one solve per distinct leg volatility",
+               py::arg("american") = true, py::arg("space_steps") = 400, py::arg("time_steps") = 200)
+          .def("set_closed_form_pricing", &optipricer::strategies::OptionsStrategy::set_closed_form_pricing,
+               "Return to Black-Scholes closed-form leg pricing")
+          .def("uses_pde_pricing", &optipricer::strategies::OptionsStrategy::uses_pde_pricing,
+               "Whether the legs are priced with the PDE engine")
+          .def("total_greeks", &optipricer::strategies::OptionsStrategy::total_greeks,
+               "Calculate the strategy value and every aggregate Greek in one pass")
+          .def("leg_greeks", &optipricer::strategies::OptionsStrategy::leg_greeks,
+               "Per-unit prices and Greeks of each leg, in position order")
           .def("total_value", &optipricer::strategies::OptionsStrategy::total_value,
                "Calculate total strategy value")
           .def("total_delta", &optipricer::strategies::OptionsStrategy::total_delta,
@@ -191,10 +2219,66 @@ PYBIND11_MODULE(_core, m)
           .def("payoff_at_expiration", &optipricer::strategies::OptionsStrategy::payoff_at_expiration,
                "Calculate payoff at expiration for given underlying price",
                py::arg("underlying_price"))
+          .def("payoff_grid",
+               [](const optipricer::strategies::OptionsStrategy &s, ArrayIn<double> S_T) {
+                    py::array_t<double> out(std::vector<py::ssize_t>(S_T.shape(), S_T.shape() + S_T.ndim()));
+                    auto n = static_cast<std::size_t>(S_T.size());
+                    const double *src = S_T.data();
+                    double *dst = out.mutable_data();
+                    {
+                         py::gil_scoped_release release;
+                         s.payoff_grid(src, dst, n);
+                    }
+                    return out;
+               },
+               "Payoff at expiration for an array of underlying prices, same shape as the input",
+               py::arg("underlying_prices"))
+          .def("value_grid",
+               [](const optipricer::strategies::OptionsStrategy &s, ArrayIn<double> spots,
+                  ArrayIn<double> vols, ArrayIn<double> times) {
+                    if (spots.ndim() > 1 || vols.ndim() > 1 || times.ndim() > 1) {
+                         throw std::invalid_argument("spots, vols and times must be scalars or 1-D arrays");
+                    }
+                    auto ns = static_cast<std::size_t>(spots.size());
+                    auto nv = static_cast<std::size_t>(vols.size());
+                    auto nt = static_cast<std::size_t>(times.size());
+                    py::array_t<double> out({static_cast<py::ssize_t>(ns), static_cast<py::ssize_t>(nv),
+                                             static_cast<py::ssize_t>(nt)});
+                    double *dst = out.mutable_data();
+                    {
+                         py::gil_scoped_release release;
+                         s.value_grid(spots.data(), ns, vols.data(), nv, times.data(), nt, dst);
+                    }
+                    return out;
+               },
+               "Strategy value over a spots x vols x times scenario lattice\n\n"
+               "times are years to expiry (0 = at expiry); r and q come from the strategy.\n"
+               "Legs with a volatility override keep their offset from the strategy vol.\n\n"
+               "Returns:\n"
+               "  numpy.ndarray of shape (len(spots), len(vols), len(times))",
+               py::arg("spots"), py::arg("vols"), py::arg("times"))
+          .def("scenarios",
+               [scenario_ladder](const optipricer::strategies::OptionsStrategy &s, ArrayIn<double> spot_shifts,
+                                 ArrayIn<double> vol_shifts, optipricer::portfolio::ScenarioMode mode) {
+                    return scenario_ladder(optipricer::portfolio::Portfolio::from_strategy(s), spot_shifts,
+                                           vol_shifts, mode);
+               },
+               "P&L cube over relative spot shifts x absolute volatility shifts (see portfolio.Portfolio.scenarios);\n"
+               "legs are valued as European options",
+               py::arg("spot_shifts"), py::arg("vol_shifts"),
+               py::arg("mode") = optipricer::portfolio::ScenarioMode::FULL)
           .def("get_positions", &optipricer::strategies::OptionsStrategy::get_positions,
                "Get all positions in the strategy")
           .def("get_name", &optipricer::strategies::OptionsStrategy::get_name,
                "Get strategy name")
+          .def("get_underlying_price", &optipricer::strategies::OptionsStrategy::get_underlying_price,
+               "Get underlying price")
+          .def("get_volatility", &optipricer::strategies::OptionsStrategy::get_volatility,
+               "Get strategy volatility")
+          .def("get_risk_free_rate", &optipricer::strategies::OptionsStrategy::get_risk_free_rate,
+               "Get risk-free rate")
+          .def("get_time_to_maturity", &optipricer::strategies::OptionsStrategy::get_time_to_maturity,
+               "Get time to maturity")
           .def("get_dividend_yield", &optipricer::strategies::OptionsStrategy::get_dividend_yield,
                "Get dividend yield")
           .def("__repr__", [](const optipricer::strategies::OptionsStrategy &s) {
@@ -520,6 +520,25 @@ def test_strategy_full_greeks():
     assert condor.total_theta() > 0.0
 
 
+def test_strategy_total_greeks_cache():
+    """total_greeks() matches the individual totals and tracks position changes."""
+    condor = optipricer.strategies.IronCondor(100.0, 0.2, 0.05, 0.5, 90.0, 95.0, 105.0, 110.0)
+    totals = condor.total_greeks()
+    for name in ('value', 'delta', 'gamma', 'vega', 'theta', 'rho', 'vanna', 'volga', 'charm'):
+        assert getattr(totals, name) == getattr(condor, 'total_' + name)()
+    assert totals.to_dict()['gamma'] == totals.gamma
+
+    legs = condor.leg_greeks()
+    assert len(legs) == 4
+    assert legs[0].put_price == pytest.approx(
+        optipricer.models.BlackScholesModel(90.0, 0.2, 0.05, 0.5, 100.0).put_price())
+
+    # Adding a leg invalidates the cache
+    condor.add_position(optipricer.strategies.OptionType.CALL, optipricer.strategies.PositionType.LONG, 1.0, 100.0)
+    assert len(condor.leg_greeks()) == 5
+    assert condor.total_value() == pytest.approx(totals.value + condor.leg_greeks()[4].call_price)
+
+
 def test_option_chain():
     """Test the OptionChain builder."""
     from optipricer.chain import OptionChain, generate_nifty_strikes
@@ -573,6 +592,46 @@ def test_option_chain():
         OptionChain(S=100.0, r=0.05, T=0.25, strikes=[], vol=0.20)
 
 
+def test_option_chain_columns():
+    """Native chain columns are zero-copy views that match the row API."""
+    import numpy as np
+    from optipricer.chain import COLUMN_NAMES, OptionChain
+
+    chain = OptionChain(S=21500.0, r=0.07, T=30 / 365, strikes=[21600.0, 21400.0, 21500.0], vol=0.16, q=0.012)
+    cols = chain.columns()
+    assert tuple(cols) == COLUMN_NAMES
+    assert list(cols['strike']) == [21400.0, 21500.0, 21600.0]
+    assert not cols['call_price'].flags.writeable
+
+    rows = chain.build()
+    for name in COLUMN_NAMES:
+        assert np.array_equal(chain.columns()[name], [row[name] for row in rows])
+
+    model = optipricer.models.BlackScholesModel(21500.0, 0.16, 0.07, 30 / 365, 21500.0, 0.012)
+    assert chain.columns()['call_price'][1] == pytest.approx(model.call_price(), abs=1e-9)
+
+    # Repricing updates existing views in place
+    cols = chain.columns()
+    before = cols['call_delta'].copy()
+    chain.update(21700.0)
+    assert np.all(cols['call_delta'] > before)
+    assert chain.summary()['atm_strike'] == 21600.0
+
+    # build() reprices the same native chain when only S moved, so views stay live
+    chain.S = 21800.0
+    chain.build()
+    moved = optipricer.models.BlackScholesModel(21500.0, 0.16, 0.07, 30 / 365, 21800.0, 0.012)
+    assert cols['call_price'][1] == pytest.approx(moved.call_price(), abs=1e-9)
+    chain.build()
+    assert cols['call_price'][1] == pytest.approx(moved.call_price(), abs=1e-9)
+
+    # Any other input change rebuilds it; earlier views keep the old values
+    chain.q = 0.0
+    rows = chain.build()
+    assert rows[1]['call_price'] > cols['call_price'][1]
+    assert cols['call_price'][1] == pytest.approx(moved.call_price(), abs=1e-9)
+
+
 def test_volatility_surface():
     """Test the VolatilitySurface class."""
     from optipricer.surface import VolatilitySurface
@@ -633,6 +692,153 @@ def test_volatility_surface():
         VolatilitySurface([95.0, 100.0], [0.08], [[0.2]])  # Wrong number of columns
 
 
+def test_volatility_surface_native():
+    """Test unsorted input, hole filling and batch queries on the native surface."""
+    import numpy as np
+    from optipricer.surface import VolatilitySurface
+
+    # Axes given out of order; rows and columns follow the sorted axes
+    surface = VolatilitySurface(
+        [105.0, 95.0, 100.0], [0.25, 0.08],
+        [[0.20, 0.21, 0.19], [0.21, 0.22, 0.20]],
+    )
+    assert surface.strikes == [95.0, 100.0, 105.0]
+    assert surface.expiries == [0.08, 0.25]
+    assert surface.smile(0)[1] == [0.22, 0.20, 0.21]
+    assert surface.get_iv(95.0, 0.25) == pytest.approx(0.21)
+
+    # A missing quote is filled along its expiry before interpolating
+    holed = VolatilitySurface(
+        [90.0, 100.0, 110.0, 125.0], [0.1, 0.5],
+        [[0.24, float('nan'), 0.20, 0.22], [0.21, 0.19, float('nan'), 0.20]],
+    )
+    assert math.isnan(holed.smile(0)[1][1])
+    assert holed.get_iv(100.0, 0.1) == pytest.approx(0.22)
+    assert holed.get_iv(110.0, 0.5) == pytest.approx(0.19 + (0.20 - 0.19) * 10.0 / 25.0)
+
+    # Batch queries match the scalar path on uniform and non-uniform axes
+    for surf in (surface, holed):
+        K = np.linspace(80.0, 130.0, 257)
+        T = np.linspace(0.0, 0.6, 257)
+        batch = surf.get_iv_batch(K, T)
+        assert batch.shape == (257,)
+        assert np.array_equal(batch, [surf.get_iv(k, t) for k, t in zip(K, T)])
+
+    with pytest.raises(ValueError, match="no finite"):
+        VolatilitySurface([100.0], [0.1], [[float('nan')]])
+
+
+def test_volatility_surface_updates():
+    """Test in-place cell and slice updates against a full rebuild."""
+    import numpy as np
+    from optipricer.surface import VolatilitySurface
+
+    strikes = [90.0, 100.0, 110.0]
+    expiries = [0.1, 0.25, 0.5]
+    iv = [[0.24, 0.22, 0.23], [float('nan')] * 3, [0.21, 0.20, 0.205]]
+    surface = VolatilitySurface(strikes, expiries, iv)
+    assert surface.version == 0
+
+    surface.update(100.0, 0.1, 0.25)
+    surface.update_many([90.0, 110.0], 0.5, [0.22, float('nan')])
+    surface.update_slice(0.25, [0.23, 0.21], strikes=[90.0, 110.0])
+    assert surface.version == 3
+    # Rows an update did not touch are shared with the previous version and keep theirs
+    assert [surface._native.slice_version(e) for e in range(3)] == [1, 3, 2]
+
+    expected = [[0.24, 0.25, 0.23], [0.23, float('nan'), 0.21], [0.22, 0.20, float('nan')]]
+    rebuilt = VolatilitySurface(strikes, expiries, expected)
+    assert np.array_equal(surface._native.filled_ivs(), rebuilt._native.filled_ivs())
+    assert math.isnan(surface.iv_matrix[1][1])
+
+    # An empty row is re-filled, and its version advances, when a quoted neighbour changes
+    gapped = VolatilitySurface(strikes, [0.1, 0.25, 0.5, 1.0], [iv[0], iv[1], iv[2], [0.2] * 3])
+    gapped.update_slice(1.0, [0.19] * 3)
+    assert [gapped._native.slice_version(e) for e in range(4)] == [0, 0, 0, 1]
+    before = gapped._native.filled_ivs()[1].copy()
+    gapped.update_slice(0.5, [0.25] * 3)
+    assert [gapped._native.slice_version(e) for e in range(4)] == [0, 2, 2, 1]
+    assert not np.array_equal(gapped._native.filled_ivs()[1], before)
+    assert np.array_equal(
+        gapped._native.filled_ivs(),
+        VolatilitySurface(strikes, [0.1, 0.25, 0.5, 1.0], [iv[0], iv[1], [0.25] * 3, [0.19] * 3])._native.filled_ivs(),
+    )
+
+    # Failed updates leave the surface untouched
+    with pytest.raises(ValueError, match="not on the surface grid"):
+        surface.update(105.0, 0.1, 0.2)
+    with pytest.raises(ValueError):
+        surface.update_slice(0.1, [0.2, 0.2])
+    assert surface.version == 3
+
+    # Readers running beside a writer always see one complete version of a row
+    import threading
+    live = VolatilitySurface(strikes, expiries, [[0.2] * 3] * 3)
+    stop = threading.Event()
+    torn = []
+
+    def read():
+        while not stop.is_set():
+            row = live.get_iv_batch(strikes, 0.1)
+            if not np.all(row == row[0]):
+                torn.append(row)
+
+    readers = [threading.Thread(target=read) for _ in range(2)]
+    for t in readers:
+        t.start()
+    for i in range(2000):
+        live.update_slice(0.1, [0.2 + 1e-4 * i] * 3)
+    stop.set()
+    for t in readers:
+        t.join()
+    assert not torn
+    assert live.version == 2000
+
+
+def test_svi_surface_fit():
+    """Test SVI/SSVI calibration against an exact SSVI surface."""
+    import numpy as np
+    from optipricer.chain import OptionChain
+    from optipricer.surface import SmileModel, SviSurface, VolatilitySurface, fit_slice
+
+    S, r, q = 100.0, 0.03, 0.01
+    rho, eta, gamma = -0.6, 1.2, 0.4
+    strikes = np.arange(70.0, 131.0, 3.0)
+    expiries = np.array([0.1, 0.25, 0.5, 1.0])
+    T, K = np.meshgrid(expiries, strikes, indexing='ij')
+    theta = 0.04 * T
+    phi = eta * theta ** -gamma
+    k = np.log(K / (S * np.exp((r - q) * T)))
+    w = 0.5 * theta * (1 + rho * phi * k + np.sqrt((phi * k + rho) ** 2 + 1 - rho ** 2))
+    iv = np.sqrt(w / T)
+
+    # Both parameterizations recover an exact SSVI surface
+    for model in (SmileModel.SVI, SmileModel.SSVI):
+        svi = SviSurface.from_quotes(S, r, T.ravel(), K.ravel(), iv.ravel(), q, model)
+        assert len(svi) == 4
+        fitted = svi.get_iv_batch(K.ravel(), T.ravel())
+        assert np.max(np.abs(fitted - iv.ravel())) < 1e-6
+        assert all(s.rmse < 1e-6 and s.params.min_variance() >= 0 for s in svi.slices())
+
+    # Price quotes go through the batch IV solver first
+    price = np.where(K >= S, optipricer.price(S, K, r, T, iv, q, 'call'), optipricer.price(S, K, r, T, iv, q, 'put'))
+    from_prices = SviSurface.from_prices(S, r, T.ravel(), K.ravel(), price.ravel(), (K >= S).ravel(), q)
+    assert from_prices.get_iv(100.0, 0.25) == pytest.approx(svi.get_iv(100.0, 0.25), abs=1e-6)
+
+    # Grid surface -> fitted smile -> chain
+    grid = VolatilitySurface(list(strikes), list(expiries), iv.tolist())
+    fitted = grid.fit_svi(S, r, q)
+    chain = OptionChain(S=S, r=r, T=0.25, strikes=list(strikes), q=q, surface=fitted)
+    assert np.allclose(chain.columns()['iv'], iv[1], atol=1e-6)
+
+    single = fit_slice(k[2], w[2], 0.5)
+    assert single.num_quotes == len(strikes)
+    assert single.params.total_variance(0.0) == pytest.approx(0.02, rel=1e-6)
+
+    with pytest.raises(ValueError, match="at least 5 quotes"):
+        SviSurface.from_quotes(S, r, 0.25, [90.0, 100.0, 110.0], [0.2, 0.19, 0.2])
+
+
 def test_facade_greeks_second_order():
     """Test that the facade greeks() function includes 2nd-order Greeks."""
     S, K, r, T, vol, q = 100.0, 105.0, 0.05, 0.25, 0.25, 0.03
@@ -673,3 +879,1108 @@ def test_surface_plot_smoke():
         assert fig2 is not None
     except ImportError:
         pytest.skip("matplotlib not installed")
+
+
+def test_price_batch():
+    """Test vectorized batch pricing against the scalar model."""
+    import numpy as np
+
+    S, r, T, vol, q = 100.0, 0.05, 0.25, 0.2, 0.01
+    strikes = np.array([90.0, 95.0, 100.0, 105.0, 110.0])
+
+    calls = optipricer.models.price_batch(S, strikes, r, T, vol, q, is_call=True)
+    puts = optipricer.models.price_batch(S, strikes, r, T, vol, q, is_call=False)
+    assert calls.shape == strikes.shape
+    for i, K in enumerate(strikes):
+        model = optipricer.models.BlackScholesModel(K, vol, r, T, S, q)
+        assert calls[i] == pytest.approx(model.call_price(), rel=1e-12)
+        assert puts[i] == pytest.approx(model.put_price(), rel=1e-12)
+
+    # Per-element option type
+    mixed = optipricer.models.price_batch(S, strikes, r, T, vol, q, is_call=np.array([True, False, True, False, True]))
+    assert mixed[1] == pytest.approx(puts[1])
+    assert mixed[2] == pytest.approx(calls[2])
+
+    # Facade accepts arrays and still returns floats for scalars
+    facade = optipricer.price(S, strikes, r, T, vol, q, option='put')
+    assert np.allclose(facade, puts)
+    assert isinstance(optipricer.price(S, 100.0, r, T, vol, q), float)
+
+    # Shape mismatch and invalid elements
+    with pytest.raises(ValueError, match="Cannot broadcast"):
+        optipricer.models.price_batch(S, strikes, r, np.array([0.1, 0.2]), vol, q)
+    with pytest.raises(ValueError, match="index 1: Strike price must be positive"):
+        optipricer.models.price_batch(S, np.array([100.0, -1.0]), r, T, vol, q)
+
+
+def test_price_delta_batch_matches_scalar():
+    """The vectorized kernel must agree with the scalar model across regimes."""
+    import numpy as np
+
+    rng = np.random.default_rng(7)
+    n = 1003  # Not a multiple of the SIMD width, exercises the remainder path
+    S = 21500.0
+    K = rng.uniform(15000.0, 28000.0, n)
+    T = rng.uniform(1.0 / 365.0, 2.0, n)
+    vol = rng.uniform(0.05, 0.8, n)
+    is_call = rng.random(n) < 0.5
+    r, q = 0.07, 0.012
+
+    price, delta = optipricer.models.price_delta_batch(S, K, r, T, vol, q, is_call)
+    for i in range(0, n, 17):
+        model = optipricer.models.BlackScholesModel(K[i], vol[i], r, T[i], S, q)
+        calc = optipricer.models.GreeksCalculator(model)
+        ref_price = model.call_price() if is_call[i] else model.put_price()
+        ref_delta = calc.call_delta() if is_call[i] else calc.put_delta()
+        assert price[i] == pytest.approx(ref_price, abs=1e-9)
+        assert delta[i] == pytest.approx(ref_delta, abs=1e-12)
+
+    # Degenerate volatility / maturity follow the scalar edge-case rules
+    edge_price, edge_delta = optipricer.models.price_delta_batch(
+        100.0, np.array([95.0, 105.0]), 0.05, 1e-12, 1e-12, 0.0, True)
+    assert edge_price[0] == pytest.approx(5.0)
+    assert edge_price[1] == pytest.approx(0.0)
+    assert edge_delta[0] == pytest.approx(1.0)
+    assert edge_delta[1] == pytest.approx(0.0)
+
+
+def test_price_delta_batch_error_bounds():
+    """The kernel stays within the error bounds documented in simd.hpp over their stated range."""
+    import numpy as np
+
+    rng = np.random.default_rng(23)
+    n = 4000
+    S = np.array([1.0, 100.0, 21000.0, 50000.0])[np.arange(n) % 4]
+    K = S * np.exp(rng.uniform(np.log(0.5), np.log(2.0), n))
+    T = np.exp(rng.uniform(np.log(1 / 365), np.log(5.0), n))
+    vol = rng.uniform(0.05, 1.5, n)
+    r = np.where(np.arange(n) % 8 < 4, 0.0, 0.065)
+    q = np.where(np.arange(n) % 16 < 8, 0.0, 0.02)
+    is_call = np.arange(n) % 32 < 16
+
+    price, delta = optipricer.models.price_delta_batch(S, K, r, T, vol, q, is_call)
+    ref_price = np.empty(n)
+    ref_delta = np.empty(n)
+    for i in range(n):
+        model = optipricer.models.BlackScholesModel(K[i], vol[i], r[i], T[i], S[i], q[i])
+        calc = optipricer.models.GreeksCalculator(model)
+        ref_price[i] = model.call_price() if is_call[i] else model.put_price()
+        ref_delta[i] = calc.call_delta() if is_call[i] else calc.put_delta()
+    assert np.max(np.abs(price - ref_price) / S) < 2e-15
+    assert np.max(np.abs(delta - ref_delta)) < 1e-15
+
+
+def test_compute_all_greeks():
+    """The fused evaluation must match every individual method, edge cases included."""
+    import numpy as np
+
+    for K, vol, T in [(110.0, 0.2, 1.0), (95.0, 1e-12, 1e-12), (105.0, 1e-12, 1e-12)]:
+        model = optipricer.models.BlackScholesModel(K, vol, 0.05, T, 100.0, 0.03)
+        calc = optipricer.models.GreeksCalculator(model)
+        g = calc.compute_all()
+        assert g.call_price == pytest.approx(model.call_price(), abs=1e-12)
+        assert g.put_price == pytest.approx(model.put_price(), abs=1e-12)
+        for name in ('call_delta', 'put_delta', 'gamma', 'vega', 'call_theta', 'put_theta',
+                     'call_rho', 'put_rho', 'vanna', 'volga', 'call_charm', 'put_charm'):
+            assert getattr(g, name) == pytest.approx(getattr(calc, name)(), abs=1e-12)
+        assert g.to_dict()['gamma'] == g.gamma
+
+    # Batch form returns a structured array with the same fields
+    strikes = np.array([95.0, 100.0, 105.0])
+    batch = optipricer.models.greeks_batch(100.0, strikes, 0.05, 0.25, 0.2, 0.01)
+    assert batch.shape == (3,)
+    single = optipricer.models.GreeksCalculator(
+        optipricer.models.BlackScholesModel(100.0, 0.2, 0.05, 0.25, 100.0, 0.01)).compute_all()
+    assert batch['vanna'][1] == pytest.approx(single.vanna)
+    assert batch['put_theta'][1] == pytest.approx(single.put_theta)
+
+    # Facade routes arrays through the batch path
+    facade = optipricer.greeks(100.0, strikes, 0.05, 0.25, 0.2, 0.01)
+    assert np.allclose(facade['gamma'], batch['gamma'])
+
+
+def test_expiry_context():
+    """Models built from a shared ExpiryContext match the ones that recompute the discount factors."""
+    expiry = optipricer.models.ExpiryContext(0.05, 0.5, 0.02)
+    assert expiry.get_discount_factor() == pytest.approx(math.exp(-0.05 * 0.5))
+    assert expiry.get_dividend_discount() == pytest.approx(math.exp(-0.02 * 0.5))
+    assert expiry.get_sqrt_time() == pytest.approx(math.sqrt(0.5))
+
+    for K in (90.0, 100.0, 115.0):
+        shared = optipricer.models.BlackScholesModel(K, 0.25, 100.0, expiry)
+        plain = optipricer.models.BlackScholesModel(K, 0.25, 0.05, 0.5, 100.0, 0.02)
+        assert shared.get_time_to_maturity() == 0.5
+        assert shared.call_price() == plain.call_price()
+        assert shared.put_price() == plain.put_price()
+        a = optipricer.models.GreeksCalculator(shared).compute_all().to_dict()
+        b = optipricer.models.GreeksCalculator(plain).compute_all().to_dict()
+        assert a == b
+
+        iv = optipricer.models.calculate_implied_volatility(plain.call_price(), K, 100.0, expiry, True)
+        assert iv == optipricer.models.calculate_implied_volatility(plain.call_price(), K, 0.05, 0.5, 100.0, 0.02, True)
+        assert iv == pytest.approx(0.25, abs=1e-5)
+
+    with pytest.raises(ValueError):
+        optipricer.models.ExpiryContext(0.05, -1.0)
+    with pytest.raises(ValueError):
+        optipricer.models.ExpiryContext(0.05, 1.0, -0.01)
+    with pytest.raises(ValueError):
+        optipricer.models.BlackScholesModel(-1.0, 0.2, 100.0, expiry)
+
+
+def test_unchecked_models():
+    """The unchecked factories skip validation and otherwise match the checked constructors."""
+    models = optipricer.models
+    expiry = models.ExpiryContext(0.065, 30 / 365, 0.012)
+    for K, vol in ((20000.0, 0.15), (21500.0, 0.3), (23000.0, 1e-12)):
+        checked = models.BlackScholesModel(K, vol, 0.065, 30 / 365, 21500.0, 0.012)
+        for fast in (models.BlackScholesModel.unchecked(K, vol, 0.065, 30 / 365, 21500.0, 0.012),
+                     models.BlackScholesModel.unchecked(K, vol, 21500.0, expiry),
+                     models.BlackScholesModel.unchecked(K, vol, 21500.0, models.ExpiryContext.unchecked(0.065, 30 / 365, 0.012))):
+            assert fast.call_price() == checked.call_price()
+            assert fast.put_price() == checked.put_price()
+            assert (models.GreeksCalculator(fast).compute_all().to_dict() ==
+                    models.GreeksCalculator(checked).compute_all().to_dict())
+
+    # Inputs the checked path rejects go straight through
+    with pytest.raises(ValueError, match="Strike price must be positive"):
+        models.BlackScholesModel(-100.0, 0.2, 0.05, 1.0, 100.0)
+    bad = models.BlackScholesModel.unchecked(-100.0, 0.2, 0.05, 1.0, 100.0)
+    assert bad.get_strike_price() == -100.0
+    with pytest.raises(ValueError, match="Time to maturity must be positive"):
+        models.ExpiryContext(0.05, -1.0)
+    assert models.ExpiryContext.unchecked(0.05, -1.0).get_time_to_maturity() == -1.0
+    assert models.BlackScholesModel.unchecked(100.0, 0.2, 100.0, models.ExpiryContext.unchecked(0.05, 0.0)).get_time_to_maturity() == 0.0
+
+
+def test_implied_volatility_batch():
+    """Batch IV recovers the input vols and reports bad quotes by status, not exceptions."""
+    import numpy as np
+
+    rng = np.random.default_rng(11)
+    n = 2000
+    S = 20000.0
+    K = S * rng.uniform(0.8, 1.2, n)
+    T = rng.uniform(0.02, 1.5, n)
+    vol = rng.uniform(0.08, 1.2, n)
+    is_call = rng.random(n) < 0.5
+    prices = optipricer.models.price_batch(S, K, 0.065, T, vol, 0.01, is_call)
+
+    iv, status = optipricer.models.implied_volatility_batch(prices, S, K, 0.065, T, 0.01, is_call)
+    ok = status == int(optipricer.models.IVStatus.OK)
+    assert ok.mean() > 0.99
+    repriced = optipricer.models.price_batch(S, K[ok], 0.065, T[ok], iv[ok], 0.01, is_call[ok])
+    assert np.max(np.abs(repriced - prices[ok])) < 1e-6
+
+    # Invalid quotes come back as NaN with a status code
+    bad_iv, bad_status = optipricer.models.implied_volatility_batch(
+        np.array([-1.0, 0.01, 150.0]), 100.0, 100.0, 0.05, 1.0, 0.0, True)
+    assert np.isnan(bad_iv).all()
+    assert list(bad_status) == [int(optipricer.models.IVStatus.INVALID_INPUT),
+                                int(optipricer.models.IVStatus.BELOW_INTRINSIC),
+                                int(optipricer.models.IVStatus.ABOVE_MAXIMUM)]
+
+    # Scalar API is unchanged and the facade accepts arrays
+    assert optipricer.implied_vol(prices[0], S, K[0], 0.065, T[0], 0.01,
+                                  'call' if is_call[0] else 'put') == pytest.approx(iv[0], abs=1e-8)
+    assert optipricer.implied_vol(prices[:3], S, K[:3], 0.065, T[:3], 0.01).shape == (3,)
+
+
+def test_thread_pool_is_deterministic():
+    """Batch results must not depend on the native thread count."""
+    import numpy as np
+
+    rng = np.random.default_rng(5)
+    K = rng.uniform(15000.0, 25000.0, 50000)
+    vol = rng.uniform(0.05, 1.5, 50000)
+    prices = optipricer.models.price_batch(20000.0, K, 0.07, 0.1, vol, 0.0, True)
+
+    original = optipricer.get_num_threads()
+    try:
+        optipricer.set_num_threads(1)
+        assert optipricer.get_num_threads() == 1
+        iv_1, status_1 = optipricer.models.implied_volatility_batch(prices, 20000.0, K, 0.07, 0.1)
+        greeks_1 = optipricer.models.greeks_batch(20000.0, K, 0.07, 0.1, vol)
+
+        optipricer.set_num_threads(4)
+        iv_4, status_4 = optipricer.models.implied_volatility_batch(prices, 20000.0, K, 0.07, 0.1)
+        greeks_4 = optipricer.models.greeks_batch(20000.0, K, 0.07, 0.1, vol)
+        assert np.array_equal(prices, optipricer.models.price_batch(20000.0, K, 0.07, 0.1, vol, 0.0, True))
+    finally:
+        optipricer.set_num_threads(original)
+
+    assert np.array_equal(iv_1, iv_4, equal_nan=True)
+    assert np.array_equal(status_1, status_4)
+    assert np.array_equal(greeks_1, greeks_4)
+
+    with pytest.raises(ValueError, match="non-negative"):
+        optipricer.set_num_threads(-1)
+
+
+def test_batch_out_buffers_and_workspace():
+    """out= fills caller arrays in place and a Workspace hands back the same buffers."""
+    import numpy as np
+    import tracemalloc
+
+    models = optipricer.models
+    K = np.linspace(18000.0, 22000.0, 257)
+    expected = models.price_batch(20000.0, K, 0.07, 0.1, 0.2, 0.01, True)
+
+    out = np.empty_like(K)
+    assert models.price_batch(20000.0, K, 0.07, 0.1, 0.2, 0.01, True, out=out) is out
+    assert np.array_equal(out, expected)
+
+    pair = (np.empty_like(K), np.empty_like(K))
+    assert models.price_delta_batch(20000.0, K, 0.07, 0.1, 0.2, 0.01, True, out=pair) is pair
+    assert np.array_equal(pair[0], expected)
+
+    greeks = models.greeks_batch(20000.0, K, 0.07, 0.1, 0.2, 0.01)
+    again = np.zeros_like(greeks)
+    models.greeks_batch(20000.0, K, 0.07, 0.1, 0.2, 0.01, out=again)
+    assert np.array_equal(again, greeks)
+
+    solved = (np.empty_like(K), np.empty(K.shape, dtype=np.int8))
+    iv, status = models.implied_volatility_batch(expected, 20000.0, K, 0.07, 0.1, 0.01, True, out=solved)
+    assert iv is solved[0] and status is solved[1]
+    assert np.allclose(iv[status == int(models.IVStatus.OK)], 0.2, atol=1e-6)
+
+    with pytest.raises(ValueError, match="shape"):
+        models.price_batch(20000.0, K, 0.07, 0.1, 0.2, out=np.empty(10))
+    with pytest.raises(ValueError, match="dtype"):
+        models.price_batch(20000.0, K, 0.07, 0.1, 0.2, out=np.empty(K.shape, dtype=np.float32))
+    with pytest.raises(ValueError, match="C-contiguous"):
+        models.price_batch(20000.0, K[::2], 0.07, 0.1, 0.2, out=np.empty(2 * K[::2].size)[::2])
+    with pytest.raises(ValueError, match="tuple"):
+        models.price_delta_batch(20000.0, K, 0.07, 0.1, 0.2, out=out)
+
+    ws = models.Workspace()
+    first = ws.price_batch(20000.0, K, 0.07, 0.1, 0.2, 0.01, True)
+    assert np.array_equal(first, expected)
+    assert ws.price_batch(20100.0, K, 0.07, 0.1, 0.2, 0.01, True) is first
+    assert ws.price_batch(20000.0, K[:10], 0.07, 0.1, 0.2, 0.01, True).shape == (10,)
+    first_iv = ws.implied_volatility_batch(expected, 20000.0, K, 0.07, 0.1, 0.01, True)
+    assert ws.implied_volatility_batch(expected, 20000.0, K, 0.07, 0.1, 0.01, True) is first_iv
+
+    # Steady-state ticks leave nothing behind
+    for _ in range(10):
+        ws.price_delta_batch(20000.0, K, 0.07, 0.1, 0.2, 0.01, True)
+    tracemalloc.start()
+    try:
+        baseline = tracemalloc.get_traced_memory()[0]
+        for tick in range(1000):
+            ws.price_delta_batch(20000.0 + tick, K, 0.07, 0.1, 0.2, 0.01, True)
+        assert tracemalloc.get_traced_memory()[0] - baseline < 1024
+    finally:
+        tracemalloc.stop()
+
+
+def test_specialized_kernels_match_mixed_batch():
+    """All-call, all-put and q = 0 blocks take specialized kernels that match the general path exactly."""
+    import numpy as np
+
+    models = optipricer.models
+    rng = np.random.default_rng(11)
+    n = 1024
+    S, r = 20000.0, 0.065
+    K = rng.uniform(16000.0, 24000.0, n)
+    T = rng.uniform(1 / 365, 1.0, n)
+    vol = rng.uniform(0.05, 0.8, n)
+    mixed = np.arange(n) % 2 == 0
+    # One dividend-paying option in every 16 keeps each block on the general dividend path
+    q_mixed = np.where(np.arange(n) % 16 == 0, 0.012, 0.0)
+    zero = q_mixed == 0.0
+
+    for q in (0.012, q_mixed):
+        blended = models.price_delta_batch(S, K, r, T, vol, q, mixed)
+        calls = models.price_delta_batch(S, K, r, T, vol, q, True)
+        puts = models.price_delta_batch(S, K, r, T, vol, q, False)
+        for got, call, put in zip(blended, calls, puts):
+            assert np.array_equal(got[mixed], call[mixed])
+            assert np.array_equal(got[~mixed], put[~mixed])
+
+    for side in (True, False, mixed):
+        general = models.price_delta_batch(S, K, r, T, vol, q_mixed, side)
+        special = models.price_delta_batch(S, K, r, T, vol, 0.0, side)
+        for g, s in zip(general, special):
+            assert np.array_equal(g[zero], s[zero])
+
+    general = models.greeks_batch(S, K, r, T, vol, q_mixed)
+    special = models.greeks_batch(S, K, r, T, vol, 0.0)
+    for name in general.dtype.names:
+        assert np.array_equal(general[name][zero], special[name][zero]), name
+
+    # The scalar wrappers pick the q = 0 instantiation on their own
+    model = models.BlackScholesModel(21000.0, 0.2, r, 0.25, S)
+    g = models.GreeksCalculator(model)
+    row = models.greeks_batch(S, 21000.0, r, 0.25, 0.2, 0.0)
+    assert model.call_price() == pytest.approx(float(row['call_price']), rel=1e-12)
+    assert g.put_theta() == pytest.approx(float(row['put_theta']), rel=1e-9)
+    assert g.call_charm() == pytest.approx(float(row['call_charm']), rel=1e-9)
+
+
+def test_float32_batches():
+    """float32 inputs run the single-precision kernels within stated bounds of float64."""
+    import numpy as np
+
+    models = optipricer.models
+    rng = np.random.default_rng(7)
+    n = 2000
+    S = np.full(n, 20000.0, dtype=np.float32)
+    K = rng.uniform(16000.0, 24000.0, n).astype(np.float32)
+    T = rng.uniform(0.05, 1.0, n).astype(np.float32)
+    vol = rng.uniform(0.1, 0.6, n).astype(np.float32)
+    is_call = rng.random(n) < 0.5
+    # The float64 reference sees the same float32-rounded inputs
+    args64 = [a.astype(np.float64) for a in (S, K, np.full(n, 0.07, dtype=np.float32), T, vol)]
+
+    price, delta = models.price_delta_batch(S, K, 0.07, T, vol, 0.01, is_call)
+    price64, delta64 = models.price_delta_batch(*args64, 0.01, is_call)
+    assert price.dtype == np.float32 and delta.dtype == np.float32
+    assert np.max(np.abs(price - price64)) <= 2e-6 * 20000.0
+    assert np.max(np.abs(delta - delta64)) <= 3e-6
+    assert models.price_batch(S[::2], K[::2], 0.07, T[::2], vol[::2]).dtype == np.float32
+    assert models.price_batch(S, K.astype(np.float64), 0.07, T, vol).dtype == np.float64
+    out = np.empty(n, dtype=np.float32)
+    assert models.price_batch(S, K, 0.07, T, vol, 0.01, is_call, out=out) is out
+    assert np.array_equal(out, price)
+
+    greeks = models.greeks_batch(S, K, 0.07, T, vol, 0.01)
+    greeks64 = models.greeks_batch(*args64, 0.01)
+    assert greeks.dtype.names == greeks64.dtype.names
+    for name in greeks.dtype.names:
+        assert greeks.dtype[name] == np.float32
+        scale = np.max(np.abs(greeks64[name]))
+        assert np.max(np.abs(greeks[name] - greeks64[name])) <= 1e-5 * scale, name
+
+    # Quotes rounded to float32 are the inputs of both paths; compare where vega makes them well posed
+    quotes = price64.astype(np.float32)
+    iv, status = models.implied_volatility_batch(quotes, S, K, 0.07, T, 0.01, is_call)
+    refined, refined_status = models.implied_volatility_batch(quotes, S, K, 0.07, T, 0.01, is_call, refine=True)
+    iv64, status64 = models.implied_volatility_batch(quotes.astype(np.float64), *args64[:4], 0.01, is_call,
+                                                     tol=1e-10)
+    assert iv.dtype == np.float32 and refined.dtype == np.float32
+    assert np.array_equal(status, refined_status)
+    ok = (status64 == int(models.IVStatus.OK)) & (greeks64['vega'] >= 5.0)
+    assert ok.sum() > n // 2
+    assert np.all(status[ok] == int(models.IVStatus.OK))
+    assert np.max(np.abs(iv[ok] - iv64[ok])) <= 1e-3
+    assert np.max(np.abs(refined[ok] - iv64[ok])) <= 1e-6
+    failed = (status != int(models.IVStatus.OK)) & (status != int(models.IVStatus.NOT_CONVERGED))
+    assert np.all(np.isnan(iv[failed]))
+
+
+def test_parity_calibration():
+    """Put-call parity recovers per-expiry carry and feeds the IV, surface and chain paths."""
+    import numpy as np
+    from optipricer import parity
+    from optipricer.chain import OptionChain
+    from optipricer.surface import SviSurface
+
+    S, r = 20000.0, 0.065
+    expiries = np.array([7 / 365, 30 / 365, 91 / 365, 182 / 365])
+    yields = np.array([0.002, 0.015, 0.011, 0.013])
+    strikes = np.arange(17000.0, 23001.0, 100.0)
+    T, K = np.meshgrid(expiries, strikes, indexing='ij')
+    q = np.repeat(yields, len(strikes)).reshape(T.shape)
+    vol = 0.14 + 0.3 * np.log(K / S) ** 2
+    calls = optipricer.models.price_batch(S, K, r, T, vol, q, True)
+    puts = optipricer.models.price_batch(S, K, r, T, vol, q, False)
+    # A stale deep ITM call and a missing put on the front expiry
+    calls[0, 5] += 40.0
+    puts[0, 50] = np.nan
+
+    fits = parity.calibrate(S, r, T.ravel(), K.ravel(), calls.ravel(), puts.ravel())
+    assert [f.expiry for f in fits] == pytest.approx(list(expiries))
+    for f, t, y in zip(fits, expiries, yields):
+        assert f.dividend_yield == pytest.approx(y, abs=1e-9)
+        assert f.forward == pytest.approx(S * math.exp((r - y) * t), rel=1e-9)
+        assert f.rate == r
+    assert fits[0].num_quotes == len(strikes) - 1
+    assert fits[0].num_used == len(strikes) - 2
+    assert fits[1].num_used == len(strikes)
+    # Without rejection the stale quote drags the front forward
+    raw = parity.calibrate(S, r, T.ravel(), K.ravel(), calls.ravel(), puts.ravel(), outlier_threshold=0.0)
+    assert abs(raw[0].dividend_yield - yields[0]) > 1e-3
+
+    free = parity.calibrate(S, r, T.ravel(), K.ravel(), calls.ravel(), puts.ravel(), fit_rate=True)
+    assert all(f.rate == pytest.approx(r, abs=1e-8) for f in free)
+
+    rate, div = parity.carry(fits, T)
+    assert rate.shape == T.shape and div.shape == T.shape
+    assert np.allclose(div, q, atol=1e-9)
+    _, mid = parity.carry(fits, [0.5 * (expiries[1] + expiries[2])])
+    assert yields[2] < mid[0] < yields[1]
+
+    chain = OptionChain.from_parity(S, fits[1], list(strikes[::10]))
+    assert chain.q == fits[1].dividend_yield and chain.T == fits[1].expiry
+
+    # The surface solves each quote with its own expiry's carry
+    otm = K >= S
+    price = np.where(otm, calls, puts)
+    near = np.abs(K - S) <= 1500.0
+    svi = SviSurface.from_prices(S, fits, T[near], K[near], price[near], otm[near])
+    assert len(svi.carry) == 4
+    assert svi.get_iv(S, expiries[2]) == pytest.approx(0.14, abs=1e-3)
+
+    with pytest.raises(ValueError, match="Put-call parity"):
+        parity.calibrate(S, r, [0.1, 0.1], [19000.0, 21000.0], [1200.0, np.nan], [np.nan, 1100.0])
+
+
+def test_strategy_update_market():
+    """Re-marking in place matches a freshly built strategy."""
+    straddle = optipricer.strategies.LongStraddle(100.0, 0.2, 0.05, 0.5, 100.0)
+    before = straddle.total_value()
+
+    straddle.update_market(103.0, 0.25, 0.06, 0.4, 0.01)
+    fresh = optipricer.strategies.LongStraddle(103.0, 0.25, 0.06, 0.4, 100.0, 1.0, 0.01)
+    assert straddle.total_value() == pytest.approx(fresh.total_value())
+    assert straddle.total_delta() == pytest.approx(fresh.total_delta())
+    assert straddle.get_underlying_price() == 103.0
+
+    # Invalid updates are rejected and leave the previous state in place
+    with pytest.raises(ValueError, match="Underlying price must be positive"):
+        straddle.update_market(-1.0, 0.25, 0.06, 0.4, 0.01)
+    assert straddle.total_value() == pytest.approx(fresh.total_value())
+
+    # Per-leg volatility override (skew between the put and call wing)
+    straddle.set_leg_volatility(1, 0.35)
+    put = optipricer.models.BlackScholesModel(100.0, 0.35, 0.06, 0.4, 103.0, 0.01).put_price()
+    call = optipricer.models.BlackScholesModel(100.0, 0.25, 0.06, 0.4, 103.0, 0.01).call_price()
+    assert straddle.total_value() == pytest.approx(call + put)
+    assert straddle.get_positions()[1].volatility_override == 0.35
+    straddle.clear_leg_volatility(1)
+    assert straddle.total_value() == pytest.approx(fresh.total_value())
+    assert straddle.total_value() != before
+
+    with pytest.raises(IndexError):
+        straddle.set_leg_volatility(5, 0.3)
+
+
+def test_strategy_payoff_and_value_grid():
+    """Grid evaluation matches the scalar payoff and a re-marked strategy."""
+    import numpy as np
+
+    condor = optipricer.strategies.IronCondor(100.0, 0.2, 0.05, 0.5, 90.0, 95.0, 105.0, 110.0)
+    spots = np.linspace(0.0, 200.0, 401).reshape(401, 1)
+    payoff = condor.payoff_grid(spots)
+    assert payoff.shape == (401, 1)
+    expected = [condor.payoff_at_expiration(s) for s in spots.ravel()]
+    assert np.allclose(payoff.ravel(), expected, atol=1e-10)
+
+    with pytest.raises(ValueError, match="index 1"):
+        condor.payoff_grid([100.0, -1.0])
+
+    grid_spots = np.array([92.0, 100.0, 108.0])
+    vols = np.array([0.15, 0.3])
+    times = np.array([0.0, 0.25, 0.5])
+    grid = condor.value_grid(grid_spots, vols, times)
+    assert grid.shape == (3, 2, 3)
+    assert np.allclose(grid[:, 0, 0], condor.payoff_grid(grid_spots), atol=1e-10)
+
+    remarked = optipricer.strategies.IronCondor(100.0, 0.2, 0.05, 0.5, 90.0, 95.0, 105.0, 110.0)
+    remarked.update_market(108.0, 0.3, 0.05, 0.25, 0.0)
+    assert grid[2, 1, 1] == pytest.approx(remarked.total_value(), abs=1e-10)
+
+
+def test_monte_carlo_engine():
+    """Test MC prices against Black-Scholes, barrier parity and reproducibility."""
+    from optipricer import montecarlo
+
+    S, K, r, T, vol, q = 100.0, 100.0, 0.05, 1.0, 0.2, 0.02
+    bs = optipricer.price(S, K, r, T, vol, q, 'call')
+
+    euro = montecarlo.price(S, K, r, T, vol, q, paths=200000)
+    assert euro.paths == 200000
+    assert abs(euro.price - bs) < 4 * euro.std_error
+
+    # Knock-in + knock-out is the vanilla, path by path on the same draws
+    common = dict(barrier=130.0, paths=20000, steps=50, control_variate=False)
+    out = montecarlo.price(S, K, r, T, vol, q, payoff='up_and_out', **common)
+    knock_in = montecarlo.price(S, K, r, T, vol, q, payoff='up_and_in', **common)
+    vanilla = montecarlo.price(S, K, r, T, vol, q, **common)
+    assert out.price + knock_in.price == pytest.approx(vanilla.price, abs=1e-9)
+    assert 0.0 < out.price < bs
+
+    # The control variate tightens an Asian estimate
+    plain = montecarlo.price(S, K, r, T, vol, q, payoff='asian', paths=20000, steps=50, control_variate=False)
+    asian = montecarlo.price(S, K, r, T, vol, q, payoff='asian', paths=20000, steps=50)
+    assert asian.std_error < plain.std_error
+    assert abs(asian.price - plain.price) < 4 * plain.std_error
+
+    # Counter-based draws: same seed, same answer on any thread count
+    original = optipricer.get_num_threads()
+    try:
+        optipricer.set_num_threads(1)
+        one = montecarlo.price(S, K, r, T, vol, q, option='put', payoff='down_and_out', barrier=80.0,
+                               paths=30000, steps=20, seed=7)
+        optipricer.set_num_threads(4)
+        four = montecarlo.price(S, K, r, T, vol, q, option='put', payoff='down_and_out', barrier=80.0,
+                                paths=30000, steps=20, seed=7)
+    finally:
+        optipricer.set_num_threads(original)
+    assert (one.price, one.std_error) == (four.price, four.std_error)
+
+    with pytest.raises(ValueError, match="Barrier"):
+        montecarlo.price(S, K, r, T, vol, q, payoff='up_and_out')
+    with pytest.raises(ValueError, match="Volatility"):
+        montecarlo.MonteCarloEngine(S, r, T, -0.1)
+
+
+def test_monte_carlo_sobol_sampler():
+    """Test the QMC sampler: unbiased, far tighter than MC and reproducible."""
+    from optipricer import montecarlo
+
+    S, K, r, T, vol, q = 100.0, 100.0, 0.05, 1.0, 0.2, 0.02
+    bs = optipricer.price(S, K, r, T, vol, q, 'call')
+    common = dict(paths=16 * 4096, steps=16, antithetic=False, control_variate=False)
+
+    mc = montecarlo.price(S, K, r, T, vol, q, **common)
+    qmc = montecarlo.price(S, K, r, T, vol, q, sampler='sobol', **common)
+    assert qmc.paths == 16 * 4096
+    assert abs(qmc.price - bs) < 5 * qmc.std_error + 1e-6
+    assert qmc.std_error < mc.std_error / 10
+
+    # More steps than Sobol dimensions: the bridge tail is padded with Philox draws
+    steps = montecarlo.SOBOL_DIMENSIONS + 20
+    plain = montecarlo.price(S, K, r, T, vol, q, payoff='asian', paths=16 * 1024, steps=steps,
+                             control_variate=False)
+    asian = montecarlo.price(S, K, r, T, vol, q, payoff='asian', paths=16 * 1024, steps=steps,
+                             control_variate=False, sampler='sobol')
+    assert asian.std_error < plain.std_error
+    assert abs(asian.price - plain.price) < 5 * plain.std_error
+    again = montecarlo.price(S, K, r, T, vol, q, payoff='asian', paths=16 * 1024, steps=steps,
+                             control_variate=False, sampler='sobol')
+    assert (again.price, again.std_error) == (asian.price, asian.std_error)
+
+    with pytest.raises(ValueError, match="replicates"):
+        montecarlo.price(S, K, r, T, vol, q, sampler='sobol', replicates=1)
+    with pytest.raises(ValueError, match="sampler"):
+        montecarlo.price(S, K, r, T, vol, q, sampler='halton')
+
+
+def test_lattice_american_options():
+    """Test lattice prices and node Greeks against Black-Scholes and early-exercise bounds."""
+    import numpy as np
+    from optipricer import lattice
+
+    S, K, r, T, vol, q = 100.0, 105.0, 0.06, 0.75, 0.3, 0.02
+    g = optipricer.greeks(S, K, r, T, vol, q)
+    bs_put = optipricer.price(S, K, r, T, vol, q, 'put')
+
+    # European trees converge to Black-Scholes, Greeks included
+    for method in ('crr', 'leisen_reimer', 'trinomial'):
+        eu = lattice.price(S, K, r, T, vol, q, option='put', american=False, method=method, steps=400)
+        assert eu.price == pytest.approx(bs_put, abs=2e-4)
+        assert eu.delta == pytest.approx(g['put_delta'], abs=1e-4)
+        assert eu.gamma == pytest.approx(g['gamma'], abs=1e-5)
+        assert eu.theta == pytest.approx(g['put_theta'], abs=1e-5)
+
+    # Early exercise premium, and agreement between methods
+    am = lattice.price(S, K, r, T, vol, q, option='put')
+    assert am.price > bs_put
+    for method in ('crr', 'trinomial'):
+        other = lattice.price(S, K, r, T, vol, q, option='put', method=method, steps=400)
+        assert other.price == pytest.approx(am.price, abs=2e-3)
+        assert other.delta == pytest.approx(am.delta, abs=1e-4)
+
+    # No dividends: an American call is never exercised early
+    call = lattice.price(S, K, r, T, vol, 0.0, option='call')
+    assert call.price == pytest.approx(optipricer.price(S, K, r, T, vol, 0.0, 'call'), abs=1e-4)
+
+    # Deep in the money the put is exercised now
+    deep = lattice.price(60.0, 100.0, 0.08, 1.0, 0.2, option='put')
+    assert deep.price == pytest.approx(40.0)
+    assert deep.delta == pytest.approx(-1.0)
+    assert deep.theta == 0.0
+
+    # A whole chain in one call matches the scalar engine
+    strikes = np.linspace(80.0, 120.0, 9)
+    chain = lattice.price(S, strikes, r, T, vol, q, option='put')
+    assert chain.shape == strikes.shape
+    engine = lattice.LatticeEngine(S, r, T, vol, q)
+    for k, row in zip(strikes, chain):
+        assert row['price'] == engine.price(k, is_call=False).price
+
+    with pytest.raises(ValueError, match="positive volatility"):
+        lattice.price(S, K, r, T, 0.0)
+    with pytest.raises(ValueError, match="steps"):
+        lattice.price(S, K, r, T, vol, steps=3)
+
+
+
+def test_pde_crank_nicolson():
+    """Test the PDE engine against Black-Scholes, the lattice, barrier parity and strategy aggregation."""
+    import numpy as np
+    from optipricer import lattice, pde, strategies
+
+    S, K, r, T, vol, q = 100.0, 105.0, 0.06, 0.75, 0.3, 0.02
+    g = optipricer.greeks(S, K, r, T, vol, q)
+    engine = pde.CrankNicolsonEngine(S, r, T, vol, q)
+
+    # European solves reproduce the closed form, Greeks included
+    for is_call, side in ((True, 'call'), (False, 'put')):
+        eu = engine.price(K, is_call, american=False)
+        assert eu.price == pytest.approx(optipricer.price(S, K, r, T, vol, q, side), abs=1e-3)
+        assert eu.delta == pytest.approx(g[f'{side}_delta'], abs=1e-4)
+        assert eu.gamma == pytest.approx(g['gamma'], abs=1e-5)
+        assert eu.vega == pytest.approx(g['vega'], abs=1e-4)
+        assert eu.theta == pytest.approx(g[f'{side}_theta'], abs=1e-5)
+        assert eu.rho == pytest.approx(g[f'{side}_rho'], abs=1e-4)
+        assert eu.vanna == pytest.approx(g['vanna'], abs=1e-3)
+        assert eu.volga == pytest.approx(g['volga'], abs=2e-2)
+        assert eu.charm == pytest.approx(g[f'{side}_charm'], abs=1e-5)
+
+    # American puts agree with the lattice; deep in the money they are exercised now
+    am = engine.price(K, False)
+    tree = lattice.price(S, K, r, T, vol, q, option='put')
+    assert am.price == pytest.approx(tree.price, abs=3e-3)
+    assert am.delta == pytest.approx(tree.delta, abs=1e-4)
+    deep = pde.price(60.0, 100.0, 0.08, 1.0, 0.2, option='put')
+    assert deep.price == pytest.approx(40.0)
+    assert deep.delta == pytest.approx(-1.0, abs=1e-4)
+    assert deep.theta == 0.0
+
+    # Knock-out plus knock-in is the vanilla; an already-breached barrier is worth nothing
+    for out_type, in_type, level in (('up_and_out', 'up_and_in', 130.0), ('down_and_out', 'down_and_in', 80.0)):
+        ko = pde.price(S, 100.0, r, T, vol, q, american=False, barrier=out_type, barrier_level=level)
+        ki = pde.price(S, 100.0, r, T, vol, q, american=False, barrier=in_type, barrier_level=level)
+        assert 0.0 < ko.price < ko.price + ki.price
+        assert ko.price + ki.price == pytest.approx(optipricer.price(S, 100.0, r, T, vol, q), abs=1e-10)
+    assert pde.price(S, K, r, T, vol, q, barrier='up_and_out', barrier_level=95.0).price == 0.0
+
+    # One chain solve matches per-strike solves up to the grid difference
+    strikes = np.linspace(80.0, 120.0, 9)
+    chain = engine.price_chain(strikes, is_call=strikes >= S)
+    assert chain.shape == strikes.shape
+    for k, row in zip(strikes, chain):
+        assert row['price'] == pytest.approx(engine.price(k, k >= S).price, abs=5e-4)
+    assert np.isnan(engine.price_chain(strikes, sensitivities=False)['vega']).all()
+
+    # Strategies aggregate PDE-priced legs
+    spread = strategies.BearPutSpread(S, vol, r, T, 110.0, 95.0, q=q)
+    closed_form = spread.total_greeks()
+    spread.set_pde_pricing(american=False)
+    assert spread.uses_pde_pricing()
+    assert spread.total_value() == pytest.approx(closed_form.value, abs=1e-3)
+    assert spread.total_delta() == pytest.approx(closed_form.delta, abs=1e-4)
+    spread.set_pde_pricing(american=True)
+    assert spread.leg_greeks()[0].put_price == pytest.approx(engine.price(110.0, False).price, abs=1e-3)
+    spread.set_closed_form_pricing()
+    assert spread.total_value() == closed_form.value
+
+    with pytest.raises(ValueError, match="positive volatility"):
+        pde.CrankNicolsonEngine(S, r, T, 0.0)
+    with pytest.raises(ValueError, match="space steps"):
+        engine.price(K, space_steps=10)
+    with pytest.raises(ValueError, match="European"):
+        engine.price(K, barrier=pde.BarrierType.UP_AND_IN, barrier_level=130.0)
+    with pytest.raises(ValueError, match="barrier"):
+        pde.price(S, K, r, T, vol, barrier='sideways')
+
+
+def test_heston_cos_pricing_and_calibration():
+    """Test the Heston COS pricer against a published value and calibrate back known parameters."""
+    import numpy as np
+    from optipricer import heston
+
+    # Fang & Oosterlee (2008) reference: S = K = 100, T = 1, r = q = 0
+    fo = heston.HestonParams(v0=0.0175, kappa=1.5768, theta=0.0398, xi=0.5751, rho=-0.5711)
+    assert heston.price(100.0, 100.0, 0.0, 1.0, fo).price == pytest.approx(5.785155450, abs=1e-6)
+
+    S, r, q, T = 100.0, 0.03, 0.01, 0.5
+    true = heston.HestonParams(v0=0.04, kappa=2.0, theta=0.05, xi=0.6, rho=-0.7)
+    strikes = np.linspace(70.0, 130.0, 21)
+    expiry = heston.HestonExpiry(S, r, T, strikes, true, dividend_yield=q)
+    calls = expiry.price_chain(true, is_call=True)
+    puts = expiry.price_chain(true, is_call=False)
+    assert len(expiry) == calls.shape[0] == 21
+    np.testing.assert_allclose(calls['price'] - puts['price'],
+                               S * math.exp(-q * T) - strikes * math.exp(-r * T), atol=1e-10)
+    np.testing.assert_array_equal(expiry.prices(true, True), calls['price'])
+
+    # COS delta and gamma against bumped spots
+    h = 0.01
+    up = heston.HestonExpiry(S + h, r, T, strikes, true, dividend_yield=q).prices(true)
+    down = heston.HestonExpiry(S - h, r, T, strikes, true, dividend_yield=q).prices(true)
+    np.testing.assert_allclose(calls['delta'], (up - down) / (2 * h), atol=1e-6)
+    np.testing.assert_allclose(calls['gamma'], (up - 2 * calls['price'] + down) / h**2, atol=1e-5)
+
+    # Nearly deterministic variance is Black-Scholes
+    flat = heston.HestonParams(v0=0.04, kappa=1.0, theta=0.04, xi=1e-3, rho=0.0)
+    assert heston.price(S, 105.0, r, T, flat, q).price == pytest.approx(optipricer.price(S, 105.0, r, T, 0.2, q), abs=1e-5)
+
+    # Calibrating to the model's own smile recovers the parameters
+    is_call = strikes >= S * math.exp((r - q) * T)
+    model = expiry.prices(true, is_call)
+    iv = np.array([optipricer.implied_vol(p, S, k, r, T, q, 'call' if c else 'put', tol=1e-12)
+                   for p, k, c in zip(model, strikes, is_call)])
+    fit = heston.calibrate(S, r, T, strikes, iv, q=q)
+    assert fit.num_quotes == 21
+    assert fit.rmse < 1e-6
+    for name in ('v0', 'kappa', 'theta', 'xi', 'rho'):
+        assert getattr(fit.params, name) == pytest.approx(getattr(true, name), rel=1e-3)
+
+    # One expiry priced from several threads under alternating parameters matches serial pricing
+    import threading
+    params = [true, fit.params, flat]
+    serial = [heston.HestonExpiry(S, r, T, strikes, true, dividend_yield=q).prices(p, is_call) for p in params]
+    mismatched = []
+
+    def price(offset):
+        for i in range(300):
+            j = (i + offset) % len(params)
+            if not np.array_equal(expiry.prices(params[j], is_call), serial[j]):
+                mismatched.append(j)
+
+    workers = [threading.Thread(target=price, args=(t,)) for t in range(3)]
+    for t in workers:
+        t.start()
+    for t in workers:
+        t.join()
+    assert not mismatched
+
+    with pytest.raises(ValueError, match="rho"):
+        heston.price(S, 100.0, r, T, heston.HestonParams(0.04, 2.0, 0.05, 0.6, -1.0))
+    with pytest.raises(ValueError, match="at least 5 quotes"):
+        heston.calibrate(S, r, T, strikes[:4], iv[:4])
+    with pytest.raises(ValueError, match="is_call"):
+        expiry.prices(true, [True, False])
+
+
+def test_portfolio_rollups():
+    """Book rollups must equal the per-leg closed-form Greeks, weighted by signed quantity."""
+    import numpy as np
+    from optipricer import portfolio
+
+    book = portfolio.Portfolio(risk_free_rate=0.06)
+    a = book.add_underlying(100.0, 0.01)
+    b = book.add_underlying(2500.0)
+    strikes = np.linspace(80.0, 120.0, 41)
+    book.add_legs(a, strikes, 0.25, 0.2, quantity=np.where(strikes > 100.0, -2.0, 1.0), is_call=strikes > 100.0)
+    book.add_legs(a, 100.0, np.array([0.1, 0.5, 0.1]), 0.3, 3.0, is_call=False)
+    book.add_leg(b, 2450.0, 0.5, 0.25, -5.0, True)
+    assert len(book) == 45 and book.num_underlyings() == 2 and book.num_expiries() == 4
+
+    risk = book.valuate()
+    expected = {name: np.zeros(2) for name in ('value', 'delta', 'gamma', 'vega', 'theta', 'rho', 'vanna', 'volga', 'charm')}
+    per_side = {'value': 'price', 'delta': 'delta', 'theta': 'theta', 'rho': 'rho', 'charm': 'charm'}
+    legs = [(a, K, 0.25, 0.2, -2.0 if K > 100.0 else 1.0, K > 100.0) for K in strikes]
+    legs += [(a, 100.0, T, 0.3, 3.0, False) for T in (0.1, 0.5, 0.1)] + [(b, 2450.0, 0.5, 0.25, -5.0, True)]
+    for u, K, T, vol, qty, call in legs:
+        g = optipricer.models.greeks_batch(book.get_underlying_price(u), K, 0.06, T, vol, book.get_dividend_yield(u))
+        side = 'call_' if call else 'put_'
+        for name in expected:
+            field = side + per_side[name] if name in per_side else name
+            expected[name][u] += qty * float(g[field])
+    for name, by_u in expected.items():
+        assert np.allclose(risk.by_underlying[name], by_u, rtol=1e-10, atol=1e-10)
+        assert getattr(risk.total, name) == pytest.approx(by_u.sum(), rel=1e-10, abs=1e-10)
+
+    rollup = risk.by_expiry
+    assert list(zip(rollup['underlying'], rollup['time_to_maturity'], rollup['num_legs'])) == [
+        (0, 0.1, 2), (0, 0.25, 41), (0, 0.5, 1), (1, 0.5, 1)]
+    assert rollup['vega'].sum() == pytest.approx(risk.total.vega)
+
+    # A rejected batch leaves the book unchanged
+    with pytest.raises(ValueError):
+        book.add_legs(a, np.array([100.0, -1.0]), 0.25, 0.2, 1.0)
+    with pytest.raises(IndexError):
+        book.add_leg(7, 100.0, 0.25, 0.2, 1.0)
+    assert len(book) == 45
+
+    book.set_underlying_price(a, 105.0)
+    assert book.valuate().by_underlying['value'][1] == risk.by_underlying['value'][1]
+
+
+def test_portfolio_scenarios():
+    """Full ladders must match repricing every leg; Taylor cells track them for small moves."""
+    import numpy as np
+    from optipricer import portfolio
+
+    book = portfolio.Portfolio(risk_free_rate=0.06)
+    a = book.add_underlying(100.0, 0.01)
+    b = book.add_underlying(2500.0)
+    strikes = np.linspace(80.0, 120.0, 41)
+    book.add_legs(a, strikes, 0.25, 0.2, quantity=np.where(strikes > 100.0, -2.0, 1.0), is_call=strikes > 100.0)
+    book.add_leg(b, 2450.0, 0.5, 0.25, -5.0, True)
+
+    spot_shifts = np.array([-0.1, -0.02, 0.0, 0.05])
+    vol_shifts = np.array([-0.25, 0.0, 0.03])
+    cube = book.scenarios(spot_shifts, vol_shifts)
+    assert cube.pnl.shape == (2, 4, 3) and cube.total.shape == (4, 3)
+    assert cube.mode == portfolio.ScenarioMode.FULL
+    assert np.all(cube.pnl[:, 2, 1] == 0.0)
+    assert cube.base_values.sum() == pytest.approx(book.valuate().total.value, rel=1e-12)
+
+    # Vol shifts floor each leg's volatility at zero
+    for i, ds in enumerate(spot_shifts):
+        for j, dv in enumerate(vol_shifts):
+            S = np.array([100.0, 100.0 * (1.0 + ds)])
+            base = optipricer.models.price_batch(S[0], strikes, 0.06, 0.25, 0.2, 0.01, strikes > 100.0)
+            shocked = optipricer.models.price_batch(S[1], strikes, 0.06, 0.25, max(0.2 + dv, 0.0), 0.01, strikes > 100.0)
+            qty = np.where(strikes > 100.0, -2.0, 1.0)
+            assert cube.pnl[0, i, j] == pytest.approx(np.dot(qty, shocked - base), abs=1e-9)
+            bb = optipricer.models.BlackScholesModel(2450.0, 0.25 + dv, 0.06, 0.5, 2500.0 * (1.0 + ds))
+            b0 = optipricer.models.BlackScholesModel(2450.0, 0.25, 0.06, 0.5, 2500.0)
+            assert cube.pnl[1, i, j] == pytest.approx(-5.0 * (bb.call_price() - b0.call_price()), abs=1e-9)
+
+    taylor = book.scenarios([-0.01, 0.01], [-0.005, 0.005], mode=portfolio.ScenarioMode.TAYLOR)
+    small = book.scenarios([-0.01, 0.01], [-0.005, 0.005])
+    assert np.allclose(taylor.total, small.total, rtol=0.02)
+
+    strategy = optipricer.strategies.OptionsStrategy(21500.0, 0.14, 0.065, 15 / 365, "ladder", 0.012)
+    strategy.add_position(optipricer.strategies.OptionType.CALL, optipricer.strategies.PositionType.SHORT, 50.0, 22000.0)
+    strategy.add_position(optipricer.strategies.OptionType.PUT, optipricer.strategies.PositionType.LONG, 25.0, 21000.0)
+    ladder = strategy.scenarios([0.03], [0.02]).total[0, 0]
+    grid = strategy.value_grid([21500.0 * 1.03], [0.16], [15 / 365])[0, 0, 0]
+    assert ladder == pytest.approx(grid - strategy.total_value(), rel=1e-12)
+
+    with pytest.raises(ValueError):
+        book.scenarios([-1.0], [0.0])
+
+
+def test_portfolio_value_at_risk():
+    """Historical VaR / ES must follow the empirical tail of the streamed scenario P&L."""
+    import numpy as np
+    from optipricer import portfolio
+
+    book = portfolio.Portfolio(risk_free_rate=0.06)
+    a = book.add_underlying(100.0, 0.01)
+    b = book.add_underlying(2500.0)
+    strikes = np.linspace(80.0, 120.0, 41)
+    book.add_legs(a, strikes, 0.25, 0.2, quantity=np.where(strikes > 100.0, -2.0, 1.0), is_call=strikes > 100.0)
+    book.add_leg(b, 2450.0, 0.5, 0.25, -5.0, True)
+
+    rng = np.random.default_rng(11)
+    n = 600
+    spot_shocks = rng.normal(0.0, 0.01, size=(n, 2))
+    vol_shocks = rng.normal(0.0, 0.005, size=(n, 2))
+    pnl = book.scenario_pnl(spot_shocks, vol_shocks)
+    assert pnl.shape == (n, 2)
+    # Spans more than one streaming block; rows match the ladder engine for common shocks
+    cube = book.scenarios(spot_shocks[417, 0], vol_shocks[417, 0])
+    common = book.scenario_pnl(spot_shocks[417:418, 0], vol_shocks[417:418, 0])
+    assert np.allclose(common[0], cube.pnl[:, 0, 0], atol=1e-9)
+
+    var = book.value_at_risk(spot_shocks, vol_shocks, confidence=0.99)
+    total = pnl.sum(axis=1)
+    worst = np.sort(total)[:6]
+    assert var.tail_size == 6 and var.num_scenarios == n
+    assert var.value_at_risk == pytest.approx(-worst[-1], rel=1e-12)
+    assert var.expected_shortfall == pytest.approx(-worst.mean(), rel=1e-12)
+    assert var.var_contributions.sum() == pytest.approx(var.value_at_risk, rel=1e-12)
+    assert var.es_contributions.sum() == pytest.approx(var.expected_shortfall, rel=1e-12)
+    assert np.allclose(var.pnl_by_underlying, pnl)
+    assert var.parametric_var == pytest.approx(-total.mean() + 2.3263478740408408 * total.std(ddof=1), rel=1e-9)
+
+    # One day of decay with no shocks is the book's theta; Taylor mode tracks full revaluation
+    decay = book.scenario_pnl(np.zeros(1), horizon=1 / 365)
+    assert np.allclose(decay[0], book.valuate().by_underlying['theta'], rtol=1e-2)
+    taylor = book.value_at_risk(spot_shocks, vol_shocks, mode=portfolio.ScenarioMode.TAYLOR)
+    assert taylor.value_at_risk == pytest.approx(var.value_at_risk, rel=0.05)
+
+    with pytest.raises(ValueError):
+        book.value_at_risk(spot_shocks, vol_shocks[:10])
+    with pytest.raises(ValueError):
+        book.value_at_risk(spot_shocks, confidence=1.0)
+
+
+def test_stats_counters():
+    """stats() has the same layout with or without OPTIPRICER_STATS; counts only move when compiled in."""
+    import numpy as np
+
+    optipricer.reset_stats()
+    price = optipricer.price(100.0, 125.0, 0.05, 30.0 / 365.0, 0.35)
+    optipricer.implied_vol(price, 100.0, 125.0, 0.05, 30.0 / 365.0)
+    optipricer.implied_vol(np.array([price, 1e6]), 100.0, 125.0, 0.05, 30.0 / 365.0)
+    optipricer.greeks(100.0, 100.0, 0.05, 0.25, 0.2)
+
+    s = optipricer.stats()
+    iv = s['implied_volatility']
+    assert len(iv['iteration_histogram']) == 17
+    assert set(s['latency']) == {'price', 'greeks', 'implied_volatility',
+                                 'price_batch', 'greeks_batch', 'implied_volatility_batch'}
+    if not s['enabled']:
+        assert iv['calls'] == 0 and all(h['count'] == 0 for h in s['latency'].values())
+        return
+
+    assert iv['calls'] == 3
+    assert iv['converged'] == 2 and iv['rejected'] == 1
+    assert sum(iv['iteration_histogram']) == 3
+    assert iv['newton_steps'] + iv['bisection_steps'] + iv['bracket_expansions'] <= iv['iterations']
+    for name in ('price', 'greeks', 'implied_volatility', 'implied_volatility_batch'):
+        h = s['latency'][name]
+        assert h['count'] >= 1 and sum(h['buckets']) == h['count']
+        assert 0 < h['p50_ns'] <= h['p99_ns']
+
+    optipricer.reset_stats()
+    assert optipricer.stats()['implied_volatility']['calls'] == 0
+
+
+def test_tick_pipeline_streaming():
+    """Updates coalesce per contract and only contracts whose mid or spot moved are re-solved."""
+    import numpy as np
+    from optipricer import stream
+
+    r, T = 0.07, 15.0 / 365.0
+    strikes = np.array([21000.0, 21500.0, 22000.0])
+    pipe = stream.TickPipeline(r, capacity=8)
+    calls = pipe.add_contracts(strikes, T, is_call=True)
+    put = pipe.add_contract(21500.0, T, is_call=False)
+    assert list(calls) == [0, 1, 2] and put == 3 and len(pipe) == 4
+
+    mids = optipricer.models.price_batch(21500.0, strikes, r, T, 0.15, 0.0, True)
+    iv = pipe.column('iv')
+    # Two ticks on contract 1 before processing: only the latest counts
+    pipe.push(1, mids[1] - 5.0, mids[1] + 5.0, 21400.0)
+    pipe.push_many(calls, mids - 1.0, mids + 1.0, 21500.0)
+    assert pipe.pending == 3 and pipe.updates_coalesced == 1
+
+    seen = []
+    changed = pipe.process(callback=seen.append)
+    assert sorted(changed) == [0, 1, 2] and np.array_equal(seen[0], changed)
+    assert np.allclose(iv[:3], 0.15, atol=1e-6)
+    assert np.allclose(pipe.column('spot')[:3], 21500.0)
+    g = optipricer.models.greeks_batch(21500.0, strikes, r, T, iv[:3])
+    assert np.allclose(pipe.column('delta')[:3], g['call_delta'], rtol=1e-12)
+    assert np.allclose(pipe.column('price')[:3], mids, atol=1e-4)
+    assert list(pipe.status()[:3]) == [0, 0, 0]
+
+    # Same mid and spot with a wider spread: no solve; a spot move re-solves
+    pipe.push(0, mids[0] - 2.0, mids[0] + 2.0, 21500.0)
+    pipe.push(2, mids[2] - 1.0, mids[2] + 1.0, 21510.0)
+    assert list(pipe.process()) == [2]
+    assert pipe.num_unchanged == 1 and pipe.column('bid')[0] == mids[0] - 2.0
+
+    # A crossed quote is flagged instead of raising
+    pipe.push(put, 90.0, 80.0, 21500.0)
+    assert list(pipe.process()) == [put]
+    assert pipe.status()[put] == int(optipricer.models.IVStatus.INVALID_INPUT) and np.isnan(iv[put])
+
+    assert pipe.values().shape == (len(stream.COLUMN_NAMES), 4)
+    with pytest.raises(IndexError):
+        pipe.push(4, 1.0, 2.0, 21500.0)
+    with pytest.raises(ValueError):
+        pipe.add_contracts(np.full(5, 21000.0), T)
+    assert len(pipe.process()) == 0
+
+
+def test_benchmark_compare(tmp_path, capsys):
+    """Test that the benchmark comparison flags a slowdown beyond the threshold and passes otherwise."""
+    import importlib.util
+    import json
+    import os
+
+    script = os.path.join(os.path.dirname(__file__), '..', '..', 'benchmarks', 'compare.py')
+    spec = importlib.util.spec_from_file_location('bench_compare', script)
+    compare = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(compare)
+
+    def report(name, times):
+        path = tmp_path / name
+        path.write_text(json.dumps({
+            'context': {'commit': name, 'num_cpus': 1, 'simd': 'avx2'},
+            'benchmarks': [
+                {'name': bench, 'run_type': 'iteration', 'real_time': t, 'cpu_time': t,
+                 'real_time_min': t, 'time_unit': unit}
+                for bench, (t, unit) in times.items()
+            ],
+        }))
+        return str(path)
+
+    baseline = report('baseline.json', {'price_batch/4096': (1000.0, 'ns'), 'greeks/4096': (2.0, 'us')})
+    # Within the threshold (and the same time in a different unit) passes...
+    steady = report('steady.json', {'price_batch/4096': (1.05, 'us'), 'greeks/4096': (1900.0, 'ns'),
+                                    'iv_batch/4096': (500.0, 'ns')})
+    assert compare.main([baseline, steady]) == 0
+    assert 'REGRESSION' not in capsys.readouterr().out
+
+    # ...while a 30% slowdown is flagged, unless the threshold allows it
+    slower = report('slower.json', {'price_batch/4096': (1000.0, 'ns'), 'greeks/4096': (2.6, 'us')})
+    assert compare.main([baseline, slower]) == 1
+    out = capsys.readouterr().out
+    assert 'greeks/4096' in out and out.count('REGRESSION') == 1
+    assert compare.main([baseline, slower, '--threshold', '0.5']) == 0
+    capsys.readouterr()
+
+    # Benchmarks missing from either run never fail the comparison
+    renamed = report('renamed.json', {'price_batch/8192': (9000.0, 'ns')})
+    assert compare.main([baseline, renamed]) == 0
+
+
+def test_chain_snapshots_roundtrip(tmp_path):
+    """Snapshots round-trip through the mapped file and replay into the surface engine."""
+    import numpy as np
+    from optipricer import snapshot
+    from optipricer.surface import VolatilitySurface
+
+    path = str(tmp_path / "chain.snap")
+    strikes = np.array([22000.0, 21000.0, 21500.0])
+    chains = []
+    with snapshot.SnapshotWriter(path) as w:
+        for i in range(4):
+            chain_data = [
+                {'expiry': 30 / 365, 'strikes': strikes, 'ivs': np.array([0.13, 0.16, 0.14]) + 0.01 * i},
+                {'expiry': 7 / 365, 'strikes': strikes[1:], 'ivs': [0.18, 0.15], 'call_prices': [520.0, 90.0]},
+            ]
+            w.append(60.0 * i, 21500.0 + i, chain_data, risk_free_rate=0.07)
+            chains.append(chain_data)
+        with pytest.raises(ValueError):
+            w.append(0.0, 21500.0, chains[0])
+        assert len(w) == 4
+
+    reader = snapshot.SnapshotReader(path)
+    assert len(reader) == 4 and reader.file_size > 0
+    assert list(reader.timestamps()) == [0.0, 60.0, 120.0, 180.0]
+    assert reader.find(130.0) == 2
+    with pytest.raises(IndexError):
+        reader.find(-1.0)
+
+    snap = reader[-1]
+    assert snap.timestamp == 180.0 and snap.underlying_price == 21503.0 and snap.risk_free_rate == 0.07
+    assert np.allclose(snap.expiries(), [7 / 365, 30 / 365])
+    # Expiries and strikes come back sorted; missing prices are NaN
+    assert list(snap.column(1, 'strike')) == [21000.0, 21500.0, 22000.0]
+    assert np.allclose(snap.column(1, 'iv'), [0.19, 0.17, 0.16])
+    assert list(snap.column(0, 'call_price')) == [520.0, 90.0] and np.isnan(snap.column(0, 'put_price')).all()
+    assert not snap.column(0, 'iv').flags.writeable
+    assert snap.num_quotes() == 5
+
+    direct = VolatilitySurface.from_chain_data(chains[3])
+    replayed = VolatilitySurface.from_snapshot(snap)
+    assert replayed.get_iv(21250.0, 20 / 365) == pytest.approx(direct.get_iv(21250.0, 20 / 365), abs=1e-14)
+    assert VolatilitySurface.from_chain_data(snap.to_chain_data()).get_iv(21800.0, 0.05) == pytest.approx(
+        direct.get_iv(21800.0, 0.05), abs=1e-14
+    )
+
+    series = reader.surface_series([21250.0, 21800.0], 20 / 365, start=1)
+    assert series.shape == (3, 2)
+    for row, i in zip(series, range(1, 4)):
+        assert np.allclose(row, reader[i].surface().get_iv_batch([21250.0, 21800.0], 20 / 365), atol=1e-14)
+
+    with pytest.raises(KeyError):
+        snap.column(0, 'delta')
+    with pytest.raises(IndexError):
+        reader[4]
+
+    # A strike column that is out of order is rejected on access rather than walked past its end
+    import struct
+    with open(path, 'rb') as f:
+        data = f.read()
+    sorted_pair = struct.pack('=2d', 21500.0, 22000.0)
+    assert sorted_pair in data
+    with open(path, 'wb') as f:
+        f.write(data.replace(sorted_pair, struct.pack('=2d', 22000.0, 21500.0), 1))
+    unsorted = snapshot.SnapshotReader(path)
+    # Seeking reads only the snapshot records, so it never looks at the strikes
+    assert unsorted.find(30.0) == 0 and list(unsorted.timestamps()) == [0.0, 60.0, 120.0, 180.0]
+    for _ in range(2):
+        with pytest.raises(RuntimeError, match="strictly increasing"):
+            unsorted[0].surface()
+    assert unsorted[1].num_quotes() == 5
+
+    # A truncated file is rejected on open rather than read past its end
+    with open(path, 'wb') as f:
+        f.write(data[: len(data) // 2])
+    with pytest.raises(RuntimeError):
+        snapshot.SnapshotReader(path)